@@ -39,8 +39,10 @@
 #include "object.h"
 #include "layout.h"
 #include "archive.h"
+#include "stringpool.h"
 #include "plugin.h"
 #include "incremental.h"
+#include "link-server.h"
 
 namespace gold
 {
@@ -183,10 +185,10 @@ const char Archive::arfmag[2] = { '`', '\n' };
 Archive::Archive(const std::string& name, Input_file* input_file,
                  bool is_thin_archive, Dirsearch* dirpath, Task* task)
   : Library_base(task), name_(name), input_file_(input_file), armap_(),
-    armap_names_(), extended_names_(), armap_checked_(), seen_offsets_(),
-    members_(), is_thin_archive_(is_thin_archive), included_member_(false),
-    nested_archives_(), dirpath_(dirpath), num_members_(0),
-    included_all_members_(false)
+    armap_names_(), extended_names_(), armap_checked_(), armap_hashes_(),
+    seen_offsets_(), members_(), is_thin_archive_(is_thin_archive),
+    included_member_(false), nested_archives_(), dirpath_(dirpath),
+    num_members_(0), included_all_members_(false)
 {
   this->no_export_ =
     parameters->options().check_excluded_libs(input_file->found_name());
@@ -266,50 +268,74 @@ Archive::unlock_nested_archives()
 
 void
 Archive::read_armap(off_t start, section_size_type size)
+{
+  // The link server may already have parsed the symbol map for us.
+  if (!Link_server::take_armap(this->input_file_->file().cached_contents(),
+			       &this->armap_names_, &this->armap_,
+			       &this->num_members_))
+    {
+      // Read in the entire armap.
+      const unsigned char* p = this->get_view(start, size, true, false);
+      if (!Archive::parse_armap(p, size, &this->armap_names_, &this->armap_,
+				&this->num_members_))
+	gold_error(_("%s: bad archive symbol table names"),
+		   this->name().c_str());
+    }
+
+  // This array keeps track of which symbols are for archive elements
+  // which we have already included in the link.
+  this->armap_checked_.resize(this->armap_.size());
+}
+
+// Parse an archive symbol map.
+
+bool
+Archive::parse_armap(const unsigned char* p, section_size_type size,
+		     std::string* names, std::vector<Armap_entry>* armap,
+		     unsigned int* num_members)
 {
   // To count the total number of archive members, we'll just count
   // the number of times the file offset changes.  Since most archives
   // group the symbols in the armap by object, this ought to give us
   // an accurate count.
   off_t last_seen_offset = -1;
+  *num_members = 0;
 
-  // Read in the entire armap.
-  const unsigned char* p = this->get_view(start, size, true, false);
+  if (size < sizeof(elfcpp::Elf_Word))
+    return false;
 
   // Numbers in the armap are always big-endian.
   const elfcpp::Elf_Word* pword = reinterpret_cast<const elfcpp::Elf_Word*>(p);
   unsigned int nsyms = elfcpp::Swap<32, true>::readval(pword);
   ++pword;
+  if (nsyms > size / sizeof(elfcpp::Elf_Word) - 1)
+    return false;
 
   // Note that the addition is in units of sizeof(elfcpp::Elf_Word).
   const char* pnames = reinterpret_cast<const char*>(pword + nsyms);
   section_size_type names_size =
     reinterpret_cast<const char*>(p) + size - pnames;
-  this->armap_names_.assign(pnames, names_size);
+  names->assign(pnames, names_size);
 
-  this->armap_.resize(nsyms);
+  armap->resize(nsyms);
 
   section_offset_type name_offset = 0;
   for (unsigned int i = 0; i < nsyms; ++i)
     {
-      this->armap_[i].name_offset = name_offset;
-      this->armap_[i].file_offset = elfcpp::Swap<32, true>::readval(pword);
-      name_offset += strlen(pnames + name_offset) + 1;
+      if (static_cast<section_size_type>(name_offset) > names_size)
+	return false;
+      (*armap)[i].name_offset = name_offset;
+      (*armap)[i].file_offset = elfcpp::Swap<32, true>::readval(pword);
+      name_offset += strlen(names->c_str() + name_offset) + 1;
       ++pword;
-      if (this->armap_[i].file_offset != last_seen_offset)
+      if ((*armap)[i].file_offset != last_seen_offset)
         {
-          last_seen_offset = this->armap_[i].file_offset;
-          ++this->num_members_;
+          last_seen_offset = (*armap)[i].file_offset;
+          ++*num_members;
         }
     }
 
-  if (static_cast<section_size_type>(name_offset) > names_size)
-    gold_error(_("%s: bad archive symbol table names"),
-	       this->name().c_str());
-
-  // This array keeps track of which symbols are for archive elements
-  // which we have already included in the link.
-  this->armap_checked_.resize(nsyms);
+  return static_cast<section_size_type>(name_offset) <= names_size;
 }
 
 // Read the header of an archive member at OFF.  Fail if something
@@ -768,51 +794,14 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
       added_new_object = false;
       for (size_t i = 0; i < armap_size; ++i)
 	{
-          if (this->armap_checked_[i])
-            continue;
-	  if (this->armap_[i].file_offset == last_seen_offset)
-            {
-              this->armap_checked_[i] = true;
-              continue;
-            }
-	  if (this->seen_offsets_.find(this->armap_[i].file_offset)
-              != this->seen_offsets_.end())
-	    {
-              this->armap_checked_[i] = true;
-	      last_seen_offset = this->armap_[i].file_offset;
-	      continue;
-	    }
-
-	  const char* sym_name = (this->armap_names_.data()
-				  + this->armap_[i].name_offset);
-
-          Symbol* sym;
-          std::string why;
-          Archive::Should_include t =
-	    Archive::should_include_member(symtab, layout, sym_name, &sym,
-					   &why, &tmpbuf, &tmpbuflen);
-
-	  if (t == Archive::SHOULD_INCLUDE_NO
-              || t == Archive::SHOULD_INCLUDE_YES)
-	    this->armap_checked_[i] = true;
-
-	  if (t != Archive::SHOULD_INCLUDE_YES)
-	    continue;
-
-	  // We want to include this object in the link.
-	  last_seen_offset = this->armap_[i].file_offset;
-	  this->seen_offsets_.insert(last_seen_offset);
-
-	  if (!this->include_member(symtab, layout, input_objects,
-				    last_seen_offset, mapfile, sym,
-				    why.c_str()))
+	  if (!this->check_armap_entry(symtab, layout, input_objects, mapfile,
+				       i, &last_seen_offset, &tmpbuf,
+				       &tmpbuflen, &added_new_object))
 	    {
 	      if (tmpbuf != NULL)
 		free(tmpbuf);
 	      return false;
 	    }
-
-	  added_new_object = true;
 	}
     }
   while (added_new_object);
@@ -825,6 +814,103 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
   return true;
 }
 
+// Check entry I in the archive map.  If the symbol it names is a
+// strong undefined symbol, include the member which defines it.
+
+bool
+Archive::check_armap_entry(Symbol_table* symtab, Layout* layout,
+			   Input_objects* input_objects, Mapfile* mapfile,
+			   size_t i, off_t* last_seen_offset, char** tmpbufp,
+			   size_t* tmpbuflen, bool* added)
+{
+  if (this->armap_checked_[i])
+    return true;
+  if (this->armap_[i].file_offset == *last_seen_offset)
+    {
+      this->armap_checked_[i] = true;
+      return true;
+    }
+  if (this->seen_offsets_.find(this->armap_[i].file_offset)
+      != this->seen_offsets_.end())
+    {
+      this->armap_checked_[i] = true;
+      *last_seen_offset = this->armap_[i].file_offset;
+      return true;
+    }
+
+  const char* sym_name = (this->armap_names_.data()
+			  + this->armap_[i].name_offset);
+
+  Symbol* sym;
+  std::string why;
+  Archive::Should_include t =
+    Archive::should_include_member(symtab, layout, sym_name, &sym,
+				   &why, tmpbufp, tmpbuflen);
+
+  if (t == Archive::SHOULD_INCLUDE_NO
+      || t == Archive::SHOULD_INCLUDE_YES)
+    this->armap_checked_[i] = true;
+
+  if (t != Archive::SHOULD_INCLUDE_YES)
+    return true;
+
+  // We want to include this object in the link.
+  *last_seen_offset = this->armap_[i].file_offset;
+  this->seen_offsets_.insert(*last_seen_offset);
+
+  if (!this->include_member(symtab, layout, input_objects,
+			    *last_seen_offset, mapfile, sym, why.c_str()))
+    return false;
+
+  *added = true;
+  return true;
+}
+
+// Include the member for archive map entry I, if it is still needed.
+// This is used by an archive group, which looks up each new undefined
+// symbol in an index of the archive maps of the group rather than
+// walking through every archive map again.  The group decides which
+// entry to check next, so we don't loop here.
+
+bool
+Archive::add_group_symbol(Symbol_table* symtab, Layout* layout,
+			  Input_objects* input_objects, Mapfile* mapfile,
+			  size_t i, bool* added)
+{
+  off_t last_seen_offset = -1;
+  char* tmpbuf = NULL;
+  size_t tmpbuflen = 0;
+  bool ret = this->check_armap_entry(symtab, layout, input_objects, mapfile,
+				     i, &last_seen_offset, &tmpbuf,
+				     &tmpbuflen, added);
+  if (tmpbuf != NULL)
+    free(tmpbuf);
+  return ret;
+}
+
+// Compute the hash codes of the names in the archive map.
+
+void
+Archive::hash_armap()
+{
+  const size_t armap_size = this->armap_.size();
+  this->armap_hashes_.resize(armap_size);
+  for (size_t i = 0; i < armap_size; ++i)
+    this->armap_hashes_[i] =
+      Archive::armap_name_hash(this->armap_names_.data()
+			       + this->armap_[i].name_offset);
+}
+
+// Return the hash code of the archive map symbol NAME.  This ignores
+// any version, so that it matches the hash code of the name of a
+// symbol in the symbol table.
+
+size_t
+Archive::armap_name_hash(const char* name)
+{
+  return gold::string_hash<char>(name, strcspn(name, "@"));
+}
+
 // Return whether the archive includes a member which defines the
 // symbol SYM.
 
@@ -1049,13 +1135,18 @@ Add_archive_symbols::~Add_archive_symbols()
 }
 
 // Return whether we can add the archive symbols.  We are blocked by
-// this_blocker_.  We block next_blocker_.  We also lock the file.
+// this_blocker_.  We block next_blocker_.  We also lock the file.  We
+// need to see all the symbols added so far, so if the symbol table
+// is sharded we wait for the shard tasks.
 
 Task_token*
 Add_archive_symbols::is_runnable()
 {
   if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
     return this->this_blocker_;
+  Task_token* shard_blocker = this->symtab_->shard_blocker();
+  if (shard_blocker != NULL && shard_blocker->is_blocked())
+    return shard_blocker;
   return NULL;
 }
 
@@ -1279,6 +1370,9 @@ Add_lib_group_symbols::is_runnable()
     return this->readsyms_blocker_;
   if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
     return this->this_blocker_;
+  Task_token* shard_blocker = this->symtab_->shard_blocker();
+  if (shard_blocker != NULL && shard_blocker->is_blocked())
+    return shard_blocker;
   return NULL;
 }
 
@@ -84,6 +84,12 @@ class Library_base
   get_mtime()
   { return this->do_get_mtime(); }
 
+  // A hash of the contents of the archive file, or 0 if it is not
+  // known.
+  uint64_t
+  get_content_hash()
+  { return this->do_get_content_hash(); }
+
   // When we see a symbol in an archive we might decide to include the member,
   // not include the member or be undecided. This enum represents these
   // possibilities.
@@ -148,6 +154,10 @@ class Library_base
   virtual Timespec
   do_get_mtime() = 0;
 
+  // Return a hash of the contents of the archive file.
+  virtual uint64_t
+  do_get_content_hash() = 0;
+
   // Iterator for unused global symbols in the library.
   virtual void
   do_for_all_unused_symbols(Symbol_visitor_base* v) const = 0;
@@ -244,10 +254,52 @@ class Archive : public Library_base
   bool
   add_symbols(Symbol_table*, Layout*, Input_objects*, Mapfile*);
 
+  // Include the member for entry I in the archive map, if it is
+  // still needed, and set *ADDED if it was included.  This is used by
+  // an archive group when it sees a new undefined symbol.  Return
+  // false if the member had an incompatible target.
+  bool
+  add_group_symbol(Symbol_table*, Layout*, Input_objects*, Mapfile*,
+		   size_t i, bool* added);
+
   // Return whether the archive defines the symbol.
   bool
   defines_symbol(Symbol*) const;
 
+  // Compute the hash codes of the names in the archive map.  This is
+  // only needed for an archive in a group, and is done by the task
+  // which reads the archive, so that the archives in a group are
+  // hashed in parallel.
+  void
+  hash_armap();
+
+  // Return the number of entries in the archive map.
+  size_t
+  armap_size() const
+  { return this->armap_.size(); }
+
+  // Return the hash code of the name of entry I in the archive map.
+  // hash_armap must have been called.
+  size_t
+  armap_hash(size_t i) const
+  { return this->armap_hashes_[i]; }
+
+  // Return whether entry I in the archive map is for the symbol NAME
+  // of length LEN, with or without a version.
+  bool
+  armap_name_matches(size_t i, const char* name, size_t len) const
+  {
+    const char* armap_name = (this->armap_names_.data()
+			      + this->armap_[i].name_offset);
+    return (strncmp(armap_name, name, len) == 0
+	    && (armap_name[len] == '\0' || armap_name[len] == '@'));
+  }
+
+  // Return the hash code used for the archive map symbol NAME, which
+  // ignores any version.
+  static size_t
+  armap_name_hash(const char* name);
+
   // Dump statistical information to stderr.
   static void
   print_stats();
@@ -261,6 +313,24 @@ class Archive : public Library_base
   no_export()
   { return this->no_export_; }
 
+  // An entry in the archive map of symbols to object files.
+  struct Armap_entry
+  {
+    // The offset to the symbol name in armap_names_.
+    off_t name_offset;
+    // The file offset to the object in the archive.
+    off_t file_offset;
+  };
+
+  // Parse the SIZE bytes of an archive symbol map at P into *NAMES
+  // and *ARMAP, and set *NUM_MEMBERS to the number of members it
+  // refers to.  Return false if the map is malformed.  This is also
+  // used by the link server, which has no Archive object.
+  static bool
+  parse_armap(const unsigned char* p, section_size_type size,
+	      std::string* names, std::vector<Armap_entry>* armap,
+	      unsigned int* num_members);
+
  private:
   Archive(const Archive&);
   Archive& operator=(const Archive&);
@@ -275,6 +345,11 @@ class Archive : public Library_base
   do_get_mtime()
   { return this->file().get_mtime(); }
 
+  // A hash of the contents of the archive file.
+  uint64_t
+  do_get_content_hash()
+  { return this->file().get_content_hash(); }
+
   struct Archive_header;
 
   // Total number of archives seen.
@@ -327,6 +402,15 @@ class Archive : public Library_base
   void
   read_symbols(off_t off);
 
+  // Check entry I in the archive map, and include the member which
+  // defines it if it satisfies an undefined symbol.  Set *ADDED if a
+  // member was included.  Return false if the member had an
+  // incompatible target.
+  bool
+  check_armap_entry(Symbol_table*, Layout*, Input_objects*, Mapfile*,
+		    size_t i, off_t* last_seen_offset, char** tmpbufp,
+		    size_t* tmpbuflen, bool* added);
+
   // Include all the archive members in the link.
   bool
   include_all_members(Symbol_table*, Layout*, Input_objects*, Mapfile*);
@@ -356,15 +440,6 @@ class Archive : public Library_base
   void
   do_for_all_unused_symbols(Symbol_visitor_base* v) const;
 
-  // An entry in the archive map of symbols to object files.
-  struct Armap_entry
-  {
-    // The offset to the symbol name in armap_names_.
-    off_t name_offset;
-    // The file offset to the object in the archive.
-    off_t file_offset;
-  };
-
   // A simple hash code for off_t values.
   class Seen_hash
   {
@@ -389,6 +464,9 @@ class Archive : public Library_base
   // Track which symbols in the archive map are for elements which are
   // defined or which have already been included in the link.
   std::vector<bool> armap_checked_;
+  // The hash codes of the names in the archive map, set by
+  // hash_armap.
+  std::vector<size_t> armap_hashes_;
   // Track which elements have been included by offset.
   Unordered_set<off_t, Seen_hash> seen_offsets_;
   // Table of objects whose symbols have been pre-read.
@@ -507,6 +585,11 @@ class Lib_group : public Library_base
   do_get_mtime()
   { return Timespec(0, 0); }
 
+  // Nor does it have any contents to hash.
+  uint64_t
+  do_get_content_hash()
+  { return 0; }
+
   // Iterator for unused global symbols in the library.
   void
   do_for_all_unused_symbols(Symbol_visitor_base*) const;
@@ -469,6 +469,8 @@ class Reloc_stub : public Stub
   static const unsigned int invalid_index = static_cast<unsigned int>(-1);
   // We assume we never jump to this address.
   static const Arm_address invalid_address = static_cast<Arm_address>(-1);
+  // A branch margin larger than any distance between two addresses.
+  static const Arm_address unlimited_margin = static_cast<Arm_address>(-1);
 
   // Return destination address.
   Arm_address
@@ -499,6 +501,12 @@ class Reloc_stub : public Stub
   stub_type_for_reloc(unsigned int r_type, Arm_address branch_address,
 		      Arm_address branch_target, bool target_is_thumb);
 
+  // Return by how much the distance between a branch at BRANCH_ADDRESS
+  // and its target BRANCH_TARGET may change without changing the result
+  // of stub_type_for_reloc.
+  static Arm_address
+  branch_margin(Arm_address branch_address, Arm_address branch_target);
+
   // Reloc_stub key.  A key is logically a triplet of a stub type, a symbol
   // and an addend.  Since we treat global and local symbol differently, we
   // use a Symbol object for a global symbol and a object-index pair for
@@ -1495,7 +1503,8 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
       attributes_section_data_(NULL), mapping_symbols_info_(),
       section_has_cortex_a8_workaround_(NULL), exidx_section_map_(),
       output_local_symbol_count_needs_update_(false),
-      merge_flags_and_attributes_(true)
+      merge_flags_and_attributes_(true), stub_scan_info_(),
+      min_stub_scan_movement_(0), min_stub_rescan_movement_(0)
   { }
 
   ~Arm_relobj()
@@ -1531,6 +1540,11 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
   scan_sections_for_stubs(Target_arm<big_endian>*, const Symbol_table*,
 			  const Layout*);
 
+  // Return whether scan_sections_for_stubs needs to scan any section
+  // of this object in the current relaxation pass.
+  bool
+  needs_stub_scan(const Target_arm<big_endian>*) const;
+
   // Convert regular input section with index SHNDX to a relaxed section.
   void
   convert_input_section_to_relaxed_section(unsigned shndx)
@@ -1740,6 +1754,21 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
   typedef Unordered_map<unsigned int, const Arm_exidx_input_section*>
     Exidx_section_map;
 
+  // What we know about a relocation section from its last scan for
+  // stubs.  The movements are values of Target_arm::branch_movement.
+  struct Stub_scan_info
+  {
+    Stub_scan_info()
+      : scan_movement(0), rescan_movement(0)
+    { }
+
+    // The movement when the section was last scanned.
+    uint64_t scan_movement;
+    // The movement from which a branch in the section may need a
+    // different stub.
+    uint64_t rescan_movement;
+  };
+
   // List of stub tables.
   Stub_table_list stub_tables_;
   // Bit vector to tell if a local symbol is a thumb function or not.
@@ -1760,6 +1789,13 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
   // Whether we merge processor flags and attributes of this object to
   // output.
   bool merge_flags_and_attributes_;
+  // Stub scanning information for each section, indexed by the section
+  // index of the relocation section.  Empty before the first scan.
+  std::vector<Stub_scan_info> stub_scan_info_;
+  // Minimum SCAN_MOVEMENT and RESCAN_MOVEMENT over the relocation
+  // sections that need scanning.
+  uint64_t min_stub_scan_movement_;
+  uint64_t min_stub_rescan_movement_;
 };
 
 // Arm_dynobj class.
@@ -2125,7 +2161,8 @@ class Target_arm : public Sized_target<32, big_endian>
       stub_tables_(), stub_factory_(Stub_factory::get_instance()),
       should_force_pic_veneer_(false),
       arm_input_section_map_(), attributes_section_data_(NULL),
-      fix_cortex_a8_(false), cortex_a8_relocs_info_()
+      fix_cortex_a8_(false), cortex_a8_relocs_info_(),
+      stub_scan_mode_(STUB_SCAN_ALL), branch_movement_(0)
   { }
 
   // Whether we force PCI branch veneers.
@@ -2383,8 +2420,33 @@ class Target_arm : public Sized_target<32, big_endian>
   Stub_table<big_endian>*
   new_stub_table(Arm_input_section<big_endian>*);
 
-  // Scan a section for stub generation.
-  void
+  // How Arm_relobj::scan_sections_for_stubs chooses the sections to
+  // scan in a relaxation pass.
+  enum Stub_scan_mode
+  {
+    // Scan all sections.
+    STUB_SCAN_ALL,
+    // Scan only the sections with a branch that may need a different
+    // stub after the layout changes of the previous passes.
+    STUB_SCAN_MOVED,
+    // Scan the sections that have not been scanned in this pass yet.
+    STUB_SCAN_REST
+  };
+
+  // Return how sections are chosen for stub scanning.
+  Stub_scan_mode
+  stub_scan_mode() const
+  { return this->stub_scan_mode_; }
+
+  // Return the sum of upper bounds on how much the distance between any
+  // two addresses in the output changed in each relaxation pass so far.
+  uint64_t
+  branch_movement() const
+  { return this->branch_movement_; }
+
+  // Scan a section for stub generation.  Return the smallest branch
+  // margin in the section.
+  Arm_address
   scan_section_for_stubs(const Relocate_info<32, big_endian>*, unsigned int,
 			 const unsigned char*, size_t, Output_section*,
 			 bool, const unsigned char*, Arm_address,
@@ -2835,7 +2897,7 @@ class Target_arm : public Sized_target<32, big_endian>
   group_sections(Layout*, section_size_type, bool, const Task*);
 
   // Scan a relocation for stub generation.
-  void
+  Arm_address
   scan_reloc_for_stub(const Relocate_info<32, big_endian>*, unsigned int,
 		      const Sized_symbol<32>*, unsigned int,
 		      const Symbol_value<32>*,
@@ -2843,7 +2905,7 @@ class Target_arm : public Sized_target<32, big_endian>
 
   // Scan a relocation section for stub.
   template<int sh_type>
-  void
+  Arm_address
   scan_reloc_section_for_stubs(
       const Relocate_info<32, big_endian>* relinfo,
       const unsigned char* prelocs,
@@ -2854,6 +2916,15 @@ class Target_arm : public Sized_target<32, big_endian>
       elfcpp::Elf_types<32>::Elf_Addr view_address,
       section_size_type);
 
+  // Scan the relocations of all input objects for stubs.
+  void
+  scan_objects_for_stubs(const Input_objects*, Symbol_table*, Layout*,
+			 const Task*);
+
+  // Update the stub tables after scanning for stubs.
+  bool
+  update_stub_tables(Layout*, uint64_t*);
+
   // Fix .ARM.exidx section coverage.
   void
   fix_exidx_coverage(Layout*, const Input_objects*,
@@ -2925,6 +2996,11 @@ class Target_arm : public Sized_target<32, big_endian>
   bool fix_cortex_a8_;
   // Map addresses to relocs for Cortex-A8 erratum.
   Cortex_a8_relocs_info cortex_a8_relocs_info_;
+  // How to choose the sections to scan for stubs.
+  Stub_scan_mode stub_scan_mode_;
+  // Upper bound on how much addresses moved relative to each other
+  // since the first relaxation pass.
+  uint64_t branch_movement_;
 };
 
 template<bool big_endian>
@@ -4617,6 +4693,41 @@ Reloc_stub::stub_type_for_reloc(
   return stub_type;
 }
 
+// Return by how much the distance between a branch at BRANCH_ADDRESS and
+// its target BRANCH_TARGET may change before stub_type_for_reloc could
+// return a different stub type.  This is the distance of the branch
+// offset to the nearest branch range limit.  We do not bother to pick
+// the limits that apply to the branch type and architecture.
+
+Arm_address
+Reloc_stub::branch_margin(
+    Arm_address branch_address,
+    Arm_address branch_target)
+{
+  static const int32_t limits[] =
+    {
+      ARM_MAX_FWD_BRANCH_OFFSET + 2,
+      ARM_MAX_FWD_BRANCH_OFFSET,
+      ARM_MAX_BWD_BRANCH_OFFSET,
+      THM_MAX_FWD_BRANCH_OFFSET,
+      THM_MAX_BWD_BRANCH_OFFSET,
+      THM2_MAX_FWD_BRANCH_OFFSET,
+      THM2_MAX_BWD_BRANCH_OFFSET
+    };
+
+  int64_t branch_offset = static_cast<int64_t>(branch_target) - branch_address;
+  int64_t margin = unlimited_margin;
+  for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); ++i)
+    {
+      int64_t distance = branch_offset - limits[i];
+      margin = std::min(margin, distance < 0 ? -distance : distance);
+    }
+
+  // stub_type_for_reloc may take bit 1 of a THUMB BLX target from the
+  // branch address, which moves the target by up to 2 bytes.
+  return margin > 4 ? margin - 4 : 0;
+}
+
 // Cortex_a8_stub methods.
 
 // Return the instruction for a THUMB16_SPECIAL_TYPE instruction template.
@@ -6228,7 +6339,33 @@ Arm_relobj<big_endian>::scan_section_for_cortex_a8_erratum(
     }
 }
 
-// Scan relocations for stub generation.
+// Return whether scan_sections_for_stubs needs to scan any section of
+// this object in the current relaxation pass.
+
+template<bool big_endian>
+bool
+Arm_relobj<big_endian>::needs_stub_scan(
+    const Target_arm<big_endian>* arm_target) const
+{
+  if (this->stub_scan_info_.empty())
+    return true;
+
+  switch (arm_target->stub_scan_mode())
+    {
+    case Target_arm<big_endian>::STUB_SCAN_ALL:
+      return true;
+    case Target_arm<big_endian>::STUB_SCAN_MOVED:
+      return this->min_stub_rescan_movement_ <= arm_target->branch_movement();
+    case Target_arm<big_endian>::STUB_SCAN_REST:
+      return this->min_stub_scan_movement_ < arm_target->branch_movement();
+    default:
+      gold_unreachable();
+    }
+}
+
+// Scan relocations for stub generation.  Depending on the stub scan mode
+// of the target, we skip the relocation sections whose branches cannot
+// need a different stub since we last scanned them.
 
 template<bool big_endian>
 void
@@ -6240,6 +6377,17 @@ Arm_relobj<big_endian>::scan_sections_for_stubs(
   unsigned int shnum = this->shnum();
   const unsigned int shdr_size = elfcpp::Elf_sizes<32>::shdr_size;
 
+  typename Target_arm<big_endian>::Stub_scan_mode scan_mode =
+    arm_target->stub_scan_mode();
+  if (this->stub_scan_info_.empty())
+    {
+      this->stub_scan_info_.resize(shnum);
+      scan_mode = Target_arm<big_endian>::STUB_SCAN_ALL;
+    }
+  uint64_t movement = arm_target->branch_movement();
+  uint64_t min_scan_movement = -1ULL;
+  uint64_t min_rescan_movement = -1ULL;
+
   // Read the section headers.
   const unsigned char* pshdrs = this->get_view(this->elf_file()->shoff(),
 					       shnum * shdr_size,
@@ -6264,6 +6412,23 @@ Arm_relobj<big_endian>::scan_sections_for_stubs(
       if (this->section_needs_reloc_stub_scanning(shdr, out_sections, symtab,
 						  pshdrs))
 	{
+	  Stub_scan_info& info(this->stub_scan_info_[i]);
+	  bool skip;
+	  if (scan_mode == Target_arm<big_endian>::STUB_SCAN_MOVED)
+	    skip = info.rescan_movement > movement;
+	  else if (scan_mode == Target_arm<big_endian>::STUB_SCAN_REST)
+	    skip = info.scan_movement >= movement;
+	  else
+	    skip = false;
+	  if (skip)
+	    {
+	      min_scan_movement = std::min(min_scan_movement,
+					   info.scan_movement);
+	      min_rescan_movement = std::min(min_rescan_movement,
+					     info.rescan_movement);
+	      continue;
+	    }
+
 	  unsigned int index = this->adjust_shndx(shdr.get_sh_info());
 	  Arm_address output_offset = this->get_output_section_offset(index);
 	  Arm_address output_address;
@@ -6300,14 +6465,23 @@ Arm_relobj<big_endian>::scan_sections_for_stubs(
 	    reloc_size = elfcpp::Elf_sizes<32>::rela_size;
 
 	  Output_section* os = out_sections[index];
-	  arm_target->scan_section_for_stubs(&relinfo, sh_type, prelocs,
-					     shdr.get_sh_size() / reloc_size,
-					     os,
-					     output_offset == invalid_address,
-					     input_view, output_address,
-					     input_view_size);
+	  Arm_address margin =
+	    arm_target->scan_section_for_stubs(&relinfo, sh_type, prelocs,
+					       shdr.get_sh_size() / reloc_size,
+					       os,
+					       output_offset == invalid_address,
+					       input_view, output_address,
+					       input_view_size);
+
+	  info.scan_movement = movement;
+	  info.rescan_movement = movement + margin;
+	  min_scan_movement = std::min(min_scan_movement, info.scan_movement);
+	  min_rescan_movement = std::min(min_rescan_movement,
+					 info.rescan_movement);
 	}
     }
+  this->min_stub_scan_movement_ = min_scan_movement;
+  this->min_stub_rescan_movement_ = min_rescan_movement;
 
   // Do Cortex-A8 erratum stubs scanning.  This has to be done for a section
   // after its relocation section, if there is one, is processed for
@@ -11056,10 +11230,11 @@ Target_arm<big_endian>::new_stub_table(Arm_input_section<big_endian>* owner)
   return stub_table;
 }
 
-// Scan a relocation for stub generation.
+// Scan a relocation for stub generation.  Return the branch margin of
+// the relocation, see Reloc_stub::branch_margin.
 
 template<bool big_endian>
-void
+Arm_address
 Target_arm<big_endian>::scan_reloc_for_stub(
     const Relocate_info<32, big_endian>* relinfo,
     unsigned int r_type,
@@ -11088,7 +11263,7 @@ Target_arm<big_endian>::scan_reloc_for_stub(
 	}
       else if (gsym->is_undefined())
 	// There is no need to generate a stub symbol is undefined.
-	return;
+	return Reloc_stub::unlimited_margin;
       else
 	{
 	  target_is_thumb =
@@ -11186,6 +11361,8 @@ Target_arm<big_endian>::scan_reloc_for_stub(
 	new Cortex_a8_reloc(stub, r_type,
 			    destination | (target_is_thumb ? 1 : 0));
     }
+
+  return Reloc_stub::branch_margin(address, destination);
 }
 
 // This function scans a relocation sections for stub generation.
@@ -11206,9 +11383,11 @@ Target_arm<big_endian>::scan_reloc_for_stub(
 // NEEDS_SPECIAL_OFFSET_HANDLING is true, in which case they refer to
 // the output section.
 
+// This returns the smallest branch margin of the relocations.
+
 template<bool big_endian>
 template<int sh_type>
-void inline
+Arm_address inline
 Target_arm<big_endian>::scan_reloc_section_for_stubs(
     const Relocate_info<32, big_endian>* relinfo,
     const unsigned char* prelocs,
@@ -11230,6 +11409,7 @@ Target_arm<big_endian>::scan_reloc_section_for_stubs(
   gold::Default_comdat_behavior default_comdat_behavior;
   Comdat_behavior comdat_behavior = CB_UNDETERMINED;
 
+  Arm_address margin = Reloc_stub::unlimited_margin;
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
     {
       Reltype reloc(prelocs);
@@ -11435,15 +11615,19 @@ Target_arm<big_endian>::scan_reloc_section_for_stubs(
       if (psymval->is_section_symbol())
 	continue;
 
-      this->scan_reloc_for_stub(relinfo, r_type, sym, r_sym, psymval,
-				addend, view_address + offset);
+      margin = std::min(margin,
+			this->scan_reloc_for_stub(relinfo, r_type, sym, r_sym,
+						  psymval, addend,
+						  view_address + offset));
     }
+
+  return margin;
 }
 
 // Scan an input section for stub generation.
 
 template<bool big_endian>
-void
+Arm_address
 Target_arm<big_endian>::scan_section_for_stubs(
     const Relocate_info<32, big_endian>* relinfo,
     unsigned int sh_type,
@@ -11456,7 +11640,7 @@ Target_arm<big_endian>::scan_section_for_stubs(
     section_size_type view_size)
 {
   if (sh_type == elfcpp::SHT_REL)
-    this->scan_reloc_section_for_stubs<elfcpp::SHT_REL>(
+    return this->scan_reloc_section_for_stubs<elfcpp::SHT_REL>(
 	relinfo,
 	prelocs,
 	reloc_count,
@@ -11468,7 +11652,7 @@ Target_arm<big_endian>::scan_section_for_stubs(
   else if (sh_type == elfcpp::SHT_RELA)
     // We do not support RELA type relocations yet.  This is provided for
     // completeness.
-    this->scan_reloc_section_for_stubs<elfcpp::SHT_RELA>(
+    return this->scan_reloc_section_for_stubs<elfcpp::SHT_RELA>(
 	relinfo,
 	prelocs,
 	reloc_count,
@@ -11513,6 +11697,104 @@ Target_arm<big_endian>::group_sections(
     }
 }
 
+// Scan the relocations of all input objects for stubs.
+
+template<bool big_endian>
+void
+Target_arm<big_endian>::scan_objects_for_stubs(
+    const Input_objects* input_objects,
+    Symbol_table* symtab,
+    Layout* layout,
+    const Task* task)
+{
+  for (Input_objects::Relobj_iterator op = input_objects->relobj_begin();
+       op != input_objects->relobj_end();
+       ++op)
+    {
+      Arm_relobj<big_endian>* arm_relobj =
+	Arm_relobj<big_endian>::as_arm_relobj(*op);
+      if (!arm_relobj->needs_stub_scan(this))
+	continue;
+
+      // Lock the object so we can read from it.  This is only called
+      // single-threaded from Layout::finalize, so it is OK to lock.
+      Task_lock_obj<Object> tl(task, arm_relobj);
+      arm_relobj->scan_sections_for_stubs(this, symtab, layout);
+    }
+}
+
+// Check all stub tables to see if any of them have their data sizes or
+// addresses alignments changed.  These are the only things that matter.
+// Return true if a stub table changed.  Set *MOVEMENT to an upper bound
+// on how much the change can move any two addresses relative to each
+// other in the next pass, or to -1 if there is no such bound.
+
+template<bool big_endian>
+bool
+Target_arm<big_endian>::update_stub_tables(Layout* layout, uint64_t* movement)
+{
+  typedef typename Stub_table_list::iterator Stub_table_iterator;
+
+  *movement = 0;
+  bool any_stub_table_changed = false;
+  Unordered_set<const Output_section*> sections_needing_adjustment;
+  for (Stub_table_iterator sp = this->stub_tables_.begin();
+       (sp != this->stub_tables_.end()) && !any_stub_table_changed;
+       ++sp)
+    {
+      Arm_input_section<big_endian>* owner = (*sp)->owner();
+      uint64_t old_addralign = owner->addralign();
+      off_t old_size = owner->data_size();
+      if ((*sp)->update_data_size_and_addralign())
+	{
+	  // Update data size of stub table owner.
+	  uint64_t address = owner->address();
+	  off_t offset = owner->offset();
+	  owner->reset_address_and_file_offset();
+	  owner->set_address_and_file_offset(address, offset);
+
+	  sections_needing_adjustment.insert(owner->output_section());
+	  any_stub_table_changed = true;
+
+	  // Nothing in front of the owner moves unless the owner needs a
+	  // stricter alignment.  Anything after it moves forward by at
+	  // most its growth rounded up to the largest alignment, and
+	  // anything in a later segment may move by up to another page
+	  // in either direction to keep addresses and file offsets
+	  // congruent.
+	  off_t new_size = owner->data_size();
+	  if (owner->addralign() != old_addralign || new_size < old_size)
+	    *movement = -1ULL;
+	  else
+	    {
+	      uint64_t max_addralign = parameters->target().abi_pagesize();
+	      for (Layout::Section_list::const_iterator p =
+		     layout->section_list().begin();
+		   p != layout->section_list().end();
+		   ++p)
+		max_addralign = std::max(max_addralign, (*p)->addralign());
+	      *movement = (align_address(new_size - old_size, max_addralign)
+			   + 2 * max_addralign);
+	    }
+	}
+    }
+
+  // Output_section_data::output_section() returns a const pointer but we
+  // need to update output sections, so we record all output sections needing
+  // update above and scan the sections here to find out what sections need
+  // to be updated.
+  for (Layout::Section_list::const_iterator p = layout->section_list().begin();
+      p != layout->section_list().end();
+      ++p)
+    {
+      if (sections_needing_adjustment.find(*p)
+	  != sections_needing_adjustment.end())
+	(*p)->set_section_offsets_need_adjustment();
+    }
+
+  return any_stub_table_changed;
+}
+
 // Relaxation hook.  This is where we do stub generation.
 
 template<bool big_endian>
@@ -11637,54 +11919,38 @@ Target_arm<big_endian>::do_relax(
 	(*sp)->remove_all_cortex_a8_stubs();
     }
 
-  // Scan relocs for relocation stubs
-  for (Input_objects::Relobj_iterator op = input_objects->relobj_begin();
-       op != input_objects->relobj_end();
-       ++op)
-    {
-      Arm_relobj<big_endian>* arm_relobj =
-	Arm_relobj<big_endian>::as_arm_relobj(*op);
-      // Lock the object so we can read from it.  This is only called
-      // single-threaded from Layout::finalize, so it is OK to lock.
-      Task_lock_obj<Object> tl(task, arm_relobj);
-      arm_relobj->scan_sections_for_stubs(this, symtab, layout);
-    }
+  // Scan relocs for relocation stubs.
+  this->scan_objects_for_stubs(input_objects, symtab, layout, task);
+  uint64_t movement;
+  bool any_stub_table_changed = this->update_stub_tables(layout, &movement);
 
-  // Check all stub tables to see if any of them have their data sizes
-  // or addresses alignments changed.  These are the only things that
-  // matter.
-  bool any_stub_table_changed = false;
-  Unordered_set<const Output_section*> sections_needing_adjustment;
-  for (Stub_table_iterator sp = this->stub_tables_.begin();
-       (sp != this->stub_tables_.end()) && !any_stub_table_changed;
-       ++sp)
+  // If nothing changed, this is the last pass.  The branches we skipped
+  // above need no new stubs, but their destinations may have moved since
+  // we recorded them in their stubs.  Scan them too.
+  if (!any_stub_table_changed
+      && this->stub_scan_mode_ == STUB_SCAN_MOVED)
     {
-      if ((*sp)->update_data_size_and_addralign())
-	{
-	  // Update data size of stub table owner.
-	  Arm_input_section<big_endian>* owner = (*sp)->owner();
-	  uint64_t address = owner->address();
-	  off_t offset = owner->offset();
-	  owner->reset_address_and_file_offset();
-	  owner->set_address_and_file_offset(address, offset);
-
-	  sections_needing_adjustment.insert(owner->output_section());
-	  any_stub_table_changed = true;
-	}
+      this->stub_scan_mode_ = STUB_SCAN_REST;
+      this->scan_objects_for_stubs(input_objects, symtab, layout, task);
+      any_stub_table_changed = this->update_stub_tables(layout, &movement);
     }
 
-  // Output_section_data::output_section() returns a const pointer but we
-  // need to update output sections, so we record all output sections needing
-  // update above and scan the sections here to find out what sections need
-  // to be updated.
-  for (Layout::Section_list::const_iterator p = layout->section_list().begin();
-      p != layout->section_list().end();
-      ++p)
+  // Decide which branches to scan in the next pass.  We only skip
+  // branches if we know how far the layout change of this pass can move
+  // them.  The Cortex-A8 stubs are rebuilt in every pass, the EXIDX
+  // fix-up changes other sections and a SECTIONS clause may not place
+  // sections in layout order, so in those cases we scan everything.
+  if (any_stub_table_changed
+      && movement != -1ULL
+      && !this->fix_cortex_a8_
+      && !done_exidx_fixup
+      && !layout->script_options()->saw_sections_clause())
     {
-      if (sections_needing_adjustment.find(*p)
-	  != sections_needing_adjustment.end())
-	(*p)->set_section_offsets_need_adjustment();
+      this->stub_scan_mode_ = STUB_SCAN_MOVED;
+      this->branch_movement_ += movement;
     }
+  else
+    this->stub_scan_mode_ = STUB_SCAN_ALL;
 
   // Stop relaxation if no EXIDX fix-up and no stub table change.
   bool continue_relaxation = done_exidx_fixup || any_stub_table_changed;
@@ -26,13 +26,27 @@
 #include <zlib.h>
 #endif
 
+#include <algorithm>
+
 #include "parameters.h"
 #include "options.h"
+#include "workqueue.h"
 #include "compressed_output.h"
 
 namespace gold
 {
 
+// Return the zlib compression level to use.
+
+static int
+zlib_compress_level()
+{
+  if (parameters->options().optimize() >= 1)
+    return 9;
+  else
+    return 1;
+}
+
 #ifdef HAVE_ZLIB_H
 
 // Compress UNCOMPRESSED_DATA of size UNCOMPRESSED_SIZE.  Returns true
@@ -54,17 +68,11 @@ zlib_compress(const unsigned char* uncompressed_data,
   *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
   *compressed_data = new unsigned char[*compressed_size + header_size];
 
-  int compress_level;
-  if (parameters->options().optimize() >= 1)
-    compress_level = 9;
-  else
-    compress_level = 1;
-
   int rc = compress2(reinterpret_cast<Bytef*>(*compressed_data) + header_size,
                      compressed_size,
                      reinterpret_cast<const Bytef*>(uncompressed_data),
                      uncompressed_size,
-                     compress_level);
+                     zlib_compress_level());
   if (rc == Z_OK)
     {
       memcpy(*compressed_data, "ZLIB", 4);
@@ -81,6 +89,97 @@ zlib_compress(const unsigned char* uncompressed_data,
     }
 }
 
+// Compress one block of a section, UNCOMPRESSED_DATA of size
+// UNCOMPRESSED_SIZE, at compression level LEVEL, as raw deflate data.
+// Unless IS_LAST, end the block with a full flush, so that the next
+// block may be compressed independently and appended to this one;
+// otherwise end the deflate stream.  Returns true if it successfully
+// compressed, false if it failed for any reason (including not having
+// zlib support in the library).  If it returns true, it allocates
+// memory for the compressed data using new, and sets
+// *COMPRESSED_DATA and *COMPRESSED_SIZE to appropriate values.  It
+// also sets *ADLER to the adler32 checksum of the uncompressed data.
+
+static bool
+zlib_compress_block(const unsigned char* uncompressed_data,
+		    unsigned long uncompressed_size,
+		    int level,
+		    bool is_last,
+		    unsigned char** compressed_data,
+		    unsigned long* compressed_size,
+		    uint32_t* adler)
+{
+  z_stream strm;
+  strm.zalloc = NULL;
+  strm.zfree = NULL;
+  strm.opaque = NULL;
+  int rc = deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8,
+			Z_DEFAULT_STRATEGY);
+  if (rc != Z_OK)
+    return false;
+
+  // Leave room for the empty stored block written by a full flush.
+  unsigned long buffer_size = deflateBound(&strm, uncompressed_size) + 16;
+  *compressed_data = new unsigned char[buffer_size];
+
+  strm.next_in = const_cast<Bytef*>(uncompressed_data);
+  strm.avail_in = uncompressed_size;
+  strm.next_out = *compressed_data;
+  strm.avail_out = buffer_size;
+  rc = deflate(&strm, is_last ? Z_FINISH : Z_FULL_FLUSH);
+  bool success;
+  if (is_last)
+    success = rc == Z_STREAM_END;
+  else
+    success = rc == Z_OK && strm.avail_in == 0 && strm.avail_out > 0;
+  *compressed_size = buffer_size - strm.avail_out;
+  deflateEnd(&strm);
+
+  if (!success)
+    {
+      delete[] *compressed_data;
+      *compressed_data = NULL;
+      return false;
+    }
+
+  *adler = adler32(adler32(0, NULL, 0), uncompressed_data, uncompressed_size);
+  return true;
+}
+
+// Write the two byte header of a zlib stream compressed at level
+// LEVEL to P.  This is the header which zlib's deflate writes, so a
+// section compressed as a single block matches the output of
+// compress2.
+
+static void
+zlib_write_header(int level, unsigned char* p)
+{
+  unsigned int level_flags;
+  if (level < 2)
+    level_flags = 0;
+  else if (level < 6)
+    level_flags = 1;
+  else if (level == 6)
+    level_flags = 2;
+  else
+    level_flags = 3;
+  unsigned int header = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8;
+  header |= level_flags << 6;
+  header += 31 - (header % 31);
+  p[0] = header >> 8;
+  p[1] = header & 0xff;
+}
+
+// Return the adler32 checksum of two consecutive blocks, given the
+// checksum ADLER1 of the first and ADLER2 of the second, of length
+// LEN2.
+
+static uint32_t
+zlib_combine_adler32(uint32_t adler1, uint32_t adler2, unsigned long len2)
+{
+  return adler32_combine(adler1, adler2, len2);
+}
+
 // Decompress COMPRESSED_DATA of size COMPRESSED_SIZE, into a buffer
 // UNCOMPRESSED_DATA of size UNCOMPRESSED_SIZE.  Returns TRUE if it
 // decompressed successfully, false if it failed.  The buffer, of
@@ -133,6 +232,25 @@ zlib_compress(const unsigned char*, unsigned long,
   return false;
 }
 
+static bool
+zlib_compress_block(const unsigned char*, unsigned long, int, bool,
+		    unsigned char**, unsigned long*, uint32_t*)
+{
+  return false;
+}
+
+static void
+zlib_write_header(int, unsigned char*)
+{
+  gold_unreachable();
+}
+
+static uint32_t
+zlib_combine_adler32(uint32_t, uint32_t, unsigned long)
+{
+  gold_unreachable();
+}
+
 static bool
 zlib_decompress(const unsigned char*, unsigned long,
 		unsigned char*, unsigned long)
@@ -189,19 +307,100 @@ decompress_input_section(const unsigned char* compressed_data,
   return false;
 }
 
+// The size of the blocks into which we split a section to compress
+// it in parallel.  Each block is compressed independently, so making
+// this smaller loses a little compression.
+
+static const unsigned long compress_block_size = 1024 * 1024;
+
+// A task to compress a section in parallel.  The first task for a
+// section waits for the input sections to be written, and then
+// queues a task for each block of the section.
+
+class Compress_section_task : public Task
+{
+ public:
+  // INPUT_BLOCKER is NULL for the block tasks.  Neither blocker is
+  // owned by the task.
+  Compress_section_task(Output_compressed_section* os, unsigned int block,
+			Task_token* input_blocker, Task_token* blocker)
+    : os_(os), block_(block), input_blocker_(input_blocker),
+      blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->input_blocker_ != NULL && this->input_blocker_->is_blocked())
+      return this->input_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue* workqueue)
+  {
+    if (this->input_blocker_ == NULL)
+      {
+	this->os_->compress_block(this->block_);
+	return;
+      }
+
+    this->os_->prepare_blocks();
+    unsigned int count = this->os_->block_count();
+    workqueue->add_blockers(this->blocker_, count);
+    for (unsigned int i = 0; i < count; ++i)
+      workqueue->queue_soon(new Compress_section_task(this->os_, i, NULL,
+						      this->blocker_));
+  }
+
+  std::string
+  get_name() const
+  {
+    if (this->input_blocker_ != NULL)
+      return std::string("Compress_section_task ") + this->os_->name();
+    char buf[32];
+    snprintf(buf, sizeof buf, " block %u", this->block_);
+    return std::string("Compress_section_task ") + this->os_->name() + buf;
+  }
+
+ private:
+  Output_compressed_section* os_;
+  unsigned int block_;
+  Task_token* input_blocker_;
+  Task_token* blocker_;
+};
+
 // Class Output_compressed_section.
 
-// Set the final data size of a compressed section.  This is where
-// we actually compress the section data.
+// Queue the tasks to compress the section.
 
-void
-Output_compressed_section::set_final_data_size()
+bool
+Output_compressed_section::do_queue_compress_tasks(Workqueue* workqueue,
+						   Task_token* input_blocker,
+						   Task_token* blocker)
 {
-  off_t uncompressed_size = this->postprocessing_buffer_size();
+  gold_assert(!this->blocks_ready_);
+  blocker->add_blocker();
+  workqueue->queue(new Compress_section_task(this, 0, input_blocker,
+					     blocker));
+  return true;
+}
 
-  // (Try to) compress the data.
-  unsigned long compressed_size;
-  unsigned char* uncompressed_data = this->postprocessing_buffer();
+// Split the section contents into blocks to compress in parallel.
+// This is called after all the input sections have been written to
+// the postprocessing buffer.
+
+void
+Output_compressed_section::prepare_blocks()
+{
+  gold_assert(!this->blocks_ready_);
+  this->blocks_ready_ = true;
 
   // At this point the contents of all regular input sections will
   // have been copied into the postprocessing buffer, and relocations
@@ -209,10 +408,127 @@ Output_compressed_section::set_final_data_size()
   // anything other than a regular input section.
   this->write_to_postprocessing_buffer();
 
+  if (strcmp(this->options_->compress_debug_sections(), "zlib") != 0)
+    return;
+
+  unsigned long uncompressed_size = this->postprocessing_buffer_size();
+  unsigned int count = ((uncompressed_size + compress_block_size - 1)
+			/ compress_block_size);
+  if (count == 0)
+    count = 1;
+  Compressed_block empty_block = { NULL, 0, 0 };
+  this->blocks_.resize(count, empty_block);
+}
+
+// Compress block I.  Blocks are compressed in parallel by different
+// tasks.
+
+void
+Output_compressed_section::compress_block(unsigned int i)
+{
+  unsigned long uncompressed_size = this->postprocessing_buffer_size();
+  unsigned long start = i * compress_block_size;
+  unsigned long len = std::min(compress_block_size, uncompressed_size - start);
+  bool is_last = i + 1 == this->blocks_.size();
+  Compressed_block* block = &this->blocks_[i];
+  if (!zlib_compress_block(this->postprocessing_buffer() + start, len,
+			   zlib_compress_level(), is_last, &block->data,
+			   &block->size, &block->adler))
+    block->data = NULL;
+}
+
+// Join the compressed blocks into a single zlib stream.  Returns
+// false if any block failed to compress.  Otherwise this allocates
+// data_ using new, and sets *COMPRESSED_SIZE.  It also writes a header
+// before the zlib stream: 4 bytes saying "ZLIB", and 8 bytes
+// indicating the uncompressed size, in big-endian order.
+
+bool
+Output_compressed_section::join_blocks(unsigned long* compressed_size)
+{
+  const int header_size = 12;
+  const int zlib_header_size = 2;
+  const int zlib_trailer_size = 4;
+
+  if (this->blocks_.empty())
+    return false;
+
+  unsigned long size = header_size + zlib_header_size + zlib_trailer_size;
+  for (std::vector<Compressed_block>::const_iterator p = this->blocks_.begin();
+       p != this->blocks_.end();
+       ++p)
+    {
+      if (p->data == NULL)
+	return false;
+      size += p->size;
+    }
+
+  unsigned long uncompressed_size = this->postprocessing_buffer_size();
+  unsigned char* data = new unsigned char[size];
+  memcpy(data, "ZLIB", 4);
+  elfcpp::Swap_unaligned<64, true>::writeval(data + 4, uncompressed_size);
+  zlib_write_header(zlib_compress_level(), data + header_size);
+
+  unsigned char* pout = data + header_size + zlib_header_size;
+  uint32_t adler = 1;
+  unsigned long start = 0;
+  for (std::vector<Compressed_block>::const_iterator p = this->blocks_.begin();
+       p != this->blocks_.end();
+       ++p)
+    {
+      memcpy(pout, p->data, p->size);
+      pout += p->size;
+      unsigned long len = std::min(compress_block_size,
+				   uncompressed_size - start);
+      adler = zlib_combine_adler32(adler, p->adler, len);
+      start += len;
+    }
+  elfcpp::Swap_unaligned<32, true>::writeval(pout, adler);
+  pout += zlib_trailer_size;
+  gold_assert(pout == data + size);
+
+  this->data_ = data;
+  *compressed_size = size;
+  return true;
+}
+
+// Set the final data size of a compressed section.  This is where
+// we actually compress the section data, unless tasks have already
+// compressed it in blocks.
+
+void
+Output_compressed_section::set_final_data_size()
+{
+  off_t uncompressed_size = this->postprocessing_buffer_size();
+
+  // (Try to) compress the data.
+  unsigned long compressed_size;
   bool success = false;
-  if (strcmp(this->options_->compress_debug_sections(), "zlib") == 0)
-    success = zlib_compress(uncompressed_data, uncompressed_size,
-                            &this->data_, &compressed_size);
+  if (this->blocks_ready_)
+    {
+      success = this->join_blocks(&compressed_size);
+
+      for (std::vector<Compressed_block>::iterator p = this->blocks_.begin();
+	   p != this->blocks_.end();
+	   ++p)
+	delete[] p->data;
+      std::vector<Compressed_block>().swap(this->blocks_);
+    }
+  else
+    {
+      unsigned char* uncompressed_data = this->postprocessing_buffer();
+
+      // At this point the contents of all regular input sections will
+      // have been copied into the postprocessing buffer, and
+      // relocations will have been applied.  Now we need to copy in
+      // the contents of anything other than a regular input section.
+      this->write_to_postprocessing_buffer();
+
+      if (strcmp(this->options_->compress_debug_sections(), "zlib") == 0)
+	success = zlib_compress(uncompressed_data, uncompressed_size,
+				&this->data_, &compressed_size);
+    }
+
   if (success)
     {
       // This converts .debug_foo to .zdebug_foo
@@ -29,6 +29,7 @@
 #define GOLD_COMPRESSED_OUTPUT_H
 
 #include <string>
+#include <vector>
 
 #include "output.h"
 
@@ -60,9 +61,28 @@ class Output_compressed_section : public Output_section
 			    const char* name, elfcpp::Elf_Word flags,
 			    elfcpp::Elf_Xword type)
     : Output_section(name, flags, type),
-      options_(options)
+      options_(options), data_(NULL), blocks_(), blocks_ready_(false)
   { this->set_requires_postprocessing(); }
 
+  // When using threads, the section is compressed in independent
+  // blocks, in parallel.  These functions are used by the tasks which
+  // do that.  Otherwise set_final_data_size compresses the whole
+  // section at once.
+
+  // Copy the contents which are not from input sections into the
+  // postprocessing buffer, and split the section into blocks.
+  void
+  prepare_blocks();
+
+  // The number of blocks.
+  unsigned int
+  block_count() const
+  { return this->blocks_.size(); }
+
+  // Compress block I.
+  void
+  compress_block(unsigned int i);
+
  protected:
   // Set the final data size.
   void
@@ -72,13 +92,37 @@ class Output_compressed_section : public Output_section
   void
   do_write(Output_file*);
 
+  // Queue tasks to compress the section.
+  bool
+  do_queue_compress_tasks(Workqueue*, Task_token*, Task_token*);
+
  private:
+  // A compressed block of the section.
+  struct Compressed_block
+  {
+    // The compressed data, allocated with new, or NULL if the block
+    // has not been compressed or failed to compress.
+    unsigned char* data;
+    // The size of the compressed data.
+    unsigned long size;
+    // The adler32 checksum of the uncompressed data.
+    uint32_t adler;
+  };
+
+  // Join the compressed blocks into data_.
+  bool
+  join_blocks(unsigned long* compressed_size);
+
   // The options--this includes the compression type.
   const General_options* options_;
   // The compressed data.
   unsigned char* data_;
   // The new section name if we do compress.
   std::string new_section_name_;
+  // The compressed blocks.
+  std::vector<Compressed_block> blocks_;
+  // Whether prepare_blocks has been called.
+  bool blocks_ready_;
 };
 
 } // End namespace gold.
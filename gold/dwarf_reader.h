@@ -972,6 +972,12 @@ class Dwarf_line_info
             std::vector<std::string>* other_lines)
   { return this->do_addr2line(shndx, offset, other_lines); }
 
+  // Return a new line info reader for OBJECT, for the target's size
+  // and endianness.  If SHNDX is not -1U, only read the line
+  // information for that section.
+  static Dwarf_line_info*
+  make_line_info(Object* object, unsigned int shndx);
+
   // A helper function for a single addr2line lookup.  It also keeps a
   // cache of the last CACHE_SIZE Dwarf_line_info objects it created;
   // set to 0 not to cache at all.  The larger CACHE_SIZE is, the more
@@ -28,6 +28,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #include <vector>
 #include <algorithm>
@@ -45,6 +51,8 @@
 #include "compressed_output.h"
 #include "stringpool.h"
 #include "dwarf_reader.h"
+#include "descriptors.h"
+#include "workqueue.h"
 
 static void
 usage(FILE* fd, int) ATTRIBUTE_NORETURN;
@@ -107,9 +115,11 @@ struct Unit_set
 class Dwo_file
 {
  public:
-  Dwo_file(const char* name)
-    : name_(name), obj_(NULL), input_file_(NULL), is_compressed_(),
-      sect_offsets_(), str_offset_map_()
+  Dwo_file(const char* name, unsigned int file_index = 0)
+    : name_(name), file_index_(file_index), obj_(NULL), input_file_(NULL),
+      machine_(0), size_(0), big_endian_(false), osabi_(0), abiversion_(0),
+      is_compressed_(), sect_offsets_(), str_offset_map_(), debug_shndx_(),
+      debug_str_(0), copies_(), units_()
   { }
 
   ~Dwo_file();
@@ -119,9 +129,37 @@ class Dwo_file
   void
   read_executable(File_list* files);
 
-  // Read the input file and send its contents to OUTPUT_FILE.
+  // Read the input file for TASK.  Add its strings to OUTPUT_FILE,
+  // and record the sections and units to copy once the output file is
+  // laid out.  The file is kept open for copy_contributions.
+  void
+  read(const Task* task, Dwp_output_file* output_file);
+
+  // Add the CU sets (or, if IS_TYPE_UNITS, the TU sets) read from the
+  // file to the index in OUTPUT_FILE.  Type units which are already in
+  // the index are dropped.
+  void
+  add_unit_sets(Dwp_output_file* output_file, bool is_type_units);
+
+  // Lay out the contributions of this file to OUTPUT_FILE, and set the
+  // output section offsets in the unit sets.
+  void
+  add_contributions(Dwp_output_file* output_file);
+
+  // Copy the contributions of this file into OUTPUT_FILE for TASK,
+  // and close the file.
+  void
+  copy_contributions(const Task* task, Dwp_output_file* output_file);
+
+  // Record a compilation unit or type unit found at OFFSET in section
+  // SHNDX.  This is called by Unit_reader.
   void
-  read(Dwp_output_file* output_file);
+  add_unit(Unit_set* unit_set, unsigned int shndx, section_offset_type offset,
+	   bool is_type_unit);
+
+  // Close the input file.
+  void
+  close();
 
   // Verify a .dwp file given a list of .dwo files referenced by the
   // corresponding executable file.  Returns true if no problems
@@ -129,6 +167,11 @@ class Dwo_file
   bool
   verify(const File_list& files);
 
+  // Return the file name.
+  const char*
+  name() const
+  { return this->name_; }
+
  private:
   // Types for mapping input string offsets to output string offsets.
   typedef std::pair<section_offset_type, section_offset_type>
@@ -144,16 +187,35 @@ class Dwo_file
     { return i1.first < i2.first; }
   };
 
+  // An input section which is copied to the output file as a whole.
+  struct Section_copy
+  {
+    elfcpp::DW_SECT section_id;
+    unsigned int shndx;
+    section_size_type size;
+  };
+
+  // A compilation unit or type unit to copy to the output file.  The
+  // offsets in UNIT_SET are relative to the input sections until
+  // add_contributions sets the output section offsets.  UNIT_SET is
+  // NULL if the unit was dropped as a duplicate.
+  struct Unit
+  {
+    Unit_set* unit_set;
+    unsigned int shndx;
+    section_offset_type offset;
+    bool is_type_unit;
+  };
+
   // Create a Sized_relobj_dwo of the given size and endianness,
   // and record the target info.  P is a pointer to the ELF header
   // in memory.
   Relobj*
-  make_object(Dwp_output_file* output_file);
+  make_object();
 
   template <int size, bool big_endian>
   Relobj*
-  sized_make_object(const unsigned char* p, Input_file* input_file,
-		    Dwp_output_file* output_file);
+  sized_make_object(const unsigned char* p, Input_file* input_file);
 
   // Return the number of sections in the input object file.
   unsigned int
@@ -178,15 +240,13 @@ class Dwo_file
   { return this->obj_->decompressed_section_contents(shndx, plen, is_new); }
 
   // Read the .debug_cu_index or .debug_tu_index section of a .dwp file,
-  // and process the CU or TU sets.
+  // and record the CU or TU sets.
   void
-  read_unit_index(unsigned int, unsigned int *, Dwp_output_file*,
-		  bool is_tu_index);
+  read_unit_index(unsigned int, unsigned int *, bool is_tu_index);
 
   template <bool big_endian>
   void
-  sized_read_unit_index(unsigned int, unsigned int *, Dwp_output_file*,
-			bool is_tu_index);
+  sized_read_unit_index(unsigned int, unsigned int *, bool is_tu_index);
 
   // Verify the .debug_cu_index section of a .dwp file, comparing it
   // against the list of .dwo files referenced by the corresponding
@@ -202,42 +262,64 @@ class Dwo_file
   void
   add_strings(Dwp_output_file*, unsigned int);
 
-  // Copy a section from the input file to the output file.
+  // Build the map from input string offsets to output string offsets.
+  void
+  read_str_offset_map(Dwp_output_file*);
+
+  // Record that a section is to be copied from the input file to the
+  // output file.
   Section_bounds
-  copy_section(Dwp_output_file* output_file, unsigned int shndx,
-	       elfcpp::DW_SECT section_id);
+  copy_section(unsigned int shndx, elfcpp::DW_SECT section_id);
 
-  // Remap the string offsets in the .debug_str_offsets.dwo section.
-  const unsigned char*
-  remap_str_offsets(const unsigned char* contents, section_size_type len);
+  // Remap the string offsets in the .debug_str_offsets.dwo section,
+  // writing the result to OUT.
+  void
+  remap_str_offsets(const unsigned char* contents, section_size_type len,
+		    unsigned char* out);
 
   template <bool big_endian>
-  const unsigned char*
-  sized_remap_str_offsets(const unsigned char* contents, section_size_type len);
+  void
+  sized_remap_str_offsets(const unsigned char* contents,
+			  section_size_type len, unsigned char* out);
 
   // Remap a single string offsets from an offset in the input string table
   // to an offset in the output string table.
   unsigned int
   remap_str_offset(section_offset_type val);
 
-  // Add a set of .debug_info.dwo or .debug_types.dwo and related sections
-  // to OUTPUT_FILE.
+  // Record a set of .debug_info.dwo or .debug_types.dwo and related
+  // sections.
   void
-  add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
-	       bool is_debug_types);
+  add_unit_set(unsigned int *debug_shndx, bool is_debug_types);
 
   // The filename.
   const char* name_;
+  // The position of this file in the list of input files.
+  unsigned int file_index_;
   // The ELF file, represented as a gold Relobj instance.
   Relobj* obj_;
   // The Input_file object.
   Input_file* input_file_;
+  // ELF header parameters.
+  int machine_;
+  int size_;
+  bool big_endian_;
+  int osabi_;
+  int abiversion_;
   // Flags indicating which sections are compressed.
   std::vector<bool> is_compressed_;
   // Map input section index onto output section offset and size.
   std::vector<Section_bounds> sect_offsets_;
   // Map input string offsets to output string offsets.
   Str_offset_map str_offset_map_;
+  // The input section index for each DW_SECT column, or 0.
+  unsigned int debug_shndx_[elfcpp::DW_SECT_MAX + 1];
+  // The input section index of the .debug_str.dwo section.
+  unsigned int debug_str_;
+  // The sections to copy, in the order they were found.
+  std::vector<Section_copy> copies_;
+  // The units to copy, in the order they were found.
+  std::vector<Unit> units_;
 };
 
 // An ELF input file.
@@ -258,7 +340,10 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   { }
 
   ~Sized_relobj_dwo()
-  { }
+  {
+    for (size_t i = 0; i < this->uncompressed_sections_.size(); ++i)
+      delete[] this->uncompressed_sections_[i].contents;
+  }
 
   // Setup the section information.
   void
@@ -285,8 +370,8 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   do_section_contents(unsigned int, section_size_type*, bool);
 
   // Return a view of the uncompressed contents of a section.  Set *PLEN
-  // to the size.  Set *IS_NEW to true if the contents need to be deleted
-  // by the caller.
+  // to the size.  Compressed sections are decompressed once and kept
+  // until the object is deleted, so *IS_NEW is always set to false.
   const unsigned char*
   do_decompressed_section_contents(unsigned int shndx,
 				   section_size_type* plen,
@@ -444,8 +529,23 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   { gold_unreachable(); }
 
  private:
+  // The uncompressed contents of a compressed section.
+  struct Uncompressed_section
+  {
+    Uncompressed_section()
+      : contents(NULL), len(0)
+    { }
+
+    unsigned char* contents;
+    section_size_type len;
+  };
+
   // General access to the ELF file.
   elfcpp::Elf_file<size, big_endian, Object> elf_file_;
+  // The uncompressed contents of compressed sections, indexed by
+  // section index.  The sizes are needed when the file is read and
+  // the contents when it is copied to the output file.
+  std::vector<Uncompressed_section> uncompressed_sections_;
 };
 
 // The output file.
@@ -457,53 +557,116 @@ class Dwp_output_file
  public:
   Dwp_output_file(const char* name)
     : name_(name), machine_(0), size_(0), big_endian_(false), osabi_(0),
-      abiversion_(0), fd_(NULL), next_file_offset_(0), shnum_(1), sections_(),
-      section_id_map_(), shoff_(0), shstrndx_(0), have_strings_(false),
-      stringpool_(), shstrtab_(), cu_index_(), tu_index_(), last_type_sig_(0),
-      last_tu_slot_(0)
+      abiversion_(0), fd_(-1), base_(NULL), file_size_(0),
+      map_is_anonymous_(false), next_file_offset_(0), shnum_(1), sections_(),
+      section_id_map_(), shoff_(0), shstrndx_(0), shstrtab_name_(NULL),
+      debug_str_shndx_(0), cu_index_shndx_(0), tu_index_shndx_(0),
+      string_shards_(), have_strings_(false), stringpool_(), shstrtab_(),
+      cu_index_(), tu_index_()
   {
     this->section_id_map_.resize(elfcpp::DW_SECT_MAX + 1);
     this->stringpool_.set_no_zero_null();
+    this->string_shards_.resize(string_shard_count);
+    for (unsigned int i = 0; i < string_shard_count; ++i)
+      this->string_shards_[i] = new String_shard();
   }
 
+  ~Dwp_output_file();
+
   // Record the target info from an input file.
   void
   record_target_info(const char* name, int machine, int size, bool big_endian,
 		     int osabi, int abiversion);
 
-  // Add a string to the debug strings section.
+  // Add the strings in the .debug_str.dwo section of input file
+  // FILE_INDEX, at P with length LEN, to the debug strings section.
+  // This may be called for different files in parallel.
+  void
+  add_strings(unsigned int file_index, const char* p, section_size_type len);
+
+  // Add the unique strings to the debug strings section in the order
+  // in which they were first seen, and fix their offsets.
+  void
+  merge_strings();
+
+  // Return the output offset of the string STR of length LEN.  This may
+  // only be called after merge_strings.
   section_offset_type
-  add_string(const char* str, size_t len);
+  string_offset(const char* str, size_t len) const
+  { return this->stringpool_.get_offset_with_length(str, len); }
 
   // Add a section to the output file, and return the new section offset.
   section_offset_type
-  add_contribution(elfcpp::DW_SECT section_id, const unsigned char* contents,
-		   section_size_type len, int align);
+  add_contribution(elfcpp::DW_SECT section_id, section_size_type len,
+		   int align);
 
   // Add a set of .debug_info and related sections to the output file.
   void
   add_cu_set(Unit_set* cu_set);
 
-  // Lookup a type signature and return TRUE if we have already seen it.
+  // Add a set of .debug_types and related sections to the output file.
+  // Return false if we have already seen the type signature.
   bool
-  lookup_tu(uint64_t type_sig);
+  add_tu_set(Unit_set* tu_set);
 
-  // Add a set of .debug_types and related sections to the output file.
+  // Lay out the output file once all the contributions have been
+  // added, and open it.
   void
-  add_tu_set(Unit_set* tu_set);
+  layout();
 
-  // Finalize the file, write the string tables and index sections,
-  // and close the file.
+  // Return a pointer to the output file at the contribution at OFFSET
+  // in the output section for SECTION_ID.
+  unsigned char*
+  contribution_view(elfcpp::DW_SECT section_id, section_offset_type offset,
+		    section_size_type len);
+
+  // Write the debug string table.
+  void
+  write_strings();
+
+  // Write the CU or TU index.
+  void
+  write_unit_index(bool is_tu_index);
+
+  // Write the section string table, the section header table and the
+  // ELF header, and close the file.
   void
   finalize();
 
  private:
-  // Contributions to output sections.
-  struct Contribution
+  // The number of partitions of the string table used while reading
+  // the input files.
+  static const unsigned int string_shard_count = 16;
+
+  // A string seen in an input file.  RANK is the file index and the
+  // position of the first occurrence within the file's string table.
+  struct Shard_string
   {
-    section_offset_type output_offset;
-    section_size_type size;
-    const unsigned char* contents;
+    const char* str;
+    size_t len;
+    size_t hash_code;
+    uint64_t rank;
+  };
+
+  // A partition of the strings by hash code.  STRINGS is indexed by
+  // Stringpool key - 1.
+  struct String_shard
+  {
+    Lock lock;
+    Stringpool pool;
+    std::vector<Shard_string> strings;
+
+    String_shard()
+      : lock(), pool(), strings()
+    { pool.set_no_zero_null(); }
+  };
+
+  // A less-than comparison routine for sorting strings by rank.
+  struct Rank_compare
+  {
+    bool
+    operator()(const Shard_string* s1, const Shard_string* s2) const
+    { return s1->rank < s2->rank; }
   };
 
   // Sections in the output file.
@@ -513,10 +676,9 @@ class Dwp_output_file
     off_t offset;
     section_size_type size;
     int align;
-    std::vector<Contribution> contributions;
 
     Section(const char* n, int a)
-      : name(n), offset(0), size(0), align(a), contributions()
+      : name(n), offset(0), size(0), align(a)
     { }
   };
 
@@ -613,10 +775,19 @@ class Dwp_output_file
   unsigned int
   add_output_section(const char* section_name, int align);
 
-  // Write a new section to the output file.
+  // Add a new section of size LEN at the end of the output file, and
+  // return the section index.
+  unsigned int
+  layout_new_section(const char* section_name, section_size_type len,
+		     int align);
+
+  // Return the size of a CU or TU index section.
+  section_size_type
+  index_size(const Dwp_index& index) const;
+
+  // Open the output file and map it into memory.
   void
-  write_new_section(const char* section_name, const unsigned char* contents,
-		    section_size_type len, int align);
+  open();
 
   // Write the ELF header.
   void
@@ -626,28 +797,26 @@ class Dwp_output_file
   void
   sized_write_ehdr();
 
-  // Write a section header.
+  // Write a section header at P.
   void
-  write_shdr(const char* name, unsigned int type, unsigned int flags,
-	     uint64_t addr, off_t offset, section_size_type sect_size,
-	     unsigned int link, unsigned int info,
+  write_shdr(unsigned char* p, const char* name, unsigned int type,
+	     unsigned int flags, uint64_t addr, off_t offset,
+	     section_size_type sect_size, unsigned int link, unsigned int info,
 	     unsigned int align, unsigned int ent_size);
 
   template<unsigned int size, bool big_endian>
   void
-  sized_write_shdr(const char* name, unsigned int type, unsigned int flags,
-		   uint64_t addr, off_t offset, section_size_type sect_size,
-		   unsigned int link, unsigned int info,
-		   unsigned int align, unsigned int ent_size);
-
-  // Write the contributions to an output section.
-  void
-  write_contributions(const Section& sect);
+  sized_write_shdr(unsigned char* p, const char* name, unsigned int type,
+		   unsigned int flags, uint64_t addr, off_t offset,
+		   section_size_type sect_size, unsigned int link,
+		   unsigned int info, unsigned int align,
+		   unsigned int ent_size);
 
-  // Write a CU or TU index section.
+  // Write a CU or TU index section to P.
   template<bool big_endian>
   void
-  write_index(const char* sect_name, const Dwp_index& index);
+  write_index(unsigned char* p, section_size_type index_size,
+	      const Dwp_index& index);
 
   // The output filename.
   const char* name_;
@@ -658,7 +827,14 @@ class Dwp_output_file
   int osabi_;
   int abiversion_;
   // The output file descriptor.
-  FILE* fd_;
+  int fd_;
+  // The contents of the output file, mapped into memory.
+  unsigned char* base_;
+  // The size of the output file.
+  off_t file_size_;
+  // TRUE if BASE_ is not mapped to the file and must be written
+  // when the file is closed.
+  bool map_is_anonymous_;
   // Next available file offset.
   off_t next_file_offset_;
   // The number of sections.
@@ -671,6 +847,14 @@ class Dwp_output_file
   off_t shoff_;
   // Section index of the section string table.
   unsigned int shstrndx_;
+  // The name of the section string table, from shstrtab_.
+  const char* shstrtab_name_;
+  // Section indexes of the string table and the index sections.
+  unsigned int debug_str_shndx_;
+  unsigned int cu_index_shndx_;
+  unsigned int tu_index_shndx_;
+  // The strings of the input files, partitioned by hash code.
+  std::vector<String_shard*> string_shards_;
   // TRUE if we have added any strings to the string pool.
   bool have_strings_;
   // String pool for the output .debug_str.dwo section.
@@ -681,10 +865,6 @@ class Dwp_output_file
   Dwp_index cu_index_;
   // The type unit index.
   Dwp_index tu_index_;
-  // Cache of the last type signature looked up.
-  uint64_t last_type_sig_;
-  // Cache of the slot index for the last type signature.
-  unsigned int last_tu_slot_;
 };
 
 // A specialization of Dwarf_info_reader, for reading dwo_names from
@@ -720,22 +900,22 @@ class Dwo_name_info_reader : public Dwarf_info_reader
 };
 
 // A specialization of Dwarf_info_reader, for reading DWARF CUs and TUs
-// and adding them to the output file.
+// and recording them in the input file.
 
 class Unit_reader : public Dwarf_info_reader
 {
  public:
   Unit_reader(bool is_type_unit, Relobj* object, unsigned int shndx)
     : Dwarf_info_reader(is_type_unit, object, NULL, 0, shndx, 0, 0),
-      output_file_(NULL), sections_(NULL)
+      dwo_file_(NULL), shndx_(shndx), sections_(NULL)
   { }
 
   ~Unit_reader()
   { }
 
-  // Read the CUs or TUs and add them to the output file.
+  // Read the CUs or TUs and record them in DWO_FILE.
   void
-  add_units(Dwp_output_file*, unsigned int debug_abbrev, Section_bounds*);
+  add_units(Dwo_file*, unsigned int debug_abbrev, Section_bounds*);
 
  protected:
   // Visit a compilation unit.
@@ -748,7 +928,8 @@ class Unit_reader : public Dwarf_info_reader
 		  uint64_t signature, Dwarf_die*);
 
  private:
-  Dwp_output_file* output_file_;
+  Dwo_file* dwo_file_;
+  unsigned int shndx_;
   Section_bounds* sections_;
 };
 
@@ -784,6 +965,7 @@ Sized_relobj_dwo<size, big_endian>::setup()
   const unsigned int shnum = this->elf_file_.shnum();
   this->set_shnum(shnum);
   this->section_offsets().resize(shnum);
+  this->uncompressed_sections_.resize(shnum);
 }
 
 // Return a view of the contents of a section.
@@ -806,8 +988,8 @@ Sized_relobj_dwo<size, big_endian>::do_section_contents(
 }
 
 // Return a view of the uncompressed contents of a section.  Set *PLEN
-// to the size.  Set *IS_NEW to true if the contents need to be deleted
-// by the caller.
+// to the size.  Set *IS_NEW to false: the uncompressed contents of a
+// compressed section belong to the object.
 
 template <int size, bool big_endian>
 const unsigned char*
@@ -816,6 +998,15 @@ Sized_relobj_dwo<size, big_endian>::do_decompressed_section_contents(
     section_size_type* plen,
     bool* is_new)
 {
+  *is_new = false;
+
+  Uncompressed_section& uncompressed(this->uncompressed_sections_[shndx]);
+  if (uncompressed.contents != NULL)
+    {
+      *plen = uncompressed.len;
+      return uncompressed.contents;
+    }
+
   section_size_type buffer_size;
   const unsigned char* buffer = this->do_section_contents(shndx, &buffer_size,
 							  false);
@@ -824,7 +1015,6 @@ Sized_relobj_dwo<size, big_endian>::do_decompressed_section_contents(
   if (!is_prefix_of(".zdebug_", sect_name.c_str()))
     {
       *plen = buffer_size;
-      *is_new = false;
       return buffer;
     }
 
@@ -837,8 +1027,9 @@ Sized_relobj_dwo<size, big_endian>::do_decompressed_section_contents(
 				uncompressed_size))
     this->error(_("could not decompress section %s"),
 		this->section_name(shndx).c_str());
+  uncompressed.contents = uncompressed_data;
+  uncompressed.len = uncompressed_size;
   *plen = uncompressed_size;
-  *is_new = true;
   return uncompressed_data;
 }
 
@@ -846,10 +1037,7 @@ Sized_relobj_dwo<size, big_endian>::do_decompressed_section_contents(
 
 Dwo_file::~Dwo_file()
 {
-  if (this->obj_ != NULL)
-    delete this->obj_;
-  if (this->input_file_ != NULL)
-    delete this->input_file_;
+  this->close();
 }
 
 // Read the input executable file and extract the list of .dwo files
@@ -858,7 +1046,7 @@ Dwo_file::~Dwo_file()
 void
 Dwo_file::read_executable(File_list* files)
 {
-  this->obj_ = this->make_object(NULL);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -898,12 +1086,17 @@ Dwo_file::read_executable(File_list* files)
     }
 }
 
-// Read the input file and send its contents to OUTPUT_FILE.
+// Read the input file for TASK.  Add its strings to OUTPUT_FILE, and
+// record the sections and units to copy once the output file is laid
+// out.  The file stays open, with its views and any decompressed
+// sections, for copy_contributions; unlocking it lets its descriptor
+// be reused.
 
 void
-Dwo_file::read(Dwp_output_file* output_file)
+Dwo_file::read(const Task* task, Dwp_output_file* output_file)
 {
-  this->obj_ = this->make_object(output_file);
+  this->obj_ = this->make_object();
+  Task_lock_obj<Object> tl(task, this->obj_);
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -911,10 +1104,7 @@ Dwo_file::read(Dwp_output_file* output_file)
 
   typedef std::vector<unsigned int> Types_list;
   Types_list debug_types;
-  unsigned int debug_shndx[elfcpp::DW_SECT_MAX + 1];
-  for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; i++)
-    debug_shndx[i] = 0;
-  unsigned int debug_str = 0;
+  unsigned int* debug_shndx = this->debug_shndx_;
   unsigned int debug_cu_index = 0;
   unsigned int debug_tu_index = 0;
 
@@ -946,7 +1136,7 @@ Dwo_file::read(Dwp_output_file* output_file)
       else if (strcmp(suffix, "loc.dwo") == 0)
 	debug_shndx[elfcpp::DW_SECT_LOC] = i;
       else if (strcmp(suffix, "str.dwo") == 0)
-	debug_str = i;
+	this->debug_str_ = i;
       else if (strcmp(suffix, "str_offsets.dwo") == 0)
 	debug_shndx[elfcpp::DW_SECT_STR_OFFSETS] = i;
       else if (strcmp(suffix, "macinfo.dwo") == 0)
@@ -960,28 +1150,28 @@ Dwo_file::read(Dwp_output_file* output_file)
     }
 
   // Merge the input string table into the output string table.
-  this->add_strings(output_file, debug_str);
+  this->add_strings(output_file, this->debug_str_);
 
-  // If we found any .dwp index sections, read those and add the section
-  // sets to the output file.
+  // If we found any .dwp index sections, read those and record the
+  // section sets.
   if (debug_cu_index > 0 || debug_tu_index > 0)
     {
       if (debug_cu_index > 0)
-	this->read_unit_index(debug_cu_index, debug_shndx, output_file, false);
+	this->read_unit_index(debug_cu_index, debug_shndx, false);
       if (debug_tu_index > 0)
         {
 	  if (debug_types.size() != 1)
 	    gold_fatal(_("%s: .dwp file must have exactly one "
 			 ".debug_types.dwo section"), this->name_);
 	  debug_shndx[elfcpp::DW_SECT_TYPES] = debug_types[0];
-	  this->read_unit_index(debug_tu_index, debug_shndx, output_file, true);
+	  this->read_unit_index(debug_tu_index, debug_shndx, true);
 	}
       return;
     }
 
   // If we found no index sections, this is a .dwo file.
   if (debug_shndx[elfcpp::DW_SECT_INFO] > 0)
-    this->add_unit_set(output_file, debug_shndx, false);
+    this->add_unit_set(debug_shndx, false);
 
   debug_shndx[elfcpp::DW_SECT_INFO] = 0;
   for (Types_list::const_iterator tp = debug_types.begin();
@@ -989,10 +1179,185 @@ Dwo_file::read(Dwp_output_file* output_file)
        ++tp)
     {
       debug_shndx[elfcpp::DW_SECT_TYPES] = *tp;
-      this->add_unit_set(output_file, debug_shndx, true);
+      this->add_unit_set(debug_shndx, true);
+    }
+}
+
+// Record a compilation unit or type unit found at OFFSET in section
+// SHNDX.  The section offsets in UNIT_SET are relative to the input
+// sections.
+
+void
+Dwo_file::add_unit(Unit_set* unit_set, unsigned int shndx,
+		   section_offset_type offset, bool is_type_unit)
+{
+  Unit unit = { unit_set, shndx, offset, is_type_unit };
+  this->units_.push_back(unit);
+}
+
+// Add the CU sets (or, if IS_TYPE_UNITS, the TU sets) read from the
+// file to the index in OUTPUT_FILE.  This only uses the signatures
+// and sizes, so it may run before add_contributions.
+
+void
+Dwo_file::add_unit_sets(Dwp_output_file* output_file, bool is_type_units)
+{
+  for (std::vector<Unit>::iterator p = this->units_.begin();
+       p != this->units_.end();
+       ++p)
+    {
+      if (p->is_type_unit != is_type_units)
+	continue;
+      if (!is_type_units)
+	output_file->add_cu_set(p->unit_set);
+      else if (!output_file->add_tu_set(p->unit_set))
+	{
+	  delete p->unit_set;
+	  p->unit_set = NULL;
+	}
+    }
+}
+
+// Lay out the contributions of this file to OUTPUT_FILE.  This must be
+// called for each file in turn, so that the output matches the order
+// of the input files.
+
+void
+Dwo_file::add_contributions(Dwp_output_file* output_file)
+{
+  output_file->record_target_info(this->name_, this->machine_, this->size_,
+				  this->big_endian_, this->osabi_,
+				  this->abiversion_);
+
+  for (std::vector<Section_copy>::const_iterator p = this->copies_.begin();
+       p != this->copies_.end();
+       ++p)
+    {
+      section_offset_type off = output_file->add_contribution(p->section_id,
+							      p->size, 1);
+      this->sect_offsets_[p->shndx] = Section_bounds(off, p->size);
+    }
+
+  for (std::vector<Unit>::iterator p = this->units_.begin();
+       p != this->units_.end();
+       ++p)
+    {
+      Unit_set* unit_set = p->unit_set;
+      if (unit_set == NULL)
+	continue;
+
+      // Adjust the offset of each contribution within the input section
+      // by the offset of the input section within the output section.
+      for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
+	{
+	  unsigned int shndx = this->debug_shndx_[i];
+	  if (shndx > 0)
+	    unit_set->sections[i].offset += this->sect_offsets_[shndx].offset;
+	}
+
+      elfcpp::DW_SECT info_sect = (p->is_type_unit
+				   ? elfcpp::DW_SECT_TYPES
+				   : elfcpp::DW_SECT_INFO);
+      section_size_type len = unit_set->sections[info_sect].size;
+      unit_set->sections[info_sect].offset =
+	  output_file->add_contribution(info_sect, len, 1);
     }
 }
 
+// Copy the contributions of this file into OUTPUT_FILE for TASK, and
+// then close the file.  Each file writes to its own parts of the
+// output file, so this may be called for different files in parallel.
+
+void
+Dwo_file::copy_contributions(const Task* task, Dwp_output_file* output_file)
+{
+  if (this->copies_.empty() && this->units_.empty())
+    {
+      this->close();
+      return;
+    }
+
+  this->obj_->lock(task);
+
+  for (std::vector<Section_copy>::const_iterator p = this->copies_.begin();
+       p != this->copies_.end();
+       ++p)
+    {
+      section_size_type len;
+      bool is_new;
+      const unsigned char* contents = this->section_contents(p->shndx, &len,
+							     &is_new);
+      gold_assert(len == p->size);
+      unsigned char* out =
+	  output_file->contribution_view(p->section_id,
+					 this->sect_offsets_[p->shndx].offset,
+					 len);
+      if (p->section_id == elfcpp::DW_SECT_STR_OFFSETS)
+	{
+	  this->read_str_offset_map(output_file);
+	  this->remap_str_offsets(contents, len, out);
+	}
+      else
+	memcpy(out, contents, len);
+      if (is_new)
+	delete[] contents;
+    }
+
+  // The units are grouped by input section, so we only need to hold
+  // on to one section at a time.
+  unsigned int shndx = 0;
+  section_size_type len = 0;
+  bool is_new = false;
+  const unsigned char* contents = NULL;
+  for (std::vector<Unit>::const_iterator p = this->units_.begin();
+       p != this->units_.end();
+       ++p)
+    {
+      const Unit_set* unit_set = p->unit_set;
+      if (unit_set == NULL)
+	continue;
+      if (p->shndx != shndx)
+	{
+	  if (is_new)
+	    delete[] contents;
+	  shndx = p->shndx;
+	  contents = this->section_contents(shndx, &len, &is_new);
+	}
+
+      elfcpp::DW_SECT info_sect = (p->is_type_unit
+				   ? elfcpp::DW_SECT_TYPES
+				   : elfcpp::DW_SECT_INFO);
+      const Section_bounds& bounds(unit_set->sections[info_sect]);
+      if (p->offset < 0
+	  || static_cast<section_size_type>(p->offset) + bounds.size > len)
+	gold_fatal(_("%s: section %s is corrupt"), this->name_,
+		   this->section_name(shndx).c_str());
+      unsigned char* out = output_file->contribution_view(info_sect,
+							  bounds.offset,
+							  bounds.size);
+      memcpy(out, contents + p->offset, bounds.size);
+    }
+  if (is_new)
+    delete[] contents;
+
+  Str_offset_map().swap(this->str_offset_map_);
+  this->obj_->unlock(task);
+  this->close();
+}
+
+// Close the input file.
+
+void
+Dwo_file::close()
+{
+  if (this->obj_ != NULL)
+    delete this->obj_;
+  this->obj_ = NULL;
+  if (this->input_file_ != NULL)
+    delete this->input_file_;
+  this->input_file_ = NULL;
+}
+
 // Verify a .dwp file given a list of .dwo files referenced by the
 // corresponding executable file.  Returns true if no problems
 // were found.
@@ -1000,7 +1365,7 @@ Dwo_file::read(Dwp_output_file* output_file)
 bool
 Dwo_file::verify(const File_list& files)
 {
-  this->obj_ = this->make_object(NULL);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -1039,7 +1404,7 @@ Dwo_file::verify(const File_list& files)
 // and record the target info.
 
 Relobj*
-Dwo_file::make_object(Dwp_output_file* output_file)
+Dwo_file::make_object()
 {
   // Open the input file.
   Input_file* input_file = new Input_file(this->name_);
@@ -1073,15 +1438,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_32_BIG
-	return this->sized_make_object<32, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<32, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_32_LITTLE
-	return this->sized_make_object<32, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<32, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1090,15 +1453,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_64_BIG
-	return this->sized_make_object<64, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<64, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_64_LITTLE
-	return this->sized_make_object<64, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<64, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1112,41 +1473,37 @@ Dwo_file::make_object(Dwp_output_file* output_file)
 
 template <int size, bool big_endian>
 Relobj*
-Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file,
-			    Dwp_output_file* output_file)
+Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file)
 {
   elfcpp::Ehdr<size, big_endian> ehdr(p);
   Sized_relobj_dwo<size, big_endian>* obj =
       new Sized_relobj_dwo<size, big_endian>(this->name_, input_file, ehdr);
   obj->setup();
-  if (output_file != NULL)
-    output_file->record_target_info(
-	this->name_, ehdr.get_e_machine(), size, big_endian,
-	ehdr.get_e_ident()[elfcpp::EI_OSABI],
-	ehdr.get_e_ident()[elfcpp::EI_ABIVERSION]);
+  this->machine_ = ehdr.get_e_machine();
+  this->size_ = size;
+  this->big_endian_ = big_endian;
+  this->osabi_ = ehdr.get_e_ident()[elfcpp::EI_OSABI];
+  this->abiversion_ = ehdr.get_e_ident()[elfcpp::EI_ABIVERSION];
   return obj;
 }
 
 // Read the .debug_cu_index or .debug_tu_index section of a .dwp file,
-// and process the CU or TU sets.
+// and record the CU or TU sets.
 
 void
 Dwo_file::read_unit_index(unsigned int shndx, unsigned int *debug_shndx,
-			  Dwp_output_file* output_file, bool is_tu_index)
+			  bool is_tu_index)
 {
   if (this->obj_->is_big_endian())
-    this->sized_read_unit_index<true>(shndx, debug_shndx, output_file,
-				      is_tu_index);
+    this->sized_read_unit_index<true>(shndx, debug_shndx, is_tu_index);
   else
-    this->sized_read_unit_index<false>(shndx, debug_shndx, output_file,
-				       is_tu_index);
+    this->sized_read_unit_index<false>(shndx, debug_shndx, is_tu_index);
 }
 
 template <bool big_endian>
 void
 Dwo_file::sized_read_unit_index(unsigned int shndx,
 				unsigned int *debug_shndx,
-				Dwp_output_file* output_file,
 				bool is_tu_index)
 {
   elfcpp::DW_SECT info_sect = (is_tu_index
@@ -1195,29 +1552,24 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
     gold_fatal(_("%s: section %s is corrupt"), this->name_,
 	       this->section_name(shndx).c_str());
 
-  // Copy the related sections and track the section offsets and sizes.
+  // Record the related sections and track the section offsets and sizes.
   Section_bounds sections[elfcpp::DW_SECT_MAX + 1];
   for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
     {
       if (debug_shndx[i] > 0)
-	sections[i] = this->copy_section(output_file, debug_shndx[i],
+	sections[i] = this->copy_section(debug_shndx[i],
 					 static_cast<elfcpp::DW_SECT>(i));
     }
 
-  // Get the contents of the .debug_info.dwo or .debug_types.dwo section.
-  section_size_type info_len;
-  bool info_is_new;
-  const unsigned char* info_contents =
-      this->section_contents(info_shndx, &info_len, &info_is_new);
-
-  // Loop over the slots of the hash table.
+  // Loop over the slots of the hash table.  Duplicate type units are
+  // dropped when the unit sets are added to the output index.
   for (unsigned int i = 0; i < nslots; ++i)
     {
       uint64_t signature =
           elfcpp::Swap_unaligned<64, big_endian>::readval(phash);
       unsigned int index =
 	  elfcpp::Swap_unaligned<32, big_endian>::readval(pindex);
-      if (index != 0 && (!is_tu_index || !output_file->lookup_tu(signature)))
+      if (index != 0)
 	{
 	  Unit_set* unit_set = new Unit_set();
 	  unit_set->signature = signature;
@@ -1227,16 +1579,20 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 	  const unsigned char* psrow =
 	      psizes + (index - 1) * ncols * sizeof(uint32_t);
 
-	  // Adjust the offset of each contribution within the input section
-	  // by the offset of the input section within the output section.
-	  for (unsigned int j = 0; j <= ncols; j++)
+	  // Record the offset of each contribution within the input
+	  // section.  The offset of the input section within the output
+	  // section is added by add_contributions.
+	  for (unsigned int j = 0; j < ncols; j++)
 	    {
 	      unsigned int dw_sect =
-		  elfcpp::Swap_unaligned<64, big_endian>::readval(pch);
+		  elfcpp::Swap_unaligned<32, big_endian>::readval(pch);
 	      unsigned int offset =
-		  elfcpp::Swap_unaligned<64, big_endian>::readval(porow);
+		  elfcpp::Swap_unaligned<32, big_endian>::readval(porow);
 	      unsigned int size =
-		  elfcpp::Swap_unaligned<64, big_endian>::readval(psrow);
+		  elfcpp::Swap_unaligned<32, big_endian>::readval(psrow);
+	      if (dw_sect == 0 || dw_sect > elfcpp::DW_SECT_MAX)
+		gold_fatal(_("%s: section %s is corrupt"), this->name_,
+			   this->section_name(shndx).c_str());
 	      unit_set->sections[dw_sect].offset = (sections[dw_sect].offset
 						    + offset);
 	      unit_set->sections[dw_sect].size = size;
@@ -1245,27 +1601,8 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 	      psrow += sizeof(uint32_t);
 	    }
 
-	  const unsigned char* unit_start =
-	      info_contents + unit_set->sections[info_sect].offset;
-	  section_size_type unit_length = unit_set->sections[info_sect].size;
-
-	  // Dwp_output_file::add_contribution writes the .debug_info.dwo
-	  // section directly to the output file, so we only need to
-	  // duplicate contributions for .debug_types.dwo section.
-	  if (is_tu_index)
-	    {
-	      unsigned char *copy = new unsigned char[unit_length];
-	      memcpy(copy, unit_start, unit_length);
-	      unit_start = copy;
-	    }
-	  section_offset_type off =
-	      output_file->add_contribution(info_sect, unit_start,
-					    unit_length, 1);
-	  unit_set->sections[info_sect].offset = off;
-	  if (is_tu_index)
-	    output_file->add_tu_set(unit_set);
-	  else
-	    output_file->add_cu_set(unit_set);
+	  this->add_unit(unit_set, info_shndx,
+			 unit_set->sections[info_sect].offset, is_tu_index);
 	}
       phash += sizeof(uint64_t);
       pindex += sizeof(uint32_t);
@@ -1273,8 +1610,6 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 
   if (index_is_new)
     delete[] contents;
-  if (info_is_new)
-    delete[] info_contents;
 }
 
 // Verify the .debug_cu_index section of a .dwp file, comparing it
@@ -1391,20 +1726,43 @@ Dwo_file::add_strings(Dwp_output_file* output_file, unsigned int debug_str)
 	       this->name_,
 	       this->section_name(debug_str).c_str());
 
+  // Add the strings to the output string table.  Their output offsets
+  // are not known until all the input files have been read.
+  output_file->add_strings(this->file_index_, p, len);
+  if (is_new)
+    delete[] pdata;
+}
+
+// Build the map from input string offsets to output string offsets,
+// by looking up each string of the input string table in the output
+// string table.
+
+void
+Dwo_file::read_str_offset_map(Dwp_output_file* output_file)
+{
+  if (!this->str_offset_map_.empty())
+    return;
+
+  section_size_type len;
+  bool is_new;
+  const unsigned char* pdata = this->section_contents(this->debug_str_, &len,
+						      &is_new);
+  const char* p = reinterpret_cast<const char*>(pdata);
+  const char* pend = p + len;
+
   // Count the number of strings in the section, and size the map.
   size_t count = 0;
   for (const char* pt = p; pt < pend; pt += strlen(pt) + 1)
     ++count;
   this->str_offset_map_.reserve(count + 1);
 
-  // Add the strings to the output string table, and record the new offsets
-  // in the map.
+  // Record the new offsets in the map.
   section_offset_type i = 0;
   section_offset_type new_offset;
   while (p < pend)
     {
       size_t len = strlen(p);
-      new_offset = output_file->add_string(p, len);
+      new_offset = output_file->string_offset(p, len);
       this->str_offset_map_.push_back(std::make_pair(i, new_offset));
       p += len + 1;
       i += len + 1;
@@ -1415,77 +1773,65 @@ Dwo_file::add_strings(Dwp_output_file* output_file, unsigned int debug_str)
     delete[] pdata;
 }
 
-// Copy a section from the input file to the output file.
-// Return the offset and length of this input section's contribution
-// in the output section.  If copying .debug_str_offsets.dwo, remap
-// the string offsets for the output string table.
+// Record that a section is to be copied from the input file to the
+// output file.  Return the offset and length of this input section's
+// contribution, relative to the start of the input section; the
+// section is placed in the output section by add_contributions.
 
 Section_bounds
-Dwo_file::copy_section(Dwp_output_file* output_file, unsigned int shndx,
-		       elfcpp::DW_SECT section_id)
+Dwo_file::copy_section(unsigned int shndx, elfcpp::DW_SECT section_id)
 {
   // Some sections may be referenced from more than one set.
   // Don't copy a section more than once.
-  if (this->sect_offsets_[shndx].size > 0)
-    return this->sect_offsets_[shndx];
-
-  // Get the section contents. Upon return, if IS_NEW is true, the memory
-  // has been allocated via new; if false, the memory is part of the mapped
-  // input file, and we will need to duplicate it so that it will persist
-  // after we close the input file.
+  for (std::vector<Section_copy>::const_iterator p = this->copies_.begin();
+       p != this->copies_.end();
+       ++p)
+    if (p->shndx == shndx)
+      return Section_bounds(0, p->size);
+
+  // We only need the size now, which for a compressed section means
+  // decompressing it.  The object keeps the decompressed contents for
+  // copy_contributions.
   section_size_type len;
-  bool is_new;
-  const unsigned char* contents = this->section_contents(shndx, &len, &is_new);
-
-  if (section_id == elfcpp::DW_SECT_STR_OFFSETS)
+  if (!this->is_compressed_[shndx])
+    len = convert_to_section_size_type(this->obj_->section_size(shndx));
+  else
     {
-      const unsigned char* remapped = this->remap_str_offsets(contents, len);
+      bool is_new;
+      const unsigned char* contents = this->section_contents(shndx, &len,
+							     &is_new);
       if (is_new)
 	delete[] contents;
-      contents = remapped;
-    }
-  else if (!is_new)
-    {
-      unsigned char* copy = new unsigned char[len];
-      memcpy(copy, contents, len);
-      contents = copy;
     }
 
-  // Add the contents of the input section to the output section.
-  // The output file takes ownership of the memory pointed to by CONTENTS.
-  section_offset_type off = output_file->add_contribution(section_id, contents,
-							  len, 1);
-
-  // Store the output section bounds.
-  Section_bounds bounds(off, len);
-  this->sect_offsets_[shndx] = bounds;
+  if (section_id == elfcpp::DW_SECT_STR_OFFSETS && (len & 3) != 0)
+    gold_fatal(_("%s: .debug_str_offsets.dwo section size not a multiple of 4"),
+	       this->name_);
 
-  return bounds;
+  Section_copy copy = { section_id, shndx, len };
+  this->copies_.push_back(copy);
+  return Section_bounds(0, len);
 }
 
-// Remap the 
-const unsigned char*
+// Remap the string offsets in the .debug_str_offsets.dwo section.
+
+void
 Dwo_file::remap_str_offsets(const unsigned char* contents,
-			    section_size_type len)
+			    section_size_type len, unsigned char* out)
 {
-  if ((len & 3) != 0)
-    gold_fatal(_("%s: .debug_str_offsets.dwo section size not a multiple of 4"),
-	       this->name_);
-
   if (this->obj_->is_big_endian())
-    return this->sized_remap_str_offsets<true>(contents, len);
+    this->sized_remap_str_offsets<true>(contents, len, out);
   else
-    return this->sized_remap_str_offsets<false>(contents, len);
+    this->sized_remap_str_offsets<false>(contents, len, out);
 }
 
 template <bool big_endian>
-const unsigned char*
+void
 Dwo_file::sized_remap_str_offsets(const unsigned char* contents,
-				  section_size_type len)
+				  section_size_type len, unsigned char* out)
 {
-  unsigned char* remapped = new unsigned char[len];
   const unsigned char* p = contents;
-  unsigned char* q = remapped;
+  unsigned char* q = out;
   while (len > 0)
     {
       unsigned int val = elfcpp::Swap_unaligned<32, big_endian>::readval(p);
@@ -1495,7 +1841,6 @@ Dwo_file::sized_remap_str_offsets(const unsigned char* contents,
       p += 4;
       q += 4;
     }
-  return remapped;
 }
 
 unsigned int
@@ -1520,12 +1865,11 @@ Dwo_file::remap_str_offset(section_offset_type val)
   return p->second + (val - p->first);
 }
 
-// Add a set of .debug_info.dwo or .debug_types.dwo and related sections
-// to OUTPUT_FILE.
+// Record a set of .debug_info.dwo or .debug_types.dwo and related
+// sections.
 
 void
-Dwo_file::add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
-		       bool is_debug_types)
+Dwo_file::add_unit_set(unsigned int *debug_shndx, bool is_debug_types)
 {
   unsigned int shndx = (is_debug_types
 			? debug_shndx[elfcpp::DW_SECT_TYPES]
@@ -1536,24 +1880,30 @@ Dwo_file::add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
   if (debug_shndx[elfcpp::DW_SECT_ABBREV] == 0)
     gold_fatal(_("%s: no .debug_abbrev.dwo section found"), this->name_);
 
-  // Copy the related sections and track the section offsets and sizes.
+  // Record the related sections and track the section offsets and sizes.
   Section_bounds sections[elfcpp::DW_SECT_MAX + 1];
   for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
     {
       if (debug_shndx[i] > 0)
-	sections[i] = this->copy_section(output_file, debug_shndx[i],
+	sections[i] = this->copy_section(debug_shndx[i],
 					 static_cast<elfcpp::DW_SECT>(i));
     }
 
-  // Parse the .debug_info or .debug_types section and add each compilation
-  // or type unit to the output file, along with the contributions to the
+  // Parse the .debug_info or .debug_types section and record each
+  // compilation or type unit, along with the contributions to the
   // related sections.
   Unit_reader reader(is_debug_types, this->obj_, shndx);
-  reader.add_units(output_file, debug_shndx[elfcpp::DW_SECT_ABBREV], sections);
+  reader.add_units(this, debug_shndx[elfcpp::DW_SECT_ABBREV], sections);
 }
 
 // Class Dwp_output_file.
 
+Dwp_output_file::~Dwp_output_file()
+{
+  for (unsigned int i = 0; i < this->string_shards_.size(); ++i)
+    delete this->string_shards_[i];
+}
+
 // Record the target info from an input file.  On first call, we
 // set the ELF header values for the output file.  On subsequent
 // calls, we just verify that the values match.
@@ -1579,31 +1929,92 @@ Dwp_output_file::record_target_info(const char*, int machine,
     this->next_file_offset_ = elfcpp::Elf_sizes<64>::ehdr_size;
   else
     gold_unreachable();
+}
 
-  this->fd_ = ::fopen(this->name_, "wb");
-  if (this->fd_ == NULL)
-    gold_fatal(_("%s: %s"), this->name_, strerror(errno));
+// Add the strings of input file FILE_INDEX to the debug strings
+// section.  The strings are entered in a partition of the string table
+// chosen by hash code, so that different files can be added in
+// parallel.  For each string we remember the earliest place where it
+// was seen, so that merge_strings can add the strings in the same order
+// as if the files had been read one at a time.
 
-  // Write zeroes for the ELF header initially.  We'll write
-  // the actual header during finalize().
-  static const char buf[elfcpp::Elf_sizes<64>::ehdr_size] = { 0 };
-  if (::fwrite(buf, 1, this->next_file_offset_, this->fd_)
-      < (size_t) this->next_file_offset_)
-    gold_fatal(_("%s: %s"), this->name_, strerror(errno));
+void
+Dwp_output_file::add_strings(unsigned int file_index, const char* p,
+			     section_size_type len)
+{
+  const char* pend = p + len;
+  if (p >= pend)
+    return;
+
+  // Compute the hash codes without holding any locks.
+  std::vector<std::vector<Shard_string> > pending(string_shard_count);
+  uint64_t rank = static_cast<uint64_t>(file_index) << 32;
+  while (p < pend)
+    {
+      size_t string_len = strlen(p);
+      Shard_string s = { p, string_len,
+			 Stringpool::hash_string(p, string_len), rank };
+      pending[s.hash_code % string_shard_count].push_back(s);
+      p += string_len + 1;
+      ++rank;
+    }
+
+  for (unsigned int i = 0; i < string_shard_count; ++i)
+    {
+      if (pending[i].empty())
+	continue;
+      String_shard* shard = this->string_shards_[i];
+      Hold_lock hl(shard->lock);
+      for (std::vector<Shard_string>::const_iterator ps = pending[i].begin();
+	   ps != pending[i].end();
+	   ++ps)
+	{
+	  Stringpool::Key key;
+	  const char* str = shard->pool.add_with_length(ps->str, ps->len, true,
+							&key);
+	  if (key > shard->strings.size())
+	    {
+	      gold_assert(key == shard->strings.size() + 1);
+	      Shard_string s = { str, ps->len, ps->hash_code, ps->rank };
+	      shard->strings.push_back(s);
+	    }
+	  else if (ps->rank < shard->strings[key - 1].rank)
+	    shard->strings[key - 1].rank = ps->rank;
+	}
+    }
 }
 
-// Add a string to the debug strings section.
+// Add the unique strings to the debug strings section in the order in
+// which they were first seen, and fix their offsets.  This is called
+// once all the input files have been read.
 
-section_offset_type
-Dwp_output_file::add_string(const char* str, size_t len)
-{
-  Stringpool::Key key;
-  this->stringpool_.add_with_length(str, len, true, &key);
-  this->have_strings_ = true;
-  // We aren't supposed to call get_offset() until after
-  // calling set_string_offsets(), but the offsets will
-  // not change unless optimizing the string pool.
-  return this->stringpool_.get_offset_from_key(key);
+void
+Dwp_output_file::merge_strings()
+{
+  std::vector<const Shard_string*> strings;
+  for (unsigned int i = 0; i < string_shard_count; ++i)
+    {
+      const String_shard* shard = this->string_shards_[i];
+      for (std::vector<Shard_string>::const_iterator p =
+	     shard->strings.begin();
+	   p != shard->strings.end();
+	   ++p)
+	strings.push_back(&*p);
+    }
+  std::sort(strings.begin(), strings.end(), Rank_compare());
+
+  this->stringpool_.reserve(strings.size());
+  for (std::vector<const Shard_string*>::const_iterator p = strings.begin();
+       p != strings.end();
+       ++p)
+    this->stringpool_.add_new_with_hash((*p)->str, (*p)->len,
+					(*p)->hash_code, NULL);
+  this->have_strings_ = !strings.empty();
+  this->stringpool_.set_string_offsets();
+
+  for (unsigned int i = 0; i < string_shard_count; ++i)
+    delete this->string_shards_[i];
+  this->string_shards_.clear();
 }
 
 // Align the file offset to the given boundary.
@@ -1624,16 +2035,13 @@ Dwp_output_file::add_output_section(const char* section_name, int align)
   return this->shnum_++;
 }
 
-// Add a contribution to a section in the output file, and return the offset
-// of the contribution within the output section.  The .debug_info.dwo section
-// is expected to be the largest one, so we will write the contents of this
-// section directly to the output file as we receive contributions, allowing
-// us to free that memory as soon as possible. We will save the remaining
-// contributions until we finalize the layout of the output file.
+// Add a contribution to a section in the output file, and return the
+// offset of the contribution within the output section.  The contents
+// are copied later by Dwo_file::copy_contributions, once layout has
+// assigned file offsets to the output sections.
 
 section_offset_type
 Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
-				  const unsigned char* contents,
 				  section_size_type len,
 				  int align)
 {
@@ -1653,51 +2061,11 @@ Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
 
   Section& section = this->sections_[shndx - 1];
 
-  section_offset_type section_offset;
-
-  if (section_id == elfcpp::DW_SECT_INFO)
-    {
-      // Write the .debug_info.dwo section directly.
-      // We do not need to free the memory in this case.
-      off_t file_offset = this->next_file_offset_;
-      gold_assert(this->size_ > 0 && file_offset > 0);
-
-      file_offset = align_offset(file_offset, align);
-      if (section.offset == 0)
-	section.offset = file_offset;
-
-      if (align > section.align)
-	{
-	  // Since we've already committed to the layout for this
-	  // section, an unexpected large alignment boundary may
-	  // be impossible to honor.
-	  if (align_offset(section.offset, align) != section.offset)
-	    gold_fatal(_("%s: alignment (%d) for section '%s' "
-			 "cannot be honored"),
-		       this->name_, align, section_name);
-	  section.align = align;
-	}
-
-      section_offset = file_offset - section.offset;
-      section.size = file_offset + len - section.offset;
-
-      ::fseek(this->fd_, file_offset, SEEK_SET);
-      if (::fwrite(contents, 1, len, this->fd_) < len)
-	gold_fatal(_("%s: error writing section '%s'"), this->name_,
-		   section_name);
-      this->next_file_offset_ = file_offset + len;
-    }
-  else
-    {
-      // Collect the contributions and keep track of the total size.
-      if (align > section.align)
-	section.align = align;
-      section_offset = align_offset(section.size, align);
-      section.size = section_offset + len;
-      Contribution contrib = { section_offset, len, contents };
-      section.contributions.push_back(contrib);
-    }
-
+  // Keep track of the total size.
+  if (align > section.align)
+    section.align = align;
+  section_offset_type section_offset = align_offset(section.size, align);
+  section.size = section_offset + len;
   return section_offset;
 }
 
@@ -1715,26 +2083,18 @@ Dwp_output_file::add_cu_set(Unit_set* cu_set)
 		 this->name_, (unsigned long long)dwo_id);
 }
 
-// Lookup a type signature and return TRUE if we have already seen it.
-bool
-Dwp_output_file::lookup_tu(uint64_t type_sig)
-{
-  this->last_type_sig_ = type_sig;
-  return this->tu_index_.find_or_add(type_sig, &this->last_tu_slot_);
-}
-
 // Add a set of .debug_types and related sections to the output file.
+// Return false if we have already seen the type signature.
 
-void
+bool
 Dwp_output_file::add_tu_set(Unit_set* tu_set)
 {
   uint64_t type_sig = tu_set->signature;
   unsigned int slot;
-  if (type_sig == this->last_type_sig_)
-    slot = this->last_tu_slot_;
-  else
-    this->tu_index_.find_or_add(type_sig, &slot);
+  if (this->tu_index_.find_or_add(type_sig, &slot))
+    return false;
   this->tu_index_.enter_set(slot, tu_set);
+  return true;
 }
 
 // Find a slot in the hash table for SIGNATURE.  Return TRUE
@@ -1843,145 +2203,266 @@ Dwp_output_file::Dwp_index::grow()
   delete[] old_index_table;
 }
 
-// Finalize the file, write the string tables and index sections,
-// and close the file.
+// Add a new section of size LEN at the end of the output file, and
+// return the section index.
+
+unsigned int
+Dwp_output_file::layout_new_section(const char* section_name,
+				    section_size_type len, int align)
+{
+  section_name = this->shstrtab_.add_with_length(section_name,
+						 strlen(section_name),
+						 false, NULL);
+  unsigned int shndx = this->add_output_section(section_name, align);
+  Section& section = this->sections_[shndx - 1];
+  off_t file_offset = this->next_file_offset_;
+  file_offset = align_offset(file_offset, align);
+  section.offset = file_offset;
+  section.size = len;
+  this->next_file_offset_ = file_offset + len;
+  return shndx;
+}
+
+// Lay out the output file once all the contributions have been added.
+// The .debug_info.dwo section comes first, followed by the other
+// contributions in the order their sections were created, the string
+// table, the index sections, the section string table and the section
+// header table.  Then open the output file.
 
 void
-Dwp_output_file::finalize()
+Dwp_output_file::layout()
 {
-  unsigned char* buf;
+  gold_assert(this->size_ > 0);
+
+  unsigned int info_shndx = this->section_id_map_[elfcpp::DW_SECT_INFO];
+  if (info_shndx > 0)
+    {
+      Section& sect = this->sections_[info_shndx - 1];
+      off_t file_offset = align_offset(this->next_file_offset_, sect.align);
+      sect.offset = file_offset;
+      this->next_file_offset_ = file_offset + sect.size;
+    }
 
-  // Write the accumulated output sections.
   for (unsigned int i = 0; i < this->sections_.size(); i++)
     {
       Section& sect = this->sections_[i];
-      // If the offset has already been assigned, the section has been written.
-      if (sect.offset > 0 || sect.size == 0)
+      if (i + 1 == info_shndx || sect.size == 0)
 	continue;
       off_t file_offset = this->next_file_offset_;
       file_offset = align_offset(file_offset, sect.align);
       sect.offset = file_offset;
-      this->write_contributions(sect);
       this->next_file_offset_ = file_offset + sect.size;
     }
 
-  // Write the debug string table.
+  // The debug string table.
   if (this->have_strings_)
-    {
-      this->stringpool_.set_string_offsets();
-      section_size_type len = this->stringpool_.get_strtab_size();
-      buf = new unsigned char[len];
-      this->stringpool_.write_to_buffer(buf, len);
-      this->write_new_section(".debug_str.dwo", buf, len, 1);
-      delete[] buf;
-    }
-
-  // Write the CU and TU indexes.
-  if (this->big_endian_)
-    {
-      this->write_index<true>(".debug_cu_index", this->cu_index_);
-      this->write_index<true>(".debug_tu_index", this->tu_index_);
-    }
-  else
-    {
-      this->write_index<false>(".debug_cu_index", this->cu_index_);
-      this->write_index<false>(".debug_tu_index", this->tu_index_);
-    }
+    this->debug_str_shndx_ =
+	this->layout_new_section(".debug_str.dwo",
+				 this->stringpool_.get_strtab_size(), 1);
+
+  // The CU and TU indexes.
+  this->cu_index_shndx_ =
+      this->layout_new_section(".debug_cu_index",
+			       this->index_size(this->cu_index_),
+			       sizeof(uint64_t));
+  this->tu_index_shndx_ =
+      this->layout_new_section(".debug_tu_index",
+			       this->index_size(this->tu_index_),
+			       sizeof(uint64_t));
 
   off_t file_offset = this->next_file_offset_;
 
-  // Write the section string table.
+  // The section string table.
   this->shstrndx_ = this->shnum_++;
-  const char* shstrtab_name =
+  this->shstrtab_name_ =
       this->shstrtab_.add_with_length(".shstrtab", sizeof(".shstrtab") - 1,
 				      false, NULL);
   this->shstrtab_.set_string_offsets();
-  section_size_type shstrtab_len = this->shstrtab_.get_strtab_size();
-  buf = new unsigned char[shstrtab_len];
-  this->shstrtab_.write_to_buffer(buf, shstrtab_len);
-  off_t shstrtab_off = file_offset;
-  ::fseek(this->fd_, file_offset, 0);
-  if (::fwrite(buf, 1, shstrtab_len, this->fd_) < shstrtab_len)
-    gold_fatal(_("%s: error writing section '.shstrtab'"), this->name_);
-  delete[] buf;
-  file_offset += shstrtab_len;
-
-  // Write the section header table.  The first entry is a NULL entry.
-  // This is followed by the debug sections, and finally we write the
+  file_offset += this->shstrtab_.get_strtab_size();
+
+  // The section header table.  The first entry is a NULL entry.
+  // This is followed by the debug sections, and finally the
   // .shstrtab section header.
   file_offset = align_offset(file_offset, this->size_ == 32 ? 4 : 8);
   this->shoff_ = file_offset;
-  ::fseek(this->fd_, file_offset, 0);
+  if (this->size_ == 32)
+    file_offset += this->shnum_ * elfcpp::Elf_sizes<32>::shdr_size;
+  else
+    file_offset += this->shnum_ * elfcpp::Elf_sizes<64>::shdr_size;
+  this->file_size_ = file_offset;
+
+  this->open();
+}
+
+// Open the output file and map it into memory.  If the file can not
+// be mapped, we build the contents in memory and write them out in
+// finalize.
+
+void
+Dwp_output_file::open()
+{
+  this->fd_ = open_descriptor(-1, this->name_, O_RDWR | O_CREAT | O_TRUNC,
+			      0666);
+  if (this->fd_ < 0)
+    gold_fatal(_("%s: %s"), this->name_, strerror(errno));
+
+#ifdef HAVE_MMAP
+  if (::ftruncate(this->fd_, this->file_size_) == 0)
+    {
+      void* base = ::mmap(NULL, this->file_size_, PROT_READ | PROT_WRITE,
+			  MAP_SHARED, this->fd_, 0);
+      if (base != MAP_FAILED)
+	{
+	  this->base_ = static_cast<unsigned char*>(base);
+	  return;
+	}
+    }
+#endif
+
+  this->base_ = new unsigned char[this->file_size_];
+  memset(this->base_, 0, this->file_size_);
+  this->map_is_anonymous_ = true;
+}
+
+// Return a pointer to the output file at the contribution at OFFSET in
+// the output section for SECTION_ID.
+
+unsigned char*
+Dwp_output_file::contribution_view(elfcpp::DW_SECT section_id,
+				   section_offset_type offset,
+				   section_size_type len)
+{
+  unsigned int shndx = this->section_id_map_[section_id];
+  gold_assert(shndx > 0 && this->base_ != NULL);
+  const Section& sect = this->sections_[shndx - 1];
+  gold_assert(offset >= 0
+	      && static_cast<section_size_type>(offset) + len <= sect.size);
+  return this->base_ + sect.offset + offset;
+}
+
+// Write the debug string table.
+
+void
+Dwp_output_file::write_strings()
+{
+  if (!this->have_strings_)
+    return;
+  const Section& sect = this->sections_[this->debug_str_shndx_ - 1];
+  this->stringpool_.write_to_buffer(this->base_ + sect.offset, sect.size);
+}
+
+// Write the CU or TU index.
+
+void
+Dwp_output_file::write_unit_index(bool is_tu_index)
+{
+  unsigned int shndx = (is_tu_index
+			? this->tu_index_shndx_
+			: this->cu_index_shndx_);
+  const Dwp_index& index = is_tu_index ? this->tu_index_ : this->cu_index_;
+  const Section& sect = this->sections_[shndx - 1];
+  if (this->big_endian_)
+    this->write_index<true>(this->base_ + sect.offset, sect.size, index);
+  else
+    this->write_index<false>(this->base_ + sect.offset, sect.size, index);
+}
+
+// Write the section string table, the section header table and the
+// ELF header, and close the file.
+
+void
+Dwp_output_file::finalize()
+{
+  // Write the section string table.
+  off_t shstrtab_off = this->next_file_offset_;
+  section_size_type shstrtab_len = this->shstrtab_.get_strtab_size();
+  this->shstrtab_.write_to_buffer(this->base_ + shstrtab_off, shstrtab_len);
+
+  // Write the section header table.
+  unsigned char* p = this->base_ + this->shoff_;
+  const unsigned int shdr_size = (this->size_ == 32
+				  ? elfcpp::Elf_sizes<32>::shdr_size
+				  : elfcpp::Elf_sizes<64>::shdr_size);
   section_size_type sh0_size = 0;
   unsigned int sh0_link = 0;
   if (this->shnum_ >= elfcpp::SHN_LORESERVE)
     sh0_size = this->shnum_;
   if (this->shstrndx_ >= elfcpp::SHN_LORESERVE)
     sh0_link = this->shstrndx_;
-  this->write_shdr(NULL, 0, 0, 0, 0, sh0_size, sh0_link, 0, 0, 0);
+  this->write_shdr(p, NULL, 0, 0, 0, 0, sh0_size, sh0_link, 0, 0, 0);
+  p += shdr_size;
   for (unsigned int i = 0; i < this->sections_.size(); ++i)
     {
       Section& sect = this->sections_[i];
-      this->write_shdr(sect.name, elfcpp::SHT_PROGBITS, 0, 0, sect.offset,
+      this->write_shdr(p, sect.name, elfcpp::SHT_PROGBITS, 0, 0, sect.offset,
 		       sect.size, 0, 0, sect.align, 0);
+      p += shdr_size;
     }
-  this->write_shdr(shstrtab_name, elfcpp::SHT_STRTAB, 0, 0,
+  this->write_shdr(p, this->shstrtab_name_, elfcpp::SHT_STRTAB, 0, 0,
 		   shstrtab_off, shstrtab_len, 0, 0, 1, 0);
+  p += shdr_size;
+  gold_assert(p == this->base_ + this->file_size_);
 
   // Write the ELF header.
   this->write_ehdr();
 
-  // Close the file.
-  if (this->fd_ != NULL)
+  // If the contents are not mapped to the file, write them now.
+  if (this->map_is_anonymous_)
     {
-      if (::fclose(this->fd_) != 0)
-	gold_fatal(_("%s: %s"), this->name_, strerror(errno));
+      off_t offset = 0;
+      while (offset < this->file_size_)
+	{
+	  ssize_t bytes_written = ::write(this->fd_, this->base_ + offset,
+					  this->file_size_ - offset);
+	  if (bytes_written <= 0)
+	    gold_fatal(_("%s: %s"), this->name_,
+		       (bytes_written == 0
+			? _("unexpected 0 return-value")
+			: strerror(errno)));
+	  offset += bytes_written;
+	}
+      delete[] this->base_;
     }
-  this->fd_ = NULL;
+#ifdef HAVE_MMAP
+  else if (::munmap(this->base_, this->file_size_) < 0)
+    gold_fatal(_("%s: munmap: %s"), this->name_, strerror(errno));
+#endif
+  this->base_ = NULL;
+
+  // Close the file.
+  if (::close(this->fd_) < 0)
+    gold_fatal(_("%s: %s"), this->name_, strerror(errno));
+  this->fd_ = -1;
 }
 
-// Write the contributions to an output section.
+// Return the size of a CU or TU index section.
 
-void
-Dwp_output_file::write_contributions(const Section& sect)
+section_size_type
+Dwp_output_file::index_size(const Dwp_index& index) const
 {
-  for (unsigned int i = 0; i < sect.contributions.size(); ++i)
-    {
-      const Contribution& c = sect.contributions[i];
-      ::fseek(this->fd_, sect.offset + c.output_offset, SEEK_SET);
-      if (::fwrite(c.contents, 1, c.size, this->fd_) < c.size)
-	gold_fatal(_("%s: error writing section '%s'"), this->name_, sect.name);
-      delete[] c.contents;
-    }
-}
+  const unsigned int nslots = index.hash_table_total_slots();
+  const unsigned int nrows = index.section_table_rows();
 
-// Write a new section to the output file.
+  int column_mask = index.section_table_cols();
+  unsigned int ncols = 0;
+  for (unsigned int c = 1; c <= elfcpp::DW_SECT_MAX; ++c)
+    if (column_mask & (1 << c))
+      ncols++;
+  const unsigned int ntable = (nrows * 2 + 1) * ncols;
 
-void
-Dwp_output_file::write_new_section(const char* section_name,
-				   const unsigned char* contents,
-				   section_size_type len, int align)
-{
-  section_name = this->shstrtab_.add_with_length(section_name,
-						 strlen(section_name),
-						 false, NULL);
-  unsigned int shndx = this->add_output_section(section_name, align);
-  Section& section = this->sections_[shndx - 1];
-  off_t file_offset = this->next_file_offset_;
-  file_offset = align_offset(file_offset, align);
-  section.offset = file_offset;
-  section.size = len;
-  ::fseek(this->fd_, file_offset, SEEK_SET);
-  if (::fwrite(contents, 1, len, this->fd_) < len)
-    gold_fatal(_("%s: error writing section '%s'"), this->name_, section_name);
-  this->next_file_offset_ = file_offset + len;
+  return (4 * sizeof(uint32_t)
+	  + nslots * sizeof(uint64_t)
+	  + nslots * sizeof(uint32_t)
+	  + ntable * sizeof(uint32_t));
 }
 
-// Write a CU or TU index section.
+// Write a CU or TU index section of size INDEX_SIZE to BUF.
 
 template<bool big_endian>
 void
-Dwp_output_file::write_index(const char* sect_name, const Dwp_index& index)
+Dwp_output_file::write_index(unsigned char* buf,
+			     section_size_type index_size,
+			     const Dwp_index& index)
 {
   const unsigned int nslots = index.hash_table_total_slots();
   const unsigned int nused = index.hash_table_used_slots();
@@ -1992,15 +2473,7 @@ Dwp_output_file::write_index(const char* sect_name, const Dwp_index& index)
   for (unsigned int c = 1; c <= elfcpp::DW_SECT_MAX; ++c)
     if (column_mask & (1 << c))
       ncols++;
-  const unsigned int ntable = (nrows * 2 + 1) * ncols;
 
-  const section_size_type index_size = (4 * sizeof(uint32_t)
-					+ nslots * sizeof(uint64_t)
-					+ nslots * sizeof(uint32_t)
-					+ ntable * sizeof(uint32_t));
-
-  // Allocate a buffer for the section contents.
-  unsigned char* buf = new unsigned char[index_size];
   unsigned char* p = buf;
 
   // Write the section header: version number, padding,
@@ -2079,10 +2552,6 @@ Dwp_output_file::write_index(const char* sect_name, const Dwp_index& index)
     }
 
   gold_assert(p == buf + index_size);
-
-  this->write_new_section(sect_name, buf, index_size, sizeof(uint64_t));
-
-  delete[] buf;
 }
 
 // Write the ELF header.
@@ -2112,9 +2581,7 @@ template<unsigned int size, bool big_endian>
 void
 Dwp_output_file::sized_write_ehdr()
 {
-  const unsigned int ehdr_size = elfcpp::Elf_sizes<size>::ehdr_size;
-  unsigned char buf[ehdr_size];
-  elfcpp::Ehdr_write<size, big_endian> ehdr(buf);
+  elfcpp::Ehdr_write<size, big_endian> ehdr(this->base_);
 
   unsigned char e_ident[elfcpp::EI_NIDENT];
   memset(e_ident, 0, elfcpp::EI_NIDENT);
@@ -2149,17 +2616,14 @@ Dwp_output_file::sized_write_ehdr()
   ehdr.put_e_shstrndx(this->shstrndx_ < elfcpp::SHN_LORESERVE
 		      ? this->shstrndx_
 		      : static_cast<unsigned int>(elfcpp::SHN_XINDEX));
-
-  ::fseek(this->fd_, 0, 0);
-  if (::fwrite(buf, 1, ehdr_size, this->fd_) < ehdr_size)
-    gold_fatal(_("%s: error writing ELF header"), this->name_);
 }
 
-// Write a section header.
+// Write a section header at P.
 
 void
-Dwp_output_file::write_shdr(const char* name, unsigned int type,
-			    unsigned int flags, uint64_t addr, off_t offset,
+Dwp_output_file::write_shdr(unsigned char* p, const char* name,
+			    unsigned int type, unsigned int flags,
+			    uint64_t addr, off_t offset,
 			    section_size_type sect_size, unsigned int link,
 			    unsigned int info, unsigned int align,
 			    unsigned int ent_size)
@@ -2167,22 +2631,22 @@ Dwp_output_file::write_shdr(const char* name, unsigned int type,
   if (this->size_ == 32)
     {
       if (this->big_endian_)
-	return this->sized_write_shdr<32, true>(name, type, flags, addr,
+	return this->sized_write_shdr<32, true>(p, name, type, flags, addr,
 						offset, sect_size, link, info,
 						align, ent_size);
       else
-	return this->sized_write_shdr<32, false>(name, type, flags, addr,
+	return this->sized_write_shdr<32, false>(p, name, type, flags, addr,
 						 offset, sect_size, link, info,
 						 align, ent_size);
     }
   else if (this->size_ == 64)
     {
       if (this->big_endian_)
-	return this->sized_write_shdr<64, true>(name, type, flags, addr,
+	return this->sized_write_shdr<64, true>(p, name, type, flags, addr,
 						offset, sect_size, link, info,
 						align, ent_size);
       else
-	return this->sized_write_shdr<64, false>(name, type, flags, addr,
+	return this->sized_write_shdr<64, false>(p, name, type, flags, addr,
 						 offset, sect_size, link, info,
 						 align, ent_size);
     }
@@ -2192,15 +2656,14 @@ Dwp_output_file::write_shdr(const char* name, unsigned int type,
 
 template<unsigned int size, bool big_endian>
 void
-Dwp_output_file::sized_write_shdr(const char* name, unsigned int type,
-				  unsigned int flags, uint64_t addr,
-				  off_t offset, section_size_type sect_size,
+Dwp_output_file::sized_write_shdr(unsigned char* p, const char* name,
+				  unsigned int type, unsigned int flags,
+				  uint64_t addr, off_t offset,
+				  section_size_type sect_size,
 				  unsigned int link, unsigned int info,
 				  unsigned int align, unsigned int ent_size)
 {
-  const unsigned int shdr_size = elfcpp::Elf_sizes<size>::shdr_size;
-  unsigned char buf[shdr_size];
-  elfcpp::Shdr_write<size, big_endian> shdr(buf);
+  elfcpp::Shdr_write<size, big_endian> shdr(p);
 
   shdr.put_sh_name(name == NULL ? 0 : this->shstrtab_.get_offset(name));
   shdr.put_sh_type(type);
@@ -2212,8 +2675,6 @@ Dwp_output_file::sized_write_shdr(const char* name, unsigned int type,
   shdr.put_sh_info(info);
   shdr.put_sh_addralign(align);
   shdr.put_sh_entsize(ent_size);
-  if (::fwrite(buf, 1, shdr_size, this->fd_) < shdr_size)
-    gold_fatal(_("%s: error writing section header table"), this->name_);
 }
 
 // Class Dwo_name_info_reader.
@@ -2233,14 +2694,14 @@ Dwo_name_info_reader::visit_compilation_unit(off_t, off_t, Dwarf_die* die)
 
 // Class Unit_reader.
 
-// Read the CUs or TUs and add them to the output file.
+// Read the CUs or TUs and record them in DWO_FILE.
 
 void
-Unit_reader::add_units(Dwp_output_file* output_file,
+Unit_reader::add_units(Dwo_file* dwo_file,
 		       unsigned int debug_abbrev,
 		       Section_bounds* sections)
 {
-  this->output_file_ = output_file;
+  this->dwo_file_ = dwo_file;
   this->sections_ = sections;
   this->set_abbrev_shndx(debug_abbrev);
   this->parse();
@@ -2249,7 +2710,8 @@ Unit_reader::add_units(Dwp_output_file* output_file,
 // Visit a compilation unit.
 
 void
-Unit_reader::visit_compilation_unit(off_t, off_t cu_length, Dwarf_die* die)
+Unit_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
+				    Dwarf_die* die)
 {
   if (cu_length == 0)
     return;
@@ -2259,42 +2721,288 @@ Unit_reader::visit_compilation_unit(off_t, off_t cu_length, Dwarf_die* die)
   for (unsigned int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
     unit_set->sections[i] = this->sections_[i];
 
-  // Dwp_output_file::add_contribution writes the .debug_info.dwo section
-  // directly to the output file, so we do not need to duplicate the
-  // section contents, and add_contribution does not need to free the memory.
-  section_offset_type off =
-      this->output_file_->add_contribution(elfcpp::DW_SECT_INFO,
-					   this->buffer_at_offset(0),
-					   cu_length, 1);
-  Section_bounds bounds(off, cu_length);
+  // The contents of the unit are copied from the input file once the
+  // output file has been laid out.
+  Section_bounds bounds(cu_offset, cu_length);
   unit_set->sections[elfcpp::DW_SECT_INFO] = bounds;
-  this->output_file_->add_cu_set(unit_set);
+  this->dwo_file_->add_unit(unit_set, this->shndx_, cu_offset, false);
 }
 
-// Visit a type unit.
+// Visit a type unit.  Duplicate type units are dropped when the unit
+// sets are added to the output index.
 
 void
-Unit_reader::visit_type_unit(off_t, off_t tu_length, off_t,
+Unit_reader::visit_type_unit(off_t tu_offset, off_t tu_length, off_t,
 			     uint64_t signature, Dwarf_die*)
 {
   if (tu_length == 0)
     return;
-  if (this->output_file_->lookup_tu(signature))
-    return;
 
   Unit_set* unit_set = new Unit_set();
   unit_set->signature = signature;
   for (unsigned int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
     unit_set->sections[i] = this->sections_[i];
 
-  unsigned char* contents = new unsigned char[tu_length];
-  memcpy(contents, this->buffer_at_offset(0), tu_length);
-  section_offset_type off =
-      this->output_file_->add_contribution(elfcpp::DW_SECT_TYPES, contents,
-					   tu_length, 1);
-  Section_bounds bounds(off, tu_length);
+  Section_bounds bounds(tu_offset, tu_length);
   unit_set->sections[elfcpp::DW_SECT_TYPES] = bounds;
-  this->output_file_->add_tu_set(unit_set);
+  this->dwo_file_->add_unit(unit_set, this->shndx_, tu_offset, true);
+}
+
+// Class Dwo_file_task.
+
+// A task to read an input file, or to copy its contributions to the
+// output file.  The tasks for different files may run in parallel.
+
+class Dwo_file_task : public Task
+{
+ public:
+  enum Step
+  {
+    DWO_READ,
+    DWO_COPY
+  };
+
+  // THIS_BLOCKER may be NULL.  Neither blocker is owned by the task.
+  Dwo_file_task(Dwo_file* dwo_file, Dwp_output_file* output_file, Step step,
+		bool verbose, Task_token* this_blocker,
+		Task_token* next_blocker)
+    : dwo_file_(dwo_file), output_file_(output_file), step_(step),
+      verbose_(verbose), this_blocker_(this_blocker),
+      next_blocker_(next_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->next_blocker_); }
+
+  void
+  run(Workqueue*)
+  {
+    if (this->step_ == DWO_READ)
+      {
+	if (this->verbose_)
+	  fprintf(stderr, "%s\n", this->dwo_file_->name());
+	this->dwo_file_->read(this, this->output_file_);
+      }
+    else
+      this->dwo_file_->copy_contributions(this, this->output_file_);
+  }
+
+  std::string
+  get_name() const
+  {
+    return (std::string(this->step_ == DWO_READ
+			? "Dwo_file_task read "
+			: "Dwo_file_task copy ")
+	    + this->dwo_file_->name());
+  }
+
+ private:
+  Dwo_file* dwo_file_;
+  Dwp_output_file* output_file_;
+  Step step_;
+  bool verbose_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
+// Class Dwp_output_task.
+
+// A task to build or write part of the output file.  The string table,
+// the CU index and the TU index are built in parallel once all the
+// input files have been read, and are written in parallel with the
+// contributions of the input files.
+
+class Dwp_output_task : public Task
+{
+ public:
+  enum Step
+  {
+    DWP_MERGE_STRINGS,
+    DWP_CU_INDEX,
+    DWP_TU_INDEX,
+    DWP_LAYOUT,
+    DWP_WRITE_STRINGS,
+    DWP_WRITE_CU_INDEX,
+    DWP_WRITE_TU_INDEX,
+    DWP_FINALIZE
+  };
+
+  // THIS_BLOCKER and NEXT_BLOCKER may be NULL.  Neither blocker is
+  // owned by the task.
+  Dwp_output_task(Dwp_output_file* output_file,
+		  const std::vector<Dwo_file*>* dwo_files, Step step,
+		  Task_token* this_blocker, Task_token* next_blocker)
+    : output_file_(output_file), dwo_files_(dwo_files), step_(step),
+      this_blocker_(this_blocker), next_blocker_(next_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    if (this->next_blocker_ != NULL)
+      tl->add(this, this->next_blocker_);
+  }
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  {
+    static const char* const names[] =
+      { "merge strings", "cu index", "tu index", "layout", "write strings",
+	"write cu index", "write tu index", "finalize" };
+    return std::string("Dwp_output_task ") + names[this->step_];
+  }
+
+ private:
+  Dwp_output_file* output_file_;
+  const std::vector<Dwo_file*>* dwo_files_;
+  Step step_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
+void
+Dwp_output_task::run(Workqueue*)
+{
+  const std::vector<Dwo_file*>& dwo_files(*this->dwo_files_);
+  switch (this->step_)
+    {
+    case DWP_MERGE_STRINGS:
+      this->output_file_->merge_strings();
+      break;
+    case DWP_CU_INDEX:
+    case DWP_TU_INDEX:
+      for (size_t i = 0; i < dwo_files.size(); ++i)
+	dwo_files[i]->add_unit_sets(this->output_file_,
+				    this->step_ == DWP_TU_INDEX);
+      break;
+    case DWP_LAYOUT:
+      for (size_t i = 0; i < dwo_files.size(); ++i)
+	dwo_files[i]->add_contributions(this->output_file_);
+      this->output_file_->layout();
+      break;
+    case DWP_WRITE_STRINGS:
+      this->output_file_->write_strings();
+      break;
+    case DWP_WRITE_CU_INDEX:
+    case DWP_WRITE_TU_INDEX:
+      this->output_file_->write_unit_index(this->step_ == DWP_WRITE_TU_INDEX);
+      break;
+    case DWP_FINALIZE:
+      this->output_file_->finalize();
+      break;
+    default:
+      gold_unreachable();
+    }
+}
+
+// Read the input files FILES and write the package to OUTPUT_FILE.
+// The input files are read in parallel, recording what each file
+// contributes to the output file without keeping the contents.  Once
+// they have all been read, the string table and the CU and TU indexes
+// are built and the output file is laid out, in the same order as if
+// the files had been processed one at a time.  The contributions are
+// then copied from each input file straight into the output file.
+
+static void
+build_dwp(Workqueue* workqueue, Dwp_output_file* output_file,
+	  const File_list& files, bool verbose)
+{
+  std::vector<Dwo_file*> dwo_files;
+  dwo_files.reserve(files.size());
+  for (File_list::const_iterator f = files.begin(); f != files.end(); ++f)
+    dwo_files.push_back(new Dwo_file(f->dwo_name.c_str(), dwo_files.size()));
+  const size_t nfiles = dwo_files.size();
+
+  Task_token* read_blocker = new Task_token(true);
+  Task_token* index_blocker = new Task_token(true);
+  Task_token* layout_blocker = new Task_token(true);
+  Task_token* write_blocker = new Task_token(true);
+
+  for (size_t i = 0; i < nfiles; ++i)
+    {
+      read_blocker->add_blocker();
+      workqueue->queue(new Dwo_file_task(dwo_files[i], output_file,
+					 Dwo_file_task::DWO_READ, verbose,
+					 NULL, read_blocker));
+    }
+
+  static const Dwp_output_task::Step index_steps[] =
+    {
+      Dwp_output_task::DWP_MERGE_STRINGS,
+      Dwp_output_task::DWP_CU_INDEX,
+      Dwp_output_task::DWP_TU_INDEX
+    };
+  for (size_t i = 0; i < sizeof(index_steps) / sizeof(index_steps[0]); ++i)
+    {
+      index_blocker->add_blocker();
+      workqueue->queue(new Dwp_output_task(output_file, &dwo_files,
+					   index_steps[i], read_blocker,
+					   index_blocker));
+    }
+
+  layout_blocker->add_blocker();
+  workqueue->queue(new Dwp_output_task(output_file, &dwo_files,
+				       Dwp_output_task::DWP_LAYOUT,
+				       index_blocker, layout_blocker));
+
+  for (size_t i = 0; i < nfiles; ++i)
+    {
+      write_blocker->add_blocker();
+      workqueue->queue(new Dwo_file_task(dwo_files[i], output_file,
+					 Dwo_file_task::DWO_COPY, verbose,
+					 layout_blocker, write_blocker));
+    }
+
+  static const Dwp_output_task::Step write_steps[] =
+    {
+      Dwp_output_task::DWP_WRITE_STRINGS,
+      Dwp_output_task::DWP_WRITE_CU_INDEX,
+      Dwp_output_task::DWP_WRITE_TU_INDEX
+    };
+  for (size_t i = 0; i < sizeof(write_steps) / sizeof(write_steps[0]); ++i)
+    {
+      write_blocker->add_blocker();
+      workqueue->queue(new Dwp_output_task(output_file, &dwo_files,
+					   write_steps[i], layout_blocker,
+					   write_blocker));
+    }
+
+  workqueue->queue(new Dwp_output_task(output_file, &dwo_files,
+				       Dwp_output_task::DWP_FINALIZE,
+				       write_blocker, NULL));
+
+  workqueue->process(0);
+
+  for (size_t i = 0; i < nfiles; ++i)
+    delete dwo_files[i];
+  delete read_blocker;
+  delete index_blocker;
+  delete layout_blocker;
+  delete write_blocker;
 }
 
 }; // End namespace gold
@@ -2303,8 +3011,14 @@ using namespace gold;
 
 // Options.
 
+// The number of threads to use with --threads if no --thread-count
+// is given.
+static const size_t default_thread_count = 8;
+
 enum Dwp_options {
   VERIFY_ONLY = 0x101,
+  THREADS,
+  THREAD_COUNT
 };
 
 struct option dwp_options[] =
@@ -2312,6 +3026,8 @@ struct option dwp_options[] =
     { "exec", required_argument, NULL, 'e' },
     { "help", no_argument, NULL, 'h' },
     { "output", required_argument, NULL, 'o' },
+    { "threads", no_argument, NULL, THREADS },
+    { "thread-count", required_argument, NULL, THREAD_COUNT },
     { "verbose", no_argument, NULL, 'v' },
     { "verify-only", no_argument, NULL, VERIFY_ONLY },
     { "version", no_argument, NULL, 'V' },
@@ -2328,6 +3044,8 @@ usage(FILE* fd, int exit_status)
   fprintf(fd, _("  -e EXE, --exec EXE       Get list of dwo files from EXE"
 					   " (defaults output to EXE.dwp)\n"));
   fprintf(fd, _("  -o FILE, --output FILE   Set output dwp file name\n"));
+  fprintf(fd, _("  --threads                Run multi-threaded\n"));
+  fprintf(fd, _("  --thread-count COUNT     Number of threads to use\n"));
   fprintf(fd, _("  -v, --verbose            Verbose output\n"));
   fprintf(fd, _("  --verify-only            Verify output file against"
 					   " exec file\n"));
@@ -2391,6 +3109,8 @@ main(int argc, char** argv)
   const char* exe_filename = NULL;
   bool verbose = false;
   bool verify_only = false;
+  bool threads = false;
+  int thread_count = 0;
   int c;
   while ((c = getopt_long(argc, argv, "e:ho:vV", dwp_options, NULL)) != -1)
     {
@@ -2410,6 +3130,12 @@ main(int argc, char** argv)
 	  case VERIFY_ONLY:
 	    verify_only = true;
 	    break;
+	  case THREADS:
+	    threads = true;
+	    break;
+	  case THREAD_COUNT:
+	    gold::options::parse_uint("--thread-count", optarg, &thread_count);
+	    break;
 	  case 'V':
 	    print_version();
 	  case '?':
@@ -2449,16 +3175,30 @@ main(int argc, char** argv)
       return ok ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-  // Process each file, adding its contents to the output file.
-  Dwp_output_file output_file(output_filename.c_str());
-  for (File_list::const_iterator f = files.begin(); f != files.end(); ++f)
+  // An executable may not reference any .dwo files.
+  if (files.empty())
+    gold_fatal(_("%s: no .dwo files referenced"), exe_filename);
+
+  if (threads)
     {
-      if (verbose)
-	fprintf(stderr, "%s\n", f->dwo_name.c_str());
-      Dwo_file dwo_file(f->dwo_name.c_str());
-      dwo_file.read(&output_file);
+#ifdef ENABLE_THREADS
+      options.enable_threads(thread_count);
+#else
+      gold_warning(_("ignoring --threads: "
+		     "%s was compiled without thread support"),
+		   program_name);
+#endif
     }
-  output_file.finalize();
 
-  return EXIT_SUCCESS;
+  // Process each file, adding its contents to the output file.
+  Dwp_output_file output_file(output_filename.c_str());
+  Workqueue workqueue(options);
+  if (thread_count == 0)
+    thread_count = std::min(files.size(), default_thread_count);
+  workqueue.set_thread_count(thread_count);
+  build_dwp(&workqueue, &output_file, files, verbose);
+
+  // As in the linker, exit without destroying the workqueue, whose
+  // threads may still be waiting for work.
+  gold_exit(GOLD_OK);
 }
@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <cstring>
+#include <cmath>
 
 #include "elfcpp.h"
 #include "parameters.h"
@@ -900,6 +901,7 @@ Dynobj::elf_hash(const char* name)
 void
 Dynobj::create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
 			      unsigned int local_dynsym_count,
+			      bool cached_hashes,
 			      unsigned char** pphash,
 			      unsigned int* phashlen)
 {
@@ -907,8 +909,16 @@ Dynobj::create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
 
   // Get the hash values for all the symbols.
   std::vector<uint32_t> dynsym_hashvals(dynsym_count);
-  for (unsigned int i = 0; i < dynsym_count; ++i)
-    dynsym_hashvals[i] = Dynobj::elf_hash(dynsyms[i]->name());
+  if (cached_hashes)
+    {
+      for (unsigned int i = 0; i < dynsym_count; ++i)
+	dynsym_hashvals[i] = Stringpool::cached_elf_hash(dynsyms[i]->name());
+    }
+  else
+    {
+      for (unsigned int i = 0; i < dynsym_count; ++i)
+	dynsym_hashvals[i] = Dynobj::elf_hash(dynsyms[i]->name());
+    }
 
   const unsigned int bucketcount =
     Dynobj::compute_bucket_count(dynsym_hashvals, false);
@@ -1008,11 +1018,13 @@ Dynobj::gnu_hash(const char* name)
 // TARGET is the target.  DYNSYMS is a vector with all the global
 // symbols which will be going into the dynamic symbol table.
 // LOCAL_DYNSYM_COUNT is the number of local symbols in the dynamic
-// symbol table.
+// symbol table.  CACHED_HASHES is true if the names of DYNSYMS have
+// their hash codes stored by the Stringpool.
 
 void
 Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
 			      unsigned int local_dynsym_count,
+			      bool cached_hashes,
 			      unsigned char** pphash,
 			      unsigned int* phashlen)
 {
@@ -1045,7 +1057,9 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
       else
 	{
 	  hashed_dynsyms.push_back(sym);
-	  dynsym_hashvals.push_back(Dynobj::gnu_hash(sym->name()));
+	  dynsym_hashvals.push_back(cached_hashes
+				    ? Stringpool::cached_gnu_hash(sym->name())
+				    : Dynobj::gnu_hash(sym->name()));
 	}
     }
 
@@ -1121,6 +1135,29 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
     gold_unreachable();
 }
 
+// Return the log2 of the number of bits in the bloom filter of a GNU
+// hash table with NSYMS symbols, such that a name which is not in the
+// table passes the filter with a probability of about RATE.  Each
+// symbol sets two bits which a lookup tests, so with M bits the
+// probability is about (1 - e^(-2 * NSYMS / M))^2.
+
+uint32_t
+Dynobj::compute_bloom_maskbitslog2(unsigned int nsyms, double rate)
+{
+  gold_assert(rate > 0.0 && rate < 1.0);
+  const double bits = -2.0 * nsyms / log(1.0 - sqrt(rate));
+
+  // The second bit for each symbol is taken from the hash code
+  // shifted right by this value, so it must leave enough bits to
+  // choose a bit within a word.
+  const uint32_t max_maskbitslog2 = 26;
+
+  uint32_t ret = 5;
+  while (ret < max_maskbitslog2 && static_cast<double>(1U << ret) < bits)
+    ++ret;
+  return ret;
+}
+
 // Create the actual data for a GNU hash table.  This is just a copy
 // of the code from the old GNU linker.
 
@@ -1162,19 +1199,27 @@ Dynobj::sized_create_gnu_hash_table(
 
   const unsigned int nsyms = hashed_dynsyms.size();
 
-  uint32_t maskbitslog2 = 1;
-  uint32_t x = nsyms >> 1;
-  while (x != 0)
+  uint32_t maskbitslog2;
+  const double bloom_rate =
+    parameters->options().hash_bloom_false_positive_rate();
+  if (bloom_rate > 0.0)
+    maskbitslog2 = Dynobj::compute_bloom_maskbitslog2(nsyms, bloom_rate);
+  else
     {
-      ++maskbitslog2;
-      x >>= 1;
+      maskbitslog2 = 1;
+      uint32_t x = nsyms >> 1;
+      while (x != 0)
+	{
+	  ++maskbitslog2;
+	  x >>= 1;
+	}
+      if (maskbitslog2 < 3)
+	maskbitslog2 = 5;
+      else if (((1U << (maskbitslog2 - 2)) & nsyms) != 0)
+	maskbitslog2 += 3;
+      else
+	maskbitslog2 += 2;
     }
-  if (maskbitslog2 < 3)
-    maskbitslog2 = 5;
-  else if (((1U << (maskbitslog2 - 2)) & nsyms) != 0)
-    maskbitslog2 += 3;
-  else
-    maskbitslog2 += 2;
 
   uint32_t shift1;
   if (size == 32)
@@ -76,23 +76,30 @@ class Dynobj : public Object
   static uint32_t
   elf_hash(const char*);
 
+  // Compute the GNU hash code for a string.
+  static uint32_t
+  gnu_hash(const char*);
+
   // Create a standard ELF hash table, setting *PPHASH and *PHASHLEN.
   // DYNSYMS is the global dynamic symbols.  LOCAL_DYNSYM_COUNT is the
   // number of local dynamic symbols, which is the index of the first
-  // dynamic gobal symbol.
+  // dynamic gobal symbol.  CACHED_HASHES is true if the symbol names
+  // have their hash codes stored by the Stringpool.
   static void
   create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
 			unsigned int local_dynsym_count,
+			bool cached_hashes,
 			unsigned char** pphash,
 			unsigned int* phashlen);
 
   // Create a GNU hash table, setting *PPHASH and *PHASHLEN.  DYNSYMS
   // is the global dynamic symbols.  LOCAL_DYNSYM_COUNT is the number
   // of local dynamic symbols, which is the index of the first dynamic
-  // gobal symbol.
+  // gobal symbol.  CACHED_HASHES is as for create_elf_hash_table.
   static void
   create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
 			unsigned int local_dynsym_count,
+			bool cached_hashes,
 			unsigned char** pphash, unsigned int* phashlen);
 
  protected:
@@ -112,15 +119,16 @@ class Dynobj : public Object
   { this->needed_.push_back(std::string(s)); }
 
  private:
-  // Compute the GNU hash code for a string.
-  static uint32_t
-  gnu_hash(const char*);
-
   // Compute the number of hash buckets to use.
   static unsigned int
   compute_bucket_count(const std::vector<uint32_t>& hashcodes,
 		       bool for_gnu_hash_table);
 
+  // Compute the log2 of the size in bits of the GNU hash table bloom
+  // filter for a target false positive rate.
+  static uint32_t
+  compute_bloom_maskbitslog2(unsigned int nsyms, double rate);
+
   // Sized version of create_elf_hash_table.
   template<bool big_endian>
   static void
@@ -29,6 +29,7 @@
 #include "dwarf.h"
 #include "symtab.h"
 #include "reloc.h"
+#include "workqueue.h"
 #include "ehframe.h"
 
 namespace gold
@@ -76,6 +77,76 @@ namespace gold
 
 const int eh_frame_hdr_size = 4;
 
+// The number of FDEs whose addresses are read and sorted by one task
+// when sorting the table in parallel.
+
+const size_t fde_sort_chunk_size = 64 * 1024;
+
+// A task to sort the FDE addresses for the exception frame header.
+// The first task waits for the .eh_frame section to be relocated,
+// and then queues a task for each chunk of the FDEs.
+
+class Eh_frame_hdr_sort_task : public Task
+{
+ public:
+  // INPUT_BLOCKER is NULL for the chunk tasks.  Neither blocker is
+  // owned by the task.
+  Eh_frame_hdr_sort_task(Eh_frame_hdr* hdr, Output_file* of,
+			 unsigned int chunk, Task_token* input_blocker,
+			 Task_token* blocker)
+    : hdr_(hdr), of_(of), chunk_(chunk), input_blocker_(input_blocker),
+      blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->input_blocker_ != NULL && this->input_blocker_->is_blocked())
+      return this->input_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue* workqueue)
+  {
+    if (this->input_blocker_ == NULL)
+      {
+	this->hdr_->sort_chunk(this->of_, this->chunk_);
+	return;
+      }
+
+    unsigned int count = this->hdr_->prepare_sort_chunks();
+    workqueue->add_blockers(this->blocker_, count);
+    for (unsigned int i = 0; i < count; ++i)
+      workqueue->queue_soon(new Eh_frame_hdr_sort_task(this->hdr_, this->of_,
+						       i, NULL,
+						       this->blocker_));
+  }
+
+  std::string
+  get_name() const
+  {
+    if (this->input_blocker_ != NULL)
+      return "Eh_frame_hdr_sort_task";
+    char buf[32];
+    snprintf(buf, sizeof buf, " chunk %u", this->chunk_);
+    return std::string("Eh_frame_hdr_sort_task") + buf;
+  }
+
+ private:
+  Eh_frame_hdr* hdr_;
+  Output_file* of_;
+  unsigned int chunk_;
+  Task_token* input_blocker_;
+  Task_token* blocker_;
+};
+
 // Construct the exception frame header.
 
 Eh_frame_hdr::Eh_frame_hdr(Output_section* eh_frame_section,
@@ -84,6 +155,8 @@ Eh_frame_hdr::Eh_frame_hdr(Output_section* eh_frame_section,
     eh_frame_section_(eh_frame_section),
     eh_frame_data_(eh_frame_data),
     fde_offsets_(),
+    fde_addresses_(),
+    sort_chunk_count_(0),
     any_unrecognized_eh_frame_sections_(false)
 {
 }
@@ -136,6 +209,93 @@ Eh_frame_hdr::do_write(Output_file* of)
     }
 }
 
+// Queue the tasks to sort the FDE addresses.
+
+void
+Eh_frame_hdr::queue_sort_tasks(Workqueue* workqueue, Output_file* of,
+			       Task_token* input_blocker, Task_token* blocker)
+{
+  gold_assert(this->sort_chunk_count_ == 0);
+  blocker->add_blocker();
+  workqueue->queue(new Eh_frame_hdr_sort_task(this, of, 0, input_blocker,
+					      blocker));
+}
+
+// Split the FDEs into chunks to sort.  This is called after the
+// .eh_frame section has been written and relocated, so all the FDEs
+// have been recorded.  Return the number of chunks.
+
+unsigned int
+Eh_frame_hdr::prepare_sort_chunks()
+{
+  gold_assert(this->sort_chunk_count_ == 0);
+  if (this->any_unrecognized_eh_frame_sections_
+      || this->fde_offsets_.empty())
+    return 0;
+
+  size_t count = this->fde_offsets_.size();
+  this->fde_addresses_.resize(count);
+  this->sort_chunk_count_ = ((count + fde_sort_chunk_size - 1)
+			     / fde_sort_chunk_size);
+  return this->sort_chunk_count_;
+}
+
+// Read and sort the FDE addresses in chunk I.  Chunks are sorted in
+// parallel by different tasks.
+
+void
+Eh_frame_hdr::sort_chunk(Output_file* of, unsigned int i)
+{
+  gold_assert(i < this->sort_chunk_count_);
+  size_t start = i * fde_sort_chunk_size;
+  size_t end = std::min(start + fde_sort_chunk_size,
+			this->fde_addresses_.size());
+  switch (parameters->size_and_endianness())
+    {
+#ifdef HAVE_TARGET_32_LITTLE
+    case Parameters::TARGET_32_LITTLE:
+      this->get_fde_addresses<32, false>(of, start, end);
+      break;
+#endif
+#ifdef HAVE_TARGET_32_BIG
+    case Parameters::TARGET_32_BIG:
+      this->get_fde_addresses<32, true>(of, start, end);
+      break;
+#endif
+#ifdef HAVE_TARGET_64_LITTLE
+    case Parameters::TARGET_64_LITTLE:
+      this->get_fde_addresses<64, false>(of, start, end);
+      break;
+#endif
+#ifdef HAVE_TARGET_64_BIG
+    case Parameters::TARGET_64_BIG:
+      this->get_fde_addresses<64, true>(of, start, end);
+      break;
+#endif
+    default:
+      gold_unreachable();
+    }
+}
+
+// Merge the chunks sorted by the sort tasks into a single sorted
+// list.
+
+void
+Eh_frame_hdr::merge_sort_chunks()
+{
+  size_t count = this->fde_addresses_.size();
+  Fde_addresses::iterator begin = this->fde_addresses_.begin();
+  for (size_t width = fde_sort_chunk_size; width < count; width *= 2)
+    {
+      for (size_t start = 0; start + width < count; start += 2 * width)
+	{
+	  size_t end = std::min(start + 2 * width, count);
+	  std::inplace_merge(begin + start, begin + start + width,
+			     begin + end, Fde_address_compare());
+	}
+    }
+}
+
 // Write the data to the file with the right endianness.
 
 template<int size, bool big_endian>
@@ -182,21 +342,25 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
       // relocations which are, of course, target specific.  This code
       // is run after all those relocations have been applied to the
       // output file.  Here we read the output file again to find the
-      // PC values.  Then we sort the list and write it out.
-
-      Fde_addresses<size> fde_addresses(this->fde_offsets_.size());
-      this->get_fde_addresses<size, big_endian>(of, &this->fde_offsets_,
-						&fde_addresses);
+      // PC values.  Then we sort the list and write it out.  If we
+      // are using the sort tasks, they have already read and sorted
+      // the list in chunks, and we only need to merge them.
 
-      std::sort(fde_addresses.begin(), fde_addresses.end(),
-		Fde_address_compare<size>());
+      if (this->sort_chunk_count_ == 0)
+	{
+	  this->fde_addresses_.resize(this->fde_offsets_.size());
+	  this->get_fde_addresses<size, big_endian>(of, 0,
+						    this->fde_offsets_.size());
+	}
+      else
+	this->merge_sort_chunks();
 
       typename elfcpp::Elf_types<size>::Elf_Addr output_address;
       output_address = this->address();
 
       unsigned char* pfde = oview + 12;
-      for (typename Fde_addresses<size>::iterator p = fde_addresses.begin();
-	   p != fde_addresses.end();
+      for (Fde_addresses::const_iterator p = this->fde_addresses_.begin();
+	   p != this->fde_addresses_.end();
 	   ++p)
 	{
 	  elfcpp::Swap<32, big_endian>::writeval(pfde,
@@ -207,6 +371,8 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
 	}
 
       gold_assert(pfde - oview == oview_size);
+
+      Fde_addresses().swap(this->fde_addresses_);
     }
 
   of->write_output_view(off, oview_size, oview);
@@ -290,18 +456,18 @@ Eh_frame_hdr::get_fde_pc(
   return pc;
 }
 
-// Given an array of FDE offsets in the .eh_frame section, return an
-// array of offsets from the exception frame header to the FDE's
-// output PC and to the output address of the FDE itself.  We get the
-// FDE's PC by actually looking in the .eh_frame section we just wrote
-// to the output file.
+// Given the FDE offsets in the .eh_frame section from START to END,
+// set the corresponding entries in fde_addresses_ to the FDE's output
+// PC and the output address of the FDE itself, and sort them.  We get
+// the FDE's PC by actually looking in the .eh_frame section we just
+// wrote to the output file.
 
 template<int size, bool big_endian>
 void
-Eh_frame_hdr::get_fde_addresses(Output_file* of,
-				const Fde_offsets* fde_offsets,
-				Fde_addresses<size>* fde_addresses)
+Eh_frame_hdr::get_fde_addresses(Output_file* of, size_t start, size_t end)
 {
+  gold_assert(end <= this->fde_addresses_.size());
+
   typename elfcpp::Elf_types<size>::Elf_Addr eh_frame_address;
   eh_frame_address = this->eh_frame_section_->address();
   off_t eh_frame_offset = this->eh_frame_section_->offset();
@@ -309,18 +475,23 @@ Eh_frame_hdr::get_fde_addresses(Output_file* of,
   const unsigned char* eh_frame_contents = of->get_input_view(eh_frame_offset,
 							      eh_frame_size);
 
-  for (Fde_offsets::const_iterator p = fde_offsets->begin();
-       p != fde_offsets->end();
-       ++p)
+  for (size_t i = start; i < end; ++i)
     {
+      const Fde_offset& fo(this->fde_offsets_[i]);
       typename elfcpp::Elf_types<size>::Elf_Addr fde_pc;
       fde_pc = this->get_fde_pc<size, big_endian>(eh_frame_address,
 						  eh_frame_contents,
-						  p->first, p->second);
-      fde_addresses->push_back(fde_pc, eh_frame_address + p->first);
+						  fo.first, fo.second);
+      typename elfcpp::Elf_types<size>::Elf_Addr fde_address;
+      fde_address = eh_frame_address + fo.first;
+      this->fde_addresses_[i] = std::make_pair(fde_pc, fde_address);
     }
 
   of->free_input_view(eh_frame_offset, eh_frame_size, eh_frame_contents);
+
+  std::sort(this->fde_addresses_.begin() + start,
+	    this->fde_addresses_.begin() + end,
+	    Fde_address_compare());
 }
 
 // Class Fde.
@@ -521,6 +692,22 @@ operator<(const Cie& cie1, const Cie& cie2)
   return cie1.contents_ < cie2.contents_;
 }
 
+// Class Parsed_eh_frame.
+
+// Delete any CIEs and FDEs which were not added to the output
+// section.
+
+Parsed_eh_frame::~Parsed_eh_frame()
+{
+  for (Entries::iterator p = this->entries_.begin();
+       p != this->entries_.end();
+       ++p)
+    {
+      delete p->cie;
+      delete p->fde;
+    }
+}
+
 // Class Eh_frame.
 
 Eh_frame::Eh_frame()
@@ -561,7 +748,8 @@ Eh_frame::skip_leb128(const unsigned char** pp, const unsigned char* pend)
 // SHT_REL or SHT_RELA.  We try to parse the input exception frame
 // data into our data structures.  If we can't do it, we return false
 // to mean that the section should be handled as a normal input
-// section.
+// section.  If OBJECT parsed the section when reading its symbols,
+// we use that instead of parsing it here.
 
 template<int size, bool big_endian>
 bool
@@ -575,40 +763,160 @@ Eh_frame::add_ehframe_input_section(
     unsigned int reloc_shndx,
     unsigned int reloc_type)
 {
+  Parsed_eh_frame* parsed = object->parsed_eh_frame(shndx);
+  if (parsed != NULL)
+    return this->add_parsed_eh_frame(object, parsed);
+
+  Parsed_eh_frame local_parsed(shndx);
+  Eh_frame::parse_ehframe_input_section(object, symbols, symbols_size,
+					symbol_names, symbol_names_size,
+					shndx, reloc_shndx, reloc_type,
+					&local_parsed);
+  return this->add_parsed_eh_frame(object, &local_parsed);
+}
+
+// Parse input section SHNDX in OBJECT into PARSED.  This only looks
+// at OBJECT, so it may be run in parallel for different objects.
+
+template<int size, bool big_endian>
+void
+Eh_frame::parse_ehframe_input_section(
+    Sized_relobj_file<size, big_endian>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame* parsed)
+{
+  gold_assert(parsed->shndx_ == shndx && parsed->entries_.empty());
+
   // Get the section contents.
   section_size_type contents_len;
   const unsigned char* pcontents = object->section_contents(shndx,
 							    &contents_len,
 							    false);
   if (contents_len == 0)
-    return false;
+    {
+      parsed->status_ = Parsed_eh_frame::EH_FRAME_EMPTY;
+      return;
+    }
 
   // If this is the marker section for the end of the data, then
-  // return false to force it to be handled as an ordinary input
-  // section.  If we don't do this, we won't correctly handle the case
-  // of unrecognized .eh_frame sections.
+  // force it to be handled as an ordinary input section.  If we don't
+  // do this, we won't correctly handle the case of unrecognized
+  // .eh_frame sections.
   if (contents_len == 4
       && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
-    return false;
+    {
+      parsed->status_ = Parsed_eh_frame::EH_FRAME_EMPTY;
+      return;
+    }
 
-  New_cies new_cies;
-  if (!this->do_add_ehframe_input_section(object, symbols, symbols_size,
-					  symbol_names, symbol_names_size,
-					  shndx, reloc_shndx,
-					  reloc_type, pcontents,
-					  contents_len, &new_cies))
+  if (!Eh_frame::do_parse_ehframe_input_section(object, symbols,
+						symbols_size, symbol_names,
+						symbol_names_size, shndx,
+						reloc_shndx, reloc_type,
+						pcontents, contents_len,
+						&parsed->entries_))
     {
-      if (this->eh_frame_hdr_ != NULL)
-	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
+      parsed->status_ = Parsed_eh_frame::EH_FRAME_UNRECOGNIZED;
+      return;
+    }
 
-      for (New_cies::iterator p = new_cies.begin();
-	   p != new_cies.end();
-	   ++p)
-	delete p->first;
+  parsed->status_ = Parsed_eh_frame::EH_FRAME_PARSED;
+}
+
+// Merge the CIEs and FDEs in PARSED into the output section.  This
+// is where we discard duplicate CIEs, and FDEs for sections which
+// are not included in the link, so it must be called during layout.
+// The CIEs and FDEs which we keep are removed from PARSED.
 
+bool
+Eh_frame::add_parsed_eh_frame(Relobj* object, Parsed_eh_frame* parsed)
+{
+  if (parsed->status_ != Parsed_eh_frame::EH_FRAME_PARSED)
+    {
+      if (parsed->status_ == Parsed_eh_frame::EH_FRAME_UNRECOGNIZED
+	  && this->eh_frame_hdr_ != NULL)
+	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
       return false;
     }
 
+  unsigned int shndx = parsed->shndx_;
+  Parsed_eh_frame::Entries* entries = &parsed->entries_;
+
+  // The CIE to use for each CIE entry.
+  std::vector<Cie*> cies(entries->size(), NULL);
+
+  New_cies new_cies;
+  for (unsigned int i = 0; i < entries->size(); ++i)
+    {
+      Parsed_eh_frame::Entry* pe = &(*entries)[i];
+      if (pe->cie != NULL)
+	{
+	  Cie* cie_pointer = NULL;
+	  if (pe->mergeable)
+	    {
+	      Cie_offsets::iterator find_cie = this->cie_offsets_.find(pe->cie);
+	      if (find_cie != this->cie_offsets_.end())
+		cie_pointer = *find_cie;
+	      else
+		{
+		  // See if we already saw this CIE in this object file.
+		  for (New_cies::const_iterator pc = new_cies.begin();
+		       pc != new_cies.end();
+		       ++pc)
+		    {
+		      if (*(pc->first) == *pe->cie)
+			{
+			  cie_pointer = pc->first;
+			  break;
+			}
+		    }
+		}
+	    }
+
+	  if (cie_pointer == NULL)
+	    {
+	      cie_pointer = pe->cie;
+	      new_cies.push_back(std::make_pair(cie_pointer, pe->mergeable));
+	    }
+	  else
+	    {
+	      // We are deleting this CIE.  Record that in our mapping
+	      // from input sections to the output section.  At this
+	      // point we don't know for sure that we are doing a
+	      // special mapping for this input section, but that's
+	      // OK--if we don't do a special mapping, nobody will
+	      // ever ask for the mapping we add here.
+	      this->merge_map_.add_mapping(object, shndx, pe->offset,
+					   pe->length, -1);
+	      delete pe->cie;
+	    }
+	  pe->cie = NULL;
+	  cies[i] = cie_pointer;
+	}
+      else
+	{
+	  gold_assert(pe->fde != NULL && cies[pe->cie_index] != NULL);
+	  if (pe->fde_shndx != 0
+	      && !object->is_section_included(pe->fde_shndx))
+	    {
+	      // This FDE applies to a section which we are discarding.
+	      // We can discard this FDE.
+	      this->merge_map_.add_mapping(object, shndx, pe->offset,
+					   pe->length, -1);
+	      delete pe->fde;
+	    }
+	  else
+	    cies[pe->cie_index]->add_fde(pe->fde);
+	  pe->fde = NULL;
+	}
+    }
+
   // Now that we know we are using this section, record any new CIEs
   // that we found.
   for (New_cies::const_iterator p = new_cies.begin();
@@ -624,11 +932,11 @@ Eh_frame::add_ehframe_input_section(
   return true;
 }
 
-// The bulk of the implementation of add_ehframe_input_section.
+// The bulk of the implementation of parse_ehframe_input_section.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::do_add_ehframe_input_section(
+Eh_frame::do_parse_ehframe_input_section(
     Sized_relobj_file<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
@@ -639,7 +947,7 @@ Eh_frame::do_add_ehframe_input_section(
     unsigned int reloc_type,
     const unsigned char* pcontents,
     section_size_type contents_len,
-    New_cies* new_cies)
+    Parsed_eh_frame::Entries* entries)
 {
   Track_relocs<size, big_endian> relocs;
 
@@ -691,17 +999,18 @@ Eh_frame::do_add_ehframe_input_section(
       if (id == 0)
 	{
 	  // CIE.
-	  if (!this->read_cie(object, shndx, symbols, symbols_size,
-			      symbol_names, symbol_names_size,
-			      pcontents, p, pentend, &relocs, &cies,
-			      new_cies))
+	  if (!Eh_frame::read_cie(object, shndx, symbols, symbols_size,
+				  symbol_names, symbol_names_size,
+				  pcontents, p, pentend, &relocs, &cies,
+				  entries))
 	    return false;
 	}
       else
 	{
 	  // FDE.
-	  if (!this->read_fde(object, shndx, symbols, symbols_size,
-			      pcontents, id, p, pentend, &relocs, &cies))
+	  if (!Eh_frame::read_fde(object, shndx, symbols, symbols_size,
+				  pcontents, id, p, pentend, &relocs, &cies,
+				  entries))
 	    return false;
 	}
 
@@ -726,7 +1035,7 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pcieend,
 		   Track_relocs<size, big_endian>* relocs,
 		   Offsets_to_cie* cies,
-		   New_cies* new_cies)
+		   Parsed_eh_frame::Entries* entries)
 {
   bool mergeable = true;
 
@@ -919,48 +1228,19 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
   if (relocs->advance(pcieend - pcontents) > 0)
     return false;
 
-  Cie cie(object, shndx, (pcie - 8) - pcontents, fde_encoding, 
-	  personality_name, pcie, pcieend - pcie);
-  Cie* cie_pointer = NULL;
-  if (mergeable)
-    {
-      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
-      if (find_cie != this->cie_offsets_.end())
-	cie_pointer = *find_cie;
-      else
-	{
-	  // See if we already saw this CIE in this object file.
-	  for (New_cies::const_iterator pc = new_cies->begin();
-	       pc != new_cies->end();
-	       ++pc)
-	    {
-	      if (*(pc->first) == cie)
-		{
-		  cie_pointer = pc->first;
-		  break;
-		}
-	    }
-	}
-    }
-
-  if (cie_pointer == NULL)
-    {
-      cie_pointer = new Cie(cie);
-      new_cies->push_back(std::make_pair(cie_pointer, mergeable));
-    }
-  else
-    {
-      // We are deleting this CIE.  Record that in our mapping from
-      // input sections to the output section.  At this point we don't
-      // know for sure that we are doing a special mapping for this
-      // input section, but that's OK--if we don't do a special
-      // mapping, nobody will ever ask for the mapping we add here.
-      this->merge_map_.add_mapping(object, shndx, (pcie - 8) - pcontents,
-				   pcieend - (pcie - 8), -1);
-    }
-
-  // Record this CIE plus the offset in the input section.
-  cies->insert(std::make_pair(pcie - pcontents, cie_pointer));
+  // Record this CIE plus the offset in the input section.  Whether
+  // it is merged with another CIE is decided during layout.
+  Parsed_eh_frame::Entry entry;
+  entry.cie = new Cie(object, shndx, (pcie - 8) - pcontents, fde_encoding,
+		      personality_name, pcie, pcieend - pcie);
+  entry.fde = NULL;
+  entry.mergeable = mergeable;
+  entry.cie_index = 0;
+  entry.fde_shndx = 0;
+  entry.offset = (pcie - 8) - pcontents;
+  entry.length = pcieend - (pcie - 8);
+  cies->insert(std::make_pair(pcie - pcontents, entries->size()));
+  entries->push_back(entry);
 
   return true;
 }
@@ -978,7 +1258,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pfde,
 		   const unsigned char* pfdeend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies)
+		   Offsets_to_cie* cies,
+		   Parsed_eh_frame::Entries* entries)
 {
   // OFFSET is the distance between the 4 bytes before PFDE to the
   // start of the CIE.  The offset we recorded for the CIE is 8 bytes
@@ -987,7 +1268,6 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   Offsets_to_cie::const_iterator pcie = cies->find(cie_offset);
   if (pcie == cies->end())
     return false;
-  Cie* cie = pcie->second;
 
   // The FDE should start with a reloc to the start of the code which
   // it describes.
@@ -1016,20 +1296,22 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   fde_shndx = object->adjust_sym_shndx(symndx, sym.get_st_shndx(),
 				       &is_ordinary);
 
-  if (is_ordinary
-      && fde_shndx != elfcpp::SHN_UNDEF
-      && fde_shndx < object->shnum()
-      && !object->is_section_included(fde_shndx))
-    {
-      // This FDE applies to a section which we are discarding.  We
-      // can discard this FDE.
-      this->merge_map_.add_mapping(object, shndx, (pfde - 8) - pcontents,
-				   pfdeend - (pfde - 8), -1);
-      return true;
-    }
-
-  cie->add_fde(new Fde(object, shndx, (pfde - 8) - pcontents,
-		       pfde, pfdeend - pfde));
+  // We don't know yet whether FDE_SHNDX is being discarded, so we
+  // record it and let add_parsed_eh_frame decide whether to discard
+  // this FDE.
+  if (!is_ordinary || fde_shndx >= object->shnum())
+    fde_shndx = 0;
+
+  Parsed_eh_frame::Entry entry;
+  entry.cie = NULL;
+  entry.fde = new Fde(object, shndx, (pfde - 8) - pcontents,
+		      pfde, pfdeend - pfde);
+  entry.mergeable = false;
+  entry.cie_index = pcie->second;
+  entry.fde_shndx = fde_shndx;
+  entry.offset = (pfde - 8) - pcontents;
+  entry.length = pfdeend - (pfde - 8);
+  entries->push_back(entry);
 
   return true;
 }
@@ -1216,6 +1498,19 @@ Eh_frame::add_ehframe_input_section<32, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<32, false>(
+    Sized_relobj_file<32, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame* parsed);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -1230,6 +1525,19 @@ Eh_frame::add_ehframe_input_section<32, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<32, true>(
+    Sized_relobj_file<32, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame* parsed);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -1244,6 +1552,19 @@ Eh_frame::add_ehframe_input_section<64, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<64, false>(
+    Sized_relobj_file<64, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame* parsed);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -1258,6 +1579,19 @@ Eh_frame::add_ehframe_input_section<64, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<64, true>(
+    Sized_relobj_file<64, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame* parsed);
 #endif
 
 } // End namespace gold.
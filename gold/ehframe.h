@@ -37,6 +37,8 @@ template<int size, bool big_endian>
 class Track_relocs;
 
 class Eh_frame;
+class Workqueue;
+class Task_token;
 
 // This class manages the .eh_frame_hdr section, which holds the data
 // for the PT_GNU_EH_FRAME segment.  gcc's unwind support code uses
@@ -63,6 +65,24 @@ class Eh_frame_hdr : public Output_section_data
       this->fde_offsets_.push_back(std::make_pair(fde_offset, fde_encoding));
   }
 
+  // Queue tasks to read and sort the FDE addresses in parallel.  The
+  // tasks run when INPUT_BLOCKER is unblocked, after the .eh_frame
+  // section has been relocated.  BLOCKER is unblocked when they are
+  // all done.
+  void
+  queue_sort_tasks(Workqueue*, Output_file*, Task_token* input_blocker,
+		   Task_token* blocker);
+
+  // Read the FDE addresses for the FDEs in chunk I, and sort them.
+  // This is called by the sort tasks.
+  void
+  sort_chunk(Output_file*, unsigned int i);
+
+  // Prepare to sort the FDE addresses in chunks.  This is called by
+  // the first sort task, and returns the number of chunks.
+  unsigned int
+  prepare_sort_chunks();
+
  protected:
   // Set the final data size.
   void
@@ -91,47 +111,25 @@ class Eh_frame_hdr : public Output_section_data
   typedef std::vector<Fde_offset> Fde_offsets;
 
   // When writing out the header, we convert the FDE offsets into FDE
-  // addresses.  This is a list of pairs of the offset from the header
-  // to the FDE PC and to the FDE itself.
-  template<int size>
-  class Fde_addresses
-  {
-   public:
-    typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
-    typedef typename std::pair<Address, Address> Fde_address;
-    typedef typename std::vector<Fde_address> Fde_address_list;
-    typedef typename Fde_address_list::iterator iterator;
-
-    Fde_addresses(unsigned int reserve)
-      : fde_addresses_()
-    { this->fde_addresses_.reserve(reserve); }
-
-    void
-    push_back(Address pc_address, Address fde_address)
-    {
-      this->fde_addresses_.push_back(std::make_pair(pc_address, fde_address));
-    }
-
-    iterator
-    begin()
-    { return this->fde_addresses_.begin(); }
-
-    iterator
-    end()
-    { return this->fde_addresses_.end(); }
-
-   private:
-    Fde_address_list fde_addresses_;
-  };
-
-  // Compare Fde_address objects.
-  template<int size>
+  // addresses.  This is a list of pairs of the FDE PC and the address
+  // of the FDE itself.  We use 64 bits for both sizes, so that the
+  // list can be built by the sort tasks before we know which size
+  // we are writing.
+  typedef std::pair<uint64_t, uint64_t> Fde_address;
+  typedef std::vector<Fde_address> Fde_addresses;
+
+  // Compare Fde_address objects.  Two FDEs for the same PC are
+  // ordered by address, so that the result does not depend on how
+  // the list was split for sorting.
   struct Fde_address_compare
   {
     bool
-    operator()(const typename Fde_addresses<size>::Fde_address& f1,
-	       const typename Fde_addresses<size>::Fde_address& f2) const
-    { return f1.first < f2.first; }
+    operator()(const Fde_address& f1, const Fde_address& f2) const
+    {
+      if (f1.first != f2.first)
+	return f1.first < f2.first;
+      return f1.second < f2.second;
+    }
   };
 
   // Return the PC to which an FDE refers.
@@ -141,12 +139,15 @@ class Eh_frame_hdr : public Output_section_data
 	     const unsigned char* eh_frame_contents,
 	     section_offset_type fde_offset, unsigned char fde_encoding);
 
-  // Convert Fde_offsets to Fde_addresses.
+  // Convert the Fde_offsets from START to END to Fde_addresses, and
+  // sort them.
   template<int size, bool big_endian>
   void
-  get_fde_addresses(Output_file* of,
-		    const Fde_offsets* fde_offsets,
-		    Fde_addresses<size>* fde_addresses);
+  get_fde_addresses(Output_file* of, size_t start, size_t end);
+
+  // Merge the sorted chunks of fde_addresses_.
+  void
+  merge_sort_chunks();
 
   // The .eh_frame section.
   Output_section* eh_frame_section_;
@@ -154,6 +155,11 @@ class Eh_frame_hdr : public Output_section_data
   const Eh_frame* eh_frame_data_;
   // Data from the FDEs in the .eh_frame sections.
   Fde_offsets fde_offsets_;
+  // The FDE addresses, built when writing out the header.
+  Fde_addresses fde_addresses_;
+  // The number of chunks in fde_addresses_ which have been sorted
+  // by tasks; 0 if the sort tasks were not used.
+  unsigned int sort_chunk_count_;
   // Whether we found any .eh_frame sections which we could not
   // process.
   bool any_unrecognized_eh_frame_sections_;
@@ -351,6 +357,75 @@ class Cie
 extern bool operator<(const Cie&, const Cie&);
 extern bool operator==(const Cie&, const Cie&);
 
+// The CIEs and FDEs read from an input .eh_frame section.  If
+// possible the section is parsed by the Read_symbols task for the
+// object, so that the sections of different objects are parsed in
+// parallel.  Eh_frame::add_ehframe_input_section then merges the
+// CIEs and drops the FDEs for discarded sections during layout.
+
+class Parsed_eh_frame
+{
+ public:
+  Parsed_eh_frame(unsigned int shndx)
+    : shndx_(shndx), status_(EH_FRAME_EMPTY), entries_()
+  { }
+
+  ~Parsed_eh_frame();
+
+  // The input section index.
+  unsigned int
+  shndx() const
+  { return this->shndx_; }
+
+ private:
+  friend class Eh_frame;
+
+  // The class is not copyable.
+  Parsed_eh_frame(const Parsed_eh_frame&);
+  Parsed_eh_frame& operator=(const Parsed_eh_frame&);
+
+  // The result of parsing the section.
+  enum Status
+  {
+    // The section is empty, or is the end marker.  It should be
+    // handled as an ordinary input section.
+    EH_FRAME_EMPTY,
+    // We could not parse the section.
+    EH_FRAME_UNRECOGNIZED,
+    // We parsed the section.
+    EH_FRAME_PARSED
+  };
+
+  // A CIE or an FDE, in the order they appear in the section.
+  struct Entry
+  {
+    // The CIE, or NULL for an FDE.
+    Cie* cie;
+    // The FDE, or NULL for a CIE.
+    Fde* fde;
+    // For a CIE, whether it may be merged with other CIEs.
+    bool mergeable;
+    // For an FDE, the index of the entry for its CIE.
+    unsigned int cie_index;
+    // For an FDE, the index of the section to which it applies, or 0
+    // if it does not apply to an ordinary section.
+    unsigned int fde_shndx;
+    // The offset and length of the entry in the input section.
+    section_offset_type offset;
+    section_size_type length;
+  };
+
+  typedef std::vector<Entry> Entries;
+
+  // The input section index.
+  unsigned int shndx_;
+  // The result of parsing the section.
+  Status status_;
+  // The CIEs and FDEs.  Any which are left here when this is
+  // deleted are deleted with it.
+  Entries entries_;
+};
+
 // This class manages .eh_frame sections.  It discards duplicate
 // exception information.
 
@@ -364,13 +439,34 @@ class Eh_frame : public Output_section_data
   set_eh_frame_hdr(Eh_frame_hdr* hdr)
   { this->eh_frame_hdr_ = hdr; }
 
+  // Return the associated Eh_frame_hdr, or NULL.
+  Eh_frame_hdr*
+  eh_frame_hdr() const
+  { return this->eh_frame_hdr_; }
+
+  // Parse the input section SHNDX in OBJECT into PARSED, without
+  // reference to any other input section.  This may be called by
+  // several threads at once for different objects.  The arguments
+  // are as for add_ehframe_input_section.
+  template<int size, bool big_endian>
+  static void
+  parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+			      const unsigned char* symbols,
+			      section_size_type symbols_size,
+			      const unsigned char* symbol_names,
+			      section_size_type symbol_names_size,
+			      unsigned int shndx, unsigned int reloc_shndx,
+			      unsigned int reloc_type,
+			      Parsed_eh_frame* parsed);
+
   // Add the input section SHNDX in OBJECT.  SYMBOLS is the contents
   // of the symbol table section (size SYMBOLS_SIZE), SYMBOL_NAMES is
   // the symbol names section (size SYMBOL_NAMES_SIZE).  RELOC_SHNDX
   // is the relocation section if any (0 for none, -1U for multiple).
-  // RELOC_TYPE is the type of the relocation section if any.  This
-  // returns whether the section was incorporated into the .eh_frame
-  // data.
+  // RELOC_TYPE is the type of the relocation section if any.  If
+  // OBJECT has already parsed the section, the arguments other than
+  // OBJECT and SHNDX are not used.  This returns whether the section
+  // was incorporated into the .eh_frame data.
   template<int size, bool big_endian>
   bool
   add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
@@ -433,9 +529,9 @@ class Eh_frame : public Output_section_data
   // A list of unmergeable CIEs.
   typedef std::vector<Cie*> Unmergeable_cie_offsets;
 
-  // A mapping from offsets to CIEs.  This is used while reading an
-  // input section.
-  typedef std::map<uint64_t, Cie*> Offsets_to_cie;
+  // A mapping from offsets to the index of the entry for a CIE in a
+  // Parsed_eh_frame.  This is used while reading an input section.
+  typedef std::map<uint64_t, unsigned int> Offsets_to_cie;
 
   // A list of CIEs, and a bool indicating whether the CIE is
   // mergeable.
@@ -445,24 +541,24 @@ class Eh_frame : public Output_section_data
   static bool
   skip_leb128(const unsigned char**, const unsigned char*);
 
-  // The implementation of add_ehframe_input_section.
+  // The implementation of parse_ehframe_input_section.
   template<int size, bool big_endian>
-  bool
-  do_add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
-			       const unsigned char* symbols,
-			       section_size_type symbols_size,
-			       const unsigned char* symbol_names,
-			       section_size_type symbol_names_size,
-			       unsigned int shndx,
-			       unsigned int reloc_shndx,
-			       unsigned int reloc_type,
-			       const unsigned char* pcontents,
-			       section_size_type contents_len,
-			       New_cies*);
+  static bool
+  do_parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+				 const unsigned char* symbols,
+				 section_size_type symbols_size,
+				 const unsigned char* symbol_names,
+				 section_size_type symbol_names_size,
+				 unsigned int shndx,
+				 unsigned int reloc_shndx,
+				 unsigned int reloc_type,
+				 const unsigned char* pcontents,
+				 section_size_type contents_len,
+				 Parsed_eh_frame::Entries*);
 
   // Read a CIE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_cie(Sized_relobj_file<size, big_endian>* object,
 	   unsigned int shndx,
 	   const unsigned char* symbols,
@@ -474,11 +570,11 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pcieend,
 	   Track_relocs<size, big_endian>* relocs,
 	   Offsets_to_cie* cies,
-	   New_cies* new_cies);
+	   Parsed_eh_frame::Entries* entries);
 
   // Read an FDE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_fde(Sized_relobj_file<size, big_endian>* object,
 	   unsigned int shndx,
 	   const unsigned char* symbols,
@@ -488,7 +584,13 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pfde,
 	   const unsigned char* pfdeend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies);
+	   Offsets_to_cie* cies,
+	   Parsed_eh_frame::Entries* entries);
+
+  // Merge the CIEs and FDEs in PARSED, read from OBJECT, into the
+  // output section.
+  bool
+  add_parsed_eh_frame(Relobj* object, Parsed_eh_frame* parsed);
 
   // Template version of write function.
   template<int size, bool big_endian>
@@ -48,6 +48,7 @@
 #include "binary.h"
 #include "descriptors.h"
 #include "gold-threads.h"
+#include "link-server.h"
 #include "fileread.h"
 
 // For systems without mmap support.
@@ -115,6 +116,98 @@ get_mtime(const char* filename, Timespec* mtime)
   return true;
 }
 
+// Return a hash of the LEN bytes at P.  This is MurmurHash64A, which
+// is fast and good enough to tell whether a file has changed.  The
+// words are read as little-endian so that the result does not depend
+// on the host.
+
+static uint64_t
+hash_contents(const unsigned char* p, size_t len)
+{
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  uint64_t h = 0x5bd1e9955bd1e995ULL ^ (len * m);
+
+  const unsigned char* pend = p + (len & ~static_cast<size_t>(7));
+  for (; p < pend; p += 8)
+    {
+      uint64_t k = elfcpp::Swap_unaligned<64, false>::readval(p);
+      k *= m;
+      k ^= k >> r;
+      k *= m;
+      h ^= k;
+      h *= m;
+    }
+
+  if ((len & 7) != 0)
+    {
+      uint64_t k = 0;
+      for (size_t i = len & 7; i > 0; --i)
+	k = (k << 8) | p[i - 1];
+      h ^= k;
+      h *= m;
+    }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+// Get a hash of the contents of an unopened file.  We never return a
+// hash of zero, so that zero can mean that no hash was recorded.
+
+bool
+get_content_hash(const char* filename, uint64_t* hash)
+{
+  int o = open_descriptor(-1, filename, O_RDONLY);
+  if (o < 0)
+    return false;
+
+  struct stat file_stat;
+  if (fstat(o, &file_stat) < 0)
+    {
+      release_descriptor(o, true);
+      return false;
+    }
+  size_t len = file_stat.st_size;
+
+  bool ok = true;
+  uint64_t h = 0;
+  void* p = len == 0 ? MAP_FAILED : ::mmap(NULL, len, PROT_READ,
+					   MAP_PRIVATE, o, 0);
+  if (p != MAP_FAILED)
+    {
+      h = hash_contents(static_cast<const unsigned char*>(p), len);
+      ::munmap(p, len);
+    }
+  else
+    {
+      unsigned char* buf = new unsigned char[len + 1];
+      size_t got = 0;
+      while (got < len)
+	{
+	  ssize_t n = ::read(o, buf + got, len - got);
+	  if (n <= 0)
+	    {
+	      ok = false;
+	      break;
+	    }
+	  got += n;
+	}
+      if (ok)
+	h = hash_contents(buf, len);
+      delete[] buf;
+    }
+
+  release_descriptor(o, true);
+
+  if (!ok)
+    return false;
+  *hash = h == 0 ? 1 : h;
+  return true;
+}
+
 // Class File_read.
 
 // A lock for the File_read static variables.
@@ -212,6 +305,23 @@ File_read::open(const Task* task, const std::string& name)
       gold_debug(DEBUG_FILES, "Attempt to open %s succeeded",
 		 this->name_.c_str());
       this->token_.add_writer(task);
+
+      // In a link run by the link server, use the server's copy of
+      // the file if it has one.
+      if (Link_server::is_server_child())
+	{
+	  Link_server::note_input_file(this->name_);
+	  this->cached_contents_ = Link_server::cached_contents(s);
+	  if (this->cached_contents_ != NULL)
+	    {
+	      gold_debug(DEBUG_FILES, "Using link server contents of %s",
+			 this->name_.c_str());
+	      this->whole_file_view_ = new View(0, this->size_,
+						this->cached_contents_, 0,
+						false, View::DATA_NOT_OWNED);
+	      this->add_view(this->whole_file_view_);
+	    }
+	}
     }
 
   return this->descriptor_ >= 0;
@@ -955,6 +1065,33 @@ File_read::get_mtime()
 #endif
 }
 
+// Return a hash of the file contents, or 0 if the file can not be
+// read.  When the file is locked we hash a view of it, which is
+// normally already mapped; otherwise we have to open it again.  The
+// result is cached, so Read_symbols can compute it in parallel for
+// Incremental_inputs to record later.
+
+uint64_t
+File_read::get_content_hash()
+{
+  if (this->content_hash_ != 0)
+    return this->content_hash_;
+
+  uint64_t hash;
+  if (this->is_locked() && this->size_ > 0)
+    {
+      const unsigned char* p = this->get_view(0, 0, this->size_, false,
+					      false);
+      hash = hash_contents(p, this->size_);
+      if (hash == 0)
+	hash = 1;
+    }
+  else if (!gold::get_content_hash(this->name_.c_str(), &hash))
+    return 0;
+  this->content_hash_ = hash;
+  return hash;
+}
+
 // Try to find a file in the extra search dirs.  Returns true on success.
 
 bool
@@ -58,6 +58,12 @@ struct Timespec
 bool
 get_mtime(const char* filename, Timespec* mtime);
 
+// Get a hash of the contents of an unopened file.  Returns false if
+// the file can not be read.
+
+bool
+get_content_hash(const char* filename, uint64_t* hash);
+
 class Position_dependent_options;
 class Input_file_argument;
 class Dirsearch;
@@ -72,7 +78,8 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), mapped_bytes_(0),
-      released_(true), whole_file_view_(NULL)
+      released_(true), whole_file_view_(NULL), cached_contents_(NULL),
+      content_hash_(0)
   { }
 
   ~File_read();
@@ -220,6 +227,18 @@ class File_read
   Timespec
   get_mtime();
 
+  // Return a hash of the file contents, or 0 if the file can not be
+  // read.  The hash is computed once, from a view of the file if the
+  // file is locked.
+  uint64_t
+  get_content_hash();
+
+  // Return the contents of the file if they are held in memory by
+  // the link server, or NULL.
+  const unsigned char*
+  cached_contents() const
+  { return this->cached_contents_; }
+
  private:
   // Control for what views to clear.
   enum Clear_views_mode
@@ -441,7 +460,12 @@ class File_read
   // - Flag --mmap_whole_files is set (default on 64-bit hosts).
   // - The contents was specified in the constructor.  Used only for
   //   testing purposes).
+  // - The link server has the file cached.
   View* whole_file_view_;
+  // The file contents held in memory by the link server, or NULL.
+  const unsigned char* cached_contents_;
+  // A hash of the file contents, or 0 if not yet computed.
+  uint64_t content_hash_;
 };
 
 // A view of file data that persists even when the file is unlocked.
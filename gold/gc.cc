@@ -31,43 +31,208 @@ namespace gold
 
 // Garbage collection uses a worklist style algorithm to determine the 
 // transitive closure of all referenced sections.
+
 void 
 Garbage_collection::do_transitive_closure()
 {
-  while (!this->worklist().empty())
+  this->prepare_mark(1);
+  this->mark_partition(0);
+  bool more = this->finish_mark_round();
+  gold_assert(!more);
+}
+
+// Return the node number of SECN, assigning node numbers to all the
+// sections of its object if needed.
+
+unsigned int
+Garbage_collection::section_node(const Section_id& secn)
+{
+  std::pair<Object_bases::iterator, bool> ins =
+    this->object_bases_.insert(std::make_pair(secn.first, this->node_count_));
+  if (ins.second)
+    this->node_count_ += secn.first->shnum();
+  gold_assert(secn.second < secn.first->shnum());
+  return ins.first->second + secn.second;
+}
+
+// Convert the section reference map into a compact graph, with the
+// references from each section stored contiguously, and put the
+// sections on the work list into the partitions.
+
+void
+Garbage_collection::prepare_mark(unsigned int partition_count)
+{
+  gold_assert(!this->is_worklist_ready_ && partition_count > 0);
+
+  // Number the sections.  Remember the numbers of the referencing
+  // sections in the order of the map, to fill in the edges below.
+  std::vector<unsigned int> src_nodes;
+  src_nodes.reserve(this->section_reloc_map_.size());
+  size_t edge_count = 0;
+  for (Section_ref::const_iterator p = this->section_reloc_map_.begin();
+       p != this->section_reloc_map_.end();
+       ++p)
+    {
+      src_nodes.push_back(this->section_node(p->first));
+      edge_count += p->second.size();
+    }
+
+  std::vector<unsigned int> roots;
+  roots.reserve(this->work_list_.size());
+  while (!this->work_list_.empty())
+    {
+      roots.push_back(this->section_node(this->work_list_.front()));
+      this->work_list_.pop();
+    }
+
+  // Count the references from each section, and set the start of each
+  // section's references.
+  this->edge_start_.assign(this->node_count_ + 1, 0);
+  size_t i = 0;
+  for (Section_ref::const_iterator p = this->section_reloc_map_.begin();
+       p != this->section_reloc_map_.end();
+       ++p, ++i)
+    this->edge_start_[src_nodes[i] + 1] = p->second.size();
+  for (unsigned int n = 0; n < this->node_count_; ++n)
+    this->edge_start_[n + 1] += this->edge_start_[n];
+  gold_assert(this->edge_start_[this->node_count_] == edge_count);
+
+  this->edges_.resize(edge_count);
+  i = 0;
+  for (Section_ref::const_iterator p = this->section_reloc_map_.begin();
+       p != this->section_reloc_map_.end();
+       ++p, ++i)
+    {
+      size_t e = this->edge_start_[src_nodes[i]];
+      for (Sections_reachable::const_iterator q = p->second.begin();
+	   q != p->second.end();
+	   ++q, ++e)
+	this->edges_[e] = this->section_node(*q);
+    }
+
+  // SECTION_NODE may have numbered more sections while adding the
+  // edges.  Those sections have no references of their own.
+  this->edge_start_.resize(this->node_count_ + 1, edge_count);
+
+  this->marked_.assign(this->node_count_, 0);
+
+  if (partition_count > this->node_count_)
+    partition_count = this->node_count_ > 0 ? this->node_count_ : 1;
+  this->partition_count_ = partition_count;
+  this->partition_size_ = ((this->node_count_ + partition_count - 1)
+			   / partition_count);
+  if (this->partition_size_ == 0)
+    this->partition_size_ = 1;
+  this->inboxes_.clear();
+  this->inboxes_.resize(partition_count);
+  this->outboxes_.clear();
+  this->outboxes_.resize(partition_count * partition_count);
+
+  for (std::vector<unsigned int>::const_iterator p = roots.begin();
+       p != roots.end();
+       ++p)
+    this->inboxes_[this->node_partition(*p)].push_back(*p);
+}
+
+// Mark the sections in PARTITION reachable from its inbox.  This only
+// reads and writes the marks of its own partition, and only writes
+// its own inbox and outboxes, so different partitions may be marked
+// in parallel.
+
+void
+Garbage_collection::mark_partition(unsigned int partition)
+{
+  std::vector<unsigned int> worklist;
+  worklist.swap(this->inboxes_[partition]);
+  std::vector<unsigned int>* outboxes =
+    &this->outboxes_[partition * this->partition_count_];
+  while (!worklist.empty())
     {
-      // Add elements from the work list to the referenced list
-      // one by one.
-      Section_id entry = this->worklist().front();
-      this->worklist().pop();
-      if (this->referenced_list().find(entry)
-          == this->referenced_list().end()) 
-        {
-          this->referenced_list().insert(entry);
-        }
-      else
-        {
-          continue;
-        }
-      Garbage_collection::Section_ref::iterator find_it = 
-                this->section_reloc_map().find(entry);
-      if (find_it == this->section_reloc_map().end()) 
-          continue;
-      Garbage_collection::Sections_reachable v = find_it->second;
-      // Scan the vector of references for each work_list entry. 
-      for (Garbage_collection::Sections_reachable::iterator it_v = v.begin();
-           it_v != v.end();
-           ++it_v)
-        {
-          // Do not add already processed sections to the work_list. 
-          if (this->referenced_list().find(*it_v)
-              == this->referenced_list().end())
-            {
-              this->worklist().push(*it_v);   
-            }
-        }
+      unsigned int node = worklist.back();
+      worklist.pop_back();
+      if (this->marked_[node])
+	continue;
+      this->marked_[node] = 1;
+      size_t end = this->edge_start_[node + 1];
+      for (size_t e = this->edge_start_[node]; e < end; ++e)
+	{
+	  unsigned int dst = this->edges_[e];
+	  unsigned int dst_partition = this->node_partition(dst);
+	  if (dst_partition != partition)
+	    outboxes[dst_partition].push_back(dst);
+	  else if (!this->marked_[dst])
+	    worklist.push_back(dst);
+	}
     }
+}
+
+// Move the references between partitions found in this round into
+// the inboxes for the next round.  Return true if there is anything
+// left to mark.  Otherwise free the graph, which is no longer needed.
+
+bool
+Garbage_collection::finish_mark_round()
+{
+  bool more = false;
+  for (unsigned int src = 0; src < this->partition_count_; ++src)
+    {
+      for (unsigned int dst = 0; dst < this->partition_count_; ++dst)
+	{
+	  std::vector<unsigned int>& outbox =
+	    this->outboxes_[src * this->partition_count_ + dst];
+	  for (std::vector<unsigned int>::const_iterator p = outbox.begin();
+	       p != outbox.end();
+	       ++p)
+	    {
+	      if (!this->marked_[*p])
+		{
+		  this->inboxes_[dst].push_back(*p);
+		  more = true;
+		}
+	    }
+	  outbox.clear();
+	}
+    }
+
+  if (more)
+    return true;
+
+  std::vector<size_t>().swap(this->edge_start_);
+  std::vector<unsigned int>().swap(this->edges_);
+  std::vector<std::vector<unsigned int> >().swap(this->inboxes_);
+  std::vector<std::vector<unsigned int> >().swap(this->outboxes_);
   this->worklist_ready();
+  return false;
+}
+
+// Gc_mark_task methods.
+
+// We can always run.
+
+Task_token*
+Gc_mark_task::is_runnable()
+{
+  return NULL;
+}
+
+// Hold the blocker until we are done.
+
+void
+Gc_mark_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->blocker_);
+}
+
+void
+Gc_mark_task::run(Workqueue*)
+{
+  this->gc_->mark_partition(this->partition_);
+}
+
+std::string
+Gc_mark_task::get_name() const
+{
+  return "Gc_mark_task";
 }
 
 } // End namespace gold.
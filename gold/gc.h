@@ -30,6 +30,7 @@
 #include "symtab.h"
 #include "object.h"
 #include "icf.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -59,15 +60,13 @@ class Garbage_collection
   typedef std::map<std::string, Sections_reachable> Cident_section_map;
 
   Garbage_collection()
-  : is_worklist_ready_(false)
+  : is_worklist_ready_(false), object_bases_(), node_count_(0),
+    edge_start_(), edges_(), marked_(), partition_count_(0),
+    partition_size_(0), inboxes_(), outboxes_()
   { }
 
   // Accessor methods for the private members.
 
-  Sections_reachable&
-  referenced_list()
-  { return referenced_list_; }
-
   Section_ref&
   section_reloc_map()
   { return this->section_reloc_map_; }
@@ -84,13 +83,47 @@ class Garbage_collection
   worklist_ready()
   { this->is_worklist_ready_ = true; }
 
+  // Find all the sections reachable from the work list.
   void
   do_transitive_closure();
 
+  // The following functions split up the work done by
+  // do_transitive_closure so that the marking may be done by
+  // Gc_mark_task tasks.  The section numbers are divided into
+  // PARTITION_COUNT ranges, and each task marks the sections in one
+  // range.  References to sections in other ranges are passed to
+  // those ranges in the next round.
+
+  // Build the reference graph and seed the partitions from the work
+  // list.
+  void
+  prepare_mark(unsigned int partition_count);
+
+  // The number of partitions.
+  unsigned int
+  mark_partition_count() const
+  { return this->partition_count_; }
+
+  // Mark the sections reachable within partition PARTITION.  This
+  // may run in parallel with other partitions.
+  void
+  mark_partition(unsigned int partition);
+
+  // Pass references between partitions at the end of a round.
+  // Return true if another round is needed.  When this returns false
+  // the marking is complete.
+  bool
+  finish_mark_round();
+
   bool
   is_section_garbage(Object* obj, unsigned int shndx)
-  { return (this->referenced_list().find(Section_id(obj, shndx))
-            == this->referenced_list().end()); }
+  {
+    gold_assert(this->is_worklist_ready_);
+    Object_bases::const_iterator p = this->object_bases_.find(obj);
+    if (p == this->object_bases_.end())
+      return true;
+    return !this->marked_[p->second + shndx];
+  }
 
   Cident_section_map*
   cident_sections()
@@ -117,12 +150,73 @@ class Garbage_collection
   }
 
  private:
+  // Map from an object to the node number of its first section.  The
+  // sections of an object have consecutive node numbers.
+  typedef Unordered_map<const Object*, unsigned int> Object_bases;
+
+  // Return the node number of SECN.
+  unsigned int
+  section_node(const Section_id& secn);
+
+  // Return the partition holding node NODE.
+  unsigned int
+  node_partition(unsigned int node) const
+  { return node / this->partition_size_; }
 
   Worklist_type work_list_;
   bool is_worklist_ready_;
   Section_ref section_reloc_map_;
-  Sections_reachable referenced_list_;
   Cident_section_map cident_sections_;
+  // The node numbers of the sections of each object.
+  Object_bases object_bases_;
+  // The number of nodes.
+  unsigned int node_count_;
+  // The references from node N are edges_[edge_start_[N]] up to
+  // edges_[edge_start_[N + 1]].
+  std::vector<size_t> edge_start_;
+  std::vector<unsigned int> edges_;
+  // Whether each node is referenced.  This is not a vector<bool>
+  // because tasks set different elements in parallel.
+  std::vector<unsigned char> marked_;
+  // The number of partitions, and the number of nodes in each.
+  unsigned int partition_count_;
+  unsigned int partition_size_;
+  // The nodes to mark in each partition in the current round.
+  std::vector<std::vector<unsigned int> > inboxes_;
+  // The nodes referenced by partition P to mark in partition Q in the
+  // next round are in outboxes_[P * partition_count_ + Q].
+  std::vector<std::vector<unsigned int> > outboxes_;
+};
+
+// A task to mark the referenced sections in one partition of the
+// reference graph.
+
+class Gc_mark_task : public Task
+{
+ public:
+  Gc_mark_task(Garbage_collection* gc, unsigned int partition,
+	       Task_token* blocker)
+    : gc_(gc), partition_(partition), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  Garbage_collection* gc_;
+  unsigned int partition_;
+  Task_token* blocker_;
 };
 
 // Data to pass between successive invocations of do_layout
@@ -28,6 +28,7 @@
 #include "object.h"
 #include "output.h"
 #include "demangle.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -171,6 +172,220 @@ mapped_index_string_hash(const unsigned char* str)
   return r;
 }
 
+// The results of scanning the .debug_info and .debug_types sections
+// of one object.  The symbols, compilation units, type units and
+// address ranges are collected in tables local to the object, so that
+// objects can be scanned in parallel.  Gdb_index::merge_scans then
+// adds them to the .gdb_index section in the order of the objects, so
+// that the output does not depend on the order in which the scans
+// run.
+
+class Gdb_index_scan
+{
+ public:
+  Gdb_index_scan(Relobj* object);
+
+  ~Gdb_index_scan();
+
+  // Return the object.
+  Relobj*
+  object() const
+  { return this->object_; }
+
+  // Scan a .debug_info or .debug_types section now.
+  void
+  scan_section(bool is_type_unit, const unsigned char* symbols,
+	       off_t symbols_size, unsigned int shndx,
+	       unsigned int reloc_shndx, unsigned int reloc_type);
+
+  // Record a .debug_info or .debug_types section to scan later, in
+  // scan_sections.  The first call copies the symbols.
+  void
+  add_section(bool is_type_unit, const unsigned char* symbols,
+	      off_t symbols_size, unsigned int shndx,
+	      unsigned int reloc_shndx, unsigned int reloc_type);
+
+  // Scan the sections recorded by add_section.
+  void
+  scan_sections();
+
+  // Add a compilation unit.  Return its index in this object.
+  int
+  add_comp_unit(off_t cu_offset, off_t cu_length)
+  {
+    this->comp_units_.push_back(Gdb_index::Comp_unit(cu_offset, cu_length));
+    return this->comp_units_.size() - 1;
+  }
+
+  // Add a type unit.  Return its index in this object.
+  int
+  add_type_unit(off_t tu_offset, off_t type_offset, uint64_t signature)
+  {
+    this->type_units_.push_back(Gdb_index::Type_unit(tu_offset, type_offset,
+						     signature));
+    return this->type_units_.size() - 1;
+  }
+
+  // Add an address range.
+  void
+  add_address_range_list(Relobj* object, unsigned int cu_index,
+			 Dwarf_range_list* ranges)
+  {
+    this->ranges_.push_back(Gdb_index::Per_cu_range_list(object, cu_index,
+							 ranges));
+  }
+
+  // Add a symbol.
+  void
+  add_symbol(int cu_index, const char* sym_name, uint8_t flags);
+
+  // Return the offset into the pubnames table for the cu at the given
+  // offset.
+  off_t
+  find_pubname_offset(off_t cu_offset);
+
+  // Return the offset into the pubtypes table for the cu at the
+  // given offset.
+  off_t
+  find_pubtype_offset(off_t cu_offset);
+
+  // Return TRUE if we have already processed the pubnames and types
+  // set for OBJECT of the CUs and TUS associated with the statement
+  // list at OFFSET.
+  bool
+  pubnames_read(const Relobj* object, off_t offset);
+
+  // Record that we have already read the pubnames associated with
+  // OBJECT and OFFSET.
+  void
+  set_pubnames_read(const Relobj* object, off_t offset);
+
+  // Return a pointer to the given table.
+  Dwarf_pubnames_table*
+  pubnames_table()
+  { return pubnames_table_; }
+
+  Dwarf_pubnames_table*
+  pubtypes_table()
+  { return pubtypes_table_; }
+
+  // Record statistics.
+  void
+  note_unit(bool is_type_unit)
+  {
+    if (is_type_unit)
+      ++this->tu_count_;
+    else
+      ++this->cu_count_;
+  }
+
+  void
+  note_unit_without_pubnames(bool is_type_unit)
+  {
+    if (is_type_unit)
+      ++this->tu_nopubnames_count_;
+    else
+      ++this->cu_nopubnames_count_;
+  }
+
+  // Print usage statistics.
+  static void
+  print_stats();
+
+ private:
+  friend class Gdb_index;
+
+  // A section to scan.
+  struct Section
+  {
+    Section(bool is_tu, unsigned int sh, unsigned int rsh, unsigned int rt)
+      : is_type_unit(is_tu), shndx(sh), reloc_shndx(rsh), reloc_type(rt)
+    { }
+    bool is_type_unit;
+    unsigned int shndx;
+    unsigned int reloc_shndx;
+    unsigned int reloc_type;
+  };
+
+  // A symbol found in this object.  NAME points to the key in
+  // symbol_map_.  CU_VEC holds the indexes in this object.
+  struct Symbol
+  {
+    const char* name;
+    unsigned int hashval;
+    Gdb_index::Cu_vector cu_vec;
+  };
+
+  // Map from symbol name to index in symbols_.
+  typedef Unordered_map<std::string, unsigned int> Symbol_map;
+
+  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
+
+  // Create a map from dies to pubnames.
+  Dwarf_pubnames_table*
+  map_pubtable_to_dies(unsigned int attr,
+		       Gdb_index_info_reader* dwinfo,
+		       const unsigned char* symbols,
+		       off_t symbols_size);
+
+  // Wrapper for map_pubtable_to_dies.
+  void
+  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
+				 const unsigned char* symbols,
+				 off_t symbols_size);
+
+  // The object.
+  Relobj* object_;
+  // The sections to scan, for scan_sections.
+  std::vector<Section> sections_;
+  // A copy of the symbols, for scan_sections.
+  unsigned char* symbols_;
+  off_t symbols_size_;
+  // Whether map_pubnames_and_types_to_dies has been called.
+  bool pubnames_mapped_;
+  Pubname_offset_map cu_pubname_map_;
+  Pubname_offset_map cu_pubtype_map_;
+  // Tables to store the pubnames section of the object.
+  Dwarf_pubnames_table* pubnames_table_;
+  Dwarf_pubnames_table* pubtypes_table_;
+  // Stmt list offset of the CUs and TUs associated with the last read
+  // pubnames and pubtypes sections.
+  off_t stmt_list_offset_;
+  // The DWARF compilation units in this object.
+  std::vector<Gdb_index::Comp_unit> comp_units_;
+  // The DWARF type units in this object.
+  std::vector<Gdb_index::Type_unit> type_units_;
+  // The address ranges in this object.
+  std::vector<Gdb_index::Per_cu_range_list> ranges_;
+  // The symbols in the order in which they were first seen.
+  std::vector<Symbol> symbols_list_;
+  Symbol_map symbol_map_;
+  // Statistics for this object.
+  unsigned int cu_count_;
+  unsigned int cu_nopubnames_count_;
+  unsigned int tu_count_;
+  unsigned int tu_nopubnames_count_;
+
+  // Statistics, added up by Gdb_index::merge_scans.
+  // Total number of DWARF compilation units processed.
+  static unsigned int dwarf_cu_count;
+  // Number of DWARF compilation units without pubnames/pubtypes.
+  static unsigned int dwarf_cu_nopubnames_count;
+  // Total number of DWARF type units processed.
+  static unsigned int dwarf_tu_count;
+  // Number of DWARF type units without pubnames/pubtypes.
+  static unsigned int dwarf_tu_nopubnames_count;
+};
+
+// Total number of DWARF compilation units processed.
+unsigned int Gdb_index_scan::dwarf_cu_count = 0;
+// Number of DWARF compilation units without pubnames/pubtypes.
+unsigned int Gdb_index_scan::dwarf_cu_nopubnames_count = 0;
+// Total number of DWARF type units processed.
+unsigned int Gdb_index_scan::dwarf_tu_count = 0;
+// Number of DWARF type units without pubnames/pubtypes.
+unsigned int Gdb_index_scan::dwarf_tu_nopubnames_count = 0;
+
 // A specialization of Dwarf_info_reader, for building the .gdb_index.
 
 class Gdb_index_info_reader : public Dwarf_info_reader
@@ -183,19 +398,15 @@ class Gdb_index_info_reader : public Dwarf_info_reader
 			unsigned int shndx,
 			unsigned int reloc_shndx,
 			unsigned int reloc_type,
-			Gdb_index* gdb_index)
+			Gdb_index_scan* scan)
     : Dwarf_info_reader(is_type_unit, object, symbols, symbols_size, shndx,
 			reloc_shndx, reloc_type),
-      gdb_index_(gdb_index), cu_index_(0), cu_language_(0)
+      scan_(scan), cu_index_(0), cu_language_(0)
   { }
 
   ~Gdb_index_info_reader()
   { this->clear_declarations(); }
 
-  // Print usage statistics.
-  static void
-  print_stats();
-
  protected:
   // Visit a compilation unit.
   virtual void
@@ -285,8 +496,8 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   void
   clear_declarations();
 
-  // The Gdb_index section.
-  Gdb_index* gdb_index_;
+  // The results of scanning the object.
+  Gdb_index_scan* scan_;
   // The current CU index (negative for a TU).
   int cu_index_;
   // The language of the current CU or TU.
@@ -294,35 +505,16 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   // Map from DIE offset to (parent offset, name) pair,
   // for DW_AT_specification.
   Declaration_map declarations_;
-
-  // Statistics.
-  // Total number of DWARF compilation units processed.
-  static unsigned int dwarf_cu_count;
-  // Number of DWARF compilation units with pubnames/pubtypes.
-  static unsigned int dwarf_cu_nopubnames_count;
-  // Total number of DWARF type units processed.
-  static unsigned int dwarf_tu_count;
-  // Number of DWARF type units with pubnames/pubtypes.
-  static unsigned int dwarf_tu_nopubnames_count;
 };
 
-// Total number of DWARF compilation units processed.
-unsigned int Gdb_index_info_reader::dwarf_cu_count = 0;
-// Number of DWARF compilation units without pubnames/pubtypes.
-unsigned int Gdb_index_info_reader::dwarf_cu_nopubnames_count = 0;
-// Total number of DWARF type units processed.
-unsigned int Gdb_index_info_reader::dwarf_tu_count = 0;
-// Number of DWARF type units without pubnames/pubtypes.
-unsigned int Gdb_index_info_reader::dwarf_tu_nopubnames_count = 0;
-
 // Process a compilation unit and parse its child DIE.
 
 void
 Gdb_index_info_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
 					      Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_cu_count;
-  this->cu_index_ = this->gdb_index_->add_comp_unit(cu_offset, cu_length);
+  this->scan_->note_unit(false);
+  this->cu_index_ = this->scan_->add_comp_unit(cu_offset, cu_length);
   this->visit_top_die(root_die);
 }
 
@@ -333,10 +525,10 @@ Gdb_index_info_reader::visit_type_unit(off_t tu_offset, off_t,
 				       off_t type_offset, uint64_t signature,
 				       Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_tu_count;
+  this->scan_->note_unit(true);
   // Use a negative index to flag this as a TU instead of a CU.
-  this->cu_index_ = -1 - this->gdb_index_->add_type_unit(tu_offset, type_offset,
-							 signature);
+  this->cu_index_ = -1 - this->scan_->add_type_unit(tu_offset, type_offset,
+						    signature);
   this->visit_top_die(root_die);
 }
 
@@ -378,10 +570,8 @@ Gdb_index_info_reader::visit_top_die(Dwarf_die* die)
 	// info to extract the names.
 	if (!this->read_pubnames_and_pubtypes(die))
 	  {
-	    if (die->tag() == elfcpp::DW_TAG_compile_unit)
-	      ++Gdb_index_info_reader::dwarf_cu_nopubnames_count;
-	    else
-	      ++Gdb_index_info_reader::dwarf_tu_nopubnames_count;
+	    this->scan_->note_unit_without_pubnames(
+		die->tag() == elfcpp::DW_TAG_type_unit);
 	    this->visit_children(die, NULL);
 	  }
 	break;
@@ -436,8 +626,8 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	    // If the DIE is not a declaration, add it to the index.
 	    std::string full_name = this->get_qualified_name(die, context);
 	    if (!full_name.empty())
-	      this->gdb_index_->add_symbol(this->cu_index_,
-                                           full_name.c_str(), 0);
+	      this->scan_->add_symbol(this->cu_index_,
+				      full_name.c_str(), 0);
 	  }
 	break;
       case elfcpp::DW_TAG_typedef:
@@ -476,8 +666,8 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	      if (full_name.empty())
 		full_name = this->get_qualified_name(die, context);
 	      if (!full_name.empty())
-		this->gdb_index_->add_symbol(this->cu_index_,
-					     full_name.c_str(), 0);
+		this->scan_->add_symbol(this->cu_index_,
+					full_name.c_str(), 0);
 	    }
 
 	  // We're interested in the children only for namespaces and
@@ -824,8 +1014,8 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
     {
       Dwarf_range_list* ranges = this->read_range_list(shndx, ranges_offset);
       if (ranges != NULL)
-	this->gdb_index_->add_address_range_list(this->object(),
-						 this->cu_index_, ranges);
+	this->scan_->add_address_range_list(this->object(),
+					    this->cu_index_, ranges);
       return;
     }
 
@@ -850,8 +1040,8 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
         {
 	  Dwarf_range_list* ranges = new Dwarf_range_list();
 	  ranges->add(shndx, low_pc, high_pc);
-	  this->gdb_index_->add_address_range_list(this->object(),
-						   this->cu_index_, ranges);
+	  this->scan_->add_address_range_list(this->object(),
+					      this->cu_index_, ranges);
         }
     }
 }
@@ -876,7 +1066,7 @@ Gdb_index_info_reader::read_pubtable(Dwarf_pubnames_table* table, off_t offset)
       if (name == NULL)
         break;
 
-      this->gdb_index_->add_symbol(this->cu_index_, name, flag_byte);
+      this->scan_->add_symbol(this->cu_index_, name, flag_byte);
     }
   return true;
 }
@@ -915,8 +1105,8 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
           // have read. If it does, then no need to read the pubnames.
           // If it doesn't, then the caller will have to parse the
           // dies manually to find the names.
-          return this->gdb_index_->pubnames_read(this->object(),
-                                                 stmt_list_off);
+          return this->scan_->pubnames_read(this->object(),
+                                            stmt_list_off);
         }
       else
         {
@@ -927,10 +1117,10 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
 
   // We found the attribute, so we can check if the corresponding
   // pubnames have been read.
-  if (this->gdb_index_->pubnames_read(this->object(), stmt_list_off))
+  if (this->scan_->pubnames_read(this->object(), stmt_list_off))
     return true;
 
-  this->gdb_index_->set_pubnames_read(this->object(), stmt_list_off);
+  this->scan_->set_pubnames_read(this->object(), stmt_list_off);
 
   // We have an attribute, and the pubnames haven't been read, so read
   // them.
@@ -938,12 +1128,12 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
   // In some of the cases, we could rely on the previous value of
   // offset here, but sorting out which cases complicates the logic
   // enough that it isn't worth it. So just look up the offset again.
-  offset = this->gdb_index_->find_pubname_offset(this->cu_offset());
-  names = this->read_pubtable(this->gdb_index_->pubnames_table(), offset);
+  offset = this->scan_->find_pubname_offset(this->cu_offset());
+  names = this->read_pubtable(this->scan_->pubnames_table(), offset);
 
   bool types = false;
-  offset = this->gdb_index_->find_pubtype_offset(this->cu_offset());
-  types = this->read_pubtable(this->gdb_index_->pubtypes_table(), offset);
+  offset = this->scan_->find_pubtype_offset(this->cu_offset());
+  types = this->read_pubtable(this->scan_->pubtypes_table(), offset);
   return names || types;
 }
 
@@ -963,55 +1153,95 @@ Gdb_index_info_reader::clear_declarations()
   this->declarations_.clear();
 }
 
-// Print usage statistics.
-void
-Gdb_index_info_reader::print_stats()
-{
-  fprintf(stderr, _("%s: DWARF CUs: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_cu_count);
-  fprintf(stderr, _("%s: DWARF CUs without pubnames/pubtypes: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_cu_nopubnames_count);
-  fprintf(stderr, _("%s: DWARF TUs: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_tu_count);
-  fprintf(stderr, _("%s: DWARF TUs without pubnames/pubtypes: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_tu_nopubnames_count);
-}
-
-// Class Gdb_index.
-
-// Construct the .gdb_index section.
+// Class Gdb_index_scan.
 
-Gdb_index::Gdb_index(Output_section* gdb_index_section)
-  : Output_section_data(4),
+Gdb_index_scan::Gdb_index_scan(Relobj* object)
+  : object_(object),
+    sections_(),
+    symbols_(NULL),
+    symbols_size_(0),
+    pubnames_mapped_(false),
+    cu_pubname_map_(),
+    cu_pubtype_map_(),
     pubnames_table_(NULL),
     pubtypes_table_(NULL),
-    gdb_index_section_(gdb_index_section),
+    stmt_list_offset_(-1),
     comp_units_(),
     type_units_(),
     ranges_(),
-    cu_vector_list_(),
-    cu_vector_offsets_(NULL),
-    stringpool_(),
-    tu_offset_(0),
-    addr_offset_(0),
-    symtab_offset_(0),
-    cu_pool_offset_(0),
-    stringpool_offset_(0),
-    pubnames_object_(NULL),
-    stmt_list_offset_(-1)
+    symbols_list_(),
+    symbol_map_(),
+    cu_count_(0),
+    cu_nopubnames_count_(0),
+    tu_count_(0),
+    tu_nopubnames_count_(0)
 {
-  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
 }
 
-Gdb_index::~Gdb_index()
+Gdb_index_scan::~Gdb_index_scan()
 {
-  // Free the memory used by the symbol table.
-  delete this->gdb_symtab_;
-  // Free the memory used by the CU vectors.
-  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
-    delete this->cu_vector_list_[i];
+  delete this->pubnames_table_;
+  delete this->pubtypes_table_;
+  delete[] this->symbols_;
 }
 
+// Scan a .debug_info or .debug_types section.
+
+void
+Gdb_index_scan::scan_section(bool is_type_unit,
+			     const unsigned char* symbols,
+			     off_t symbols_size,
+			     unsigned int shndx,
+			     unsigned int reloc_shndx,
+			     unsigned int reloc_type)
+{
+  Gdb_index_info_reader dwinfo(is_type_unit, this->object_,
+			       symbols, symbols_size,
+			       shndx, reloc_shndx,
+			       reloc_type, this);
+  if (!this->pubnames_mapped_)
+    this->map_pubnames_and_types_to_dies(&dwinfo, symbols, symbols_size);
+  dwinfo.parse();
+}
+
+// Record a section to scan later.  The symbols are only valid while
+// the object is being laid out, so we make a copy.
+
+void
+Gdb_index_scan::add_section(bool is_type_unit,
+			    const unsigned char* symbols,
+			    off_t symbols_size,
+			    unsigned int shndx,
+			    unsigned int reloc_shndx,
+			    unsigned int reloc_type)
+{
+  if (this->sections_.empty() && symbols != NULL)
+    {
+      this->symbols_ = new unsigned char[symbols_size];
+      memcpy(this->symbols_, symbols, symbols_size);
+      this->symbols_size_ = symbols_size;
+    }
+  this->sections_.push_back(Section(is_type_unit, shndx, reloc_shndx,
+				    reloc_type));
+}
+
+// Scan the sections recorded by add_section.  This is called by a
+// Gdb_index_scan_task, with the object locked.
+
+void
+Gdb_index_scan::scan_sections()
+{
+  for (std::vector<Section>::const_iterator p = this->sections_.begin();
+       p != this->sections_.end();
+       ++p)
+    this->scan_section(p->is_type_unit, this->symbols_, this->symbols_size_,
+		       p->shndx, p->reloc_shndx, p->reloc_type);
+
+  this->sections_.clear();
+  delete[] this->symbols_;
+  this->symbols_ = NULL;
+  this->symbols_size_ = 0;
+}
 
 // Scan the pubnames and pubtypes sections and build a map of the
 // various cus and tus they refer to, so we can process the entries
@@ -1019,11 +1249,10 @@ Gdb_index::~Gdb_index()
 // Return the just-read table so it can be cached.
 
 Dwarf_pubnames_table*
-Gdb_index::map_pubtable_to_dies(unsigned int attr,
-                                Gdb_index_info_reader* dwinfo,
-                                Relobj* object,
-                                const unsigned char* symbols,
-                                off_t symbols_size)
+Gdb_index_scan::map_pubtable_to_dies(unsigned int attr,
+				     Gdb_index_info_reader* dwinfo,
+				     const unsigned char* symbols,
+				     off_t symbols_size)
 {
   uint64_t section_offset = 0;
   Dwarf_pubnames_table* table;
@@ -1041,7 +1270,7 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
     }
 
   map->clear();
-  if (!table->read_section(object, symbols, symbols_size))
+  if (!table->read_section(this->object_, symbols, symbols_size))
     return NULL;
 
   while (table->read_header(section_offset))
@@ -1056,30 +1285,28 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
 // Wrapper for map_pubtable_to_dies
 
 void
-Gdb_index::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                          Relobj* object,
-                                          const unsigned char* symbols,
-                                          off_t symbols_size)
+Gdb_index_scan::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
+					       const unsigned char* symbols,
+					       off_t symbols_size)
 {
-  // This is a new object, so reset the relevant variables.
-  this->pubnames_object_ = object;
+  this->pubnames_mapped_ = true;
   this->stmt_list_offset_ = -1;
 
   delete this->pubnames_table_;
   this->pubnames_table_
       = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubnames, dwinfo,
-                                   object, symbols, symbols_size);
+                                   symbols, symbols_size);
   delete this->pubtypes_table_;
   this->pubtypes_table_
       = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubtypes, dwinfo,
-                                   object, symbols, symbols_size);
+                                   symbols, symbols_size);
 }
 
 // Given a cu_offset, find the associated section of the pubnames
 // table.
 
 off_t
-Gdb_index::find_pubname_offset(off_t cu_offset)
+Gdb_index_scan::find_pubname_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubname_map_.find(cu_offset);
   if (it != this->cu_pubname_map_.end())
@@ -1091,7 +1318,7 @@ Gdb_index::find_pubname_offset(off_t cu_offset)
 // table.
 
 off_t
-Gdb_index::find_pubtype_offset(off_t cu_offset)
+Gdb_index_scan::find_pubtype_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubtype_map_.find(cu_offset);
   if (it != this->cu_pubtype_map_.end())
@@ -1099,81 +1326,281 @@ Gdb_index::find_pubtype_offset(off_t cu_offset)
   return -1;
 }
 
-// Scan a .debug_info or .debug_types input section.
+// Return TRUE if we have already processed the pubnames associated
+// with the statement list at the given OFFSET.
+
+bool
+Gdb_index_scan::pubnames_read(const Relobj* object, off_t offset)
+{
+  bool ret = (this->pubnames_mapped_
+	      && this->object_ == object
+	      && this->stmt_list_offset_ == offset);
+  return ret;
+}
+
+// Record that we have processed the pubnames associated with the
+// statement list for OBJECT at the given OFFSET.
 
 void
-Gdb_index::scan_debug_info(bool is_type_unit,
-			   Relobj* object,
-			   const unsigned char* symbols,
-			   off_t symbols_size,
-			   unsigned int shndx,
-			   unsigned int reloc_shndx,
-			   unsigned int reloc_type)
+Gdb_index_scan::set_pubnames_read(const Relobj* object, off_t offset)
 {
-  Gdb_index_info_reader dwinfo(is_type_unit, object,
-			       symbols, symbols_size,
-			       shndx, reloc_shndx,
-			       reloc_type, this);
-  if (object != this->pubnames_object_)
-    map_pubnames_and_types_to_dies(&dwinfo, object, symbols, symbols_size);
-  dwinfo.parse();
+  gold_assert(object == this->object_);
+  this->stmt_list_offset_ = offset;
 }
 
-// Add a symbol.
+// Add a symbol to the table for this object.  This does the same
+// thing as Gdb_index::merge_scans does for the whole output, so that
+// merging the tables gives the same result as adding each symbol to
+// the output directly.
 
 void
-Gdb_index::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
+Gdb_index_scan::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
 {
-  unsigned int hash = mapped_index_string_hash(
-      reinterpret_cast<const unsigned char*>(sym_name));
-  Gdb_symbol* sym = new Gdb_symbol();
-  this->stringpool_.add(sym_name, true, &sym->name_key);
-  sym->hashval = hash;
-  sym->cu_vector_index = 0;
-
-  Gdb_symbol* found = this->gdb_symtab_->add(sym);
-  if (found == sym)
+  std::pair<Symbol_map::iterator, bool> ins =
+    this->symbol_map_.insert(std::make_pair(std::string(sym_name),
+					    this->symbols_list_.size()));
+  if (ins.second)
     {
-      // New symbol -- allocate a new CU index vector.
-      found->cu_vector_index = this->cu_vector_list_.size();
-      this->cu_vector_list_.push_back(new Cu_vector());
-    }
-  else
-    {
-      // Found an existing symbol -- append to the existing
-      // CU index vector.
-      delete sym;
+      // New symbol -- compute the hash value now, while we are
+      // running in parallel with other objects.
+      Symbol sym;
+      sym.name = ins.first->first.c_str();
+      sym.hashval = mapped_index_string_hash(
+	  reinterpret_cast<const unsigned char*>(sym.name));
+      this->symbols_list_.push_back(sym);
     }
 
   // Add the CU index to the vector list for this symbol,
   // if it's not already on the list.  We only need to
   // check the last added entry.
-  Cu_vector* cu_vec = this->cu_vector_list_[found->cu_vector_index];
+  Gdb_index::Cu_vector* cu_vec =
+    &this->symbols_list_[ins.first->second].cu_vec;
   if (cu_vec->size() == 0
       || cu_vec->back().first != cu_index
       || cu_vec->back().second != flags)
     cu_vec->push_back(std::make_pair(cu_index, flags));
 }
 
-// Return TRUE if we have already processed the pubnames associated
-// with the statement list at the given OFFSET.
+// Print usage statistics.
+void
+Gdb_index_scan::print_stats()
+{
+  fprintf(stderr, _("%s: DWARF CUs: %u\n"),
+          program_name, Gdb_index_scan::dwarf_cu_count);
+  fprintf(stderr, _("%s: DWARF CUs without pubnames/pubtypes: %u\n"),
+          program_name, Gdb_index_scan::dwarf_cu_nopubnames_count);
+  fprintf(stderr, _("%s: DWARF TUs: %u\n"),
+          program_name, Gdb_index_scan::dwarf_tu_count);
+  fprintf(stderr, _("%s: DWARF TUs without pubnames/pubtypes: %u\n"),
+          program_name, Gdb_index_scan::dwarf_tu_nopubnames_count);
+}
 
-bool
-Gdb_index::pubnames_read(const Relobj* object, off_t offset)
+// A task to scan the debug info sections of one object.
+
+class Gdb_index_scan_task : public Task
 {
-  bool ret = (this->pubnames_object_ == object
-	      && this->stmt_list_offset_ == offset);
-  return ret;
+ public:
+  Gdb_index_scan_task(Gdb_index_scan* scan, Task_token* blocker)
+    : scan_(scan), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    Relobj* object = this->scan_->object();
+    return object->is_locked() ? object->token() : NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->blocker_);
+    Task_token* token = this->scan_->object()->token();
+    if (token != NULL)
+      tl->add(this, token);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->scan_->scan_sections();
+    this->scan_->object()->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Gdb_index_scan_task " + this->scan_->object()->name(); }
+
+ private:
+  Gdb_index_scan* scan_;
+  Task_token* blocker_;
+};
+
+// Class Gdb_index.
+
+// Construct the .gdb_index section.
+
+Gdb_index::Gdb_index(Output_section* gdb_index_section)
+  : Output_section_data(4),
+    gdb_index_section_(gdb_index_section),
+    comp_units_(),
+    type_units_(),
+    ranges_(),
+    cu_vector_list_(),
+    cu_vector_offsets_(NULL),
+    stringpool_(),
+    tu_offset_(0),
+    addr_offset_(0),
+    symtab_offset_(0),
+    cu_pool_offset_(0),
+    stringpool_offset_(0),
+    scans_(),
+    defer_scans_(parameters->options().threads())
+{
+  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
 }
 
-// Record that we have processed the pubnames associated with the
-// statement list for OBJECT at the given OFFSET.
+Gdb_index::~Gdb_index()
+{
+  // Free the memory used by the symbol table.
+  delete this->gdb_symtab_;
+  // Free the memory used by the CU vectors.
+  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
+    delete this->cu_vector_list_[i];
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    delete this->scans_[i];
+}
+
+// Scan a .debug_info or .debug_types input section.  When using
+// threads, we only record the section here, and queue_scan_tasks
+// scans it later.
 
 void
-Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
+Gdb_index::scan_debug_info(bool is_type_unit,
+			   Relobj* object,
+			   const unsigned char* symbols,
+			   off_t symbols_size,
+			   unsigned int shndx,
+			   unsigned int reloc_shndx,
+			   unsigned int reloc_type)
 {
-  this->pubnames_object_ = object;
-  this->stmt_list_offset_ = offset;
+  Gdb_index_scan* scan;
+  if (!this->scans_.empty() && this->scans_.back()->object() == object)
+    scan = this->scans_.back();
+  else
+    {
+      // This is a new object.  If we are not deferring the scans,
+      // we are done with the previous object.
+      if (!this->defer_scans_)
+	this->merge_scans();
+      scan = new Gdb_index_scan(object);
+      this->scans_.push_back(scan);
+    }
+
+  if (this->defer_scans_)
+    scan->add_section(is_type_unit, symbols, symbols_size, shndx,
+		      reloc_shndx, reloc_type);
+  else
+    scan->scan_section(is_type_unit, symbols, symbols_size, shndx,
+		       reloc_shndx, reloc_type);
+}
+
+// Queue a task for each object to scan its debug info sections.
+// BLOCKER is held until all the tasks are done.
+
+void
+Gdb_index::queue_scan_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  if (!this->defer_scans_ || this->scans_.empty())
+    return;
+
+  workqueue->add_blockers(blocker, this->scans_.size());
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    workqueue->queue(new Gdb_index_scan_task(this->scans_[i], blocker));
+}
+
+// Add the results of the scans to the .gdb_index section, in the
+// order in which the objects were laid out, and free them.
+
+void
+Gdb_index::merge_scans()
+{
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    {
+      Gdb_index_scan* scan = this->scans_[i];
+      gold_assert(scan->sections_.empty());
+
+      // The CU and TU indexes in the scan are relative to the object.
+      const int cu_base = this->comp_units_.size();
+      const int tu_base = this->type_units_.size();
+      this->comp_units_.insert(this->comp_units_.end(),
+			       scan->comp_units_.begin(),
+			       scan->comp_units_.end());
+      this->type_units_.insert(this->type_units_.end(),
+			       scan->type_units_.begin(),
+			       scan->type_units_.end());
+
+      for (unsigned int j = 0; j < scan->ranges_.size(); ++j)
+	{
+	  Per_cu_range_list r = scan->ranges_[j];
+	  int cu_index = static_cast<int>(r.cu_index);
+	  if (cu_index < 0)
+	    cu_index = -1 - (tu_base + (-1 - cu_index));
+	  else
+	    cu_index += cu_base;
+	  r.cu_index = cu_index;
+	  this->ranges_.push_back(r);
+	}
+
+      for (unsigned int j = 0; j < scan->symbols_list_.size(); ++j)
+	{
+	  const Gdb_index_scan::Symbol& ssym(scan->symbols_list_[j]);
+	  Gdb_symbol* sym = new Gdb_symbol();
+	  this->stringpool_.add(ssym.name, true, &sym->name_key);
+	  sym->hashval = ssym.hashval;
+	  sym->cu_vector_index = 0;
+
+	  Gdb_symbol* found = this->gdb_symtab_->add(sym);
+	  if (found == sym)
+	    {
+	      // New symbol -- allocate a new CU index vector.
+	      found->cu_vector_index = this->cu_vector_list_.size();
+	      this->cu_vector_list_.push_back(new Cu_vector());
+	    }
+	  else
+	    {
+	      // Found an existing symbol -- append to the existing
+	      // CU index vector.
+	      delete sym;
+	    }
+
+	  // The scan has already removed duplicate entries, and the
+	  // entries from different objects refer to different units,
+	  // so we can append them all.
+	  Cu_vector* cu_vec = this->cu_vector_list_[found->cu_vector_index];
+	  for (Cu_vector::const_iterator p = ssym.cu_vec.begin();
+	       p != ssym.cu_vec.end();
+	       ++p)
+	    {
+	      int cu_index = p->first;
+	      if (cu_index < 0)
+		cu_index = -1 - (tu_base + (-1 - cu_index));
+	      else
+		cu_index += cu_base;
+	      cu_vec->push_back(std::make_pair(cu_index, p->second));
+	    }
+	}
+
+      Gdb_index_scan::dwarf_cu_count += scan->cu_count_;
+      Gdb_index_scan::dwarf_cu_nopubnames_count += scan->cu_nopubnames_count_;
+      Gdb_index_scan::dwarf_tu_count += scan->tu_count_;
+      Gdb_index_scan::dwarf_tu_nopubnames_count += scan->tu_nopubnames_count_;
+
+      delete scan;
+    }
+  this->scans_.clear();
 }
 
 // Set the size of the .gdb_index section.
@@ -1181,6 +1608,9 @@ Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
 void
 Gdb_index::set_final_data_size()
 {
+  // Add the results of any remaining scans.
+  this->merge_scans();
+
   // Finalize the string pool.
   this->stringpool_.set_string_offsets();
 
@@ -1352,7 +1782,7 @@ void
 Gdb_index::print_stats()
 {
   if (parameters->options().gdb_index())
-    Gdb_index_info_reader::print_stats();
+    Gdb_index_scan::print_stats();
 }
 
 } // End namespace gold.
@@ -47,6 +47,7 @@
 #include "icf.h"
 #include "incremental.h"
 #include "timer.h"
+#include "link-server.h"
 
 namespace gold
 {
@@ -69,6 +70,7 @@ gold_exit(Exit_status status)
     parameters->options().plugins()->cleanup();
   if (status != GOLD_OK && parameters != NULL && parameters->options_valid())
     unlink_if_ordinary(parameters->options().output_file_name());
+  Link_server::report_input_files();
   exit(status);
 }
 
@@ -167,6 +169,169 @@ Gc_runner::run(Workqueue* workqueue, const Task* task)
 			this->mapfile_);
 }
 
+static void
+queue_middle_icf_tasks(const General_options&, const Task*,
+		       const Input_objects*, Symbol_table*, Layout*,
+		       Workqueue*, Mapfile*);
+
+static void
+queue_middle_layout_tasks(const General_options&, const Task*,
+			  const Input_objects*, Symbol_table*, Layout*,
+			  Workqueue*, Mapfile*);
+
+// Set the number of threads to use for the middle or final tasks, and
+// return it.  THREAD_COUNT is the value of --thread-count-middle or
+// --thread-count-final; if it is zero, use a thread per input object,
+// but at least two.
+
+static int
+set_tasks_thread_count(int thread_count, const Input_objects* input_objects,
+		       Workqueue* workqueue)
+{
+  if (thread_count == 0)
+    thread_count = std::max(2, input_objects->number_of_input_objects());
+  workqueue->set_thread_count(thread_count);
+  return thread_count;
+}
+
+// The number of partitions of the reference graph to mark in parallel
+// for garbage collection.
+
+static const unsigned int gc_mark_partition_count = 16;
+
+// Queue a Gc_mark_task for each partition of the reference graph.
+// Return a blocker which is cleared when they are all done.
+
+static Task_token*
+queue_gc_mark_tasks(Garbage_collection* gc, Workqueue* workqueue)
+{
+  unsigned int count = gc->mark_partition_count();
+  Task_token* blocker = new Task_token(true);
+  for (unsigned int i = 0; i < count; ++i)
+    blocker->add_blocker();
+  for (unsigned int i = 0; i < count; ++i)
+    workqueue->queue(new Gc_mark_task(gc, i, blocker));
+  return blocker;
+}
+
+// This class arranges to run another round of Gc_mark_task tasks, or
+// to continue with the middle tasks when garbage collection is done.
+
+class Gc_mark_runner : public Task_function_runner
+{
+ public:
+  Gc_mark_runner(const General_options& options,
+		 const Input_objects* input_objects,
+		 Symbol_table* symtab,
+		 Layout* layout, Mapfile* mapfile)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), mapfile_(mapfile)
+  { }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  Symbol_table* symtab_;
+  Layout* layout_;
+  Mapfile* mapfile_;
+};
+
+void
+Gc_mark_runner::run(Workqueue* workqueue, const Task* task)
+{
+  Garbage_collection* gc = this->symtab_->gc();
+  if (gc->finish_mark_round())
+    {
+      Task_token* blocker = queue_gc_mark_tasks(gc, workqueue);
+      Gc_mark_runner* runner = new Gc_mark_runner(this->options_,
+						  this->input_objects_,
+						  this->symtab_,
+						  this->layout_,
+						  this->mapfile_);
+      workqueue->queue(new Task_function(runner, blocker,
+					 "Task_function Gc_mark_runner"));
+      return;
+    }
+
+  queue_middle_icf_tasks(this->options_, task, this->input_objects_,
+			 this->symtab_, this->layout_, workqueue,
+			 this->mapfile_);
+}
+
+// Queue an Icf_task to do STEP for each object with sections which
+// may be folded.  Return a blocker which is cleared when they are
+// all done.
+
+static Task_token*
+queue_icf_tasks(Symbol_table* symtab, Workqueue* workqueue,
+		Icf_task::Step step)
+{
+  Icf* icf = symtab->icf();
+  unsigned int count = icf->candidate_object_count();
+  Task_token* blocker = new Task_token(true);
+  for (unsigned int i = 0; i < count; ++i)
+    blocker->add_blocker();
+  for (unsigned int i = 0; i < count; ++i)
+    workqueue->queue(new Icf_task(symtab, i, step, blocker));
+  return blocker;
+}
+
+// This class arranges to run the rest of identical code folding after
+// the Icf_task tasks for each object are done.
+
+class Icf_runner : public Task_function_runner
+{
+ public:
+  Icf_runner(const General_options& options,
+	     const Input_objects* input_objects,
+	     Symbol_table* symtab,
+	     Layout* layout, Mapfile* mapfile,
+	     Icf_task::Step step)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), mapfile_(mapfile), step_(step)
+  { }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  Symbol_table* symtab_;
+  Layout* layout_;
+  Mapfile* mapfile_;
+  // The step which the tasks just finished.
+  Icf_task::Step step_;
+};
+
+void
+Icf_runner::run(Workqueue* workqueue, const Task* task)
+{
+  Icf* icf = this->symtab_->icf();
+  if (this->step_ == Icf_task::ICF_CHECKSUM)
+    {
+      icf->find_unique_sections();
+      Task_token* blocker = queue_icf_tasks(this->symtab_, workqueue,
+					    Icf_task::ICF_CONTENTS);
+      Icf_runner* runner = new Icf_runner(this->options_,
+					  this->input_objects_,
+					  this->symtab_, this->layout_,
+					  this->mapfile_,
+					  Icf_task::ICF_CONTENTS);
+      workqueue->queue(new Task_function(runner, blocker,
+					 "Task_function Icf_runner"));
+      return;
+    }
+
+  icf->find_identical_sections(this->input_objects_, this->symtab_);
+  queue_middle_layout_tasks(this->options_, task, this->input_objects_,
+			    this->symtab_, this->layout_, workqueue,
+			    this->mapfile_);
+}
+
 // Queue up the initial set of tasks for this link job.
 
 void
@@ -270,6 +435,17 @@ queue_initial_tasks(const General_options& options,
 	workqueue->queue(tasks[i]);
     }
 
+  // If the symbol table is sharded, wait for the last shard tasks
+  // and fold their deferred state back into the symbol table.
+  if (symtab->shard_count() > 1)
+    {
+      Task_token* next_blocker = new Task_token(true);
+      next_blocker->add_blocker();
+      workqueue->queue(new Finish_symbol_shards(symtab, this_blocker,
+						next_blocker));
+      this_blocker = next_blocker;
+    }
+
   if (options.has_plugins())
     {
       Task_token* next_blocker = new Task_token(true);
@@ -515,17 +691,80 @@ queue_middle_tasks(const General_options& options,
       symtab->gc_mark_undef_symbols(layout);
       gold_assert(symtab->gc() != NULL);
       // Do a transitive closure on all references to determine the worklist.
+      // When using threads, the marking is done by Gc_mark_task tasks,
+      // and Gc_mark_runner continues after that.
+      if (parameters->options().threads())
+	{
+	  Garbage_collection* gc = symtab->gc();
+	  gc->prepare_mark(gc_mark_partition_count);
+	  Task_token* blocker = queue_gc_mark_tasks(gc, workqueue);
+	  workqueue->queue(new Task_function(new Gc_mark_runner(options,
+								input_objects,
+								symtab,
+								layout,
+								mapfile),
+					     blocker,
+					     "Task_function Gc_mark_runner"));
+	  return;
+	}
       symtab->gc()->do_transitive_closure();
     }
 
+  queue_middle_icf_tasks(options, task, input_objects, symtab, layout,
+			 workqueue, mapfile);
+}
+
+// Queue up the tasks for identical code folding, after garbage
+// collection is done.
+
+static void
+queue_middle_icf_tasks(const General_options& options,
+		       const Task* task,
+		       const Input_objects* input_objects,
+		       Symbol_table* symtab,
+		       Layout* layout,
+		       Workqueue* workqueue,
+		       Mapfile* mapfile)
+{
   // If identical code folding (--icf) is chosen it makes sense to do it
   // only after garbage collection (--gc-sections) as we do not want to
   // be folding sections that will be garbage.
+  // When using threads, the section contents are read by one task
+  // per object, and Icf_runner continues after that.
   if (parameters->options().icf_enabled())
     {
+      if (parameters->options().threads())
+	{
+	  Icf* icf = symtab->icf();
+	  icf->find_candidate_sections(input_objects, symtab);
+	  Task_token* blocker = queue_icf_tasks(symtab, workqueue,
+						Icf_task::ICF_CHECKSUM);
+	  Icf_runner* runner = new Icf_runner(options, input_objects,
+					      symtab, layout, mapfile,
+					      Icf_task::ICF_CHECKSUM);
+	  workqueue->queue(new Task_function(runner, blocker,
+					     "Task_function Icf_runner"));
+	  return;
+	}
       symtab->icf()->find_identical_sections(input_objects, symtab);
     }
 
+  queue_middle_layout_tasks(options, task, input_objects, symtab, layout,
+			    workqueue, mapfile);
+}
+
+// Queue up the rest of the middle set of tasks, after garbage
+// collection and identical code folding are done.
+
+static void
+queue_middle_layout_tasks(const General_options& options,
+			  const Task* task,
+			  const Input_objects* input_objects,
+			  Symbol_table* symtab,
+			  Layout* layout,
+			  Workqueue* workqueue,
+			  Mapfile* mapfile)
+{
   // Call Object::layout for the second time to determine the
   // output_sections for all referenced input sections.  When
   // --gc-sections or --icf is turned on, or when certain input
@@ -567,6 +806,16 @@ queue_middle_tasks(const General_options& options,
 	(*p)->update_section_layout(layout->get_section_order_map());
     }
 
+  // Order the sections in the --call-graph-ordering profile, now that
+  // we know where each function is defined.
+  if (parameters->options().call_graph_ordering())
+    layout->order_sections_by_call_graph(symtab);
+
+  // Move the hot .text sections to the front, after any other
+  // ordering of the input sections.
+  if (parameters->options().hot_text())
+    layout->place_hot_text_sections(symtab);
+
   if (parameters->options().gc_sections()
       || parameters->options().icf_enabled())
     {
@@ -595,10 +844,8 @@ queue_middle_tasks(const General_options& options,
       && layout->incremental_base() == NULL)
     parameters_force_valid_target();
 
-  int thread_count = options.thread_count_middle();
-  if (thread_count == 0)
-    thread_count = std::max(2, input_objects->number_of_input_objects());
-  workqueue->set_thread_count(thread_count);
+  set_tasks_thread_count(options.thread_count_middle(), input_objects,
+			 workqueue);
 
   // Now we have seen all the input files.
   const bool doing_static_link =
@@ -769,6 +1016,17 @@ queue_middle_tasks(const General_options& options,
 	}
     }
 
+  // All the input sections have been added, so we can merge the
+  // strings in the merge sections, scan the debug info for the
+  // .gdb_index section, and read the line information for
+  // --detect-odr-violations while the relocs are read.
+  if (parameters->options().threads())
+    {
+      layout->queue_merge_tasks(workqueue, this_blocker);
+      layout->queue_gdb_index_tasks(workqueue, this_blocker);
+      symtab->queue_odr_tasks(workqueue, this_blocker);
+    }
+
   // When all those tasks are complete, we can start laying out the
   // output file.
   workqueue->queue(new Task_function(new Layout_task_runner(options,
@@ -781,6 +1039,82 @@ queue_middle_tasks(const General_options& options,
 				     "Task_function Layout_task_runner"));
 }
 
+// This class arranges to queue the final set of tasks once the
+// Prefault_output_task tasks are done.
+
+class Prefault_runner : public Task_function_runner
+{
+ public:
+  Prefault_runner(const General_options& options,
+		  const Input_objects* input_objects,
+		  const Symbol_table* symtab,
+		  Layout* layout, Output_file* of)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), of_(of)
+  { }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  const Symbol_table* symtab_;
+  Layout* layout_;
+  Output_file* of_;
+};
+
+void
+Prefault_runner::run(Workqueue* workqueue, const Task*)
+{
+  this->of_->finish_prefault();
+  queue_final_tasks(this->options_, this->input_objects_, this->symtab_,
+		    this->layout_, workqueue, this->of_);
+}
+
+// Queue up tasks to fault in the pages of the output file before any
+// task writes to it, for --prefault-output-file.  When using threads,
+// split the file into one chunk per thread.  The final set of tasks is
+// queued when they are done.  This is called at the end of
+// Layout_task.
+
+void
+queue_prefault_tasks(const General_options& options,
+		     const Input_objects* input_objects,
+		     const Symbol_table* symtab,
+		     Layout* layout,
+		     Workqueue* workqueue,
+		     Output_file* of)
+{
+  int thread_count = set_tasks_thread_count(options.thread_count_final(),
+					    input_objects, workqueue);
+
+  // Chunks are multiples of 1M, so that they start on a page boundary.
+  const off_t chunk_align = 1024 * 1024;
+  off_t file_size = of->filesize();
+  off_t chunk_size = file_size;
+  if (options.threads())
+    chunk_size = file_size / thread_count;
+  chunk_size = align_address(chunk_size, chunk_align);
+  if (chunk_size == 0)
+    chunk_size = chunk_align;
+
+  of->start_prefault();
+  Task_token* blocker = new Task_token(true);
+  for (off_t start = 0; start < file_size; start += chunk_size)
+    {
+      off_t len = std::min(chunk_size, file_size - start);
+      blocker->add_blocker();
+      workqueue->queue(new Prefault_output_task(of, start, len, blocker));
+    }
+
+  workqueue->queue(new Task_function(new Prefault_runner(options,
+							 input_objects,
+							 symtab, layout, of),
+				     blocker,
+				     "Task_function Prefault_runner"));
+}
+
 // Queue up the final set of tasks.  This is called at the end of
 // Layout_task.
 
@@ -796,10 +1130,8 @@ queue_final_tasks(const General_options& options,
   if (timer != NULL)
     timer->stamp(1);
 
-  int thread_count = options.thread_count_final();
-  if (thread_count == 0)
-    thread_count = std::max(2, input_objects->number_of_input_objects());
-  workqueue->set_thread_count(thread_count);
+  set_tasks_thread_count(options.thread_count_final(), input_objects,
+			 workqueue);
 
   bool any_postprocessing_sections = layout->any_postprocessing_sections();
 
@@ -826,6 +1158,13 @@ queue_final_tasks(const General_options& options,
   if (!any_postprocessing_sections)
     final_blocker->add_blocker();
 
+  // When using threads, sort the dynamic relocs in parallel before
+  // writing out the output sections.  This gets the sort keys now,
+  // so it must be done before queuing any other task.
+  Task_token* dynamic_relocs_blocker = NULL;
+  if (options.threads())
+    dynamic_relocs_blocker = layout->queue_dynamic_reloc_sort_tasks(workqueue);
+
   // Queue a task to write out the symbol table.
   workqueue->queue(new Write_symbols_task(layout,
 					  symtab,
@@ -836,7 +1175,8 @@ queue_final_tasks(const General_options& options,
 					  final_blocker));
 
   // Queue a task to write out the output sections.
-  workqueue->queue(new Write_sections_task(layout, of, output_sections_blocker,
+  workqueue->queue(new Write_sections_task(layout, of, dynamic_relocs_blocker,
+					   output_sections_blocker,
 					   final_blocker));
 
   // Queue a task to write out everything else.
@@ -858,17 +1198,35 @@ queue_final_tasks(const General_options& options,
   // the output file.
   if (!any_postprocessing_sections)
     {
+      // When using threads, sort the .eh_frame_hdr table in parallel
+      // first.
+      Task_token* input_blocker = input_sections_blocker;
+      if (options.threads())
+	input_blocker = layout->queue_eh_frame_hdr_tasks(workqueue, of,
+							 input_blocker);
+
       Task* t = new Write_after_input_sections_task(layout, of,
-						    input_sections_blocker,
+						    input_blocker,
 						    final_blocker);
       workqueue->queue(t);
     }
   else
     {
+      // When using threads, compress the compressed debug sections
+      // and sort the .eh_frame_hdr table in parallel first.
+      Task_token* input_blocker = final_blocker;
+      if (options.threads())
+	{
+	  input_blocker = layout->queue_compress_tasks(workqueue,
+						       final_blocker);
+	  input_blocker = layout->queue_eh_frame_hdr_tasks(workqueue, of,
+							   input_blocker);
+	}
+
       Task_token* new_final_blocker = new Task_token(true);
       new_final_blocker->add_blocker();
       Task* t = new Write_after_input_sections_task(layout, of,
-						    final_blocker,
+						    input_blocker,
 						    new_final_blocker);
       workqueue->queue(t);
       final_blocker = new_final_blocker;
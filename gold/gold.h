@@ -232,6 +232,16 @@ queue_middle_tasks(const General_options&,
 		   Workqueue*,
 		   Mapfile*);
 
+// Queue up tasks to fault in the pages of the output file, followed by
+// the final set of tasks.
+extern void
+queue_prefault_tasks(const General_options&,
+		     const Input_objects*,
+		     const Symbol_table*,
+		     Layout*,
+		     Workqueue*,
+		     Output_file* of);
+
 // Queue up the final set of tasks.
 extern void
 queue_final_tasks(const General_options&,
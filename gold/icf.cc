@@ -132,8 +132,22 @@
 //
 //
 //
+// Read-only data :
+// ---------------
+//
+// With --icf-rodata, read-only data sections created by -fdata-sections,
+// .rodata.* and .data.rel.ro.*, are also candidates.  Their relocs are
+// tracked like those of functions, so that a vtable pointing to folded
+// functions can itself be folded.  With --icf=all any such section may
+// be folded; as with function pointers, this breaks programs which
+// compare the addresses of distinct constant objects.  With --icf=safe
+// only vtables and VTTs, whose addresses the program can not take, are
+// folded.  Merge sections are not candidates as they are already
+// merged.
+//
 // How to run  : --icf=[safe|all|none]
 // Optional parameters : --icf-iterations <num> --print-icf-sections
+//                       --icf-rodata
 //
 // Performance : Less than 20 % link-time overhead on industry strength
 // applications.  Up to 6 %  text size reductions.
@@ -153,108 +167,78 @@ namespace gold
 
 // This function determines if a section or a group of identical
 // sections has unique contents.  Such unique sections or groups can be
-// declared final and need not be processed any further.
-// Parameters :
-// ID_SECTION : Vector mapping a section index to a Section_id pair.
-// IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
-//                            sections is already known to be unique.
-// SECTION_CONTENTS : Contains the section's text and relocs to sections
-//                    that cannot be folded.   SECTION_CONTENTS are NULL
-//                    implies that this function is being called for the
-//                    first time before the first iteration of icf.
+// declared final and need not be processed any further.  Before the
+// first iteration this uses the checksums of the section contents
+// computed by checksum_sections.  Later iterations use the section's
+// text and relocs to sections that cannot be folded.
 
-static void
-preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
-                               std::vector<bool>* is_secn_or_group_unique,
-                               std::vector<std::string>* section_contents)
+void
+Icf::preprocess_for_unique_sections(unsigned int iteration_num)
 {
   Unordered_map<uint32_t, unsigned int> uniq_map;
   std::pair<Unordered_map<uint32_t, unsigned int>::iterator, bool>
     uniq_map_insert;
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < this->id_section_.size(); i++)
     {
-      if ((*is_secn_or_group_unique)[i])
+      if (this->is_secn_or_group_unique_[i])
         continue;
 
       uint32_t cksum;
-      Section_id secn = id_section[i];
-      section_size_type plen;
-      if (section_contents == NULL)
-        {
-          // Lock the object so we can read from it.  This is only called
-          // single-threaded from queue_middle_tasks, so it is OK to lock.
-          // Unfortunately we have no way to pass in a Task token.
-          const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-          Task_lock_obj<Object> tl(dummy_task, secn.first);
-          const unsigned char* contents;
-          contents = secn.first->section_contents(secn.second,
-                                                  &plen,
-                                                  false);
-          cksum = xcrc32(contents, plen, 0xffffffff);
-        }
+      if (iteration_num == 1)
+        cksum = this->raw_cksum_[i];
       else
         {
           const unsigned char* contents_array = reinterpret_cast
-            <const unsigned char*>((*section_contents)[i].c_str());
-          cksum = xcrc32(contents_array, (*section_contents)[i].length(),
+            <const unsigned char*>(this->section_contents_[i].c_str());
+          cksum = xcrc32(contents_array, this->section_contents_[i].length(),
                          0xffffffff);
         }
       uniq_map_insert = uniq_map.insert(std::make_pair(cksum, i));
       if (uniq_map_insert.second)
         {
-          (*is_secn_or_group_unique)[i] = true;
+          this->is_secn_or_group_unique_[i] = true;
         }
       else
         {
-          (*is_secn_or_group_unique)[i] = false;
-          (*is_secn_or_group_unique)[uniq_map_insert.first->second] = false;
+          this->is_secn_or_group_unique_[i] = false;
+          this->is_secn_or_group_unique_[uniq_map_insert.first->second] =
+            false;
         }
     }
 }
 
-// This returns the buffer containing the section's contents, both
-// text and relocs.  Relocs are differentiated as those pointing to
-// sections that could be folded and those that cannot.  Only relocs
-// pointing to sections that could be folded are recomputed on
-// subsequent invocations of this function.
+// This computes the parts of the section's contents, both text and
+// relocs, which do not change between iterations.  Relocs are
+// differentiated as those pointing to sections that could be folded
+// and those that cannot.  Relocs pointing to sections that could be
+// folded are returned in TRACKED_RELOCS; their contents depend on
+// which section they are folded into, and are added by
+// add_tracked_relocs on each iteration.
 // Parameters  :
-// FIRST_ITERATION    : true if it is the first invocation.
 // SECN               : Section for which contents are desired.
-// SECTION_NUM        : Unique section number of this section.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
-//                      to ICF sections.
-// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
+// LOCKED_OBJECT      : If not NULL, the only object whose file may be
+//                      read.  If other objects need to be read, this
+//                      returns false.  Otherwise this returns true.
+// BUFFER             : Store the section's text and relocs to non-ICF
 //                      sections.
+// TRACKED_RELOCS     : Store the relocs to ICF sections.
 
-static std::string
-get_section_contents(bool first_iteration,
-                     const Section_id& secn,
-                     unsigned int section_num,
-                     unsigned int* num_tracked_relocs,
+static bool
+get_section_contents(const Section_id& secn,
                      Symbol_table* symtab,
-                     const std::vector<unsigned int>& kept_section_id,
-                     std::vector<std::string>* section_contents)
+                     const Object* locked_object,
+                     const Unordered_set<Section_id, Section_id_hash>&
+                       merge_sections,
+                     std::string* buffer,
+                     Icf::Tracked_relocs* tracked_relocs)
 {
-  // Lock the object so we can read from it.  This is only called
-  // single-threaded from queue_middle_tasks, so it is OK to lock.
-  // Unfortunately we have no way to pass in a Task token.
-  const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-  Task_lock_obj<Object> tl(dummy_task, secn.first);
-
   section_size_type plen;
   const unsigned char* contents = NULL;
-  if (first_iteration)
-    contents = secn.first->section_contents(secn.second, &plen, false);
-
-  // The buffer to hold all the contents including relocs.  A checksum
-  // is then computed on this buffer.
-  std::string buffer;
-  std::string icf_reloc_buffer;
+  contents = secn.first->section_contents(secn.second, &plen, false);
 
-  if (num_tracked_relocs)
-    *num_tracked_relocs = 0;
+  buffer->clear();
+  tracked_relocs->clear();
 
   Icf::Reloc_info_list& reloc_info_list = 
     symtab->icf()->reloc_info_list();
@@ -262,9 +246,6 @@ get_section_contents(bool first_iteration,
   Icf::Reloc_info_list::iterator it_reloc_info_list =
     reloc_info_list.find(secn);
 
-  buffer.clear();
-  icf_reloc_buffer.clear();
-
   // Process relocs and put them into the buffer.
 
   if (it_reloc_info_list != reloc_info_list.end())
@@ -272,24 +253,23 @@ get_section_contents(bool first_iteration,
       Icf::Sections_reachable_info v =
         (it_reloc_info_list->second).section_info;
       // Stores the information of the symbol pointed to by the reloc.
-      Icf::Symbol_info s = (it_reloc_info_list->second).symbol_info;
+      const Icf::Symbol_info& s = (it_reloc_info_list->second).symbol_info;
       // Stores the addend and the symbol value.
       Icf::Addend_info a = (it_reloc_info_list->second).addend_info;
       // Stores the offset of the reloc.
-      Icf::Offset_info o = (it_reloc_info_list->second).offset_info;
-      Icf::Reloc_addend_size_info reloc_addend_size_info =
+      const Icf::Offset_info& o = (it_reloc_info_list->second).offset_info;
+      const Icf::Reloc_addend_size_info& reloc_addend_size_info =
         (it_reloc_info_list->second).reloc_addend_size_info;
       Icf::Sections_reachable_info::iterator it_v = v.begin();
-      Icf::Symbol_info::iterator it_s = s.begin();
+      Icf::Symbol_info::const_iterator it_s = s.begin();
       Icf::Addend_info::iterator it_a = a.begin();
-      Icf::Offset_info::iterator it_o = o.begin();
-      Icf::Reloc_addend_size_info::iterator it_addend_size =
+      Icf::Offset_info::const_iterator it_o = o.begin();
+      Icf::Reloc_addend_size_info::const_iterator it_addend_size =
         reloc_addend_size_info.begin();
 
       for (; it_v != v.end(); ++it_v, ++it_s, ++it_a, ++it_o, ++it_addend_size)
         {
-	  if (first_iteration
-	      && it_v->first != NULL)
+	  if (it_v->first != NULL)
 	    {
 	      Symbol_location loc;
 	      loc.object = it_v->first;
@@ -325,15 +305,12 @@ get_section_contents(bool first_iteration,
 	  // object is NULL.
 	  if (it_v->first == NULL)
             {
-	      if (first_iteration)
-                {
-		  // If the symbol name is available, use it.
-                  if ((*it_s) != NULL)
-                      buffer.append((*it_s)->name());
-                  // Append the addend.
-                  buffer.append(addend_str);
-                  buffer.append("@");
-		}
+              // If the symbol name is available, use it.
+              if ((*it_s) != NULL)
+                buffer->append((*it_s)->name());
+              // Append the addend.
+              buffer->append(addend_str);
+              buffer->append("@");
 	      continue;
 	    }
 
@@ -344,12 +321,9 @@ get_section_contents(bool first_iteration,
           if (reloc_secn.first == secn.first
               && reloc_secn.second == secn.second)
             {
-              if (first_iteration)
-                {
-                  buffer.append("R");
-                  buffer.append(addend_str);
-                  buffer.append("@");
-                }
+              buffer->append("R");
+              buffer->append(addend_str);
+              buffer->append("@");
               continue;
             }
           Icf::Uniq_secn_id_map& section_id_map =
@@ -364,36 +338,39 @@ get_section_contents(bool first_iteration,
               && section_id_map_it != section_id_map.end())
             {
               // This is a reloc to a section that might be folded.
-              if (num_tracked_relocs)
-                (*num_tracked_relocs)++;
-
-              char kept_section_str[10];
-              unsigned int secn_id = section_id_map_it->second;
-              snprintf(kept_section_str, sizeof(kept_section_str), "%u",
-                       kept_section_id[secn_id]);
-              if (first_iteration)
-                {
-                  buffer.append("ICF_R");
-                  buffer.append(addend_str);
-                }
-              icf_reloc_buffer.append(kept_section_str);
-              // Append the addend.
-              icf_reloc_buffer.append(addend_str);
-              icf_reloc_buffer.append("@");
+              buffer->append("ICF_R");
+              buffer->append(addend_str);
+              tracked_relocs->push_back(
+                  Icf::Tracked_reloc(section_id_map_it->second,
+                                     std::string(addend_str) + "@"));
             }
           else
             {
               // This is a reloc to a section that cannot be folded.
-              // Process it only in the first iteration.
-              if (!first_iteration)
-                continue;
+              bool is_merge;
+              if (locked_object == NULL || it_v->first == locked_object)
+                {
+                  uint64_t secn_flags =
+                    (it_v->first)->section_flags(it_v->second);
+                  is_merge = (secn_flags & elfcpp::SHF_MERGE) != 0;
+                }
+              else if (it_v->first->is_dynamic())
+                return false;
+              else
+                is_merge = (merge_sections.find(reloc_secn)
+                            != merge_sections.end());
 
-              uint64_t secn_flags = (it_v->first)->section_flags(it_v->second);
               // This reloc points to a merge section.  Hash the
               // contents of this section.
-              if ((secn_flags & elfcpp::SHF_MERGE) != 0
+              if (is_merge
 		  && parameters->target().can_icf_inline_merge_sections())
                 {
+                  // We need to read the merge section.
+                  if (locked_object != NULL && it_v->first != locked_object)
+                    return false;
+
+                  uint64_t secn_flags =
+                    (it_v->first)->section_flags(it_v->second);
                   uint64_t entsize =
                     (it_v->first)->section_entsize(it_v->second);
 		  long long offset = it_a->first;
@@ -458,7 +435,7 @@ get_section_contents(bool first_iteration,
                         {
                         case 1:
                           {
-                            buffer.append(str_char);
+                            buffer->append(str_char);
                             break;
                           }
                         case 2:
@@ -469,7 +446,7 @@ get_section_contents(bool first_iteration,
                             // Find the NULL character.
                             while(*(ptr_16 + strlen_16) != 0)
                                 strlen_16++;
-                            buffer.append(str_char, strlen_16 * 2);
+                            buffer->append(str_char, strlen_16 * 2);
                           }
                           break;
                         case 4:
@@ -480,7 +457,7 @@ get_section_contents(bool first_iteration,
                             // Find the NULL character.
                             while(*(ptr_32 + strlen_32) != 0)
                                 strlen_32++;
-                            buffer.append(str_char, strlen_32 * 4);
+                            buffer->append(str_char, strlen_32 * 4);
                           }
                           break;
                         default:
@@ -490,53 +467,71 @@ get_section_contents(bool first_iteration,
                   else
                     {
                       // Use the entsize to determine the length.
-                      buffer.append(reinterpret_cast<const 
-                                                     char*>(str_contents),
-                                    entsize);
+                      buffer->append(reinterpret_cast<const 
+                                                      char*>(str_contents),
+                                     entsize);
                     }
-		  buffer.append("@");
+		  buffer->append("@");
                 }
               else if ((*it_s) != NULL)
                 {
                   // If symbol name is available use that.
-                  buffer.append((*it_s)->name());
+                  buffer->append((*it_s)->name());
                   // Append the addend.
-                  buffer.append(addend_str);
-                  buffer.append("@");
+                  buffer->append(addend_str);
+                  buffer->append("@");
                 }
               else
                 {
                   // Symbol name is not available, like for a local symbol,
                   // use object and section id.
-                  buffer.append(it_v->first->name());
+                  buffer->append(it_v->first->name());
                   char secn_id[10];
                   snprintf(secn_id, sizeof(secn_id), "%u",it_v->second);
-                  buffer.append(secn_id);
+                  buffer->append(secn_id);
                   // Append the addend.
-                  buffer.append(addend_str);
-                  buffer.append("@");
+                  buffer->append(addend_str);
+                  buffer->append("@");
                 }
             }
         }
     }
 
-  if (first_iteration)
+  // Data may be accessed with instructions which require it to be
+  // aligned, so data sections with different alignments are different.
+  if ((secn.first->section_flags(secn.second) & elfcpp::SHF_EXECINSTR) == 0)
     {
-      buffer.append("Contents = ");
-      buffer.append(reinterpret_cast<const char*>(contents), plen);
-      // Store the section contents that dont change to avoid recomputing
-      // during the next call to this function.
-      (*section_contents)[section_num] = buffer;
+      char align_str[30];
+      snprintf(align_str, sizeof(align_str), "Align = %llu ",
+               static_cast<unsigned long long>(
+                 secn.first->section_addralign(secn.second)));
+      buffer->append(align_str);
     }
-  else
+
+  buffer->append("Contents = ");
+  buffer->append(reinterpret_cast<const char*>(contents), plen);
+  return true;
+}
+
+// Append the relocs to sections that could be folded to BUFFER.  Each
+// reloc is represented by the section its target has been folded
+// into, so this changes from one iteration to the next.
+
+static void
+add_tracked_relocs(const Icf::Tracked_relocs& tracked_relocs,
+                   const std::vector<unsigned int>& kept_section_id,
+                   std::string* buffer)
+{
+  for (Icf::Tracked_relocs::const_iterator p = tracked_relocs.begin();
+       p != tracked_relocs.end();
+       ++p)
     {
-      gold_assert(buffer.empty());
-      // Reuse the contents computed in the previous iteration.
-      buffer.append((*section_contents)[section_num]);
+      char kept_section_str[10];
+      snprintf(kept_section_str, sizeof(kept_section_str), "%u",
+               kept_section_id[p->section_num]);
+      buffer->append(kept_section_str);
+      buffer->append(p->addend);
     }
-
-  buffer.append(icf_reloc_buffer);
-  return buffer;
 }
 
 // This function computes a checksum on each section to detect and form
@@ -552,81 +547,62 @@ get_section_contents(bool first_iteration,
 // identical sections.  A section is added to a group only after its
 // contents are explicitly compared with the kept section of the group.
 //
-// Parameters  :
-// ITERATION_NUM           : Invocation instance of this function.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
-//                      to ICF sections.
-// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
-// ID_SECTION         : Vector mapping a section to an unique integer.
-// IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
-//                            sections is already known to be unique.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
-//                      sections.
+// The parts of the section contents which do not depend on other
+// sections being folded are computed once, before the first
+// iteration, possibly in parallel by Icf_task tasks.  Returns whether
+// the iteration converged.
 
-static bool
-match_sections(unsigned int iteration_num,
-               Symbol_table* symtab,
-               std::vector<unsigned int>* num_tracked_relocs,
-               std::vector<unsigned int>* kept_section_id,
-               const std::vector<Section_id>& id_section,
-               std::vector<bool>* is_secn_or_group_unique,
-               std::vector<std::string>* section_contents)
+bool
+Icf::match_sections(unsigned int iteration_num)
 {
   Unordered_multimap<uint32_t, unsigned int> section_cksum;
   std::pair<Unordered_multimap<uint32_t, unsigned int>::iterator,
             Unordered_multimap<uint32_t, unsigned int>::iterator> key_range;
   bool converged = true;
+  std::vector<unsigned int>& kept_section_id(this->kept_section_id_);
 
-  if (iteration_num == 1)
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   NULL);
-  else
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   section_contents);
+  Iteration_stats stats;
+  stats.compared = 0;
+  stats.folded = 0;
+  Timer timer;
+  timer.start();
+
+  // The unique sections for the first iteration are found by
+  // find_unique_sections.
+  if (iteration_num > 1)
+    this->preprocess_for_unique_sections(iteration_num);
 
   std::vector<std::string> full_section_contents;
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < this->id_section_.size(); i++)
     {
       full_section_contents.push_back("");
-      if ((*is_secn_or_group_unique)[i])
+      if (this->is_secn_or_group_unique_[i])
         continue;
 
-      Section_id secn = id_section[i];
-      std::string this_secn_contents;
-      uint32_t cksum;
-      if (iteration_num == 1)
+      if (iteration_num > 1 && kept_section_id[i] != i)
         {
-          unsigned int num_relocs = 0;
-          this_secn_contents = get_section_contents(true, secn, i, &num_relocs,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
-          (*num_tracked_relocs)[i] = num_relocs;
-        }
-      else
-        {
-          if ((*kept_section_id)[i] != i)
+          // This section is already folded into something.  See
+          // if it should point to a different kept section.
+          unsigned int kept_section = kept_section_id[i];
+          if (kept_section != kept_section_id[kept_section])
             {
-              // This section is already folded into something.  See
-              // if it should point to a different kept section.
-              unsigned int kept_section = (*kept_section_id)[i];
-              if (kept_section != (*kept_section_id)[kept_section])
-                {
-                  (*kept_section_id)[i] = (*kept_section_id)[kept_section];
-                }
-              continue;
+              kept_section_id[i] = kept_section_id[kept_section];
             }
-          this_secn_contents = get_section_contents(false, secn, i, NULL,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
+          continue;
         }
 
+      gold_assert(this->contents_state_[i] == CONTENTS_DONE);
+      std::string this_secn_contents(this->section_contents_[i]);
+      add_tracked_relocs(this->tracked_relocs_[i], kept_section_id,
+                         &this_secn_contents);
+      ++stats.compared;
+
       const unsigned char* this_secn_contents_array =
             reinterpret_cast<const unsigned char*>(this_secn_contents.c_str());
-      cksum = xcrc32(this_secn_contents_array, this_secn_contents.length(),
-                     0xffffffff);
+      uint32_t cksum = xcrc32(this_secn_contents_array,
+                              this_secn_contents.length(),
+                              0xffffffff);
       size_t count = section_cksum.count(cksum);
 
       if (count == 0)
@@ -650,8 +626,9 @@ match_sections(unsigned int iteration_num,
                          this_secn_contents.c_str(),
                          this_secn_contents.length()) != 0)
                   continue;
-              (*kept_section_id)[i] = kept_section;
+              kept_section_id[i] = kept_section;
               converged = false;
+              ++stats.folded;
               break;
             }
           if (it == key_range.second)
@@ -663,10 +640,13 @@ match_sections(unsigned int iteration_num,
         }
       // If there are no relocs to foldable sections do not process
       // this section any further.
-      if (iteration_num == 1 && (*num_tracked_relocs)[i] == 0)
-        (*is_secn_or_group_unique)[i] = true;
+      if (iteration_num == 1 && this->tracked_relocs_[i].empty())
+        this->is_secn_or_group_unique_[i] = true;
     }
 
+  stats.time = timer.get_elapsed_time();
+  this->iteration_stats_.push_back(stats);
+
   return converged;
 }
 
@@ -688,21 +668,38 @@ is_function_ctor_or_dtor(const std::string& section_name)
   return false;
 }
 
-// This is the main ICF function called in gold.cc.  This does the
-// initialization and calls match_sections repeatedly (twice by default)
-// which computes the crc checksums and detects identical functions.
+// During safe icf with --icf-rodata, only fold read-only data that is a
+// vtable, a VTT or a construction vtable.  C++ gives no way to take
+// the address of these, so folding them can not change the result of
+// a comparison.  Identical vtables are common after identical virtual
+// functions have been folded, particularly with -fno-rtti.  Note that
+// typeinfo objects and names are compared by address, and so are not
+// folded.
+
+static bool
+is_data_vtable_or_vtt(const std::string& section_name)
+{
+  const char* mangled_name = strrchr(section_name.c_str(), '.');
+  gold_assert(mangled_name != NULL);
+  return (is_prefix_of("._ZTV", mangled_name)
+          || is_prefix_of("._ZTT", mangled_name)
+          || is_prefix_of("._ZTC", mangled_name));
+}
+
+// Decide which sections are possible candidates for folding, and
+// assign each a unique number.
 
 void
-Icf::find_identical_sections(const Input_objects* input_objects,
+Icf::find_candidate_sections(const Input_objects* input_objects,
                              Symbol_table* symtab)
 {
+  gold_assert(!this->have_candidates_);
+  this->have_candidates_ = true;
+  this->fingerprint_timer_.start();
+
   unsigned int section_num = 0;
-  std::vector<unsigned int> num_tracked_relocs;
-  std::vector<bool> is_secn_or_group_unique;
-  std::vector<std::string> section_contents;
   const Target& target = parameters->target();
-
-  // Decide which sections are possible candidates first.
+  const bool record_merge_sections = target.can_icf_inline_merge_sections();
 
   for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
        p != input_objects->relobj_end();
@@ -714,8 +711,13 @@ Icf::find_identical_sections(const Input_objects* input_objects,
       const Task* dummy_task = reinterpret_cast<const Task*>(-1);
       Task_lock_obj<Object> tl(dummy_task, *p);
 
+      unsigned int first_section_num = section_num;
       for (unsigned int i = 0;i < (*p)->shnum(); ++i)
         {
+	  if (record_merge_sections
+	      && ((*p)->section_flags(i) & elfcpp::SHF_MERGE) != 0)
+	    this->merge_sections_.insert(Section_id(*p, i));
+
 	  const std::string section_name = (*p)->section_name(i);
           if (!is_section_foldable_candidate(section_name))
             continue;
@@ -724,25 +726,169 @@ Icf::find_identical_sections(const Input_objects* input_objects,
           if (parameters->options().gc_sections()
               && symtab->gc()->is_section_garbage(*p, i))
               continue;
+          bool is_data = (((*p)->section_flags(i) & elfcpp::SHF_EXECINSTR)
+                          == 0);
+          if (is_data)
+            {
+              // Merge sections are already merged, and sections with
+              // no contents can not be compared.
+              if (((*p)->section_flags(i) & elfcpp::SHF_MERGE) != 0
+                  || (*p)->section_type(i) != elfcpp::SHT_PROGBITS)
+                continue;
+              // With --icf=safe, only fold data whose address the
+              // program can not see.
+              if (parameters->options().icf_safe_folding()
+                  && !is_data_vtable_or_vtt(section_name))
+                continue;
+            }
 	  // With --icf=safe, check if the mangled function name is a ctor
 	  // or a dtor.  The mangled function name can be obtained from the
 	  // section name by stripping the section prefix.
-	  if (parameters->options().icf_safe_folding()
-              && !is_function_ctor_or_dtor(section_name)
-	      && (!target.can_check_for_function_pointers()
-                  || section_has_function_pointers(*p, i)))
+	  else if (parameters->options().icf_safe_folding()
+                   && !is_function_ctor_or_dtor(section_name)
+                   && (!target.can_check_for_function_pointers()
+                       || section_has_function_pointers(*p, i)))
             {
 	      continue;
             }
           this->id_section_.push_back(Section_id(*p, i));
           this->section_id_[Section_id(*p, i)] = section_num;
           this->kept_section_id_.push_back(section_num);
-          num_tracked_relocs.push_back(0);
-          is_secn_or_group_unique.push_back(false);
-          section_contents.push_back("");
           section_num++;
         }
+      if (section_num > first_section_num)
+        this->candidate_objects_.push_back(std::make_pair(*p,
+                                                          first_section_num));
+    }
+
+  this->raw_cksum_.resize(section_num);
+  this->is_secn_or_group_unique_.resize(section_num, false);
+  this->section_contents_.resize(section_num);
+  this->tracked_relocs_.resize(section_num);
+  this->contents_state_.resize(section_num, CONTENTS_NONE);
+}
+
+// Return the range of section numbers of candidate object I.
+
+void
+Icf::candidate_range(unsigned int i, unsigned int* begin,
+                     unsigned int* end) const
+{
+  *begin = this->candidate_objects_[i].second;
+  if (i + 1 < this->candidate_objects_.size())
+    *end = this->candidate_objects_[i + 1].second;
+  else
+    *end = this->id_section_.size();
+}
+
+// Compute the checksums of the contents of the candidate sections of
+// candidate object I.  This may run in a task, in which case
+// different tasks set different elements of raw_cksum_.
+
+void
+Icf::checksum_sections(unsigned int i)
+{
+  unsigned int begin, end;
+  this->candidate_range(i, &begin, &end);
+  for (unsigned int j = begin; j < end; ++j)
+    {
+      Section_id secn = this->id_section_[j];
+      section_size_type plen;
+      const unsigned char* contents;
+      contents = secn.first->section_contents(secn.second, &plen, false);
+      this->raw_cksum_[j] = xcrc32(contents, plen, 0xffffffff);
+    }
+}
+
+// Mark the sections whose contents are unique, using the checksums
+// computed by checksum_sections.
+
+void
+Icf::find_unique_sections()
+{
+  gold_assert(this->have_candidates_ && !this->have_unique_sections_);
+  if (!this->have_raw_cksums_)
+    {
+      for (unsigned int i = 0; i < this->candidate_objects_.size(); ++i)
+        {
+          const Task* dummy_task = reinterpret_cast<const Task*>(-1);
+          Task_lock_obj<Object> tl(dummy_task, this->candidate_object(i));
+          this->checksum_sections(i);
+        }
+      this->have_raw_cksums_ = true;
+    }
+  this->preprocess_for_unique_sections(1);
+  this->have_unique_sections_ = true;
+}
+
+// Compute the contents of candidate section I.  If IN_TASK, the
+// section's object is locked by the task and no other object may be
+// read.
+
+bool
+Icf::do_compute_section_contents(Symbol_table* symtab, unsigned int i,
+                                 bool in_task)
+{
+  Section_id secn = this->id_section_[i];
+  return get_section_contents(secn, symtab, in_task ? secn.first : NULL,
+                              this->merge_sections_,
+                              &this->section_contents_[i],
+                              &this->tracked_relocs_[i]);
+}
+
+// Compute the contents of the candidate sections of candidate object
+// I which are not known to be unique.  This is called by an Icf_task,
+// so only this object may be read.  Tasks for different objects set
+// different elements of the vectors.
+
+void
+Icf::compute_section_contents(Symbol_table* symtab, unsigned int i)
+{
+  gold_assert(this->have_unique_sections_);
+  unsigned int begin, end;
+  this->candidate_range(i, &begin, &end);
+  for (unsigned int j = begin; j < end; ++j)
+    {
+      if (this->is_secn_or_group_unique_[j])
+        continue;
+      if (this->do_compute_section_contents(symtab, j, true))
+        this->contents_state_[j] = CONTENTS_DONE;
+      else
+        this->contents_state_[j] = CONTENTS_DEFERRED;
+    }
+}
+
+// This is the main ICF function called in gold.cc.  This does the
+// initialization and calls match_sections repeatedly (twice by default)
+// which computes the crc checksums and detects identical functions.
+// When using threads, the initialization may already have been done
+// by Icf_task tasks.
+
+void
+Icf::find_identical_sections(const Input_objects* input_objects,
+                             Symbol_table* symtab)
+{
+  if (!this->have_candidates_)
+    this->find_candidate_sections(input_objects, symtab);
+  if (!this->have_unique_sections_)
+    this->find_unique_sections();
+
+  // Compute the contents of any sections that the tasks did not.
+  for (unsigned int i = 0; i < this->id_section_.size(); ++i)
+    {
+      if (this->is_secn_or_group_unique_[i]
+          || this->contents_state_[i] == CONTENTS_DONE)
+        continue;
+      // Lock the object so we can read from it.  This is only called
+      // single-threaded from queue_middle_tasks, so it is OK to lock.
+      // Unfortunately we have no way to pass in a Task token.
+      const Task* dummy_task = reinterpret_cast<const Task*>(-1);
+      Task_lock_obj<Object> tl(dummy_task, this->id_section_[i].first);
+      bool ok = this->do_compute_section_contents(symtab, i, false);
+      gold_assert(ok);
+      this->contents_state_[i] = CONTENTS_DONE;
     }
+  this->fingerprint_time_ = this->fingerprint_timer_.get_elapsed_time();
 
   unsigned int num_iterations = 0;
 
@@ -756,10 +902,7 @@ Icf::find_identical_sections(const Input_objects* input_objects,
   while (!converged && (num_iterations < max_iterations))
     {
       num_iterations++;
-      converged = match_sections(num_iterations, symtab,
-                                 &num_tracked_relocs, &this->kept_section_id_,
-                                 this->id_section_, &is_secn_or_group_unique,
-                                 &section_contents);
+      converged = this->match_sections(num_iterations);
     }
 
   if (parameters->options().print_icf_sections())
@@ -772,6 +915,10 @@ Icf::find_identical_sections(const Input_objects* input_objects,
                   program_name, num_iterations);
     }
 
+  // The section contents are no longer needed.
+  std::vector<std::string>().swap(this->section_contents_);
+  std::vector<Tracked_relocs>().swap(this->tracked_relocs_);
+
   // Unfold --keep-unique symbols.
   for (options::String_set::const_iterator p =
 	 parameters->options().keep_unique_begin();
@@ -801,6 +948,93 @@ Icf::find_identical_sections(const Input_objects* input_objects,
   this->icf_ready();
 }
 
+// Print statistics about ICF to stderr.
+
+void
+Icf::print_stats() const
+{
+  fprintf(stderr, _("%s: ICF candidate sections: %zu; in %zu objects\n"),
+          program_name, this->id_section_.size(),
+          this->candidate_objects_.size());
+  fprintf(stderr,
+          _("%s: ICF section contents time: "
+            "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+          program_name,
+          this->fingerprint_time_.user / 1000,
+          (this->fingerprint_time_.user % 1000) * 1000,
+          this->fingerprint_time_.sys / 1000,
+          (this->fingerprint_time_.sys % 1000) * 1000,
+          this->fingerprint_time_.wall / 1000,
+          (this->fingerprint_time_.wall % 1000) * 1000);
+  unsigned int total_folded = 0;
+  for (size_t i = 0; i < this->iteration_stats_.size(); ++i)
+    {
+      const Iteration_stats& stats(this->iteration_stats_[i]);
+      fprintf(stderr,
+              _("%s: ICF iteration %zu: sections compared: %u; "
+                "sections folded: %u; "
+                "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+              program_name, i + 1, stats.compared, stats.folded,
+              stats.time.user / 1000, (stats.time.user % 1000) * 1000,
+              stats.time.sys / 1000, (stats.time.sys % 1000) * 1000,
+              stats.time.wall / 1000, (stats.time.wall % 1000) * 1000);
+      total_folded += stats.folded;
+    }
+  fprintf(stderr, _("%s: ICF sections folded: %u\n"), program_name,
+          total_folded);
+}
+
+// Icf_task methods.
+
+// We need the object to be unlocked.
+
+Task_token*
+Icf_task::is_runnable()
+{
+  Relobj* object = this->symtab_->icf()->candidate_object(this->index_);
+  return object->is_locked() ? object->token() : NULL;
+}
+
+// Lock the object, and hold the blocker until we are done.
+
+void
+Icf_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->blocker_);
+  Relobj* object = this->symtab_->icf()->candidate_object(this->index_);
+  Task_token* token = object->token();
+  if (token != NULL)
+    tl->add(this, token);
+}
+
+void
+Icf_task::run(Workqueue*)
+{
+  Icf* icf = this->symtab_->icf();
+  switch (this->step_)
+    {
+    case ICF_CHECKSUM:
+      icf->checksum_sections(this->index_);
+      break;
+    case ICF_CONTENTS:
+      icf->compute_section_contents(this->symtab_, this->index_);
+      break;
+    default:
+      gold_unreachable();
+    }
+  icf->candidate_object(this->index_)->release();
+}
+
+std::string
+Icf_task::get_name() const
+{
+  Relobj* object = this->symtab_->icf()->candidate_object(this->index_);
+  return ((this->step_ == ICF_CHECKSUM
+	   ? "Icf_task checksum "
+	   : "Icf_task contents ")
+	  + object->name());
+}
+
 // Unfolds the section denoted by OBJ and SHNDX if folded.
 
 void
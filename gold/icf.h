@@ -28,6 +28,8 @@
 #include "elfcpp.h"
 #include "symtab.h"
 #include "object.h"
+#include "timer.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -64,11 +66,32 @@ class Icf
   typedef Unordered_map<Section_id, Reloc_info,
                         Section_id_hash> Reloc_info_list;
 
+  // A reloc to a section which might be folded.  The contents of a
+  // section include the kept section of the target of each such
+  // reloc, which changes as sections are folded.
+  struct Tracked_reloc
+  {
+    // The unique number of the target section.
+    unsigned int section_num;
+    // The symbol value, addend and offset of the reloc, as a string.
+    std::string addend;
+
+    Tracked_reloc(unsigned int section_numa, const std::string& addenda)
+      : section_num(section_numa), addend(addenda)
+    { }
+  };
+
+  typedef std::vector<Tracked_reloc> Tracked_relocs;
+
   Icf()
   : id_section_(), section_id_(), kept_section_id_(),
     fptr_section_id_(),
     icf_ready_(false),
-    reloc_info_list_()
+    reloc_info_list_(), candidate_objects_(), merge_sections_(),
+    raw_cksum_(), is_secn_or_group_unique_(), section_contents_(),
+    tracked_relocs_(), contents_state_(), have_candidates_(false),
+    have_raw_cksums_(false), have_unique_sections_(false),
+    fingerprint_timer_(), fingerprint_time_(), iteration_stats_()
   { }
 
   // Returns the kept folded identical section corresponding to
@@ -82,6 +105,47 @@ class Icf
   find_identical_sections(const Input_objects* input_objects,
                           Symbol_table* symtab);
 
+  // The following functions split up the work done by
+  // find_identical_sections so that parts of it may be done by
+  // Icf_task tasks, one per object.  They must be called in order,
+  // and find_identical_sections will do any steps not already done.
+
+  // Decide which sections are candidates for folding.
+  void
+  find_candidate_sections(const Input_objects* input_objects,
+                          Symbol_table* symtab);
+
+  // The number of objects with candidate sections.
+  unsigned int
+  candidate_object_count() const
+  { return this->candidate_objects_.size(); }
+
+  // The object with candidate sections number I.
+  Relobj*
+  candidate_object(unsigned int i) const
+  { return this->candidate_objects_[i].first; }
+
+  // Compute the checksums of the contents of the candidate sections
+  // of candidate object I.  The object must be locked.
+  void
+  checksum_sections(unsigned int i);
+
+  // Mark the sections whose contents are unique based on those
+  // checksums.
+  void
+  find_unique_sections();
+
+  // Compute the contents, including relocs, of the candidate sections
+  // of candidate object I which are not yet known to be unique.  The
+  // object must be locked.  Sections which need to read other objects
+  // are left to find_identical_sections.
+  void
+  compute_section_contents(Symbol_table* symtab, unsigned int i);
+
+  // Print statistics to stderr.
+  void
+  print_stats() const;
+
   // This is set when ICF has been run and the groups of
   // identical sections have been formed.
   void
@@ -143,6 +207,45 @@ class Icf
   { return this->section_id_; }
 
  private:
+  // The state of a candidate section in contents_state_.
+  enum Contents_state
+  {
+    // The section contents have not been computed.
+    CONTENTS_NONE,
+    // The contents are in section_contents_ and tracked_relocs_.
+    CONTENTS_DONE,
+    // A task could not compute the contents.
+    CONTENTS_DEFERRED
+  };
+
+  // Statistics for one iteration of match_sections.
+  struct Iteration_stats
+  {
+    // The number of sections whose contents were compared.
+    unsigned int compared;
+    // The number of sections folded in this iteration.
+    unsigned int folded;
+    // The time taken.
+    Timer::TimeStats time;
+  };
+
+  // Return the range of section numbers of candidate object I.
+  void
+  candidate_range(unsigned int i, unsigned int* begin,
+                  unsigned int* end) const;
+
+  // Compute the contents of candidate section I.
+  bool
+  do_compute_section_contents(Symbol_table* symtab, unsigned int i,
+                              bool in_task);
+
+  // Do one iteration of the matching.
+  bool
+  match_sections(unsigned int iteration_num);
+
+  // Mark sections with unique contents before iteration ITERATION_NUM.
+  void
+  preprocess_for_unique_sections(unsigned int iteration_num);
 
   // Maps integers to sections.
   std::vector<Section_id> id_section_;
@@ -160,18 +263,101 @@ class Icf
   bool icf_ready_;
   // This list is populated by gc_process_relocs in gc.h.
   Reloc_info_list reloc_info_list_;
+  // The objects with candidate sections, with the number of the
+  // first candidate section in each.
+  std::vector<std::pair<Relobj*, unsigned int> > candidate_objects_;
+  // The SHF_MERGE sections of the input objects, if the target can
+  // inline merge sections.  Tasks use this to avoid reading the
+  // section headers of other objects.
+  Unordered_set<Section_id, Section_id_hash> merge_sections_;
+  // The checksum of the contents of each candidate section.
+  std::vector<uint32_t> raw_cksum_;
+  // Whether a section or a group of identical sections is known to be
+  // unique.
+  std::vector<bool> is_secn_or_group_unique_;
+  // The contents of each candidate section, including relocs to
+  // sections that cannot be folded.
+  std::vector<std::string> section_contents_;
+  // The relocs to sections that may be folded for each candidate.
+  std::vector<Tracked_relocs> tracked_relocs_;
+  // A Contents_state for each candidate.  This is not a vector<bool>
+  // because tasks set different elements in parallel.
+  std::vector<unsigned char> contents_state_;
+  // Which steps have been done.
+  bool have_candidates_;
+  bool have_raw_cksums_;
+  bool have_unique_sections_;
+  // The time taken to compute the section contents.
+  Timer fingerprint_timer_;
+  Timer::TimeStats fingerprint_time_;
+  // Statistics for each iteration.
+  std::vector<Iteration_stats> iteration_stats_;
+};
+
+// A task to do part of the ICF work for one object.
+
+class Icf_task : public Task
+{
+ public:
+  enum Step
+  {
+    // Call Icf::checksum_sections.
+    ICF_CHECKSUM,
+    // Call Icf::compute_section_contents.
+    ICF_CONTENTS
+  };
+
+  Icf_task(Symbol_table* symtab, unsigned int index, Step step,
+           Task_token* blocker)
+    : symtab_(symtab), index_(index), step_(step), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  Symbol_table* symtab_;
+  unsigned int index_;
+  Step step_;
+  Task_token* blocker_;
 };
 
+// This function returns true if this section holds read-only data
+// that --icf-rodata should consider for folding.
+
+inline bool
+is_section_foldable_data_candidate(const std::string& section_name)
+{
+  const char* section_name_cstr = section_name.c_str();
+  return (is_prefix_of(".rodata.", section_name_cstr)
+          || is_prefix_of(".data.rel.ro.", section_name_cstr)
+          || is_prefix_of(".gnu.linkonce.r.", section_name_cstr));
+}
+
 // This function returns true if this section corresponds to a function that
 // should be considered by icf as a possible candidate for folding.  Some
 // earlier gcc versions, like 4.0.3, put constructors and destructors in
 // .gnu.linkonce.t sections and hence should be included too.
+
 inline bool
 is_section_foldable_candidate(const std::string& section_name)
 {
   const char* section_name_cstr = section_name.c_str();
   return (is_prefix_of(".text", section_name_cstr)
-          || is_prefix_of(".gnu.linkonce.t", section_name_cstr));
+          || is_prefix_of(".gnu.linkonce.t", section_name_cstr)
+          || (parameters->options().icf_rodata()
+              && is_section_foldable_data_candidate(section_name)));
 }
 
 } // End of namespace gold.
@@ -96,7 +96,7 @@ dump_incremental_inputs(const char* argv0, const char* filename,
   Incremental_inputs_reader<size, big_endian>
       incremental_inputs(inc->inputs_reader());
 
-  if (incremental_inputs.version() != 2)
+  if (incremental_inputs.version() != 3)
     {
       fprintf(stderr, "%s: %s: unknown incremental version %d\n", argv0,
               filename, incremental_inputs.version());
@@ -112,6 +112,7 @@ dump_incremental_inputs(const char* argv0, const char* filename,
       exit(1);
     }
   printf("Link command line: %s\n", command_line);
+  printf("Symbol name hash size: %u\n", incremental_inputs.name_hash_size());
 
   printf("\nInput files:\n");
   for (unsigned int i = 0; i < incremental_inputs.input_file_count(); ++i)
@@ -132,6 +133,8 @@ dump_incremental_inputs(const char* argv0, const char* filename,
 	     static_cast<unsigned long long>(mtime.seconds),
 	     mtime.nanoseconds,
 	     ctime(&mtime.seconds));
+      printf("    Content hash: 0x%016llx\n",
+	     static_cast<unsigned long long>(input_file.get_content_hash()));
 
       printf("    Serial Number: %d\n", input_file.arg_serial());
       printf("    In System Directory: %s\n",
@@ -44,7 +44,9 @@ namespace gold {
 // Version number for the .gnu_incremental_inputs section.
 // Version 1 was the initial checkin.
 // Version 2 adds some padding to ensure 8-byte alignment where necessary.
-const unsigned int INCREMENTAL_LINK_VERSION = 2;
+// Version 3 adds a hash of the contents of each input file, and the
+// length and hash code of each global symbol name.
+const unsigned int INCREMENTAL_LINK_VERSION = 3;
 
 // This class manages the .gnu_incremental_inputs section, which holds
 // the header information, a directory of input files, and separate
@@ -125,6 +127,8 @@ class Output_section_incremental_inputs : public Output_section_data
       Incremental_inputs_reader<size, big_endian>::global_sym_entry_size;
   static const unsigned int incr_reloc_size =
       Incremental_relocs_reader<size, big_endian>::reloc_size;
+  static const unsigned int symtab_entry_size =
+      Incremental_symtab_reader<big_endian>::entry_size;
 
   // The Incremental_inputs object.
   const Incremental_inputs* inputs_;
@@ -311,7 +315,8 @@ Sized_incremental_binary<size, big_endian>::setup_readers()
   for (unsigned int i = 0; i < count; i++)
     {
       Input_entry_reader input_file = inputs.input_file(i);
-      this->input_entry_readers_.push_back(Sized_input_reader(input_file));
+      this->input_entry_readers_.push_back(Sized_input_reader(input_file,
+							      this, i));
       switch (input_file.type())
 	{
 	case INCREMENTAL_INPUT_OBJECT:
@@ -352,10 +357,22 @@ Sized_incremental_binary<size, big_endian>::setup_readers()
 	}
     }
 
+  this->content_checks_.resize(count);
+
   // Initialize the map of global symbols.
   unsigned int nglobals = this->symtab_reader_.symbol_count();
   this->symbol_map_.resize(nglobals);
 
+  // The symbol name hash codes are only useful if they were computed
+  // the same way we compute them now.  The hash function is part of
+  // the file format, so a change to Stringpool::hash_string must bump
+  // INCREMENTAL_LINK_VERSION; beyond that, the codes are only correct
+  // here if the linker that wrote them used a size_t at least as wide
+  // as ours, which it records in the header.
+  this->has_name_hashes_ =
+    (inputs.version() == INCREMENTAL_LINK_VERSION
+     && inputs.name_hash_size() >= sizeof(size_t));
+
   this->has_incremental_info_ = true;
 }
 
@@ -474,6 +491,7 @@ Sized_incremental_binary<size, big_endian>::do_file_has_changed(
     unsigned int n) const
 {
   Input_entry_reader input_file = this->inputs_reader_.input_file(n);
+  const unsigned int input_index = n;
   Incremental_disposition disp = INCREMENTAL_CHECK;
 
   // For files named in scripts, find the file that was actually named
@@ -507,12 +525,34 @@ Sized_incremental_binary<size, big_endian>::do_file_has_changed(
       return true;
     }
 
-  if (new_mtime.seconds > old_mtime.seconds)
-    return true;
+  if (new_mtime.seconds < old_mtime.seconds)
+    return false;
   if (new_mtime.seconds == old_mtime.seconds
-      && new_mtime.nanoseconds > old_mtime.nanoseconds)
+      && new_mtime.nanoseconds <= old_mtime.nanoseconds)
+    return false;
+
+  // The file has been touched.  If we recorded a hash of its contents,
+  // it has only changed if the contents have.
+  uint64_t old_hash = input_file.get_content_hash();
+  if (old_hash == 0)
     return true;
-  return false;
+
+  Content_check& check(this->content_checks_[input_index]);
+  if (check.status == CONTENT_UNKNOWN)
+    {
+      uint64_t new_hash;
+      if (get_content_hash(filename, &new_hash) && new_hash == old_hash)
+	{
+	  gold_debug(DEBUG_INCREMENTAL,
+		     "%s: timestamp changed but contents unchanged",
+		     filename);
+	  check.status = CONTENT_SAME;
+	  check.mtime = new_mtime;
+	}
+      else
+	check.status = CONTENT_CHANGED;
+    }
+  return check.status == CONTENT_CHANGED;
 }
 
 // Initialize the layout of the output file based on the existing
@@ -1028,6 +1068,7 @@ Incremental_inputs::report_archive_begin(Library_base* arch,
   this->strtab_->add(arch->filename().c_str(), false, &filename_key);
   Incremental_archive_entry* entry =
       new Incremental_archive_entry(filename_key, arg_serial, mtime);
+  entry->set_content_hash(arch->get_content_hash());
   arch->set_incremental_info(entry);
 
   if (script_info != NULL)
@@ -1132,6 +1173,11 @@ Incremental_inputs::report_object(Object* obj, unsigned int arg_serial,
   if (obj->as_needed())
     input_entry->set_as_needed();
 
+  // Archive members are checked by the timestamp and contents of the
+  // archive itself, so we don't hash them separately.
+  if (arch == NULL)
+    input_entry->set_content_hash(obj->get_content_hash());
+
   this->inputs_.push_back(input_entry);
 
   if (script_info != NULL)
@@ -1186,6 +1232,9 @@ Incremental_inputs::report_script(Script_info* script,
   this->strtab_->add(script->filename().c_str(), false, &filename_key);
   Incremental_script_entry* entry =
       new Incremental_script_entry(filename_key, arg_serial, script, mtime);
+  uint64_t content_hash;
+  if (get_content_hash(script->filename().c_str(), &content_hash))
+    entry->set_content_hash(content_hash);
   this->inputs_.push_back(entry);
   script->set_incremental_info(entry);
 }
@@ -1240,12 +1289,19 @@ Incremental_inputs::create_data_sections(Symbol_table* symtab)
     default:
       gold_unreachable();
     }
-  this->symtab_section_ = new Output_data_space(4, "** incremental_symtab");
+  this->symtab_section_ = new Output_data_space(8, "** incremental_symtab");
   this->relocs_section_ = new Output_data_space(reloc_align,
 						"** incremental_relocs");
   this->got_plt_section_ = new Output_data_space(4, "** incremental_got_plt");
 }
 
+// Return the sh_entsize value for the .gnu_incremental_symtab section.
+unsigned int
+Incremental_inputs::symtab_entsize() const
+{
+  return Incremental_symtab_reader<false>::entry_size;
+}
+
 // Return the sh_entsize value for the .gnu_incremental_relocs section.
 unsigned int
 Incremental_inputs::relocs_entsize() const
@@ -1368,7 +1424,7 @@ Output_section_incremental_inputs<size, big_endian>::set_final_data_size()
 
   // Set the size of the .gnu_incremental_symtab section.
   inputs->symtab_section()->set_current_data_size(this->symtab_->output_count()
-						  * sizeof(unsigned int));
+						  * this->symtab_entry_size);
 
   // Set the size of the .gnu_incremental_relocs section.
   inputs->relocs_section()->set_current_data_size(inputs->get_reloc_count()
@@ -1432,7 +1488,8 @@ Output_section_incremental_inputs<size, big_endian>::do_write(Output_file* of)
   gold_assert(pov - oview == oview_size);
 
   // Write the .gnu_incremental_symtab section.
-  gold_assert(static_cast<off_t>(global_sym_count) * 4 == symtab_size);
+  gold_assert(static_cast<off_t>(global_sym_count) * this->symtab_entry_size
+	      == symtab_size);
   this->write_symtab(symtab_view, global_syms, global_sym_count);
 
   delete[] global_syms;
@@ -1450,7 +1507,7 @@ Output_section_incremental_inputs<size, big_endian>::do_write(Output_file* of)
 }
 
 // Write the section header: version, input file count, offset of command line
-// in the string table, and 4 bytes of padding.
+// in the string table, and size of the symbol name hash codes.
 
 template<int size, bool big_endian>
 unsigned char*
@@ -1462,7 +1519,7 @@ Output_section_incremental_inputs<size, big_endian>::write_header(
   Swap32::writeval(pov, INCREMENTAL_LINK_VERSION);
   Swap32::writeval(pov + 4, input_file_count);
   Swap32::writeval(pov + 8, command_line_offset);
-  Swap32::writeval(pov + 12, 0);
+  Swap32::writeval(pov + 12, sizeof(size_t));
   gold_assert(this->header_size == 16);
   return pov + this->header_size;
 }
@@ -1498,7 +1555,8 @@ Output_section_incremental_inputs<size, big_endian>::write_input_files(
       Swap32::writeval(pov + 16, mtime.nanoseconds);
       Swap16::writeval(pov + 20, flags);
       Swap16::writeval(pov + 22, (*p)->arg_serial());
-      gold_assert(this->input_entry_size == 24);
+      Swap64::writeval(pov + 24, (*p)->get_content_hash());
+      gold_assert(this->input_entry_size == 32);
       pov += this->input_entry_size;
     }
   return pov;
@@ -1784,6 +1842,47 @@ Output_section_incremental_inputs<size, big_endian>::write_info_blocks(
   return pov;
 }
 
+// Class Global_symbol_visitor_name_hash.  Visitor class for writing the
+// length and hash code of each global symbol name into the
+// .gnu_incremental_symtab section.
+
+template<int size, bool big_endian>
+class Global_symbol_visitor_name_hash
+{
+ public:
+  Global_symbol_visitor_name_hash(unsigned char* pov,
+				  unsigned int first_global_index,
+				  unsigned int global_sym_count)
+    : pov_(pov), first_global_index_(first_global_index),
+      global_sym_count_(global_sym_count)
+  { }
+
+  void
+  operator()(const Sized_symbol<size>* sym)
+  {
+    unsigned int symtab_index = sym->symtab_index();
+    if (symtab_index == -1U
+	|| symtab_index < this->first_global_index_
+	|| symtab_index - this->first_global_index_ >= this->global_sym_count_)
+      return;
+    const char* name = sym->name();
+    size_t len = strlen(name);
+    unsigned char* p =
+      (this->pov_
+       + ((symtab_index - this->first_global_index_)
+	  * Incremental_symtab_reader<big_endian>::entry_size));
+    elfcpp::Swap<32, big_endian>::writeval(p + 4, len);
+    uint64_t hash = Stringpool::hash_string(name, len);
+    elfcpp::Swap<64, big_endian>::writeval(p + 8, hash);
+  }
+
+ private:
+
+  unsigned char* pov_;
+  unsigned int first_global_index_;
+  unsigned int global_sym_count_;
+};
+
 // Write the contents of the .gnu_incremental_symtab section.
 
 template<int size, bool big_endian>
@@ -1795,9 +1894,19 @@ Output_section_incremental_inputs<size, big_endian>::write_symtab(
 {
   for (unsigned int i = 0; i < global_sym_count; ++i)
     {
-      Swap32::writeval(pov, global_syms[i]);
-      pov += 4;
+      unsigned char* p = pov + i * this->symtab_entry_size;
+      Swap32::writeval(p, global_syms[i]);
+      Swap32::writeval(p + 4, 0);
+      Swap64::writeval(p + 8, 0);
     }
+
+  // Record the length and hash code of each global symbol name, so
+  // that an incremental update can add the names to the symbol table
+  // without scanning them again.
+  typedef Global_symbol_visitor_name_hash<size, big_endian> Symbol_visitor;
+  this->symtab_->for_all_symbols<size, Symbol_visitor>(
+      Symbol_visitor(pov, this->symtab_->first_global_index(),
+		     global_sym_count));
 }
 
 // This struct holds the view information needed to write the
@@ -2191,7 +2300,12 @@ Sized_relobj_incr<size, big_endian>::do_add_symbols(
       osym.put_st_other(gsym.get_st_other());
       osym.put_st_shndx(shndx);
 
-      Symbol* res = symtab->add_from_incrobj(this, name, NULL, &sym);
+      size_t name_len;
+      size_t name_hash;
+      this->ibase_->global_symbol_name_hash(output_symndx - first_global,
+					    name, &name_len, &name_hash);
+      Symbol* res = symtab->add_from_incrobj(this, name, name_len, name_hash,
+					     NULL, &sym);
 
       if (shndx != elfcpp::SHN_UNDEF)
 	++this->defined_count_;
@@ -2790,8 +2904,13 @@ Sized_incr_dynobj<size, big_endian>::do_add_symbols(
       osym.put_st_other(gsym.get_st_other());
       osym.put_st_shndx(shndx);
 
+      size_t name_len;
+      size_t name_hash;
+      this->ibase_->global_symbol_name_hash(output_symndx - first_global,
+					    name, &name_len, &name_hash);
       Sized_symbol<size>* res =
-	  symtab->add_from_incrobj<size, big_endian>(this, name, NULL, &sym);
+	  symtab->add_from_incrobj<size, big_endian>(this, name, name_len,
+						     name_hash, NULL, &sym);
       this->symbols_[i] = res;
       this->ibase_->add_global_symbol(output_symndx - first_global,
 				      this->symbols_[i]);
@@ -100,8 +100,8 @@ class Incremental_input_entry
   Incremental_input_entry(Stringpool::Key filename_key, unsigned int arg_serial,
 			  Timespec mtime)
     : filename_key_(filename_key), file_index_(0), offset_(0), info_offset_(0),
-      arg_serial_(arg_serial), mtime_(mtime), is_in_system_directory_(false),
-      as_needed_(false)
+      arg_serial_(arg_serial), mtime_(mtime), content_hash_(0),
+      is_in_system_directory_(false), as_needed_(false)
   { }
 
   virtual
@@ -156,6 +156,17 @@ class Incremental_input_entry
   get_mtime() const
   { return this->mtime_; }
 
+  // Record a hash of the contents of the input file.
+  void
+  set_content_hash(uint64_t content_hash)
+  { this->content_hash_ = content_hash; }
+
+  // Get the hash of the contents of the input file, or 0 if none was
+  // recorded.
+  uint64_t
+  get_content_hash() const
+  { return this->content_hash_; }
+
   // Record that the file was found in a system directory.
   void
   set_is_in_system_directory()
@@ -248,6 +259,9 @@ class Incremental_input_entry
   // Last modification time of the file.
   Timespec mtime_;
 
+  // Hash of the contents of the file, or 0.
+  uint64_t content_hash_;
+
   // TRUE if the file was found in a system directory.
   bool is_in_system_directory_;
 
@@ -665,6 +679,10 @@ class Incremental_inputs
   input_files() const
   { return this->inputs_; }
 
+  // Return the sh_entsize value for the .gnu_incremental_symtab section.
+  unsigned int
+  symtab_entsize() const;
+
   // Return the sh_entsize value for the .gnu_incremental_relocs section.
   unsigned int
   relocs_entsize() const;
@@ -757,11 +775,12 @@ class Incremental_inputs_reader
 
  public:
   // Size of the .gnu_incremental_inputs header.
-  // (3 x 4-byte fields, plus 4 bytes padding.)
+  // (4 x 4-byte fields.)
   static const unsigned int header_size = 16;
   // Size of an input file entry.
-  // (2 x 4-byte fields, 1 x 12-byte field, 2 x 2-byte fields.)
-  static const unsigned int input_entry_size = 24;
+  // (2 x 4-byte fields, 1 x 12-byte field, 2 x 2-byte fields,
+  // 1 x 8-byte field.)
+  static const unsigned int input_entry_size = 32;
   // Size of the first part of the supplemental info block for
   // relocatable objects and archive members.
   // (7 x 4-byte fields, plus 4 bytes padding.)
@@ -800,6 +819,13 @@ class Incremental_inputs_reader
     return this->get_string(offset);
   }
 
+  // Return the size in bytes of the symbol name hash codes in the
+  // .gnu_incremental_symtab section, which is the size of size_t on
+  // the host which computed them.
+  unsigned int
+  name_hash_size() const
+  { return Swap32::readval(this->p_ + 12); }
+
   // Reader class for an input file entry and its supplemental info.
   class Incremental_input_entry_reader
   {
@@ -846,6 +872,11 @@ class Incremental_inputs_reader
       return t;
     }
 
+    // Return the hash of the file contents, or 0 if none was recorded.
+    uint64_t
+    get_content_hash() const
+    { return Swap64::readval(this->inputs_->p_ + this->offset_ + 24); }
+
     // Return the type of input file.
     Incremental_input_type
     type() const
@@ -1172,6 +1203,10 @@ template<bool big_endian>
 class Incremental_symtab_reader
 {
  public:
+  // Size of a symbol entry: list head, name length, name hash.
+  // (2 x 4-byte fields, 1 x 8-byte field.)
+  static const unsigned int entry_size = 16;
+
   Incremental_symtab_reader()
     : p_(NULL), len_(0)
   { }
@@ -1183,12 +1218,32 @@ class Incremental_symtab_reader
   // Return the count of symbols in this section.
   unsigned int
   symbol_count() const
-  { return static_cast<unsigned int>(this->len_ / 4); }
+  { return static_cast<unsigned int>(this->len_ / entry_size); }
 
   // Return the list head for symbol table entry N.
   unsigned int
   get_list_head(unsigned int n) const
-  { return elfcpp::Swap<32, big_endian>::readval(this->p_ + 4 * n); }
+  {
+    return elfcpp::Swap<32, big_endian>::readval(this->p_
+						 + entry_size * n);
+  }
+
+  // Return the length of the name of symbol table entry N.
+  unsigned int
+  get_name_length(unsigned int n) const
+  {
+    return elfcpp::Swap<32, big_endian>::readval(this->p_
+						 + entry_size * n + 4);
+  }
+
+  // Return the hash code of the name of symbol table entry N, as
+  // computed by Stringpool::hash_string.
+  uint64_t
+  get_name_hash(unsigned int n) const
+  {
+    return elfcpp::Swap<64, big_endian>::readval(this->p_
+						 + entry_size * n + 8);
+  }
 
  private:
   // Base address of the .gnu_incremental_relocs section.
@@ -1380,6 +1435,10 @@ class Incremental_binary
     get_mtime() const
     { return this->do_get_mtime(); }
 
+    uint64_t
+    get_content_hash() const
+    { return this->do_get_content_hash(); }
+
     Incremental_input_type
     type() const
     { return this->do_type(); }
@@ -1403,6 +1462,9 @@ class Incremental_binary
     virtual Timespec
     do_get_mtime() const = 0;
 
+    virtual uint64_t
+    do_get_content_hash() const = 0;
+
     virtual Incremental_input_type
     do_type() const = 0;
 
@@ -1595,8 +1657,9 @@ class Sized_incremental_binary : public Incremental_binary
     : Incremental_binary(output, target), elf_file_(this, ehdr),
       input_objects_(), section_map_(), symbol_map_(), copy_relocs_(),
       main_symtab_loc_(), main_strtab_loc_(), has_incremental_info_(false),
-      inputs_reader_(), symtab_reader_(), relocs_reader_(), got_plt_reader_(),
-      input_entry_readers_()
+      has_name_hashes_(false), inputs_reader_(), symtab_reader_(),
+      relocs_reader_(), got_plt_reader_(), input_entry_readers_(),
+      content_checks_()
   { this->setup_readers(); }
 
   // Returns TRUE if the file contains incremental info.
@@ -1637,6 +1700,42 @@ class Sized_incremental_binary : public Incremental_binary
   global_symbol(unsigned int symndx) const
   { return this->symbol_map_[symndx]; }
 
+  // Return the modification time to record for input file N.  This
+  // is the time in the base file, unless file_has_changed found that
+  // the file was touched without changing its contents, in which case
+  // it is the new time, so that later links need not hash the file
+  // again.
+  Timespec
+  input_file_mtime(unsigned int n) const
+  {
+    gold_assert(n < this->content_checks_.size());
+    const Content_check& check(this->content_checks_[n]);
+    if (check.status == CONTENT_SAME)
+      return check.mtime;
+    return this->inputs_reader_.input_file(n).get_mtime();
+  }
+
+  // Set *PLEN and *PHASH to the length and Stringpool hash code of
+  // NAME, the name of global symbol SYMNDX in the base file.  These
+  // are taken from the .gnu_incremental_symtab section when
+  // possible, so that the name need not be scanned again.
+  void
+  global_symbol_name_hash(unsigned int symndx, const char* name,
+			  size_t* plen, size_t* phash) const
+  {
+    if (this->has_name_hashes_)
+      {
+	*plen = this->symtab_reader_.get_name_length(symndx);
+	*phash =
+	  static_cast<size_t>(this->symtab_reader_.get_name_hash(symndx));
+      }
+    else
+      {
+	*plen = strlen(name);
+	*phash = Stringpool::hash_string(name, *plen);
+      }
+  }
+
   // Add a COPY relocation for a global symbol.
   void
   add_copy_reloc(Symbol* gsym, Output_section* os, off_t offset)
@@ -1704,8 +1803,11 @@ class Sized_incremental_binary : public Incremental_binary
   class Sized_input_reader : public Input_reader
   {
    public:
-    Sized_input_reader(Input_entry_reader r)
-      : Input_reader(), reader_(r)
+    Sized_input_reader(Input_entry_reader r,
+		       const Sized_incremental_binary* ibase,
+		       unsigned int input_file_index)
+      : Input_reader(), reader_(r), ibase_(ibase),
+	input_file_index_(input_file_index)
     { }
 
     virtual
@@ -1719,7 +1821,11 @@ class Sized_incremental_binary : public Incremental_binary
 
     Timespec
     do_get_mtime() const
-    { return this->reader_.get_mtime(); }
+    { return this->ibase_->input_file_mtime(this->input_file_index_); }
+
+    uint64_t
+    do_get_content_hash() const
+    { return this->reader_.get_content_hash(); }
 
     Incremental_input_type
     do_type() const
@@ -1738,6 +1844,8 @@ class Sized_incremental_binary : public Incremental_binary
     { return this->reader_.get_unused_symbol(n); }
 
     Input_entry_reader reader_;
+    const Sized_incremental_binary* ibase_;
+    unsigned int input_file_index_;
   };
 
   virtual unsigned int
@@ -1778,6 +1886,28 @@ class Sized_incremental_binary : public Incremental_binary
   void
   setup_readers();
 
+  // Whether an input file has the same contents as in the base file.
+  enum Content_status
+  {
+    CONTENT_UNKNOWN,
+    CONTENT_SAME,
+    CONTENT_CHANGED
+  };
+
+  // The result of checking the contents of an input file whose
+  // timestamp has changed.
+  struct Content_check
+  {
+    Content_check()
+      : status(CONTENT_UNKNOWN), mtime()
+    { }
+
+    // Whether the contents have changed.
+    Content_status status;
+    // The new modification time, if the contents are the same.
+    Timespec mtime;
+  };
+
   // Output as an ELF file.
   elfcpp::Elf_file<size, big_endian, Incremental_binary> elf_file_;
 
@@ -1800,11 +1930,20 @@ class Sized_incremental_binary : public Incremental_binary
 
   // Readers for the incremental info sections.
   bool has_incremental_info_;
+  // Whether the name lengths and hash codes in the
+  // .gnu_incremental_symtab section can be used.
+  bool has_name_hashes_;
   Incremental_inputs_reader<size, big_endian> inputs_reader_;
   Incremental_symtab_reader<big_endian> symtab_reader_;
   Incremental_relocs_reader<size, big_endian> relocs_reader_;
   Incremental_got_plt_reader<big_endian> got_plt_reader_;
   std::vector<Sized_input_reader> input_entry_readers_;
+
+  // For each input file whose timestamp has changed, whether its
+  // contents have changed.  This caches the result of hashing the
+  // file, since file_has_changed is called for an archive once for
+  // each member.
+  mutable std::vector<Content_check> content_checks_;
 };
 
 // An incremental Relobj.  This class represents a relocatable object
@@ -1867,7 +2006,12 @@ class Sized_relobj_incr : public Sized_relobj<size, big_endian>
   // Return the last modified time of the file.
   Timespec
   do_get_mtime()
-  { return this->input_reader_.get_mtime(); }
+  { return this->ibase_->input_file_mtime(this->input_file_index_); }
+
+  // Return the hash of the file contents.
+  uint64_t
+  do_get_content_hash()
+  { return this->input_reader_.get_content_hash(); }
 
   // Read the symbols.
   void
@@ -2078,7 +2222,12 @@ class Sized_incr_dynobj : public Dynobj
   // Return the last modified time of the file.
   Timespec
   do_get_mtime()
-  { return this->input_reader_.get_mtime(); }
+  { return this->ibase_->input_file_mtime(this->input_file_index_); }
+
+  // Return the hash of the file contents.
+  uint64_t
+  do_get_content_hash()
+  { return this->input_reader_.get_content_hash(); }
 
   // Read the symbols.
   void
@@ -2234,6 +2383,11 @@ class Incremental_library : public Library_base
   do_get_mtime()
   { return this->input_reader_->get_mtime(); }
 
+  // Return the hash of the contents of the archive file.
+  uint64_t
+  do_get_content_hash()
+  { return this->input_reader_->get_content_hash(); }
+
   // Iterator for unused global symbols in the library.
   void
   do_for_all_unused_symbols(Symbol_visitor_base* v) const;
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <utility>
 #include <fcntl.h>
 #include <fnmatch.h>
@@ -369,7 +370,7 @@ void
 Layout_task_runner::run(Workqueue* workqueue, const Task* task)
 {
   // See if any of the input definitions violate the One Definition Rule.
-  // TODO: if this is too slow, do this as a task, rather than inline.
+  // With threads, the line information was read by Odr_task tasks.
   this->symtab_->detect_odr_violations(task, this->options_.output_file_name());
 
   Layout* layout = this->layout_;
@@ -412,9 +413,14 @@ Layout_task_runner::run(Workqueue* workqueue, const Task* task)
       of->resize(file_size);
     }
 
-  // Queue up the final set of tasks.
-  gold::queue_final_tasks(this->options_, this->input_objects_,
-			  this->symtab_, layout, workqueue, of);
+  // Queue up the final set of tasks, after faulting in the output file
+  // if requested.
+  if (this->options_.prefault_output_file())
+    gold::queue_prefault_tasks(this->options_, this->input_objects_,
+			       this->symtab_, layout, workqueue, of);
+  else
+    gold::queue_final_tasks(this->options_, this->input_objects_,
+			    this->symtab_, layout, workqueue, of);
 }
 
 // Layout methods.
@@ -444,6 +450,7 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     dynamic_section_(NULL),
     dynamic_symbol_(NULL),
     dynamic_data_(NULL),
+    dynamic_relocs_(NULL),
     eh_frame_section_(NULL),
     eh_frame_data_(NULL),
     added_eh_frame_data_(false),
@@ -477,6 +484,10 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     section_segment_map_(),
     input_section_position_(),
     input_section_glob_(),
+    call_graph_edges_(),
+    hot_text_names_(),
+    hot_text_globs_(),
+    hot_text_sections_(),
     incremental_base_(NULL),
     free_list_()
 {
@@ -1215,6 +1226,14 @@ Layout::layout(Sized_relobj_file<size, big_endian>* object, unsigned int shndx,
       && Layout::special_ordering_of_input_section(name) >= 0)
     os->set_must_sort_attached_input_sections();
 
+  // Remember the hot sections which go into .text, for
+  // place_hot_text_sections.
+  if (parameters->options().hot_text()
+      && !this->script_options_->saw_sections_clause()
+      && strcmp(os->name(), ".text") == 0
+      && this->is_hot_text_section(name))
+    this->hot_text_sections_.insert(Section_id(object, shndx));
+
   // If this is a .ctors or .ctors.* section being mapped to a
   // .init_array section, or a .dtors or .dtors.* section being mapped
   // to a .fini_array section, we will need to reverse the words if
@@ -1713,6 +1732,13 @@ Layout::make_output_section(const char* name, elfcpp::Elf_Word type,
       && strcmp(name, ".text") == 0)
     os->set_may_sort_attached_input_sections();
 
+  // With --hot-text we move the hot .text sections to the front, so
+  // we need to keep track of the input sections.
+  if (parameters->options().hot_text()
+      && !this->script_options_->saw_sections_clause()
+      && strcmp(name, ".text") == 0)
+    os->set_may_sort_attached_input_sections();
+
   // GNU linker sorts section by name with --sort-section=name.
   if (strcmp(parameters->options().sort_section(), "name") == 0)
       os->set_must_sort_attached_input_sections();
@@ -2613,6 +2639,465 @@ Layout::read_layout_from_file()
     }
 }
 
+// Read the call graph profile specified with --call-graph-ordering.
+// Each line has the form "CALLER CALLEE WEIGHT", where CALLER and
+// CALLEE are symbol names and WEIGHT is the number of calls, or any
+// other measure of how hot the edge is.  Lines starting with '#' are
+// comments.
+
+void
+Layout::read_call_graph_profile()
+{
+  const char* filename = parameters->options().call_graph_ordering();
+  std::ifstream in(filename);
+  if (!in)
+    gold_fatal(_("unable to open --call-graph-ordering file %s: %s"),
+	       filename, strerror(errno));
+
+  // Input sections must be recorded so that they can be sorted.
+  this->set_section_ordering_specified();
+
+  std::string line;
+  unsigned int lineno = 0;
+  while (std::getline(in, line))
+    {
+      ++lineno;
+      size_t start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos || line[start] == '#')
+	continue;
+
+      std::istringstream fields(line);
+      Call_graph_edge edge;
+      std::string extra;
+      if (!(fields >> edge.caller >> edge.callee >> edge.weight)
+	  || (fields >> extra))
+	{
+	  gold_error(_("%s:%u: expected CALLER CALLEE WEIGHT"),
+		     filename, lineno);
+	  continue;
+	}
+      if (edge.weight != 0)
+	this->call_graph_edges_.push_back(edge);
+    }
+}
+
+// Order the sections named by the call graph.  This uses the
+// Call-Chain Clustering (C3) heuristic described by Ottoni and Maher
+// in "Optimizing Function Placement for Large-Scale Data-Center
+// Applications".  Each section starts as a cluster of its own.
+// Visiting the sections from the most to the least dense, where
+// density is the weight of incoming calls divided by the size, each
+// cluster is appended to the cluster of its most frequent caller,
+// unless the result would be too large or much less dense.  The
+// clusters are then placed in order of density.  This keeps hot call
+// chains together within a few pages, which helps the instruction
+// cache and the iTLB.
+
+// The maximum size of a cluster.  Past this, a cluster no longer
+// fits in a large page, and merging does not help.
+static const uint64_t call_graph_max_cluster_size = 1024 * 1024;
+
+// A cluster is not merged into its caller's cluster if that would
+// make the caller's cluster this many times less dense.
+static const double call_graph_max_density_degradation = 8.0;
+
+// A cluster is not merged into its caller's cluster if the calls from
+// that caller are at most this fraction of all the calls to it.
+static const double call_graph_min_caller_fraction = 0.1;
+
+// A node in the call graph: an input section.
+
+struct Call_graph_node
+{
+  Call_graph_node(Relobj* relobj_arg, unsigned int shndx_arg,
+		  Output_section* os_arg, uint64_t size_arg)
+    : relobj(relobj_arg), shndx(shndx_arg), os(os_arg),
+      size(size_arg == 0 ? 1 : size_arg), weight(0), initial_weight(0),
+      best_caller(-1U), best_caller_weight(0), leader(-1U), next(-1U),
+      tail(-1U)
+  { }
+
+  double
+  density() const
+  { return static_cast<double>(this->weight) / this->size; }
+
+  // The input section.
+  Relobj* relobj;
+  unsigned int shndx;
+  Output_section* os;
+  // The size and weight of the cluster this node leads.
+  uint64_t size;
+  uint64_t weight;
+  // The weight of the calls to this node alone.
+  uint64_t initial_weight;
+  // The node which calls this one most often, and how often.
+  unsigned int best_caller;
+  uint64_t best_caller_weight;
+  // The leader of the cluster holding this node.
+  unsigned int leader;
+  // The next node in the cluster, and, for a leader, the last node.
+  unsigned int next;
+  unsigned int tail;
+};
+
+// Sort the nodes by decreasing density, keeping the input order for
+// nodes of the same density.
+
+class Call_graph_density_compare
+{
+ public:
+  Call_graph_density_compare(const std::vector<Call_graph_node>& nodes)
+    : nodes_(nodes)
+  { }
+
+  bool
+  operator()(unsigned int i1, unsigned int i2) const
+  {
+    double d1 = this->nodes_[i1].density();
+    double d2 = this->nodes_[i2].density();
+    if (d1 != d2)
+      return d1 > d2;
+    return i1 < i2;
+  }
+
+ private:
+  const std::vector<Call_graph_node>& nodes_;
+};
+
+// Return the leader of the cluster holding node I.
+
+static unsigned int
+call_graph_leader(std::vector<Call_graph_node>* nodes, unsigned int i)
+{
+  unsigned int leader = i;
+  while ((*nodes)[leader].leader != leader)
+    leader = (*nodes)[leader].leader;
+  // Compress the path.
+  while ((*nodes)[i].leader != leader)
+    {
+      unsigned int next = (*nodes)[i].leader;
+      (*nodes)[i].leader = leader;
+      i = next;
+    }
+  return leader;
+}
+
+// Order the input sections in the call graph, by merging each
+// function into the cluster of its most frequent caller and placing
+// the densest clusters first.  The order is recorded in
+// section_order_map_, which a plugin may not also set; see
+// update_section_order in plugin.cc.
+
+void
+Layout::order_sections_by_call_graph(const Symbol_table* symtab)
+{
+  gold_assert(this->section_order_map_.empty());
+
+  if (this->call_graph_edges_.empty())
+    return;
+
+  // Find the input section defining each symbol in the call graph.
+  std::vector<Call_graph_node> nodes;
+  std::map<Section_id, unsigned int> node_index;
+  Unordered_map<std::string, unsigned int> symbol_node;
+  for (std::vector<Call_graph_edge>::const_iterator p =
+	 this->call_graph_edges_.begin();
+       p != this->call_graph_edges_.end();
+       ++p)
+    {
+      const std::string* names[2] = { &p->caller, &p->callee };
+      for (int i = 0; i < 2; ++i)
+	{
+	  if (symbol_node.find(*names[i]) != symbol_node.end())
+	    continue;
+	  unsigned int index = -1U;
+	  const Symbol* sym = symtab->lookup(names[i]->c_str());
+	  bool is_ordinary;
+	  if (sym != NULL
+	      && sym->source() == Symbol::FROM_OBJECT
+	      && sym->is_defined()
+	      && !sym->object()->is_dynamic()
+	      && !sym->object()->pluginobj())
+	    {
+	      unsigned int shndx = sym->shndx(&is_ordinary);
+	      Relobj* relobj = static_cast<Relobj*>(sym->object());
+	      Output_section* os = (is_ordinary
+				    ? relobj->output_section(shndx)
+				    : NULL);
+	      if (os != NULL)
+		{
+		  Section_id secid(relobj, shndx);
+		  std::map<Section_id, unsigned int>::const_iterator q =
+		    node_index.find(secid);
+		  if (q != node_index.end())
+		    index = q->second;
+		  else
+		    {
+		      index = nodes.size();
+		      node_index[secid] = index;
+		      uint64_t secsize = relobj->section_size(shndx);
+		      nodes.push_back(Call_graph_node(relobj, shndx, os,
+						      secsize));
+		    }
+		}
+	    }
+	  symbol_node[*names[i]] = index;
+	}
+    }
+
+  if (nodes.empty())
+    return;
+
+  // Add up the weight of the calls to each node, and find the most
+  // frequent caller of each node.  Calls between output sections do
+  // not help.
+  for (std::vector<Call_graph_edge>::const_iterator p =
+	 this->call_graph_edges_.begin();
+       p != this->call_graph_edges_.end();
+       ++p)
+    {
+      unsigned int from = symbol_node[p->caller];
+      unsigned int to = symbol_node[p->callee];
+      if (from == -1U || to == -1U || nodes[from].os != nodes[to].os)
+	continue;
+      Call_graph_node* callee = &nodes[to];
+      callee->weight += p->weight;
+      if (from != to && p->weight > callee->best_caller_weight)
+	{
+	  callee->best_caller = from;
+	  callee->best_caller_weight = p->weight;
+	}
+    }
+
+  std::vector<unsigned int> sorted(nodes.size());
+  for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+      nodes[i].initial_weight = nodes[i].weight;
+      nodes[i].leader = i;
+      nodes[i].tail = i;
+      sorted[i] = i;
+    }
+  std::stable_sort(sorted.begin(), sorted.end(),
+		   Call_graph_density_compare(nodes));
+
+  // Merge each cluster into the cluster of its best caller.  When a
+  // node is visited it still leads its own cluster, because clusters
+  // are only merged into their caller's cluster.
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      Call_graph_node* c = &nodes[*p];
+      if (c->best_caller == -1U
+	  || (c->best_caller_weight
+	      <= call_graph_min_caller_fraction * c->initial_weight))
+	continue;
+
+      unsigned int pl = call_graph_leader(&nodes, c->best_caller);
+      if (pl == *p)
+	continue;
+      Call_graph_node* pred = &nodes[pl];
+      if (pred->size + c->size > call_graph_max_cluster_size)
+	continue;
+      double new_density = (static_cast<double>(pred->weight + c->weight)
+			    / (pred->size + c->size));
+      if (new_density * call_graph_max_density_degradation
+	  < pred->density())
+	continue;
+
+      nodes[pred->tail].next = *p;
+      pred->tail = c->tail;
+      pred->size += c->size;
+      pred->weight += c->weight;
+      c->leader = pl;
+    }
+
+  // Place the clusters in order of density.
+  std::vector<unsigned int> leaders;
+  for (unsigned int i = 0; i < nodes.size(); ++i)
+    if (nodes[i].leader == i)
+      leaders.push_back(i);
+  std::stable_sort(leaders.begin(), leaders.end(),
+		   Call_graph_density_compare(nodes));
+
+  unsigned int position = 1;
+  for (std::vector<unsigned int>::const_iterator p = leaders.begin();
+       p != leaders.end();
+       ++p)
+    {
+      for (unsigned int i = *p; i != -1U; i = nodes[i].next)
+	this->section_order_map_[Section_id(nodes[i].relobj,
+					    nodes[i].shndx)] = position++;
+    }
+
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    (*p)->update_section_layout(&this->section_order_map_);
+}
+
+// Read the list of hot input sections specified with --hot-text-list.
+// Each line is an input section name or a glob pattern.  Lines
+// starting with '#' are comments.
+
+void
+Layout::read_hot_text_list()
+{
+  const char* filename = parameters->options().hot_text_list();
+  std::ifstream in(filename);
+  if (!in)
+    gold_fatal(_("unable to open --hot-text-list file %s: %s"),
+	       filename, strerror(errno));
+
+  std::string line;
+  while (std::getline(in, line))
+    {
+      if (!line.empty() && line[line.length() - 1] == '\r')   // Windows
+	line.resize(line.length() - 1);
+      if (line.empty() || line[0] == '#')
+	continue;
+      if (is_wildcard_string(line.c_str()))
+	this->hot_text_globs_.push_back(line);
+      else
+	this->hot_text_names_.insert(line);
+    }
+}
+
+// Return whether the input section NAME is hot.  Sections which gcc
+// names .text.hot, for functions with the hot attribute or which the
+// profile says are hot, are always hot.
+
+bool
+Layout::is_hot_text_section(const char* name) const
+{
+  if (strcmp(name, ".text.hot") == 0 || is_prefix_of(".text.hot.", name))
+    return true;
+
+  if (this->hot_text_names_.find(name) != this->hot_text_names_.end())
+    return true;
+
+  for (std::vector<std::string>::const_iterator p =
+	 this->hot_text_globs_.begin();
+       p != this->hot_text_globs_.end();
+       ++p)
+    if (fnmatch(p->c_str(), name, FNM_NOESCAPE) == 0)
+      return true;
+
+  return false;
+}
+
+// Gather the hot input sections at the start of .text.  The hot text
+// is aligned to, and padded to a multiple of, --hot-text-align, which
+// defaults to the 2M huge page size.  Since the file offset of a
+// PT_LOAD segment is congruent to its address modulo the alignment of
+// its sections, the hot text then covers whole huge pages in both the
+// file and memory, so that the kernel or the program can map it with
+// huge pages.  The program can find it using __hot_text_start and
+// __hot_text_end.
+
+void
+Layout::place_hot_text_sections(Symbol_table* symtab)
+{
+  if (this->hot_text_sections_.empty())
+    return;
+
+  Output_section* os = this->find_output_section(".text");
+  if (os == NULL)
+    return;
+
+  Output_section_data* end =
+    os->set_hot_input_sections(&this->hot_text_sections_,
+			       parameters->options().hot_text_align());
+  if (end == NULL)
+    return;
+
+  symtab->define_in_output_data("__hot_text_start", NULL,
+				Symbol_table::PREDEFINED, os, 0, 0,
+				elfcpp::STT_NOTYPE, elfcpp::STB_GLOBAL,
+				elfcpp::STV_HIDDEN, 0, false, true);
+  symtab->define_in_output_data("__hot_text_end", NULL,
+				Symbol_table::PREDEFINED, end, 0, 0,
+				elfcpp::STT_NOTYPE, elfcpp::STB_GLOBAL,
+				elfcpp::STV_HIDDEN, 0, false, true);
+}
+
+// Queue tasks to merge the merge sections in parallel.
+
+void
+Layout::queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    (*p)->queue_merge_tasks(workqueue, blocker);
+}
+
+// Queue tasks to scan the debug info for the .gdb_index section in
+// parallel.
+
+void
+Layout::queue_gdb_index_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  if (this->gdb_index_data_ != NULL)
+    this->gdb_index_data_->queue_scan_tasks(workqueue, blocker);
+}
+
+// Queue tasks to compress the compressed debug sections in parallel.
+
+Task_token*
+Layout::queue_compress_tasks(Workqueue* workqueue, Task_token* input_blocker)
+{
+  Task_token* blocker = new Task_token(true);
+  bool any = false;
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    {
+      if ((*p)->requires_postprocessing()
+	  && (*p)->queue_compress_tasks(workqueue, input_blocker, blocker))
+	any = true;
+    }
+  if (!any)
+    {
+      delete blocker;
+      return input_blocker;
+    }
+  return blocker;
+}
+
+// Queue the tasks to sort the .eh_frame_hdr table.
+
+Task_token*
+Layout::queue_eh_frame_hdr_tasks(Workqueue* workqueue, Output_file* of,
+				 Task_token* input_blocker)
+{
+  if (this->eh_frame_data_ == NULL)
+    return input_blocker;
+  Eh_frame_hdr* hdr = this->eh_frame_data_->eh_frame_hdr();
+  if (hdr == NULL)
+    return input_blocker;
+
+  Task_token* blocker = new Task_token(true);
+  hdr->queue_sort_tasks(workqueue, of, input_blocker, blocker);
+  return blocker;
+}
+
+// Queue the tasks to sort the dynamic relocs.
+
+Task_token*
+Layout::queue_dynamic_reloc_sort_tasks(Workqueue* workqueue)
+{
+  Output_data_reloc_generic* dyn_rel = this->dynamic_relocs_;
+  if (dyn_rel == NULL
+      || dyn_rel->output_section() == NULL
+      || !dyn_rel->sort_relocs())
+    return NULL;
+
+  Task_token* blocker = new Task_token(true);
+  dyn_rel->queue_sort_tasks(workqueue, blocker);
+  return blocker;
+}
+
 // Finalize the layout.  When this is called, we have created all the
 // output sections and all the output segments which are based on
 // input sections.  We have several things to do, and we have to do
@@ -3156,7 +3641,7 @@ Layout::create_incremental_info_sections(Symbol_table* symtab)
 			      elfcpp::SHT_GNU_INCREMENTAL_SYMTAB, 0,
 			      ORDER_INVALID, false);
   incremental_symtab_os->add_output_section_data(incr->symtab_section());
-  incremental_symtab_os->set_entsize(4);
+  incremental_symtab_os->set_entsize(incr->symtab_entsize());
 
   // Add the .gnu_incremental_relocs section.
   const char* incremental_relocs_name =
@@ -4307,6 +4792,7 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
       unsigned char* phash;
       unsigned int hashlen;
       Dynobj::create_elf_hash_table(*pdynamic_symbols, local_symcount,
+				    symtab->has_cached_name_hashes(),
 				    &phash, &hashlen);
 
       Output_section* hashsec =
@@ -4338,6 +4824,7 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
       unsigned char* phash;
       unsigned int hashlen;
       Dynobj::create_gnu_hash_table(*pdynamic_symbols, local_symcount,
+				    symtab->has_cached_name_hashes(),
 				    &phash, &hashlen);
 
       Output_section* hashsec =
@@ -4594,13 +5081,15 @@ Layout::create_interp(const Target* target)
 void
 Layout::add_target_dynamic_tags(bool use_rel, const Output_data* plt_got,
 				const Output_data* plt_rel,
-				const Output_data_reloc_generic* dyn_rel,
+				Output_data_reloc_generic* dyn_rel,
 				bool add_debug, bool dynrel_includes_plt)
 {
   Output_data_dynamic* odyn = this->dynamic_data_;
   if (odyn == NULL)
     return;
 
+  this->dynamic_relocs_ = dyn_rel;
+
   if (plt_got != NULL && plt_got->output_section() != NULL)
     odyn->add_section_address(elfcpp::DT_PLTGOT, plt_got);
 
@@ -5502,6 +5991,32 @@ Layout::print_stats() const
     (*p)->print_merge_stats();
 }
 
+// Prefault_output_task methods.
+
+// We can always run this task.
+
+Task_token*
+Prefault_output_task::is_runnable()
+{
+  return NULL;
+}
+
+// We need to unlock BLOCKER when finished.
+
+void
+Prefault_output_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->blocker_);
+}
+
+// Run the task--fault in the pages.
+
+void
+Prefault_output_task::run(Workqueue*)
+{
+  this->of_->prefault(this->start_, this->len_);
+}
+
 // Write_sections_task methods.
 
 // We can always run this task.
@@ -5509,6 +6024,8 @@ Layout::print_stats() const
 Task_token*
 Write_sections_task::is_runnable()
 {
+  if (this->input_blocker_ != NULL && this->input_blocker_->is_blocked())
+    return this->input_blocker_;
   return NULL;
 }
 
@@ -5528,6 +6045,8 @@ void
 Write_sections_task::run(Workqueue*)
 {
   this->layout_->write_output_sections(this->of_);
+  if (this->input_blocker_ != NULL)
+    delete this->input_blocker_;
 }
 
 // Write_data_task methods.
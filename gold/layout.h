@@ -591,6 +591,30 @@ class Layout
   void
   read_layout_from_file();
 
+  // Read the weighted call graph from the file specified with linker
+  // option --call-graph-ordering.
+  void
+  read_call_graph_profile();
+
+  // Order the input sections which define the functions in the call
+  // graph, so that functions which call each other frequently are
+  // placed together.  This is called after all input sections have
+  // been laid out.
+  void
+  order_sections_by_call_graph(const Symbol_table*);
+
+  // Read the list of hot input sections from the file specified with
+  // linker option --hot-text-list.
+  void
+  read_hot_text_list();
+
+  // Move the hot input sections to the start of .text, pad them to
+  // the --hot-text-align boundary, and define __hot_text_start and
+  // __hot_text_end around them.  This is called after all input
+  // sections have been laid out.
+  void
+  place_hot_text_sections(Symbol_table*);
+
   // Layout an input reloc section when doing a relocatable link.  The
   // section is RELOC_SHNDX in OBJECT, with data in SHDR.
   // DATA_SECTION is the reloc section to which it refers.  RR is the
@@ -782,6 +806,39 @@ class Layout
 			   unsigned int shndx, bool is_comdat,
 			   bool is_group_name, Kept_section** kept_section);
 
+  // Queue tasks to merge the contents of merge sections in parallel
+  // once all the input sections have been added.  The tasks hold
+  // blockers on BLOCKER, which should block finalize.
+  void
+  queue_merge_tasks(Workqueue*, Task_token* blocker);
+
+  // Queue tasks to scan the debug info for the .gdb_index section in
+  // parallel once all the input sections have been added.  The tasks
+  // hold blockers on BLOCKER, which should block finalize.
+  void
+  queue_gdb_index_tasks(Workqueue*, Task_token* blocker);
+
+  // Queue tasks to compress the compressed debug sections in
+  // parallel, once INPUT_BLOCKER is clear.  This returns a blocker
+  // which is clear when they are done, which is INPUT_BLOCKER if
+  // there is nothing to compress.
+  Task_token*
+  queue_compress_tasks(Workqueue*, Task_token* input_blocker);
+
+  // Queue tasks to sort the .eh_frame_hdr table in parallel, once
+  // INPUT_BLOCKER is clear.  This returns a blocker which is clear
+  // when they are done, which is INPUT_BLOCKER if there is no table.
+  Task_token*
+  queue_eh_frame_hdr_tasks(Workqueue*, Output_file*,
+			   Task_token* input_blocker);
+
+  // Get the sort keys of the dynamic relocs, and queue tasks to sort
+  // them in parallel.  This returns a blocker which is clear when
+  // they are done, or NULL if the dynamic relocs are not sorted.
+  // This must be called before the final tasks are queued.
+  Task_token*
+  queue_dynamic_reloc_sort_tasks(Workqueue*);
+
   // Finalize the layout after all the input sections have been added.
   off_t
   finalize(const Input_objects*, Symbol_table*, Target*, const Task*);
@@ -889,7 +946,7 @@ class Layout
   void
   add_target_dynamic_tags(bool use_rel, const Output_data* plt_got,
 			  const Output_data* plt_rel,
-			  const Output_data_reloc_generic* dyn_rel,
+			  Output_data_reloc_generic* dyn_rel,
 			  bool add_debug, bool dynrel_includes_plt);
 
   // If a treehash is necessary to compute the build ID, then queue
@@ -1116,6 +1173,10 @@ class Layout
   include_section(Sized_relobj_file<size, big_endian>* object, const char* name,
 		  const elfcpp::Shdr<size, big_endian>&);
 
+  // Return whether the input section NAME is hot for --hot-text.
+  bool
+  is_hot_text_section(const char* name) const;
+
   // Return the output section name to use given an input section
   // name.  Set *PLEN to the length of the name.  *PLEN must be
   // initialized to the length of NAME.
@@ -1363,6 +1424,8 @@ class Layout
   Symbol* dynamic_symbol_;
   // The dynamic data which goes into dynamic_section_.
   Output_data_dynamic* dynamic_data_;
+  // The dynamic relocs, as passed to add_target_dynamic_tags.
+  Output_data_reloc_generic* dynamic_relocs_;
   // The exception frame output section if there is one.
   Output_section* eh_frame_section_;
   // The exception frame data for eh_frame_section_.
@@ -1428,7 +1491,8 @@ class Layout
   // A relaxation debug checker.  We only create one when in debugging mode.
   Relaxation_debug_check* relaxation_debug_check_;
   // Plugins specify section_ordering using this map.  This is set in
-  // update_section_order in plugin.cc
+  // update_section_order in plugin.cc, and by
+  // order_sections_by_call_graph.
   std::map<Section_id, unsigned int> section_order_map_;
   // This maps an input section to a unique segment. This is done by first
   // placing such input sections in unique output sections and then mapping
@@ -1439,12 +1503,62 @@ class Layout
   Unordered_map<std::string, unsigned int> input_section_position_;
   // Vector of glob only patterns in the section_ordering file.
   std::vector<std::string> input_section_glob_;
+  // An edge in the --call-graph-ordering file: CALLER calls CALLEE
+  // WEIGHT times.
+  struct Call_graph_edge
+  {
+    std::string caller;
+    std::string callee;
+    uint64_t weight;
+  };
+  // The edges in the --call-graph-ordering file.
+  std::vector<Call_graph_edge> call_graph_edges_;
+  // Section names listed in the --hot-text-list file.
+  Unordered_set<std::string> hot_text_names_;
+  // Glob patterns listed in the --hot-text-list file.
+  std::vector<std::string> hot_text_globs_;
+  // The hot input sections which have been placed in .text.
+  Unordered_set<Section_id, Section_id_hash> hot_text_sections_;
   // For incremental links, the base file to be modified.
   Incremental_binary* incremental_base_;
   // For incremental links, a list of free space within the file.
   Free_list free_list_;
 };
 
+// This task faults in the pages of a range of the output file before
+// anything is written to it, for --prefault-output-file.  When this is
+// done, it unblocks BLOCKER.
+
+class Prefault_output_task : public Task
+{
+ public:
+  Prefault_output_task(Output_file* of, off_t start, off_t len,
+		       Task_token* blocker)
+    : of_(of), start_(start), len_(len), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Prefault_output_task"; }
+
+ private:
+  Output_file* of_;
+  off_t start_;
+  off_t len_;
+  Task_token* blocker_;
+};
+
 // This task handles writing out data in output sections which is not
 // part of an input section, or which requires special handling.  When
 // this is done, it unblocks both output_sections_blocker and
@@ -1453,10 +1567,12 @@ class Layout
 class Write_sections_task : public Task
 {
  public:
+  // INPUT_BLOCKER may be NULL; it is deleted when the task runs.
   Write_sections_task(const Layout* layout, Output_file* of,
+		      Task_token* input_blocker,
 		      Task_token* output_sections_blocker,
 		      Task_token* final_blocker)
-    : layout_(layout), of_(of),
+    : layout_(layout), of_(of), input_blocker_(input_blocker),
       output_sections_blocker_(output_sections_blocker),
       final_blocker_(final_blocker)
   { }
@@ -1481,6 +1597,7 @@ class Write_sections_task : public Task
 
   const Layout* layout_;
   Output_file* of_;
+  Task_token* input_blocker_;
   Task_token* output_sections_blocker_;
   Task_token* final_blocker_;
 };
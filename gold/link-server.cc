@@ -0,0 +1,924 @@
+// link-server.cc -- resident link server for gold
+
+// Copyright 2014 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "libiberty.h"
+#include "gold-threads.h"
+#include "archive.h"
+#include "link-server.h"
+
+extern char** environ;
+
+namespace gold
+{
+
+// A file held in memory by the link server.
+
+struct Cached_file
+{
+  // The name used to check whether the file has changed.
+  std::string name;
+  // The identity of the file when it was read.
+  off_t size;
+  time_t mtime_sec;
+  long mtime_nsec;
+  // The file contents, mapped read-only.
+  const unsigned char* contents;
+  // Whether ARMAP_NAMES, ARMAP and ARMAP_MEMBERS hold the parsed
+  // archive symbol map.
+  bool has_armap;
+  std::string armap_names;
+  std::vector<Archive::Armap_entry> armap;
+  unsigned int armap_members;
+};
+
+// The cached files, indexed by device and inode.
+
+typedef std::map<std::pair<dev_t, ino_t>, Cached_file*> Cached_files;
+
+static Cached_files cached_files;
+
+// The names of the input files opened by a link run for the server.
+
+static std::vector<std::string> input_file_names;
+
+// The descriptor used to report input files to the server, or -1 if
+// this process is not running a link for the server.
+
+static int report_descriptor = -1;
+
+// A lock for INPUT_FILE_NAMES and for taking archive maps, which
+// happens in the child while the link runs.
+
+static Lock* link_server_lock = NULL;
+static Initialize_lock link_server_initialize_lock(&link_server_lock);
+
+// The request sent by a client.  HEADER[3] is the umask of the
+// client.  The header is followed by the soft and hard values of
+// each of the resource limits in REQUEST_LIMITS, as 64-bit words,
+// and then by a block of HEADER[0] bytes holding NUL terminated
+// strings: the working directory, HEADER[1] arguments and HEADER[2]
+// environment variables.  The standard input, output and error
+// descriptors are passed with the header.  The server replies with
+// the 32-bit exit status of the link.
+
+static const int request_header_words = 4;
+static const int request_descriptors = 3;
+
+// The resource limits which the link takes from the client.
+
+static const int request_limits[] =
+{
+  RLIMIT_AS,
+  RLIMIT_CORE,
+  RLIMIT_CPU,
+  RLIMIT_DATA,
+  RLIMIT_FSIZE,
+  RLIMIT_NOFILE,
+  RLIMIT_STACK
+};
+
+static const int request_limit_count =
+  sizeof request_limits / sizeof request_limits[0];
+
+// The offset and size of the size field of an archive member header,
+// and the size of the header.
+
+static const int ar_size_offset = 48;
+static const int ar_size_size = 10;
+static const int ar_fmag_offset = 58;
+static const int ar_header_size = 60;
+
+// Get the modification time from ST.
+
+static void
+get_stat_mtime(const struct stat& st, time_t* sec, long* nsec)
+{
+  *sec = st.st_mtime;
+#ifdef HAVE_STAT_ST_MTIM
+  *nsec = st.st_mtim.tv_nsec;
+#else
+  *nsec = 0;
+#endif
+}
+
+// Return whether CF is a copy of the file described by ST.
+
+static bool
+is_same_file(const Cached_file* cf, const struct stat& st)
+{
+  time_t sec;
+  long nsec;
+  get_stat_mtime(st, &sec, &nsec);
+  return (cf->size == st.st_size
+	  && cf->mtime_sec == sec
+	  && cf->mtime_nsec == nsec);
+}
+
+// Free a cached file.
+
+static void
+free_cached_file(Cached_file* cf)
+{
+  ::munmap(const_cast<unsigned char*>(cf->contents), cf->size);
+  delete cf;
+}
+
+// Write SIZE bytes at P to DESCRIPTOR.  Return false on error.
+
+static bool
+write_all(int descriptor, const void* p, size_t size)
+{
+  const char* pc = static_cast<const char*>(p);
+  while (size > 0)
+    {
+      ssize_t len = ::write(descriptor, pc, size);
+      if (len < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return false;
+	}
+      pc += len;
+      size -= len;
+    }
+  return true;
+}
+
+// Read SIZE bytes from DESCRIPTOR into P.  Return false on error or
+// end of file.
+
+static bool
+read_all(int descriptor, void* p, size_t size)
+{
+  char* pc = static_cast<char*>(p);
+  while (size > 0)
+    {
+      ssize_t len = ::read(descriptor, pc, size);
+      if (len < 0 && errno == EINTR)
+	continue;
+      if (len <= 0)
+	return false;
+      pc += len;
+      size -= len;
+    }
+  return true;
+}
+
+// Set up ADDR to refer to the socket NAME.
+
+static void
+make_socket_address(const char* name, struct sockaddr_un* addr)
+{
+  memset(addr, 0, sizeof *addr);
+  addr->sun_family = AF_UNIX;
+  if (strlen(name) >= sizeof addr->sun_path)
+    gold_fatal(_("%s: link server socket name too long"), name);
+  strcpy(addr->sun_path, name);
+}
+
+// Return whether the peer of the connected socket DESCRIPTOR runs as
+// the same user as this process.  A link runs with the privileges of
+// the server, so only our own user may send requests.
+
+static bool
+is_same_user(int descriptor)
+{
+#if defined(SO_PEERCRED)
+  struct ucred cred;
+  socklen_t len = sizeof cred;
+  if (::getsockopt(descriptor, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0)
+    return false;
+  return cred.uid == ::geteuid();
+#elif defined(HAVE_GETPEEREID)
+  uid_t uid;
+  gid_t gid;
+  if (::getpeereid(descriptor, &uid, &gid) < 0)
+    return false;
+  return uid == ::geteuid();
+#else
+  // We can't ask, so rely on the permissions of the socket.
+  return true;
+#endif
+}
+
+// If CF is an archive with a symbol map, parse the map.
+
+static void
+read_cached_armap(Cached_file* cf)
+{
+  if (cf->size < Archive::sarmag + ar_header_size
+      || (memcmp(cf->contents, Archive::armag, Archive::sarmag) != 0
+	  && memcmp(cf->contents, Archive::armagt, Archive::sarmag) != 0))
+    return;
+
+  // The symbol map is the first member, and is named "/".
+  const char* hdr = reinterpret_cast<const char*>(cf->contents
+						  + Archive::sarmag);
+  if (hdr[0] != '/'
+      || hdr[1] != ' '
+      || memcmp(hdr + ar_fmag_offset, Archive::arfmag,
+		sizeof Archive::arfmag) != 0)
+    return;
+
+  char size_string[ar_size_size + 1];
+  memcpy(size_string, hdr + ar_size_offset, ar_size_size);
+  size_string[ar_size_size] = '\0';
+  char* end;
+  long size = strtol(size_string, &end, 10);
+  if (size < 0
+      || (*end != '\0' && *end != ' ')
+      || size > cf->size - Archive::sarmag - ar_header_size)
+    return;
+
+  const unsigned char* p = cf->contents + Archive::sarmag + ar_header_size;
+  if (Archive::parse_armap(p, size, &cf->armap_names, &cf->armap,
+			   &cf->armap_members))
+    cf->has_armap = true;
+  else
+    {
+      cf->armap_names.clear();
+      cf->armap.clear();
+    }
+}
+
+// Add the file NAME to the cache, unless it is already there.
+
+static void
+cache_file(const char* name)
+{
+  int o = ::open(name, O_RDONLY);
+  if (o < 0)
+    return;
+
+  struct stat st;
+  if (::fstat(o, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+    {
+      ::close(o);
+      return;
+    }
+
+  std::pair<dev_t, ino_t> key(st.st_dev, st.st_ino);
+  Cached_files::iterator p = cached_files.find(key);
+  if (p != cached_files.end())
+    {
+      if (is_same_file(p->second, st))
+	{
+	  ::close(o);
+	  return;
+	}
+      free_cached_file(p->second);
+      cached_files.erase(p);
+    }
+
+  void* contents = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, o, 0);
+  ::close(o);
+  if (contents == MAP_FAILED)
+    return;
+
+  Cached_file* cf = new Cached_file();
+  cf->name = name;
+  cf->size = st.st_size;
+  get_stat_mtime(st, &cf->mtime_sec, &cf->mtime_nsec);
+  cf->contents = static_cast<const unsigned char*>(contents);
+  cf->has_armap = false;
+  cf->armap_members = 0;
+  read_cached_armap(cf);
+
+  cached_files[key] = cf;
+}
+
+// Drop any cached files which have been changed or removed, then add
+// the NUL separated file names in NAMES to the cache.
+
+static void
+update_cache(const std::string& names)
+{
+  Cached_files::iterator p = cached_files.begin();
+  while (p != cached_files.end())
+    {
+      struct stat st;
+      if (::stat(p->second->name.c_str(), &st) == 0
+	  && st.st_dev == p->first.first
+	  && st.st_ino == p->first.second
+	  && is_same_file(p->second, st))
+	++p;
+      else
+	{
+	  free_cached_file(p->second);
+	  cached_files.erase(p++);
+	}
+    }
+
+  size_t start = 0;
+  while (start < names.size())
+    {
+      size_t end = names.find('\0', start);
+      if (end == std::string::npos)
+	break;
+      cache_file(names.c_str() + start);
+      start = end + 1;
+    }
+}
+
+// A link request read by the server.
+
+struct Link_request
+{
+  // The strings in the request.
+  std::vector<char> strings;
+  // The working directory.
+  const char* cwd;
+  // The command line and the environment, each terminated by NULL.
+  std::vector<char*> argv;
+  std::vector<char*> envp;
+  // The standard descriptors of the client.
+  int descriptors[request_descriptors];
+  // The umask of the client.
+  mode_t umask;
+  // The resource limits of the client, in the order of
+  // REQUEST_LIMITS.
+  struct rlimit limits[request_limit_count];
+};
+
+// Read a link request from the client on DESCRIPTOR.  Return false
+// if the request is malformed.
+
+static bool
+read_request(int descriptor, Link_request* req)
+{
+  for (int i = 0; i < request_descriptors; ++i)
+    req->descriptors[i] = -1;
+
+  uint32_t header[request_header_words];
+  char control[CMSG_SPACE(request_descriptors * sizeof(int))];
+  struct iovec iov;
+  iov.iov_base = header;
+  iov.iov_len = sizeof header;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof msg);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof control;
+
+  ssize_t len;
+  do
+    len = ::recvmsg(descriptor, &msg, 0);
+  while (len < 0 && errno == EINTR);
+  if (len <= 0)
+    return false;
+
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+       cmsg != NULL;
+       cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if (cmsg->cmsg_level == SOL_SOCKET
+	  && cmsg->cmsg_type == SCM_RIGHTS
+	  && cmsg->cmsg_len == CMSG_LEN(request_descriptors * sizeof(int)))
+	memcpy(req->descriptors, CMSG_DATA(cmsg),
+	       request_descriptors * sizeof(int));
+    }
+  if (req->descriptors[0] < 0)
+    return false;
+
+  if (static_cast<size_t>(len) < sizeof header
+      && !read_all(descriptor, reinterpret_cast<char*>(header) + len,
+		   sizeof header - len))
+    return false;
+
+  uint32_t size = header[0];
+  uint32_t argc = header[1];
+  uint32_t envc = header[2];
+  if (size == 0 || argc == 0 || argc > size || envc > size)
+    return false;
+  req->umask = header[3] & 0777;
+
+  uint64_t limits[2 * request_limit_count];
+  if (!read_all(descriptor, limits, sizeof limits))
+    return false;
+  for (int i = 0; i < request_limit_count; ++i)
+    {
+      req->limits[i].rlim_cur = limits[2 * i];
+      req->limits[i].rlim_max = limits[2 * i + 1];
+    }
+
+  req->strings.resize(size);
+  if (!read_all(descriptor, &req->strings[0], size)
+      || req->strings[size - 1] != '\0')
+    return false;
+
+  char* p = &req->strings[0];
+  char* pend = p + size;
+  std::vector<char*> strings;
+  while (p < pend)
+    {
+      strings.push_back(p);
+      p += strlen(p) + 1;
+    }
+  if (strings.size() != 1 + argc + envc)
+    return false;
+
+  req->cwd = strings[0];
+  req->argv.assign(strings.begin() + 1, strings.begin() + 1 + argc);
+  req->argv.push_back(NULL);
+  req->envp.assign(strings.begin() + 1 + argc, strings.end());
+  req->envp.push_back(NULL);
+  return true;
+}
+
+// Close the client descriptors in REQ.
+
+static void
+close_request_descriptors(Link_request* req)
+{
+  for (int i = 0; i < request_descriptors; ++i)
+    {
+      if (req->descriptors[i] >= 0)
+	::close(req->descriptors[i]);
+      req->descriptors[i] = -1;
+    }
+}
+
+// Give this process the umask and resource limits of the client
+// which sent REQ.  A limit can not be raised above the hard limit of
+// the server, so such a limit is clamped to it.
+
+static void
+apply_request_limits(const Link_request* req)
+{
+  ::umask(req->umask);
+  for (int i = 0; i < request_limit_count; ++i)
+    {
+      struct rlimit old_limit;
+      if (::getrlimit(request_limits[i], &old_limit) < 0)
+	gold_fatal(_("getrlimit failed: %s"), strerror(errno));
+      struct rlimit limit = req->limits[i];
+      if (old_limit.rlim_max != RLIM_INFINITY
+	  && (limit.rlim_max == RLIM_INFINITY
+	      || limit.rlim_max > old_limit.rlim_max))
+	limit.rlim_max = old_limit.rlim_max;
+      if (limit.rlim_max != RLIM_INFINITY
+	  && (limit.rlim_cur == RLIM_INFINITY
+	      || limit.rlim_cur > limit.rlim_max))
+	limit.rlim_cur = limit.rlim_max;
+      if (::setrlimit(request_limits[i], &limit) < 0)
+	gold_fatal(_("setrlimit failed: %s"), strerror(errno));
+    }
+}
+
+// Run as a link server on the socket SOCKET_NAME, after caching the
+// files in PRELOAD.  This only returns in a child process, after
+// setting *PARGC and *PARGV to the command line of the link to run.
+
+static void
+run_server(const char* socket_name, const std::vector<char*>& preload,
+	   int* pargc, char*** pargv)
+{
+  struct sockaddr_un addr;
+  make_socket_address(socket_name, &addr);
+
+  int listen_descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_descriptor < 0)
+    gold_fatal(_("%s: socket failed: %s"), socket_name, strerror(errno));
+
+  // Remove a socket left behind by an earlier server, but not one
+  // which a running server is still listening on.
+  struct stat st;
+  if (::lstat(socket_name, &st) == 0 && S_ISSOCK(st.st_mode))
+    {
+      int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      if (probe < 0)
+	gold_fatal(_("%s: socket failed: %s"), socket_name, strerror(errno));
+      int r = ::connect(probe, reinterpret_cast<struct sockaddr*>(&addr),
+			sizeof addr);
+      ::close(probe);
+      if (r == 0)
+	gold_fatal(_("%s: link server already running"), socket_name);
+      ::unlink(socket_name);
+    }
+
+  // Only our own user may connect to the socket.
+  mode_t old_umask = ::umask(077);
+  int r = ::bind(listen_descriptor, reinterpret_cast<struct sockaddr*>(&addr),
+		 sizeof addr);
+  int bind_errno = errno;
+  ::umask(old_umask);
+  if (r < 0)
+    gold_fatal(_("%s: bind failed: %s"), socket_name, strerror(bind_errno));
+  if (::listen(listen_descriptor, 16) < 0)
+    gold_fatal(_("%s: listen failed: %s"), socket_name, strerror(errno));
+
+  ::signal(SIGPIPE, SIG_IGN);
+
+  for (std::vector<char*>::const_iterator p = preload.begin();
+       p != preload.end();
+       ++p)
+    cache_file(*p);
+
+  while (true)
+    {
+      int client = ::accept(listen_descriptor, NULL, NULL);
+      if (client < 0)
+	{
+	  if (errno == EINTR || errno == ECONNABORTED)
+	    continue;
+	  gold_fatal(_("%s: accept failed: %s"), socket_name, strerror(errno));
+	}
+
+      if (!is_same_user(client))
+	{
+	  gold_warning(_("%s: rejected link request from another user"),
+		       socket_name);
+	  ::close(client);
+	  continue;
+	}
+
+      Link_request* req = new Link_request();
+      if (!read_request(client, req))
+	{
+	  close_request_descriptors(req);
+	  delete req;
+	  ::close(client);
+	  continue;
+	}
+
+      int report[2];
+      if (::pipe(report) < 0)
+	gold_fatal(_("pipe failed: %s"), strerror(errno));
+
+      pid_t pid = ::fork();
+      if (pid < 0)
+	gold_fatal(_("fork failed: %s"), strerror(errno));
+
+      if (pid == 0)
+	{
+	  // This is the child, which runs the link with the client's
+	  // descriptors, directory, environment, umask and resource
+	  // limits.  REQ is never freed, since the command line
+	  // points into it.
+	  ::close(listen_descriptor);
+	  ::close(client);
+	  ::close(report[0]);
+	  ::fcntl(report[1], F_SETFD, FD_CLOEXEC);
+	  ::signal(SIGPIPE, SIG_DFL);
+	  for (int i = 0; i < request_descriptors; ++i)
+	    {
+	      if (::dup2(req->descriptors[i], i) < 0)
+		_exit(GOLD_ERR);
+	      if (req->descriptors[i] >= request_descriptors)
+		::close(req->descriptors[i]);
+	    }
+	  if (::chdir(req->cwd) < 0)
+	    gold_fatal(_("%s: chdir failed: %s"), req->cwd, strerror(errno));
+	  apply_request_limits(req);
+	  environ = &req->envp[0];
+	  report_descriptor = report[1];
+	  *pargc = req->argv.size() - 1;
+	  *pargv = &req->argv[0];
+	  return;
+	}
+
+      close_request_descriptors(req);
+      delete req;
+      ::close(report[1]);
+
+      // Collect the names of the input files until the child exits.
+      std::string names;
+      char buf[4096];
+      ssize_t len;
+      while ((len = ::read(report[0], buf, sizeof buf)) != 0)
+	{
+	  if (len > 0)
+	    names.append(buf, len);
+	  else if (errno != EINTR)
+	    break;
+	}
+      ::close(report[0]);
+
+      int status;
+      while (::waitpid(pid, &status, 0) < 0)
+	{
+	  if (errno != EINTR)
+	    {
+	      status = GOLD_ERR << 8;
+	      break;
+	    }
+	}
+
+      uint32_t exit_status;
+      if (WIFEXITED(status))
+	exit_status = WEXITSTATUS(status);
+      else if (WIFSIGNALED(status))
+	exit_status = 128 + WTERMSIG(status);
+      else
+	exit_status = GOLD_ERR;
+      write_all(client, &exit_status, sizeof exit_status);
+      ::close(client);
+
+      update_cache(names);
+    }
+}
+
+// Send the link ARGV to the server on SOCKET_NAME, and exit with its
+// status.  Return only if the server can not be reached.
+
+static void
+run_client(const char* socket_name, const std::vector<char*>& argv)
+{
+  struct sockaddr_un addr;
+  make_socket_address(socket_name, &addr);
+
+  int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0)
+    return;
+  if (::connect(server, reinterpret_cast<struct sockaddr*>(&addr),
+		sizeof addr) < 0)
+    {
+      gold_info(_("%s: cannot connect to link server: %s; linking directly"),
+		socket_name, strerror(errno));
+      ::close(server);
+      return;
+    }
+
+  std::string strings;
+  char* cwd = getpwd();
+  if (cwd == NULL)
+    gold_fatal(_("cannot get working directory: %s"), strerror(errno));
+  strings.append(cwd, strlen(cwd) + 1);
+  for (std::vector<char*>::const_iterator p = argv.begin();
+       p != argv.end();
+       ++p)
+    strings.append(*p, strlen(*p) + 1);
+  uint32_t envc = 0;
+  for (char** p = environ; *p != NULL; ++p, ++envc)
+    strings.append(*p, strlen(*p) + 1);
+
+  uint32_t header[request_header_words];
+  header[0] = strings.size();
+  header[1] = argv.size();
+  header[2] = envc;
+  mode_t mask = ::umask(0);
+  ::umask(mask);
+  header[3] = mask;
+
+  uint64_t limits[2 * request_limit_count];
+  for (int i = 0; i < request_limit_count; ++i)
+    {
+      struct rlimit limit;
+      if (::getrlimit(request_limits[i], &limit) < 0)
+	gold_fatal(_("getrlimit failed: %s"), strerror(errno));
+      limits[2 * i] = limit.rlim_cur;
+      limits[2 * i + 1] = limit.rlim_max;
+    }
+
+  int descriptors[request_descriptors] = { 0, 1, 2 };
+  char control[CMSG_SPACE(sizeof descriptors)];
+  memset(control, 0, sizeof control);
+  struct iovec iov;
+  iov.iov_base = header;
+  iov.iov_len = sizeof header;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof msg);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof control;
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof descriptors);
+  memcpy(CMSG_DATA(cmsg), descriptors, sizeof descriptors);
+
+  ssize_t len;
+  do
+    len = ::sendmsg(server, &msg, 0);
+  while (len < 0 && errno == EINTR);
+  if (len < 0
+      || (static_cast<size_t>(len) < sizeof header
+	  && !write_all(server, reinterpret_cast<char*>(header) + len,
+			sizeof header - len))
+      || !write_all(server, limits, sizeof limits)
+      || !write_all(server, strings.data(), strings.size()))
+    gold_fatal(_("%s: cannot send request to link server: %s"),
+	       socket_name, strerror(errno));
+
+  uint32_t exit_status;
+  if (!read_all(server, &exit_status, sizeof exit_status))
+    gold_fatal(_("%s: link server closed the connection"), socket_name);
+  exit(exit_status);
+}
+
+// If ARGV[*PI] is the option NAME, set *PVALUE to its argument,
+// advance *PI past the option, and return true.  Like the rest of
+// the command line, this accepts one or two dashes, and the argument
+// may be joined with '='.
+
+static bool
+match_option(int argc, char** argv, int* pi, const char* name,
+	     const char** pvalue)
+{
+  const char* arg = argv[*pi];
+  if (arg[0] != '-')
+    return false;
+  ++arg;
+  if (arg[0] == '-')
+    ++arg;
+  size_t len = strlen(name);
+  if (strncmp(arg, name, len) != 0)
+    return false;
+  if (arg[len] == '=')
+    {
+      *pvalue = arg + len + 1;
+      ++*pi;
+      return true;
+    }
+  if (arg[len] != '\0')
+    return false;
+  if (*pi + 1 >= argc)
+    gold_fatal(_("missing argument to --%s"), name);
+  *pvalue = argv[*pi + 1];
+  *pi += 2;
+  return true;
+}
+
+// Class Link_server.
+
+void
+Link_server::handle_command_line(int* pargc, char*** pargv)
+{
+  int argc = *pargc;
+  char** argv = *pargv;
+
+  const char* server_name = NULL;
+  const char* client_name = NULL;
+  std::vector<char*> rest;
+  rest.push_back(argv[0]);
+  int i = 1;
+  while (i < argc)
+    {
+      const char* value;
+      if (match_option(argc, argv, &i, "link-server", &value))
+	server_name = value;
+      else if (match_option(argc, argv, &i, "use-link-server", &value))
+	client_name = value;
+      else
+	rest.push_back(argv[i++]);
+    }
+
+  if (server_name == NULL && client_name == NULL)
+    return;
+  if (server_name != NULL && client_name != NULL)
+    gold_fatal(_("--link-server and --use-link-server are incompatible"));
+
+  if (server_name != NULL)
+    {
+      // Any other arguments name files to cache before the first
+      // request.
+      rest.erase(rest.begin());
+      for (std::vector<char*>::const_iterator p = rest.begin();
+	   p != rest.end();
+	   ++p)
+	if ((*p)[0] == '-')
+	  gold_fatal(_("%s: option may not be used with --link-server"), *p);
+      run_server(server_name, rest, pargc, pargv);
+      return;
+    }
+
+  run_client(client_name, rest);
+
+  // The server could not be reached, so link here without the option.
+  char** new_argv = new char*[rest.size() + 1];
+  std::copy(rest.begin(), rest.end(), new_argv);
+  new_argv[rest.size()] = NULL;
+  *pargc = rest.size();
+  *pargv = new_argv;
+}
+
+// Return whether this process is running a link for the server.
+
+bool
+Link_server::is_server_child()
+{
+  return report_descriptor >= 0;
+}
+
+// Record an input file opened by a link run for the server.
+
+void
+Link_server::note_input_file(const std::string& name)
+{
+  if (report_descriptor < 0)
+    return;
+  link_server_initialize_lock.initialize();
+  Hold_optional_lock hl(link_server_lock);
+  input_file_names.push_back(name);
+}
+
+// Return the cached contents of a file.
+
+const unsigned char*
+Link_server::cached_contents(const struct stat& st)
+{
+  Cached_files::const_iterator p =
+    cached_files.find(std::make_pair(st.st_dev, st.st_ino));
+  if (p == cached_files.end() || !is_same_file(p->second, st))
+    return NULL;
+  return p->second->contents;
+}
+
+// Take the parsed symbol map of a cached archive.  An archive named
+// twice on the command line gets the map the first time; the second
+// Archive reads it again.
+
+bool
+Link_server::take_armap(const unsigned char* contents, std::string* names,
+			std::vector<Archive::Armap_entry>* armap,
+			unsigned int* num_members)
+{
+  if (contents == NULL)
+    return false;
+
+  link_server_initialize_lock.initialize();
+  Hold_optional_lock hl(link_server_lock);
+  for (Cached_files::iterator p = cached_files.begin();
+       p != cached_files.end();
+       ++p)
+    {
+      Cached_file* cf = p->second;
+      if (cf->contents != contents)
+	continue;
+      if (!cf->has_armap)
+	return false;
+      names->swap(cf->armap_names);
+      armap->swap(cf->armap);
+      *num_members = cf->armap_members;
+      cf->has_armap = false;
+      return true;
+    }
+  return false;
+}
+
+// Send the names of the input files to the server.
+
+void
+Link_server::report_input_files()
+{
+  if (report_descriptor < 0)
+    return;
+
+  link_server_initialize_lock.initialize();
+  Hold_optional_lock hl(link_server_lock);
+  for (std::vector<std::string>::const_iterator p = input_file_names.begin();
+       p != input_file_names.end();
+       ++p)
+    {
+      char* name = lrealpath(p->c_str());
+      bool ok = write_all(report_descriptor, name,
+			  strlen(name) + 1);
+      free(name);
+      if (!ok)
+	break;
+    }
+  ::close(report_descriptor);
+  report_descriptor = -1;
+}
+
+} // End namespace gold.
@@ -0,0 +1,91 @@
+// link-server.h -- resident link server for gold   -*- C++ -*-
+
+// Copyright 2014 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_LINK_SERVER_H
+#define GOLD_LINK_SERVER_H
+
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "archive.h"
+
+namespace gold
+{
+
+// A link server is a long running gold process, started with
+// --link-server=SOCKET, which keeps its input files mapped into
+// memory along with their parsed archive symbol maps.  A link run
+// with --use-link-server=SOCKET passes its command line, working
+// directory, environment and standard descriptors to the server.
+// The server forks a child to run the link; the child sees the
+// server's cache, and only reads the files which are not in it or
+// which have changed since they were cached.  After each link the
+// server adds the input files the child used to the cache.
+
+// Requests are handled one at a time.  Each link may still use
+// threads.
+
+class Link_server
+{
+ public:
+  // Handle the --link-server and --use-link-server options.  This is
+  // called by main before the command line is processed.  If
+  // --use-link-server is used, this either exits with the status of
+  // the remote link, or removes the option from *PARGC and *PARGV if
+  // the server can not be reached, so that the link is done here.
+  // If --link-server is used, this returns only in a child process,
+  // with *PARGC and *PARGV set to the command line of a link.
+  static void
+  handle_command_line(int* pargc, char*** pargv);
+
+  // Return whether this process is running a link for the server.
+  static bool
+  is_server_child();
+
+  // Record that the file NAME was opened as an input file, so that
+  // the server can cache it for the next link.
+  static void
+  note_input_file(const std::string& name);
+
+  // Return the contents of the file described by ST if the server
+  // has them in memory, or NULL.
+  static const unsigned char*
+  cached_contents(const struct stat& st);
+
+  // If CONTENTS are cached file contents for an archive whose symbol
+  // map has been parsed by the server, move the parsed map into
+  // *NAMES, *ARMAP and *NUM_MEMBERS and return true.  Otherwise
+  // return false.
+  static bool
+  take_armap(const unsigned char* contents, std::string* names,
+	     std::vector<Archive::Armap_entry>* armap,
+	     unsigned int* num_members);
+
+  // Send the list of input files to the server.  This is called when
+  // a link run by the server exits.
+  static void
+  report_input_files();
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_LINK_SERVER_H)
@@ -49,6 +49,7 @@
 #include "incremental.h"
 #include "gdb-index.h"
 #include "timer.h"
+#include "link-server.h"
 
 using namespace gold;
 
@@ -151,15 +152,19 @@ main(int argc, char** argv)
   // In libiberty; expands @filename to the args in "filename".
   expandargv(&argc, &argv);
 
-  // This is used by write_debug_script(), which wants the unedited argv.
-  std::string args = collect_argv(argc, argv);
-
   Errors errors(program_name);
 
   // Initialize the global parameters, to let random code get to the
   // errors object.
   set_parameters_errors(&errors);
 
+  // Hand the link to a link server, or become one.  In a server this
+  // returns in a child process with the command line of a link.
+  Link_server::handle_command_line(&argc, &argv);
+
+  // This is used by write_debug_script(), which wants the unedited argv.
+  std::string args = collect_argv(argc, argv);
+
   // Handle the command line options.
   Command_line command_line;
   command_line.process(argc - 1, const_cast<const char**>(argv + 1));
@@ -234,6 +239,11 @@ main(int argc, char** argv)
 
   if (parameters->options().section_ordering_file())
     layout.read_layout_from_file();
+  else if (parameters->options().call_graph_ordering())
+    layout.read_call_graph_profile();
+
+  if (parameters->options().hot_text_list())
+    layout.read_hot_text_list();
 
   // Load plugin libraries.
   if (command_line.options().has_plugins())
@@ -251,6 +261,9 @@ main(int argc, char** argv)
   // Run the main task processing loop.
   workqueue.process(0);
 
+  if (command_line.options().task_timeline() != NULL)
+    workqueue.write_timeline(command_line.options().task_timeline());
+
   if (command_line.options().print_output_format())
     print_output_format();
 
@@ -300,10 +313,14 @@ main(int argc, char** argv)
       Lib_group::print_stats();
       fprintf(stderr, _("%s: output file size: %lld bytes\n"),
 	      program_name, static_cast<long long>(layout.output_file_size()));
+      Output_file::print_stats();
       symtab.print_stats();
+      if (symtab.icf() != NULL)
+	symtab.icf()->print_stats();
       layout.print_stats();
       Gdb_index::print_stats();
       Free_list::print_stats();
+      workqueue.print_stats();
     }
 
   // Issue defined symbol report.
@@ -574,8 +574,9 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 	      != init_align_modulo))
 	  has_misaligned_strings = true;
 
-      Stringpool::Key key;
-      this->stringpool_.add_with_length(p, len, true, &key);
+      Stringpool::Key key = 0;
+      if (!this->defer_strings_)
+	this->stringpool_.add_with_length(p, len, true, &key);
 
       merged_strings.push_back(Merged_string(i, key));
       p += len + 1;
@@ -585,8 +586,9 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
     {
       size_t len = pend - p;
 
-      Stringpool::Key key;
-      this->stringpool_.add_with_length(p, len, true, &key);
+      Stringpool::Key key = 0;
+      if (!this->defer_strings_)
+	this->stringpool_.add_with_length(p, len, true, &key);
 
       merged_strings.push_back(Merged_string(i, key));
 
@@ -597,6 +599,16 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   // compute the length of the last string.
   merged_strings.push_back(Merged_string(i, 0));
 
+  // If we are deferring the strings, keep a copy of the section
+  // contents until they are added to the Stringpool.
+  if (this->defer_strings_)
+    {
+      size_t char_count = sec_len / sizeof(Char_type);
+      merged_strings_list->contents = new Char_type[char_count];
+      memcpy(merged_strings_list->contents, pdata,
+	     char_count * sizeof(Char_type));
+    }
+
   this->input_count_ += count;
   this->input_size_ += i;
 
@@ -623,6 +635,20 @@ template<typename Char_type>
 section_size_type
 Output_merge_string<Char_type>::finalize_merged_data()
 {
+  // Add any strings which were not added by the merge tasks.  The
+  // tasks are done by now, so we can delete their blockers.
+  if (this->defer_strings_)
+    {
+      for (size_t i = this->merged_lists_;
+	   i < this->merged_strings_lists_.size();
+	   ++i)
+	this->add_deferred_list(this->merged_strings_lists_[i]);
+      delete this->hash_blocker_;
+      this->hash_blocker_ = NULL;
+      delete this->dedup_blocker_;
+      this->dedup_blocker_ = NULL;
+    }
+
   this->stringpool_.set_string_offsets();
 
   for (typename Merged_strings_lists::const_iterator l =
@@ -653,10 +679,308 @@ Output_merge_string<Char_type>::finalize_merged_data()
   // if called twice, as may happen if Layout::set_segment_offsets
   // finds a better alignment.
   this->merged_strings_lists_.clear();
+  this->merged_lists_ = 0;
 
   return this->stringpool_.get_strtab_size();
 }
 
+// Add the strings of a list which were deferred to the Stringpool.
+// This is used for lists which were not handled by the merge tasks.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::add_deferred_list(Merged_strings_list* l)
+{
+  if (l->contents == NULL)
+    return;
+  Merged_strings& merged_strings(l->merged_strings);
+  for (size_t i = 0; i + 1 < merged_strings.size(); ++i)
+    {
+      size_t len;
+      const Char_type* s = l->deferred_string(i, &len);
+      Stringpool::Key key;
+      this->stringpool_.add_with_length(s, len, true, &key);
+      merged_strings[i].stringpool_key = key;
+    }
+  delete[] l->contents;
+  l->contents = NULL;
+}
+
+// The merge tasks.  When we are using threads, we don't add the
+// strings to the Stringpool as we see them.  Instead, once all the
+// input sections have been added, we run these tasks to compute the
+// hash codes of the strings, then to find the first occurrence of
+// each string (split by hash code), and finally to add the unique
+// strings to the Stringpool in the same order as the serial code
+// would.  If we are merging string suffixes, we then sort the
+// strings in parallel as well.
+
+// The number of tasks to use for each step.
+const unsigned int merge_task_count = 16;
+
+// Don't bother with tasks for sections with fewer strings than this.
+const size_t merge_task_min_strings = 10000;
+
+template<typename Char_type>
+class Merge_strings_task : public Task
+{
+ public:
+  enum Step
+  {
+    MERGE_HASH,
+    MERGE_DEDUP,
+    MERGE_ADD,
+    MERGE_SORT
+  };
+
+  // THIS_BLOCKER may be NULL.  Neither blocker is owned by the task.
+  Merge_strings_task(Output_merge_string<Char_type>* posd, Step step,
+		     size_t arg1, size_t arg2, Task_token* this_blocker,
+		     Task_token* next_blocker)
+    : posd_(posd), step_(step), arg1_(arg1), arg2_(arg2),
+      this_blocker_(this_blocker), next_blocker_(next_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->next_blocker_); }
+
+  void
+  run(Workqueue* workqueue)
+  {
+    switch (this->step_)
+      {
+      case MERGE_HASH:
+	this->posd_->hash_strings(this->arg1_, this->arg2_);
+	break;
+      case MERGE_DEDUP:
+	this->posd_->dedup_strings(this->arg1_, this->arg2_);
+	break;
+      case MERGE_ADD:
+	this->posd_->add_strings(workqueue, this->next_blocker_);
+	break;
+      case MERGE_SORT:
+	this->posd_->sort_strings(this->arg1_);
+	break;
+      default:
+	gold_unreachable();
+      }
+  }
+
+  std::string
+  get_name() const
+  {
+    static const char* const names[] =
+      { "hash", "dedup", "add", "sort" };
+    return std::string("Merge_strings_task ") + names[this->step_];
+  }
+
+ private:
+  Output_merge_string<Char_type>* posd_;
+  Step step_;
+  size_t arg1_;
+  size_t arg2_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
+// Queue the merge tasks.  This is called once all input sections have
+// been added.  Any sections added later are handled serially by
+// finalize_merged_data.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::do_queue_merge_tasks(Workqueue* workqueue,
+						     Task_token* blocker)
+{
+  if (!this->defer_strings_ || this->hash_blocker_ != NULL)
+    return;
+
+  const size_t list_count = this->merged_strings_lists_.size();
+  this->list_ordinals_.resize(list_count + 1);
+  size_t total = 0;
+  for (size_t i = 0; i < list_count; ++i)
+    {
+      this->list_ordinals_[i] = total;
+      total += this->merged_strings_lists_[i]->merged_strings.size() - 1;
+    }
+  this->list_ordinals_[list_count] = total;
+
+  if (total < merge_task_min_strings)
+    {
+      this->list_ordinals_.clear();
+      return;
+    }
+
+  this->merged_lists_ = list_count;
+  this->first_ordinals_.resize(total);
+
+  typedef Merge_strings_task<Char_type> Merge_task;
+
+  this->hash_blocker_ = new Task_token(true);
+  this->dedup_blocker_ = new Task_token(true);
+
+  // Split the lists into groups with roughly the same number of
+  // strings for hashing.
+  std::vector<Task*> hash_tasks;
+  size_t begin = 0;
+  for (unsigned int i = 1; i <= merge_task_count && begin < list_count; ++i)
+    {
+      size_t end = begin + 1;
+      size_t limit = total / merge_task_count * i;
+      while (end < list_count && this->list_ordinals_[end] < limit)
+	++end;
+      if (i == merge_task_count)
+	end = list_count;
+      this->hash_blocker_->add_blocker();
+      hash_tasks.push_back(new Merge_task(this, Merge_task::MERGE_HASH,
+					  begin, end, NULL,
+					  this->hash_blocker_));
+      begin = end;
+    }
+  gold_assert(begin == list_count);
+
+  for (size_t i = 0; i < hash_tasks.size(); ++i)
+    workqueue->queue(hash_tasks[i]);
+
+  for (unsigned int i = 0; i < merge_task_count; ++i)
+    {
+      this->dedup_blocker_->add_blocker();
+      workqueue->queue(new Merge_task(this, Merge_task::MERGE_DEDUP,
+				      i, merge_task_count,
+				      this->hash_blocker_,
+				      this->dedup_blocker_));
+    }
+
+  workqueue->add_blockers(blocker, 1);
+  workqueue->queue(new Merge_task(this, Merge_task::MERGE_ADD, 0, 0,
+				  this->dedup_blocker_, blocker));
+}
+
+// Compute the hash codes of the strings in the lists from BEGIN up to
+// END.  This is called by a merge task.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::hash_strings(size_t begin, size_t end)
+{
+  for (size_t l = begin; l < end; ++l)
+    {
+      Merged_strings_list* list = this->merged_strings_lists_[l];
+      Merged_strings& merged_strings(list->merged_strings);
+      for (size_t i = 0; i + 1 < merged_strings.size(); ++i)
+	{
+	  size_t len;
+	  const Char_type* s = list->deferred_string(i, &len);
+	  merged_strings[i].stringpool_key =
+	    Stringpool_template<Char_type>::hash_string(s, len);
+	}
+    }
+}
+
+// Find the first occurrence of each string whose hash code is in
+// PARTITION.  This is called by a merge task.  Each task writes to
+// different entries of first_ordinals_.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::dedup_strings(unsigned int partition,
+					      unsigned int partition_count)
+{
+  typedef Unordered_map<Deferred_string, size_t, Deferred_string_hash,
+			Deferred_string_eq> Seen;
+  Seen seen(this->list_ordinals_.back() / partition_count + 1);
+
+  for (size_t l = 0; l < this->merged_lists_; ++l)
+    {
+      const Merged_strings_list* list = this->merged_strings_lists_[l];
+      const Merged_strings& merged_strings(list->merged_strings);
+      const size_t ordinal = this->list_ordinals_[l];
+      for (size_t i = 0; i + 1 < merged_strings.size(); ++i)
+	{
+	  size_t hash_code = merged_strings[i].stringpool_key;
+	  if (hash_code % partition_count != partition)
+	    continue;
+	  size_t len;
+	  const Char_type* s = list->deferred_string(i, &len);
+	  std::pair<Deferred_string, size_t> value(Deferred_string(s, len,
+								   hash_code),
+						   ordinal + i);
+	  std::pair<typename Seen::iterator, bool> ins = seen.insert(value);
+	  this->first_ordinals_[ordinal + i] = ins.first->second;
+	}
+    }
+}
+
+// Add the unique strings to the Stringpool, in order, and set the
+// keys of all the strings.  This is called by a merge task, after the
+// dedup tasks are complete.  BLOCKER is the blocker held by this
+// task.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::add_strings(Workqueue* workqueue,
+					    Task_token* blocker)
+{
+  size_t unique_count = 0;
+  for (size_t i = 0; i < this->first_ordinals_.size(); ++i)
+    if (this->first_ordinals_[i] == i)
+      ++unique_count;
+  this->stringpool_.reserve(unique_count);
+
+  for (size_t l = 0; l < this->merged_lists_; ++l)
+    {
+      Merged_strings_list* list = this->merged_strings_lists_[l];
+      Merged_strings& merged_strings(list->merged_strings);
+      const size_t ordinal = this->list_ordinals_[l];
+      for (size_t i = 0; i + 1 < merged_strings.size(); ++i)
+	{
+	  // When we add the first occurrence of a string, we replace
+	  // its entry in first_ordinals_ with the key.  All later
+	  // occurrences point at that entry.
+	  size_t first = this->first_ordinals_[ordinal + i];
+	  Stringpool::Key key;
+	  if (first == ordinal + i)
+	    {
+	      size_t len;
+	      const Char_type* s = list->deferred_string(i, &len);
+	      size_t hash_code = merged_strings[i].stringpool_key;
+	      this->stringpool_.add_new_with_hash(s, len, hash_code, &key);
+	      this->first_ordinals_[first] = key;
+	    }
+	  else
+	    key = this->first_ordinals_[first];
+	  merged_strings[i].stringpool_key = key;
+	}
+      delete[] list->contents;
+      list->contents = NULL;
+    }
+
+  std::vector<size_t>().swap(this->first_ordinals_);
+  std::vector<size_t>().swap(this->list_ordinals_);
+
+  // If we are going to look for suffixes, do the sort now.
+  unsigned int groups = this->stringpool_.partition_for_sort(merge_task_count);
+  if (groups > 0)
+    {
+      typedef Merge_strings_task<Char_type> Merge_task;
+      workqueue->add_blockers(blocker, groups);
+      for (unsigned int i = 0; i < groups; ++i)
+	workqueue->queue_soon(new Merge_task(this, Merge_task::MERGE_SORT,
+					     i, 0, NULL, blocker));
+    }
+}
+
 template<typename Char_type>
 void
 Output_merge_string<Char_type>::set_final_data_size()
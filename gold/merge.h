@@ -462,11 +462,37 @@ class Output_merge_string : public Output_merge_base
  public:
   Output_merge_string(uint64_t addralign)
     : Output_merge_base(sizeof(Char_type), addralign), stringpool_(addralign),
-      merged_strings_lists_(), input_count_(0), input_size_(0)
+      merged_strings_lists_(), input_count_(0), input_size_(0),
+      defer_strings_(parameters->options().threads()), merged_lists_(0),
+      list_ordinals_(), first_ordinals_(), hash_blocker_(NULL),
+      dedup_blocker_(NULL)
   {
     this->stringpool_.set_no_zero_null();
   }
 
+  // The following functions are called by the tasks queued by
+  // queue_merge_tasks.
+
+  // Compute the hash codes of the strings in the input sections from
+  // BEGIN up to END.
+  void
+  hash_strings(size_t begin, size_t end);
+
+  // Find the first occurrence of each string whose hash code falls in
+  // PARTITION of PARTITION_COUNT.
+  void
+  dedup_strings(unsigned int partition, unsigned int partition_count);
+
+  // Add the unique strings to the Stringpool in input order.  Queue
+  // tasks to sort the strings if we are going to merge suffixes.
+  void
+  add_strings(Workqueue*, Task_token* blocker);
+
+  // Sort group I of the Stringpool strings.
+  void
+  sort_strings(unsigned int i)
+  { this->stringpool_.sort_group(i); }
+
  protected:
   // Add an input section.
   bool
@@ -498,6 +524,10 @@ class Output_merge_string : public Output_merge_base
   void
   do_print_merge_stats(const char* section_name);
 
+  // Queue tasks to hash and merge the strings in parallel.
+  void
+  do_queue_merge_tasks(Workqueue*, Task_token* blocker);
+
   // Writes the stringpool to a buffer.
   void
   stringpool_to_buffer(unsigned char* buffer, section_size_type buffer_size)
@@ -550,14 +580,70 @@ class Output_merge_string : public Output_merge_base
     unsigned int shndx;
     // The list of merged strings.
     Merged_strings merged_strings;
+    // If the strings have not been added to the Stringpool yet, a
+    // copy of the section contents.  Until then, the stringpool_key
+    // field of each Merged_string holds its hash code, or zero.
+    Char_type* contents;
 
     Merged_strings_list(Relobj* objecta, unsigned int shndxa)
-      : object(objecta), shndx(shndxa), merged_strings()
+      : object(objecta), shndx(shndxa), merged_strings(), contents(NULL)
     { }
+
+    ~Merged_strings_list()
+    { delete[] this->contents; }
+
+    // Return string I, which has not been added to the Stringpool
+    // yet.  Set *PLEN to its length in characters.
+    const Char_type*
+    deferred_string(size_t i, size_t* plen) const
+    {
+      section_offset_type offset = this->merged_strings[i].offset;
+      *plen = ((this->merged_strings[i + 1].offset - offset)
+	       / sizeof(Char_type) - 1);
+      return this->contents + offset / sizeof(Char_type);
+    }
   };
 
   typedef std::vector<Merged_strings_list*> Merged_strings_lists;
 
+  // A string which has not been added to the Stringpool, used while
+  // looking for duplicates.
+  struct Deferred_string
+  {
+    const Char_type* string;
+    // Length is in characters, not bytes.
+    size_t length;
+    size_t hash_code;
+
+    Deferred_string(const Char_type* s, size_t len, size_t hash)
+      : string(s), length(len), hash_code(hash)
+    { }
+  };
+
+  struct Deferred_string_hash
+  {
+    size_t
+    operator()(const Deferred_string& ds) const
+    { return ds.hash_code; }
+  };
+
+  struct Deferred_string_eq
+  {
+    bool
+    operator()(const Deferred_string& ds1, const Deferred_string& ds2) const
+    {
+      return (ds1.hash_code == ds2.hash_code
+	      && ds1.length == ds2.length
+	      && memcmp(ds1.string, ds2.string,
+			ds1.length * sizeof(Char_type)) == 0);
+    }
+  };
+
+  // Add the strings in a list whose strings were deferred to the
+  // Stringpool one at a time.
+  void
+  add_deferred_list(Merged_strings_list*);
+
   // As we see the strings, we add them to a Stringpool.
   Stringpool_template<Char_type> stringpool_;
   // Map from a location in an input object to an entry in the
@@ -567,6 +653,22 @@ class Output_merge_string : public Output_merge_base
   size_t input_count_;
   // The total size of input sections.
   size_t input_size_;
+  // Whether we copy the input sections and add their strings to the
+  // Stringpool later, so that the hashing can be done in parallel.
+  bool defer_strings_;
+  // The number of lists at the start of merged_strings_lists_ whose
+  // strings have been handed to the tasks queued by
+  // queue_merge_tasks.
+  size_t merged_lists_;
+  // The ordinal of the first string in each of those lists, counting
+  // all strings in all lists, followed by the total.
+  std::vector<size_t> list_ordinals_;
+  // For each of those strings, indexed by ordinal, the ordinal of
+  // the first occurrence of the same string.
+  std::vector<size_t> first_ordinals_;
+  // Blockers used to order the merge tasks.
+  Task_token* hash_blocker_;
+  Task_token* dedup_blocker_;
 };
 
 } // End namespace gold.
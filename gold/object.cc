@@ -42,6 +42,7 @@
 #include "plugin.h"
 #include "compressed_output.h"
 #include "incremental.h"
+#include "ehframe.h"
 
 namespace gold
 {
@@ -67,6 +68,8 @@ Read_symbols_data::~Read_symbols_data()
     delete this->verdef;
   if (this->verneed != NULL)
     delete this->verneed;
+  if (this->symbol_shards != NULL)
+    delete this->symbol_shards;
 }
 
 // Class Xindex.
@@ -429,6 +432,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
     kept_comdat_sections_(),
     has_eh_frame_(false),
     discarded_eh_frame_shndx_(-1U),
+    parsed_eh_frame_(NULL),
     deferred_layout_(),
     deferred_layout_relocs_(),
     compressed_sections_()
@@ -439,6 +443,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
 template<int size, bool big_endian>
 Sized_relobj_file<size, big_endian>::~Sized_relobj_file()
 {
+  delete this->parsed_eh_frame_;
 }
 
 // Set up an object file based on the file header.  This sets up the
@@ -837,6 +842,99 @@ Sized_relobj_file<size, big_endian>::do_read_symbols(Read_symbols_data* sd)
   sd->symbol_names = fvstrtab;
   sd->symbol_names_size =
     convert_to_section_size_type(strtabshdr.get_sh_size());
+
+  // Parse the .eh_frame section now, while we are running in
+  // parallel with the other objects.  When the section is laid out
+  // we only have to merge the result into the output section.  The
+  // symbols are read again for a deferred .eh_frame section, and the
+  // section has already been parsed by then.
+  if (this->has_eh_frame_
+      && this->parsed_eh_frame_ == NULL
+      && need_local_symbols
+      && !parameters->options().relocatable()
+      && !parameters->incremental())
+    {
+      const unsigned char* namesu = sd->section_names->data();
+      const char* names = reinterpret_cast<const char*>(namesu);
+      this->parse_eh_frame_section(pshdrs, names, sd->section_names_size,
+				   fvsymtab->data(), readsize,
+				   fvstrtab->data(), sd->symbol_names_size);
+    }
+}
+
+// Parse the first GNU style .eh_frame section into
+// parsed_eh_frame_.  PSHDRS is the section headers and NAMES is the
+// section names.  SYMBOLS is all the symbols, and SYMBOL_NAMES is the
+// symbol names.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::parse_eh_frame_section(
+    const unsigned char* pshdrs,
+    const char* names,
+    section_size_type names_size,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size)
+{
+  gold_assert(this->parsed_eh_frame_ == NULL);
+
+  const unsigned char* s = NULL;
+  while (1)
+    {
+      s = this->template find_shdr<size, big_endian>(pshdrs, ".eh_frame",
+						     names, names_size, s);
+      if (s == NULL)
+	return;
+      typename This::Shdr shdr(s);
+      if (this->check_eh_frame_flags(&shdr))
+	break;
+    }
+
+  const unsigned int shndx = (s - pshdrs) / This::shdr_size;
+  const unsigned int shnum = this->shnum();
+
+  // Find the relocation section for the .eh_frame section, as
+  // do_layout does.
+  unsigned int reloc_shndx = 0;
+  unsigned int reloc_type = elfcpp::SHT_NULL;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if ((sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	  && this->adjust_shndx(shdr.get_sh_info()) == shndx)
+	{
+	  if (reloc_shndx != 0)
+	    reloc_shndx = -1U;
+	  else
+	    {
+	      reloc_shndx = i;
+	      reloc_type = sh_type;
+	    }
+	}
+    }
+
+  Parsed_eh_frame* parsed = new Parsed_eh_frame(shndx);
+  Eh_frame::parse_ehframe_input_section(this, symbols, symbols_size,
+					symbol_names, symbol_names_size,
+					shndx, reloc_shndx, reloc_type,
+					parsed);
+  this->parsed_eh_frame_ = parsed;
+}
+
+// Return the .eh_frame section SHNDX if it has already been parsed.
+
+template<int size, bool big_endian>
+Parsed_eh_frame*
+Sized_relobj_file<size, big_endian>::parsed_eh_frame(unsigned int shndx) const
+{
+  if (this->parsed_eh_frame_ != NULL
+      && this->parsed_eh_frame_->shndx() == shndx)
+    return this->parsed_eh_frame_;
+  return NULL;
 }
 
 // Return the section index of symbol SYM.  Set *VALUE to its value in
@@ -1221,6 +1319,16 @@ Sized_relobj_file<size, big_endian>::layout_eh_frame_section(
 					       reloc_type,
 					       &offset);
   this->output_sections()[shndx] = os;
+
+  // Any CIEs and FDEs we parsed earlier have been added to the output
+  // section by now if they are going to be.
+  if (this->parsed_eh_frame_ != NULL
+      && this->parsed_eh_frame_->shndx() == shndx)
+    {
+      delete this->parsed_eh_frame_;
+      this->parsed_eh_frame_ = NULL;
+    }
+
   if (os == NULL || offset == -1)
     {
       // An object can contain at most one section holding exception
@@ -1945,6 +2053,92 @@ Sized_relobj_file<size, big_endian>::do_add_symbols(Symbol_table* symtab,
   sd->symbol_names = NULL;
 }
 
+// Sort the external symbols by symbol table shard, so that
+// do_add_shard_symbols can add each shard's symbols separately.  We
+// also count the defined symbols here, since the shards are added by
+// different tasks.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::do_assign_symbol_shards(
+    const Symbol_table* symtab,
+    Read_symbols_data* sd)
+{
+  if (sd->symbols == NULL)
+    return;
+
+  const int sym_size = This::sym_size;
+  size_t symcount = ((sd->symbols_size - sd->external_symbols_offset)
+		     / sym_size);
+  if (symcount * sym_size != sd->symbols_size - sd->external_symbols_offset)
+    {
+      // do_add_symbols will report the error.
+      return;
+    }
+
+  const unsigned char* p = sd->symbols->data() + sd->external_symbols_offset;
+  const char* sym_names =
+    reinterpret_cast<const char*>(sd->symbol_names->data());
+
+  std::vector<std::vector<unsigned int> >* shards =
+    new std::vector<std::vector<unsigned int> >(symtab->shard_count());
+  size_t defined = 0;
+  for (size_t i = 0; i < symcount; ++i, p += sym_size)
+    {
+      elfcpp::Sym<size, big_endian> sym(p);
+
+      // Looking up an extended section index is not thread safe, so
+      // leave objects which use them to do_add_symbols.
+      unsigned int st_shndx = sym.get_st_shndx();
+      if (st_shndx == elfcpp::SHN_XINDEX)
+	{
+	  delete shards;
+	  return;
+	}
+
+      // A bad name offset will be reported by add_from_relobj.
+      unsigned int st_name = sym.get_st_name();
+      if (st_name >= sd->symbol_names_size)
+	{
+	  (*shards)[0].push_back(i);
+	  continue;
+	}
+
+      if (st_shndx != elfcpp::SHN_UNDEF)
+	++defined;
+
+      const char* name = sym_names + st_name;
+      const char* ver = strchr(name, '@');
+      size_t namelen = ver != NULL ? ver - name : strlen(name);
+      (*shards)[symtab->symbol_shard(name, namelen)].push_back(i);
+    }
+
+  this->symbols_.resize(symcount);
+  this->defined_count_ = defined;
+  sd->symbol_shards = shards;
+}
+
+// Add the external symbols in symbol table shard SHARD.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::do_add_shard_symbols(
+    Symbol_table* symtab,
+    Read_symbols_data* sd,
+    unsigned int shard)
+{
+  gold_assert(sd->symbol_shards != NULL);
+  const char* sym_names =
+    reinterpret_cast<const char*>(sd->symbol_names->data());
+  size_t defined;
+  symtab->add_from_relobj(this,
+			  sd->symbols->data() + sd->external_symbols_offset,
+			  this->symbols_.size(), this->local_symbol_count_,
+			  sym_names, sd->symbol_names_size,
+			  &this->symbols_, &defined,
+			  &(*sd->symbol_shards)[shard], shard);
+}
+
 // Find out if this object, that is a member of a lib group, should be included
 // in the link. We check every symbol defined by this object. If the symbol
 // table has a strong undefined reference to that symbol, we have to include
@@ -39,6 +39,7 @@ namespace gold
 class General_options;
 class Task;
 class Cref;
+class Object;
 class Layout;
 class Output_data;
 class Output_section;
@@ -48,6 +49,7 @@ class Pluginobj;
 class Dynobj;
 class Object_merge_map;
 class Relocatable_relocs;
+class Parsed_eh_frame;
 struct Symbols_data;
 
 template<typename Stringpool_char>
@@ -59,7 +61,8 @@ struct Read_symbols_data
 {
   Read_symbols_data()
     : section_headers(NULL), section_names(NULL), symbols(NULL),
-      symbol_names(NULL), versym(NULL), verdef(NULL), verneed(NULL)
+      symbol_names(NULL), versym(NULL), verdef(NULL), verneed(NULL),
+      symbol_shards(NULL)
   { }
 
   ~Read_symbols_data();
@@ -95,6 +98,12 @@ struct Read_symbols_data
   File_view* verneed;
   section_size_type verneed_size;
   unsigned int verneed_info;
+
+  // If the symbol table is sharded, this is set by
+  // Object::assign_symbol_shards to hold, for each shard, the indexes
+  // of the external symbols which belong to it.  NULL if the symbols
+  // must all be added by Object::add_symbols.
+  std::vector<std::vector<unsigned int> >* symbol_shards;
 };
 
 // Information used to print error messages.
@@ -122,7 +131,10 @@ struct Section_relocs
   unsigned int reloc_shndx;
   // Index of section that relocs apply to.
   unsigned int data_shndx;
-  // Contents of reloc section.
+  // File offset of reloc section.
+  off_t reloc_offset;
+  // Contents of reloc section.  This is NULL if --reloc-window-size
+  // was used, in which case the relocs are read when they are used.
   File_view* contents;
   // Reloc section type.
   unsigned int sh_type;
@@ -155,6 +167,35 @@ struct Read_relocs_data
   File_view* local_symbols;
 };
 
+// A buffer used to read relocations from an object file when
+// --reloc-window-size is used.  The buffer is reused for each read,
+// so that we don't keep views of the relocation sections until we
+// are done with the object.
+
+class Reloc_window
+{
+ public:
+  Reloc_window()
+    : data_(NULL), capacity_(0)
+  { }
+
+  ~Reloc_window();
+
+  // Read SIZE bytes at offset START in OBJECT.  The returned data is
+  // valid until the next call.
+  const unsigned char*
+  read(Object* object, off_t start, section_size_type size);
+
+ private:
+  Reloc_window(const Reloc_window&);
+  Reloc_window& operator=(const Reloc_window&);
+
+  // The buffer.
+  unsigned char* data_;
+  // The size of the buffer.
+  section_size_type capacity_;
+};
+
 // The Xindex class manages section indexes for objects with more than
 // 0xff00 sections.
 
@@ -468,6 +509,11 @@ class Object
   get_mtime()
   { return this->do_get_mtime(); }
 
+  // Return a hash of the file contents, or 0 if it is not known.
+  uint64_t
+  get_content_hash()
+  { return this->do_get_content_hash(); }
+
   // Get the number of sections.
   unsigned int
   shnum() const
@@ -581,6 +627,21 @@ class Object
   add_symbols(Symbol_table* symtab, Read_symbols_data* sd, Layout *layout)
   { this->do_add_symbols(symtab, sd, layout); }
 
+  // Sort the external symbols read into SD by the shard of SYMTAB
+  // which they belong to.  This is called after read_symbols, and may
+  // run in parallel with other objects.
+  void
+  assign_symbol_shards(const Symbol_table* symtab, Read_symbols_data* sd)
+  { this->do_assign_symbol_shards(symtab, sd); }
+
+  // Add the external symbols which assign_symbol_shards put in SHARD
+  // to the symbol table.  This is called instead of add_symbols, once
+  // for each shard, when SD->symbol_shards is not NULL.
+  void
+  add_shard_symbols(Symbol_table* symtab, Read_symbols_data* sd,
+		    unsigned int shard)
+  { this->do_add_shard_symbols(symtab, sd, shard); }
+
   // Add symbol information to the global symbol table.
   Archive::Should_include
   should_include_member(Symbol_table* symtab, Layout* layout,
@@ -784,6 +845,12 @@ class Object
   do_get_mtime()
   { return this->input_file()->file().get_mtime(); }
 
+  // Return a hash of the file contents.  This may be overridden like
+  // do_get_mtime.
+  virtual uint64_t
+  do_get_content_hash()
+  { return this->input_file()->file().get_content_hash(); }
+
   // Read the symbols--implemented by child class.
   virtual void
   do_read_symbols(Read_symbols_data*) = 0;
@@ -797,6 +864,19 @@ class Object
   virtual void
   do_add_symbols(Symbol_table*, Read_symbols_data*, Layout*) = 0;
 
+  // Sort the external symbols by symbol table shard.  Only
+  // relocatable objects do this; for other objects
+  // SD->symbol_shards stays NULL and add_symbols is used.
+  virtual void
+  do_assign_symbol_shards(const Symbol_table*, Read_symbols_data*)
+  { }
+
+  // Add the external symbols in one shard--implemented by child
+  // classes which implement do_assign_symbol_shards.
+  virtual void
+  do_add_shard_symbols(Symbol_table*, Read_symbols_data*, unsigned int)
+  { gold_unreachable(); }
+
   virtual Archive::Should_include
   do_should_include_member(Symbol_table* symtab, Layout*, Read_symbols_data*,
                            std::string* why) = 0;
@@ -2081,6 +2161,11 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   e_type() const
   { return this->e_type_; }
 
+  // Return the .eh_frame section SHNDX as parsed when reading the
+  // symbols, or NULL if it was not parsed then.
+  Parsed_eh_frame*
+  parsed_eh_frame(unsigned int shndx) const;
+
   // Return the number of symbols.  This is only valid after
   // Object::add_symbols has been called.
   unsigned int
@@ -2261,6 +2346,14 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   do_add_symbols(Symbol_table*, Read_symbols_data*, Layout*);
 
+  // Sort the external symbols by symbol table shard.
+  void
+  do_assign_symbol_shards(const Symbol_table*, Read_symbols_data*);
+
+  // Add the external symbols in one symbol table shard.
+  void
+  do_add_shard_symbols(Symbol_table*, Read_symbols_data*, unsigned int);
+
   Archive::Should_include
   do_should_include_member(Symbol_table* symtab, Layout*, Read_symbols_data*,
                            std::string* why);
@@ -2274,6 +2367,19 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   do_read_relocs(Read_relocs_data*);
 
+  // Return the contents of the reloc section described by SR.  If
+  // do_read_relocs did not read them, read them into WINDOW.
+  const unsigned char*
+  section_relocs_contents(const Section_relocs& sr, Reloc_window* window)
+  {
+    if (sr.contents != NULL)
+      return sr.contents->data();
+    section_size_type reloc_size = (sr.sh_type == elfcpp::SHT_REL
+				    ? elfcpp::Elf_sizes<size>::rel_size
+				    : elfcpp::Elf_sizes<size>::rela_size);
+    return window->read(this, sr.reloc_offset, sr.reloc_count * reloc_size);
+  }
+
   // Process the relocs to find list of referenced sections. Used only
   // during garbage collection.
   void
@@ -2531,6 +2637,16 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
                  const typename This::Shdr& shdr, unsigned int reloc_shndx,
                  unsigned int reloc_type);
 
+  // Parse the .eh_frame section, so that the parsing is done in
+  // parallel with other objects rather than during layout.
+  void
+  parse_eh_frame_section(const unsigned char* pshdrs, const char* names,
+			 section_size_type names_size,
+			 const unsigned char* symbols,
+			 section_size_type symbols_size,
+			 const unsigned char* symbol_names,
+			 section_size_type symbol_names_size);
+
   // Layout an input .eh_frame section.
   void
   layout_eh_frame_section(Layout* layout, const unsigned char* symbols_data,
@@ -2561,7 +2677,8 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   // Scan the input relocations for --emit-relocs.
   void
   emit_relocs_scan(Symbol_table*, Layout*, const unsigned char* plocal_syms,
-		   const Read_relocs_data::Relocs_list::iterator&);
+		   const Read_relocs_data::Relocs_list::iterator&,
+		   const unsigned char* prelocs);
 
   // Scan the input relocations for --emit-relocs, templatized on the
   // type of the relocation section.
@@ -2570,18 +2687,21 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   emit_relocs_scan_reltype(Symbol_table*, Layout*,
 			   const unsigned char* plocal_syms,
 			   const Read_relocs_data::Relocs_list::iterator&,
+			   const unsigned char* prelocs,
 			   Relocatable_relocs*);
 
   // Scan the input relocations for --incremental.
   void
-  incremental_relocs_scan(const Read_relocs_data::Relocs_list::iterator&);
+  incremental_relocs_scan(const Read_relocs_data::Relocs_list::iterator&,
+			  const unsigned char* prelocs);
 
   // Scan the input relocations for --incremental, templatized on the
   // type of the relocation section.
   template<int sh_type>
   void
   incremental_relocs_scan_reltype(
-      const Read_relocs_data::Relocs_list::iterator&);
+      const Read_relocs_data::Relocs_list::iterator&,
+      const unsigned char* prelocs);
 
   void
   incremental_relocs_write(const Relocate_info<size, big_endian>*,
@@ -2736,6 +2856,9 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   // If this object has a GNU style .eh_frame section that is discarded in
   // output, record the index here.  Otherwise it is -1U.
   unsigned int discarded_eh_frame_shndx_;
+  // The .eh_frame section parsed when reading the symbols, if any.
+  // This is deleted when the section is laid out.
+  Parsed_eh_frame* parsed_eh_frame_;
   // The list of sections whose layout was deferred.
   std::vector<Deferred_layout> deferred_layout_;
   // The list of relocation sections whose layout was deferred.
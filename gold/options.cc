@@ -1184,6 +1184,10 @@ General_options::finalize()
 	}
     }
 
+  // --hot-text-list implies --hot-text.
+  if (this->hot_text_list() != NULL)
+    this->set_hot_text(true);
+
   // -Bgroup implies --unresolved-symbols=report-all.
   if (this->Bgroup() && !this->user_set_unresolved_symbols())
     this->set_unresolved_symbols("report-all");
@@ -1220,6 +1224,25 @@ General_options::finalize()
 	gold_fatal(_("-f/--auxiliary may not be used without -shared"));
     }
 
+  if (this->call_graph_ordering() != NULL)
+    {
+      if (this->section_ordering_file() != NULL)
+	gold_fatal(_("--call-graph-ordering and --section-ordering-file "
+		     "are incompatible"));
+      if (this->relocatable())
+	gold_fatal(_("--call-graph-ordering may not be used with -r"));
+    }
+
+  if (this->hot_text())
+    {
+      if (this->relocatable())
+	gold_fatal(_("--hot-text may not be used with -r"));
+      uint64_t align = this->hot_text_align();
+      if (align == 0 || (align & (align - 1)) != 0)
+	gold_fatal(_("--hot-text-align value is not a power of two: 0x%llx"),
+		   static_cast<unsigned long long>(align));
+    }
+
   // TODO: implement support for -retain-symbols-file with -r, if needed.
   if (this->relocatable() && this->retain_symbols_file())
     gold_fatal(_("-retain-symbols-file does not yet work with -r"));
@@ -1238,6 +1261,13 @@ General_options::finalize()
 		 "[0.0, 1.0)"),
 	       this->hash_bucket_empty_fraction());
 
+  if (this->user_set_hash_bloom_false_positive_rate()
+      && (this->hash_bloom_false_positive_rate() <= 0.0
+	  || this->hash_bloom_false_positive_rate() >= 1.0))
+    gold_fatal(_("--hash-bloom-false-positive-rate value %g out of range "
+		 "(0.0, 1.0)"),
+	       this->hash_bloom_false_positive_rate());
+
   if (this->implicit_incremental_ && this->incremental_mode_ == INCREMENTAL_OFF)
     gold_fatal(_("Options --incremental-changed, --incremental-unchanged, "
 		 "--incremental-unknown require the use of --incremental"));
@@ -1277,6 +1307,17 @@ General_options::finalize()
   if (this->user_set_rosegment_gap())
     this->set_rosegment(true);
 
+  // Adding symbols to a sharded symbol table only helps with threads,
+  // and is not supported for the kinds of links which need to see the
+  // whole symbol table while adding each object.
+  if (this->symbol_table_shards() > 1
+      && (!this->threads()
+	  || this->relocatable()
+	  || this->incremental_mode_ != INCREMENTAL_OFF
+	  || this->has_plugins()
+	  || this->any_wrap()))
+    this->set_symbol_table_shards(0);
+
   // FIXME: we can/should be doing a lot more sanity checking here.
 }
 
@@ -692,6 +692,10 @@ class General_options
 		N_("Minimum output file size for '--build-id=tree' to work"
 		   " differently than '--build-id=sha1'"), N_("SIZE"));
 
+  DEFINE_string(call_graph_ordering, options::TWO_DASHES, '\0', NULL,
+		N_("Order functions using the weighted call graph in FILE"),
+		N_("FILE"));
+
   DEFINE_bool(check_sections, options::TWO_DASHES, '\0', true,
 	      N_("Check segment addresses for overlaps (default)"),
 	      N_("Do not check segment addresses for overlaps"));
@@ -845,10 +849,28 @@ class General_options
 		N_("Min fraction of empty buckets in dynamic hash"),
 		N_("FRACTION"));
 
+  DEFINE_double(hash_bloom_false_positive_rate, options::TWO_DASHES, '\0',
+		0.0,
+		N_("Size the .gnu.hash bloom filter for this false "
+		   "positive rate"),
+		N_("RATE"));
+
   DEFINE_enum(hash_style, options::TWO_DASHES, '\0', "sysv",
 	      N_("Dynamic hash style"), N_("[sysv,gnu,both]"),
 	      {"sysv", "gnu", "both"});
 
+  DEFINE_bool(hot_text, options::TWO_DASHES, '\0', false,
+	      N_("Place hot .text sections first, aligned for huge pages"),
+	      N_("Do not group hot .text sections (default)"));
+  DEFINE_string(hot_text_list, options::TWO_DASHES, '\0', NULL,
+		N_("Treat the input sections listed in FILE as hot; "
+		   "implies --hot-text"),
+		N_("FILE"));
+  DEFINE_uint64(hot_text_align, options::TWO_DASHES, '\0', 0x200000,
+		N_("Align and pad the hot text to SIZE "
+		   "(default 0x200000)"),
+		N_("SIZE"));
+
   DEFINE_string(dynamic_linker, options::TWO_DASHES, 'I', NULL,
 		N_("Set dynamic linker path"), N_("PROGRAM"));
 
@@ -914,6 +936,12 @@ class General_options
   DEFINE_dirlist(library_path, options::TWO_DASHES, 'L',
 		 N_("Add directory to search path"), N_("DIR"));
 
+  // This is handled by Link_server before the command line is
+  // processed.
+  DEFINE_string(link_server, options::TWO_DASHES, '\0', NULL,
+		N_("Run as a link server on SOCKET, caching FILES"),
+		N_("SOCKET [FILES]"));
+
   DEFINE_bool(text_reorder, options::TWO_DASHES, '\0', true,
 	      N_("Enable text section reordering for GCC section names "
 		 "(default)"),
@@ -1005,6 +1033,12 @@ class General_options
 		 " (default)."),
 	      N_("Use fallocate or ftruncate to reserve space."));
 
+  DEFINE_bool(prefault_output_file, options::TWO_DASHES, '\0', false,
+	      N_("Fault in the pages of the output file in parallel before"
+		 " writing it."),
+	      N_("Fault in the pages of the output file as they are written"
+		 " (default)."));
+
   DEFINE_bool(preread_archive_symbols, options::TWO_DASHES, '\0', false,
 	      N_("Preread archive symbols when multi-threaded"), NULL);
 
@@ -1029,6 +1063,11 @@ class General_options
   DEFINE_bool(relax, options::TWO_DASHES, '\0', false,
 	      N_("Relax branches on certain targets"), NULL);
 
+  DEFINE_uint64(reloc_window_size, options::TWO_DASHES, '\0', 0,
+		N_("Read relocations when they are used, at most SIZE bytes "
+		   "at a time where possible, to limit memory use"),
+		N_("SIZE"));
+
   DEFINE_string(retain_symbols_file, options::TWO_DASHES, '\0', NULL,
 		N_("keep only symbols listed in this file"), N_("FILE"));
 
@@ -1111,6 +1150,11 @@ class General_options
 	      ("[none,all,safe]"),
 	      {"none", "all", "safe"});
 
+  DEFINE_bool(icf_rodata, options::TWO_DASHES, '\0', false,
+	      N_("Also fold identical read-only data sections with --icf. "
+		 "\'--icf=safe\' only folds vtables and VTTs."),
+	      N_("Only fold code sections with --icf (default)"));
+
   DEFINE_uint(icf_iterations, options::TWO_DASHES , '\0', 0,
 	      N_("Number of iterations of ICF (default 2)"), N_("COUNT"));
 
@@ -1132,9 +1176,19 @@ class General_options
   DEFINE_bool(stats, options::TWO_DASHES, '\0', false,
 	      N_("Print resource usage statistics"), NULL);
 
+  DEFINE_uint(symbol_table_shards, options::TWO_DASHES, '\0', 0,
+	      N_("Split the symbol table into COUNT shards which are "
+		 "filled in parallel (requires --threads)"),
+	      N_("COUNT"));
+
   DEFINE_string(sysroot, options::TWO_DASHES, '\0', "",
 		N_("Set target system root directory"), N_("DIR"));
 
+  DEFINE_string(task_timeline, options::TWO_DASHES, '\0', NULL,
+		N_("Write a timeline of the linker's tasks to FILE in the "
+		   "trace event format"),
+		N_("FILE"));
+
   DEFINE_bool(trace, options::TWO_DASHES, 't', false,
 	      N_("Print the name of each input file"), NULL);
 
@@ -1183,6 +1237,12 @@ class General_options
 	      {"ignore-all", "report-all", "ignore-in-object-files",
 		  "ignore-in-shared-libs"});
 
+  // This is handled by Link_server before the command line is
+  // processed.
+  DEFINE_string(use_link_server, options::TWO_DASHES, '\0', NULL,
+		N_("Run the link in the link server on SOCKET"),
+		N_("SOCKET"));
+
   DEFINE_bool(verbose, options::TWO_DASHES, '\0', false,
 	      N_("Synonym for --debug=files"), NULL);
 
@@ -1340,6 +1400,15 @@ class General_options
   printed_version() const
   { return this->printed_version_; }
 
+  // Turn on --threads, using THREAD_COUNT threads.  This is for
+  // programs which use libgold but parse their own options, like dwp.
+  void
+  enable_threads(int thread_count)
+  {
+    this->set_threads(true);
+    this->set_thread_count(thread_count);
+  }
+
   // The macro defines output() (based on --output), but that's a
   // generic name.  Provide this alternative name, which is clearer.
   const char*
@@ -1205,6 +1205,25 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::
   return 0;
 }
 
+// Get the key used to sort a dynamic reloc.  This must give the same
+// order as compare.
+
+template<bool dynamic, int size, bool big_endian>
+void
+Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::get_sort_key(
+    unsigned int index,
+    Output_reloc_sort_key* key) const
+{
+  if (this->is_relative_)
+    key->symbol = 0;
+  else
+    key->symbol = static_cast<uint64_t>(this->get_symbol_index()) + 1;
+  key->address = this->get_address();
+  key->type = this->type_;
+  key->index = index;
+  key->addend = 0;
+}
+
 // Write out a Rela relocation.
 
 template<bool dynamic, int size, bool big_endian>
@@ -1225,6 +1244,114 @@ Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>::write(
   orel.put_r_addend(addend);
 }
 
+// Class Output_data_reloc_generic.
+
+// The number of sort keys sorted by a single task.
+
+static const size_t reloc_sort_chunk_size = 0x40000;
+
+// A task to sort one chunk of the sort keys of the dynamic relocs.
+// The chunks are merged when the relocs are written.
+
+class Reloc_sort_task : public Task
+{
+ public:
+  // BLOCKER is not owned by the task.
+  Reloc_sort_task(Output_data_reloc_generic* relocs, unsigned int chunk,
+		  Task_token* blocker)
+    : relocs_(relocs), chunk_(chunk), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->relocs_->sort_chunk(this->chunk_); }
+
+  std::string
+  get_name() const
+  {
+    char buf[32];
+    snprintf(buf, sizeof buf, " chunk %u", this->chunk_);
+    return std::string("Reloc_sort_task") + buf;
+  }
+
+ private:
+  Output_data_reloc_generic* relocs_;
+  unsigned int chunk_;
+  Task_token* blocker_;
+};
+
+// Get the sort keys and queue the tasks to sort them.  This is called
+// after the layout is finalized, so the symbol indexes and the reloc
+// addresses are known.  The keys are found here, before the final
+// tasks are queued, because finding the address of a reloc in a
+// merged section is not thread safe: it may sort the merge map, which
+// a Relocate_task may be reading.
+
+void
+Output_data_reloc_generic::queue_sort_tasks(Workqueue* workqueue,
+					    Task_token* blocker)
+{
+  gold_assert(this->sort_relocs_ && this->sort_chunk_count_ == 0);
+  this->do_get_sort_keys(&this->sort_keys_);
+  size_t count = this->sort_keys_.size();
+  this->sort_chunk_count_ = ((count + reloc_sort_chunk_size - 1)
+			     / reloc_sort_chunk_size);
+  blocker->add_blockers(this->sort_chunk_count_);
+  for (unsigned int i = 0; i < this->sort_chunk_count_; ++i)
+    workqueue->queue(new Reloc_sort_task(this, i, blocker));
+}
+
+// Sort chunk I of the sort keys.  Chunks are sorted in parallel by
+// different tasks.
+
+void
+Output_data_reloc_generic::sort_chunk(unsigned int i)
+{
+  gold_assert(i < this->sort_chunk_count_);
+  size_t start = i * reloc_sort_chunk_size;
+  size_t end = std::min(start + reloc_sort_chunk_size,
+			this->sort_keys_.size());
+  std::sort(this->sort_keys_.begin() + start,
+	    this->sort_keys_.begin() + end);
+}
+
+// Return the sorted keys.  If the sort tasks ran, merge the chunks
+// they sorted; otherwise sort the keys here.
+
+Output_data_reloc_generic::Sort_keys*
+Output_data_reloc_generic::sorted_keys()
+{
+  if (this->sort_chunk_count_ == 0)
+    {
+      this->do_get_sort_keys(&this->sort_keys_);
+      std::sort(this->sort_keys_.begin(), this->sort_keys_.end());
+      return &this->sort_keys_;
+    }
+
+  size_t count = this->sort_keys_.size();
+  Sort_keys::iterator begin = this->sort_keys_.begin();
+  for (size_t width = reloc_sort_chunk_size; width < count; width *= 2)
+    {
+      for (size_t start = 0; start + width < count; start += 2 * width)
+	{
+	  size_t end = std::min(start + 2 * width, count);
+	  std::inplace_merge(begin + start, begin + start + width,
+			     begin + end);
+	}
+    }
+  return &this->sort_keys_;
+}
+
 // Output_data_reloc_base methods.
 
 // Adjust the output section.
@@ -1253,7 +1380,22 @@ Output_data_reloc_base<sh_type, dynamic, size, big_endian>
     os->set_should_link_to_dynsym();
 }
 
-// Write out relocation data.
+// Get the sort keys of the relocs.
+
+template<int sh_type, bool dynamic, int size, bool big_endian>
+void
+Output_data_reloc_base<sh_type, dynamic, size, big_endian>::do_get_sort_keys(
+    Sort_keys* keys) const
+{
+  gold_assert(dynamic);
+  size_t count = this->relocs_.size();
+  keys->resize(count);
+  for (size_t i = 0; i < count; ++i)
+    this->relocs_[i].get_sort_key(i, &(*keys)[i]);
+}
+
+// Write out relocation data.  When sorting, the relocs are written in
+// the order of their sort keys; the relocs themselves are not moved.
 
 template<int sh_type, bool dynamic, int size, bool big_endian>
 void
@@ -1264,20 +1406,30 @@ Output_data_reloc_base<sh_type, dynamic, size, big_endian>::do_write(
   const off_t oview_size = this->data_size();
   unsigned char* const oview = of->get_output_view(off, oview_size);
 
+  unsigned char* pov = oview;
   if (this->sort_relocs())
     {
       gold_assert(dynamic);
-      std::sort(this->relocs_.begin(), this->relocs_.end(),
-		Sort_relocs_comparison());
+      Sort_keys* keys = this->sorted_keys();
+      gold_assert(keys->size() == this->relocs_.size());
+      for (Sort_keys::const_iterator p = keys->begin();
+	   p != keys->end();
+	   ++p)
+	{
+	  this->relocs_[p->index].write(pov);
+	  pov += reloc_size;
+	}
+      Sort_keys().swap(*keys);
     }
-
-  unsigned char* pov = oview;
-  for (typename Relocs::const_iterator p = this->relocs_.begin();
-       p != this->relocs_.end();
-       ++p)
+  else
     {
-      p->write(pov);
-      pov += reloc_size;
+      for (typename Relocs::const_iterator p = this->relocs_.begin();
+	   p != this->relocs_.end();
+	   ++p)
+	{
+	  p->write(pov);
+	  pov += reloc_size;
+	}
     }
 
   gold_assert(pov - oview == oview_size);
@@ -2310,6 +2462,8 @@ Output_section::Output_section(const char* name, elfcpp::Elf_Word type,
     tls_offset_(0),
     extra_segment_flags_(0),
     segment_alignment_(0),
+    hot_input_sections_(NULL),
+    hot_input_sections_end_(NULL),
     checkpoint_(NULL),
     lookup_maps_(new Output_section_lookup_maps),
     free_list_(),
@@ -2444,13 +2598,15 @@ Output_section::add_input_section(Layout* layout,
   // Determine if we want to delay code-fill generation until the output
   // section is written.  When the target is relaxing, we want to delay fill
   // generating to avoid adjusting them during relaxation.  Also, if we are
-  // sorting input sections we must delay fill generation.
+  // sorting input sections or moving hot ones to the front we must delay
+  // fill generation.
   if (!this->generate_code_fills_at_write_
       && !have_sections_script
       && (sh_flags & elfcpp::SHF_EXECINSTR) != 0
       && parameters->target().has_code_fill()
       && (parameters->target().may_relax()
-	  || layout->is_section_ordering_specified()))
+	  || layout->is_section_ordering_specified()
+	  || parameters->options().hot_text()))
     {
       gold_assert(this->fills_.empty());
       this->generate_code_fills_at_write_ = true;
@@ -3555,6 +3711,25 @@ Output_section::Input_section_sort_section_name_compare
   return s1.index() < s2.index();
 }
 
+// Return true if S is one of the hot input sections.
+
+bool
+Output_section::Input_section_sort_is_hot::operator()(
+    const Output_section::Input_section_sort_entry& s) const
+{
+  const Input_section& is(s.input_section());
+  if (is.is_input_section())
+    return this->hot_->find(Section_id(is.relobj(), is.shndx()))
+	    != this->hot_->end();
+  else if (is.is_relaxed_input_section())
+    {
+      Output_relaxed_input_section* poris = is.relaxed_input_section();
+      return this->hot_->find(Section_id(poris->relobj(), poris->shndx()))
+	      != this->hot_->end();
+    }
+  return false;
+}
+
 // This updates the section order index of input sections according to the
 // the order specified in the mapping from Section id to order index.
 
@@ -3587,6 +3762,48 @@ Output_section::update_section_layout(
     }
 }
 
+// Move the hot input sections to the start of the section.  They are
+// moved when the input sections are sorted, so all we do here is add
+// the padding and remember which sections are hot.
+
+Output_section_data*
+Output_section::set_hot_input_sections(const Hot_input_sections* hot,
+				       uint64_t align)
+{
+  gold_assert(!this->attached_input_sections_are_sorted_);
+
+  Input_section_list::const_iterator p;
+  for (p = this->input_sections_.begin();
+       p != this->input_sections_.end();
+       ++p)
+    {
+      Section_id secn;
+      if (p->is_input_section())
+	secn = Section_id(p->relobj(), p->shndx());
+      else if (p->is_relaxed_input_section())
+	secn = Section_id(p->relaxed_input_section()->relobj(),
+			  p->relaxed_input_section()->shndx());
+      else
+	continue;
+      if (hot->find(secn) != hot->end())
+	break;
+    }
+  if (p == this->input_sections_.end())
+    return NULL;
+
+  // An empty section with the alignment we want ends the hot input
+  // sections, so that the next input section starts on a new
+  // ALIGN boundary.  Adding it also raises the alignment of this
+  // section to ALIGN, so the hot input sections start on one too.
+  Output_section_data* posd = new Output_data_zero_fill(0, align);
+  this->add_output_section_data(posd);
+
+  this->hot_input_sections_ = hot;
+  this->hot_input_sections_end_ = posd;
+  this->set_input_section_order_specified();
+  return posd;
+}
+
 // Sort the input sections attached to an output section.
 
 void
@@ -3640,6 +3857,25 @@ Output_section::sort_attached_input_sections()
 		Input_section_sort_section_order_index_compare());
     }
 
+  // Put the hot input sections first, keeping their relative order,
+  // and follow them with the padding which ends them.
+  if (this->hot_input_sections_end_ != NULL)
+    {
+      std::vector<Input_section_sort_entry>::iterator hot_end =
+	std::stable_partition(sort_list.begin(), sort_list.end(),
+			      Input_section_sort_is_hot(
+				  this->hot_input_sections_));
+      std::vector<Input_section_sort_entry>::iterator pad = hot_end;
+      while (!pad->input_section().is_output_section_data()
+	     || (pad->input_section().output_section_data()
+		 != this->hot_input_sections_end_))
+	{
+	  ++pad;
+	  gold_assert(pad != sort_list.end());
+	}
+      std::rotate(hot_end, pad, pad + 1);
+    }
+
   // Copy the sorted input sections back to our list.
   this->input_sections_.clear();
   for (std::vector<Input_section_sort_entry>::iterator p = sort_list.begin();
@@ -4055,6 +4291,18 @@ Output_section::print_merge_stats()
     p->print_merge_stats(this->name_);
 }
 
+// Queue tasks to merge the merge sections in parallel.
+
+void
+Output_section::queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  Input_section_list::iterator p;
+  for (p = this->input_sections_.begin();
+       p != this->input_sections_.end();
+       ++p)
+    p->queue_merge_tasks(workqueue, blocker);
+}
+
 // Set a fixed layout for the section.  Used for incremental update links.
 
 void
@@ -4932,6 +5180,34 @@ Output_segment::print_section_list_to_mapfile(Mapfile* mapfile,
 
 // Output_file methods.
 
+Timer::TimeStats Output_file::open_time;
+Timer::TimeStats Output_file::prefault_time;
+Timer::TimeStats Output_file::close_time;
+
+// Add the time since TIMER was started to *TOTAL, for the output file
+// statistics.
+
+static void
+add_output_file_time(Timer* timer, Timer::TimeStats* total)
+{
+  Timer::TimeStats elapsed = timer->get_elapsed_time();
+  total->user += elapsed.user;
+  total->sys += elapsed.sys;
+  total->wall += elapsed.wall;
+}
+
+// Print one of the output file times for --stats.  FORMAT has a %s for
+// the program name, followed by the times.
+
+static void
+print_output_file_time(const char* format, const Timer::TimeStats& time)
+{
+  fprintf(stderr, format, program_name,
+	  time.user / 1000, (time.user % 1000) * 1000,
+	  time.sys / 1000, (time.sys % 1000) * 1000,
+	  time.wall / 1000, (time.wall % 1000) * 1000);
+}
+
 Output_file::Output_file(const char* name)
   : name_(name),
     o_(-1),
@@ -4939,7 +5215,8 @@ Output_file::Output_file(const char* name)
     base_(NULL),
     map_is_anonymous_(false),
     map_is_allocated_(false),
-    is_temporary_(false)
+    is_temporary_(false),
+    prefault_timer_()
 {
 }
 
@@ -5040,6 +5317,8 @@ Output_file::open_base_file(const char* base_name, bool writable)
 void
 Output_file::open(off_t file_size)
 {
+  Timer timer;
+  timer.start();
   this->file_size_ = file_size;
 
   // Unlink the file first; otherwise the open() may fail if the file
@@ -5090,6 +5369,7 @@ Output_file::open(off_t file_size)
     }
 
   this->map();
+  add_output_file_time(&timer, &Output_file::open_time);
 }
 
 // Resize the output file.
@@ -5097,6 +5377,9 @@ Output_file::open(off_t file_size)
 void
 Output_file::resize(off_t file_size)
 {
+  Timer timer;
+  timer.start();
+
   // If the mmap is mapping an anonymous memory buffer, this is easy:
   // just mremap to the new size.  If it's mapping to a file, we want
   // to unmap to flush to the file, then remap after growing the file.
@@ -5129,6 +5412,8 @@ Output_file::resize(off_t file_size)
       if (!this->map_no_anonymous(true))
 	gold_fatal(_("%s: mmap: %s"), this->name_, strerror(errno));
     }
+
+  add_output_file_time(&timer, &Output_file::open_time);
 }
 
 // Map an anonymous block of memory which will later be written to the
@@ -5242,11 +5527,83 @@ Output_file::unmap()
   this->base_ = NULL;
 }
 
+// Make sure the pages from START for LEN bytes are present and
+// writable.  Populating a file mapping also allocates the file blocks
+// and page cache pages, which is where most of the time goes on
+// tmpfs and ext4.
+
+void
+Output_file::prefault(off_t start, off_t len)
+{
+  gold_assert(start >= 0 && start + len <= this->file_size_);
+
+  // Memory we allocated ourselves was cleared, which touched it.
+  if (this->map_is_allocated_ || len == 0)
+    return;
+
+#if defined(HAVE_MMAP) && defined(MADV_POPULATE_WRITE)
+  if (::madvise(this->base_ + start, len, MADV_POPULATE_WRITE) == 0)
+    return;
+#endif
+
+  // Otherwise write to each page.  We write back the byte we read, so
+  // this keeps the contents of an incremental base file.  We only
+  // touch bytes within the range, since other tasks may be writing
+  // next to it.
+  off_t page_size = 4096;
+#if defined(HAVE_SYSCONF) && defined(_SC_PAGESIZE)
+  long sc_page_size = ::sysconf(_SC_PAGESIZE);
+  if (sc_page_size > 0)
+    page_size = sc_page_size;
+#endif
+  volatile unsigned char* p = this->base_;
+  p[start] = p[start];
+  for (off_t off = (start / page_size + 1) * page_size;
+       off < start + len;
+       off += page_size)
+    p[off] = p[off];
+}
+
+// Note the start of pre-faulting the output file.
+
+void
+Output_file::start_prefault()
+{
+  this->prefault_timer_.start();
+}
+
+// Note the end of pre-faulting the output file.
+
+void
+Output_file::finish_prefault()
+{
+  add_output_file_time(&this->prefault_timer_, &Output_file::prefault_time);
+}
+
+// Print statistics about the output file.
+
+void
+Output_file::print_stats()
+{
+  print_output_file_time(_("%s: output file open time: "
+			   "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+			 Output_file::open_time);
+  print_output_file_time(_("%s: output file prefault time: "
+			   "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+			 Output_file::prefault_time);
+  print_output_file_time(_("%s: output file close time: "
+			   "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+			 Output_file::close_time);
+}
+
 // Close the output file.
 
 void
 Output_file::close()
 {
+  Timer timer;
+  timer.start();
+
   // If the map isn't file-backed, we need to write it now.
   if (this->map_is_anonymous_ && !this->is_temporary_)
     {
@@ -5276,6 +5633,8 @@ Output_file::close()
     if (::close(this->o_) < 0)
       gold_error(_("%s: close: %s"), this->name_, strerror(errno));
   this->o_ = -1;
+
+  add_output_file_time(&timer, &Output_file::close_time);
 }
 
 // Instantiate the templates we need.  We could use the configure
@@ -31,6 +31,7 @@
 #include "mapfile.h"
 #include "layout.h"
 #include "reloc-types.h"
+#include "timer.h"
 
 namespace gold
 {
@@ -695,6 +696,14 @@ class Output_section_data : public Output_data
   print_merge_stats(const char* section_name)
   { this->do_print_merge_stats(section_name); }
 
+  // Queue tasks to do any merging which can be done in parallel once
+  // all the input sections have been added.  Each task holds a
+  // blocker on BLOCKER until it is done.  This should only be called
+  // for SHF_MERGE sections.
+  void
+  queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+  { this->do_queue_merge_tasks(workqueue, blocker); }
+
  protected:
   // The child class must implement do_write.
 
@@ -733,6 +742,11 @@ class Output_section_data : public Output_data
   do_print_merge_stats(const char*)
   { gold_unreachable(); }
 
+  // The child class may implement queue_merge_tasks.
+  virtual void
+  do_queue_merge_tasks(Workqueue*, Task_token*)
+  { }
+
   // Return the required alignment.
   uint64_t
   do_addralign() const
@@ -993,6 +1007,42 @@ class Output_data_strtab : public Output_section_data
   Stringpool* strtab_;
 };
 
+// The fields of a dynamic reloc which determine where it goes when
+// the dynamic relocs are sorted.  Comparing these orders the relocs
+// as Output_reloc::compare does, with the addend for SHT_RELA, and
+// then the position of the reloc in its section so that the order is
+// the same however the relocs are sorted.  Relocs are sorted by
+// their keys, which are much cheaper to compare than the relocs.
+
+struct Output_reloc_sort_key
+{
+  // Zero for a relative reloc, otherwise one more than the symbol
+  // index.
+  uint64_t symbol;
+  // The address of the reloc.
+  section_offset_type address;
+  // The reloc type.
+  unsigned int type;
+  // The position of the reloc in its section.
+  unsigned int index;
+  // The addend, or zero for SHT_REL.
+  uint64_t addend;
+
+  bool
+  operator<(const Output_reloc_sort_key& k) const
+  {
+    if (this->symbol != k.symbol)
+      return this->symbol < k.symbol;
+    if (this->address != k.address)
+      return this->address < k.address;
+    if (this->type != k.type)
+      return this->type < k.type;
+    if (this->addend != k.addend)
+      return this->addend < k.addend;
+    return this->index < k.index;
+  }
+};
+
 // This POD class is used to represent a single reloc in the output
 // file.  This could be a private class within Output_data_reloc, but
 // the templatization is complex enough that I broke it out into a
@@ -1156,12 +1206,10 @@ class Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>
   compare(const Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>& r2)
     const;
 
-  // Return whether this reloc should be sorted before the argument
-  // when sorting dynamic relocs.
-  bool
-  sort_before(const Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>&
-	      r2) const
-  { return this->compare(r2) < 0; }
+  // Set *KEY to the key used to sort dynamic relocs, which gives the
+  // same order as compare.  INDEX is the position of the reloc.
+  void
+  get_sort_key(unsigned int index, Output_reloc_sort_key* key) const;
 
  private:
   // Record that we need a dynamic symbol index.
@@ -1366,19 +1414,13 @@ class Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   void
   write(unsigned char* pov) const;
 
-  // Return whether this reloc should be sorted before the argument
-  // when sorting dynamic relocs.
-  bool
-  sort_before(const Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>&
-	      r2) const
+  // Set *KEY to the key used to sort dynamic relocs.  INDEX is the
+  // position of the reloc.
+  void
+  get_sort_key(unsigned int index, Output_reloc_sort_key* key) const
   {
-    int i = this->rel_.compare(r2.rel_);
-    if (i < 0)
-      return true;
-    else if (i > 0)
-      return false;
-    else
-      return this->addend_ < r2.addend_;
+    this->rel_.get_sort_key(index, key);
+    key->addend = this->addend_;
   }
 
  private:
@@ -1397,7 +1439,8 @@ class Output_data_reloc_generic : public Output_section_data_build
  public:
   Output_data_reloc_generic(int size, bool sort_relocs)
     : Output_section_data_build(Output_data::default_alignment_for_size(size)),
-      relative_reloc_count_(0), sort_relocs_(sort_relocs)
+      relative_reloc_count_(0), sort_relocs_(sort_relocs), sort_keys_(),
+      sort_chunk_count_(0)
   { }
 
   // Return the number of relative relocs in this section.
@@ -1410,6 +1453,17 @@ class Output_data_reloc_generic : public Output_section_data_build
   sort_relocs() const
   { return this->sort_relocs_; }
 
+  // Get the sort keys, and queue tasks to sort them in parallel
+  // before the relocs are written.  BLOCKER is unblocked when the
+  // tasks are done.  This must be called before any task which may
+  // look up an address in a merged section is queued.
+  void
+  queue_sort_tasks(Workqueue*, Task_token* blocker);
+
+  // Sort chunk I of the sort keys.
+  void
+  sort_chunk(unsigned int i);
+
   // Add a reloc of type TYPE against the global symbol GSYM.  The
   // relocation applies to the data at offset ADDRESS within OD.
   virtual void
@@ -1460,11 +1514,23 @@ class Output_data_reloc_generic : public Output_section_data_build
 			     uint64_t addend) = 0;
 
  protected:
+  typedef std::vector<Output_reloc_sort_key> Sort_keys;
+
   // Note that we've added another relative reloc.
   void
   bump_relative_reloc_count()
   { ++this->relative_reloc_count_; }
 
+  // Return the sorted keys for the relocs.  If the sort tasks sorted
+  // chunks of the keys, this merges them; otherwise this gets the
+  // keys and sorts them.
+  Sort_keys*
+  sorted_keys();
+
+  // Set *KEYS to the sort keys of the relocs, in order of position.
+  virtual void
+  do_get_sort_keys(Sort_keys* keys) const = 0;
+
  private:
   // The number of relative relocs added to this section.  This is to
   // support DT_RELCOUNT.
@@ -1472,6 +1538,10 @@ class Output_data_reloc_generic : public Output_section_data_build
   // Whether to sort the relocations when writing them out, to make
   // the dynamic linker more efficient.
   bool sort_relocs_;
+  // The sort keys of the relocs.
+  Sort_keys sort_keys_;
+  // The number of chunks of sort_keys_ sorted by the sort tasks.
+  unsigned int sort_chunk_count_;
 };
 
 // Output_data_reloc is used to manage a section containing relocs.
@@ -1514,6 +1584,10 @@ class Output_data_reloc_base : public Output_data_reloc_generic
 				: _("** relocs")));
   }
 
+  // Get the sort keys.
+  void
+  do_get_sort_keys(Sort_keys* keys) const;
+
   // Add a relocation entry.
   void
   add(Output_data* od, const Output_reloc_type& reloc)
@@ -1532,14 +1606,6 @@ class Output_data_reloc_base : public Output_data_reloc_generic
  private:
   typedef std::vector<Output_reloc_type> Relocs;
 
-  // The class used to sort the relocations.
-  struct Sort_relocs_comparison
-  {
-    bool
-    operator()(const Output_reloc_type& r1, const Output_reloc_type& r2) const
-    { return r1.sort_before(r2); }
-  };
-
   // The relocations in this section.
   Relocs relocs_;
 };
@@ -3117,6 +3183,15 @@ class Output_section : public Output_data
   void
   update_section_layout(const Section_layout_order* order_map);
 
+  typedef Unordered_set<Section_id, Section_id_hash> Hot_input_sections;
+
+  // Move the input sections in HOT to the start of this section, and
+  // pad them to a multiple of ALIGN.  This returns the padding, which
+  // marks the end of the hot input sections, or NULL if none of the
+  // input sections are in HOT.
+  Output_section_data*
+  set_hot_input_sections(const Hot_input_sections* hot, uint64_t align);
+
   // Update the output section flags based on input section flags.
   void
   update_flags_for_input_section(elfcpp::Elf_Xword flags);
@@ -3778,6 +3853,15 @@ class Output_section : public Output_data
 	this->u2_.posd->print_merge_stats(section_name);
     }
 
+    // Queue tasks to merge a merge section in parallel.
+    void
+    queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+    {
+      if (this->shndx_ == MERGE_DATA_SECTION_CODE
+	  || this->shndx_ == MERGE_STRING_SECTION_CODE)
+	this->u2_.posd->queue_merge_tasks(workqueue, blocker);
+    }
+
    private:
     // Code values which appear in shndx_.  If the value is not one of
     // these codes, it is the input section index in the object file.
@@ -3907,6 +3991,19 @@ class Output_section : public Output_data
   void
   print_merge_stats();
 
+  // Queue tasks to merge the merge sections in parallel.
+  void
+  queue_merge_tasks(Workqueue*, Task_token* blocker);
+
+  // Queue tasks to compress the contents of the section in parallel,
+  // if it is compressed.  The tasks must wait for INPUT_BLOCKER, and
+  // hold blockers on BLOCKER until they are done.  Return true if
+  // any tasks were queued.
+  bool
+  queue_compress_tasks(Workqueue* workqueue, Task_token* input_blocker,
+		       Task_token* blocker)
+  { return this->do_queue_compress_tasks(workqueue, input_blocker, blocker); }
+
   // Set a fixed layout for the section.  Used for incremental update links.
   void
   set_fixed_layout(uint64_t sh_addr, off_t sh_offset, off_t sh_size,
@@ -4057,6 +4154,11 @@ class Output_section : public Output_data
   do_finalize_name(Layout*)
   { }
 
+  // This may be implemented by a child class.
+  virtual bool
+  do_queue_compress_tasks(Workqueue*, Task_token*, Task_token*)
+  { return false; }
+
   // Print to the map file.
   virtual void
   do_print_to_mapfile(Mapfile*) const;
@@ -4221,6 +4323,22 @@ class Output_section : public Output_data
 	       const Input_section_sort_entry&) const;
   };
 
+  // This is the predicate which selects the hot input sections, for
+  // set_hot_input_sections.
+  class Input_section_sort_is_hot
+  {
+   public:
+    Input_section_sort_is_hot(const Hot_input_sections* hot)
+      : hot_(hot)
+    { }
+
+    bool
+    operator()(const Input_section_sort_entry&) const;
+
+   private:
+    const Hot_input_sections* hot_;
+  };
+
   // Fill data.  This is used to fill in data between input sections.
   // It is also used for data statements (BYTE, WORD, etc.) in linker
   // scripts.  When we have to keep track of the input sections, we
@@ -4429,6 +4547,11 @@ class Output_section : public Output_data
   // Segment alignment specified via linker plugin, when mapping some
   // input sections to unique segments.
   uint64_t segment_alignment_;
+  // The input sections which go at the start of this section, set
+  // by set_hot_input_sections.
+  const Hot_input_sections* hot_input_sections_;
+  // The padding which follows the hot input sections.
+  Output_section_data* hot_input_sections_end_;
   // Saved checkpoint.
   Checkpoint_output_section* checkpoint_;
   // Fast lookup maps for merged and relaxed input sections.
@@ -4771,6 +4894,26 @@ class Output_file
   void
   close();
 
+  // Make sure the pages of the output file from START for LEN bytes are
+  // present and writable, so that writing to them does not fault.  START
+  // must be a multiple of the page size.  This may be called by several
+  // threads for disjoint ranges, but only before anything is written to
+  // the file.
+  void
+  prefault(off_t start, off_t len);
+
+  // Note the start and the end of pre-faulting the output file, for
+  // --stats.  This method is thread-unsafe.
+  void
+  start_prefault();
+
+  void
+  finish_prefault();
+
+  // Print statistics about the output file to stderr.
+  static void
+  print_stats();
+
   // Return the size of this file.
   off_t
   filesize()
@@ -4859,6 +5002,14 @@ class Output_file
   bool map_is_allocated_;
   // True if this is a temporary file which should not be output.
   bool is_temporary_;
+  // Started when pre-faulting starts.
+  Timer prefault_timer_;
+
+  // Time spent opening and allocating the output file, pre-faulting
+  // it, and flushing and closing it, for --stats.
+  static Timer::TimeStats open_time;
+  static Timer::TimeStats prefault_time;
+  static Timer::TimeStats close_time;
 };
 
 } // End namespace gold.
@@ -155,6 +155,9 @@ unique_segment_for_sections(const char* segment_name,
 			    uint64_t align,
 			    const struct ld_plugin_section *section_list,
 			    unsigned int num_sections);
+
+static enum ld_plugin_status
+allow_concurrent_claim_file();
 };
 
 #endif // ENABLE_PLUGINS
@@ -199,7 +202,7 @@ Plugin::load()
   sscanf(ver, "%d.%d", &major, &minor);
 
   // Allocate and populate a transfer vector.
-  const int tv_fixed_size = 26;
+  const int tv_fixed_size = 27;
 
   int tv_size = this->args_.size() + tv_fixed_size;
   ld_plugin_tv* tv = new ld_plugin_tv[tv_size];
@@ -321,6 +324,10 @@ Plugin::load()
   tv[i].tv_tag = LDPT_UNIQUE_SEGMENT_FOR_SECTIONS;
   tv[i].tv_u.tv_unique_segment_for_sections = unique_segment_for_sections;
 
+  ++i;
+  tv[i].tv_tag = LDPT_ALLOW_CONCURRENT_CLAIM_FILE;
+  tv[i].tv_u.tv_allow_concurrent_claim_file = allow_concurrent_claim_file;
+
   ++i;
   tv[i].tv_tag = LDPT_NULL;
   tv[i].tv_u.tv_val = 0;
@@ -439,9 +446,22 @@ Plugin_manager::load_plugins(Layout* layout)
        this->current_ != this->plugins_.end();
        ++this->current_)
     (*this->current_)->load();
+
+  this->concurrent_claim_file_ = true;
+  for (Plugin_list::const_iterator p = this->plugins_.begin();
+       p != this->plugins_.end();
+       ++p)
+    if (!(*p)->concurrent_claim_file())
+      this->concurrent_claim_file_ = false;
+
+  this->initialize_lock_.initialize();
+  this->initialize_claim_lock_.initialize();
 }
 
 // Call the plugin claim-file handlers in turn to see if any claim the file.
+// This is called by the Read_symbols tasks, which may run in parallel.
+// If every plugin allows it, the handlers are called for several files
+// at once; otherwise they are called for one file at a time.
 
 Pluginobj*
 Plugin_manager::claim_file(Input_file* input_file, off_t offset,
@@ -450,39 +470,66 @@ Plugin_manager::claim_file(Input_file* input_file, off_t offset,
   if (this->in_replacement_phase_)
     return NULL;
 
-  unsigned int handle = this->objects_.size();
-  this->input_file_ = input_file;
-  this->plugin_input_file_.name = input_file->filename().c_str();
-  this->plugin_input_file_.fd = input_file->file().descriptor();
-  this->plugin_input_file_.offset = offset;
-  this->plugin_input_file_.filesize = filesize;
-  this->plugin_input_file_.handle = reinterpret_cast<void*>(handle);
-  if (elf_object != NULL)
+  Hold_optional_lock hcl(this->concurrent_claim_file_
+			 ? NULL
+			 : this->claim_lock_);
+
+  Claim_file claim;
+  claim.input_file = input_file;
+  claim.plugin_input_file.name = input_file->filename().c_str();
+  claim.plugin_input_file.fd = input_file->file().descriptor();
+  claim.plugin_input_file.offset = offset;
+  claim.plugin_input_file.filesize = filesize;
+
+  // Reserve a handle for the file.  The slot holds the ELF object, if
+  // any, until a plugin claims the file.
+  unsigned int handle;
+  {
+    Hold_optional_lock hl(this->lock_);
+    handle = this->objects_.size();
     this->objects_.push_back(elf_object);
-  this->in_claim_file_handler_ = true;
+    this->claims_.resize(handle + 1, NULL);
+    this->claims_[handle] = &claim;
+  }
+  claim.plugin_input_file.handle = reinterpret_cast<void*>(handle);
 
-  for (this->current_ = this->plugins_.begin();
-       this->current_ != this->plugins_.end();
-       ++this->current_)
+  Pluginobj* obj = NULL;
+  for (Plugin_list::const_iterator p = this->plugins_.begin();
+       p != this->plugins_.end();
+       ++p)
     {
-      if ((*this->current_)->claim_file(&this->plugin_input_file_))
+      if ((*p)->claim_file(&claim.plugin_input_file))
         {
-	  this->any_claimed_ = true;
-	  this->in_claim_file_handler_ = false;
-
-          if (this->objects_.size() > handle
-              && this->objects_[handle]->pluginobj() != NULL)
-            return this->objects_[handle]->pluginobj();
-
-          // If the plugin claimed the file but did not call the
-          // add_symbols callback, we need to create the Pluginobj now.
-          Pluginobj* obj = this->make_plugin_object(handle);
-          return obj;
+	  Object* claimed = this->object(handle);
+	  if (claimed != NULL && claimed->pluginobj() != NULL)
+	    obj = claimed->pluginobj();
+	  else
+	    {
+	      // If the plugin claimed the file but did not call the
+	      // add_symbols callback, we need to create the Pluginobj now.
+	      obj = this->make_plugin_object(handle);
+	    }
+	  break;
         }
     }
 
-  this->in_claim_file_handler_ = false;
-  return NULL;
+  Hold_optional_lock hl(this->lock_);
+  this->claims_[handle] = NULL;
+  if (obj != NULL)
+    this->any_claimed_ = true;
+  return obj;
+}
+
+// Return whether the claim-file handlers are being called for the
+// file with HANDLE.
+
+bool
+Plugin_manager::in_claim_file_handler(const void* handle)
+{
+  unsigned int index =
+      static_cast<unsigned int>(reinterpret_cast<intptr_t>(handle));
+  Hold_optional_lock hl(this->lock_);
+  return index < this->claims_.size() && this->claims_[index] != NULL;
 }
 
 // Save an archive.  This is used so that a plugin can add a file
@@ -718,22 +765,26 @@ Plugin_manager::cleanup()
 Pluginobj*
 Plugin_manager::make_plugin_object(unsigned int handle)
 {
+  Hold_optional_lock hl(this->lock_);
+
+  // We can only make an object for a file which is up for claim.
+  if (handle >= this->claims_.size() || this->claims_[handle] == NULL)
+    return NULL;
+
   // Make sure we aren't asked to make an object for the same handle twice.
-  if (this->objects_.size() != handle
+  if (this->objects_[handle] != NULL
       && this->objects_[handle]->pluginobj() != NULL)
     return NULL;
 
-  Pluginobj* obj = make_sized_plugin_object(this->input_file_,
-                                            this->plugin_input_file_.offset,
-                                            this->plugin_input_file_.filesize);
-
-
-  // If the elf object for this file was pushed into the objects_ vector, delete
-  // it to make room for the Pluginobj as this file is claimed.
-  if (this->objects_.size() != handle)
-    this->objects_.pop_back();
+  const Claim_file* claim = this->claims_[handle];
+  Pluginobj* obj = make_sized_plugin_object(claim->input_file,
+                                            claim->plugin_input_file.offset,
+                                            claim->plugin_input_file.filesize);
 
-  this->objects_.push_back(obj);
+  // If the elf object for this file was stored in the objects_ vector,
+  // replace it with the Pluginobj as this file is claimed.  The caller
+  // deletes the elf object.
+  this->objects_[handle] = obj;
   return obj;
 }
 
@@ -744,7 +795,13 @@ ld_plugin_status
 Plugin_manager::get_input_file(unsigned int handle,
                                struct ld_plugin_input_file* file)
 {
-  Pluginobj* obj = this->object(handle)->pluginobj();
+  // The slot is NULL while a file which is not an ELF object is
+  // being claimed.
+  Object* object = this->object(handle);
+  if (object == NULL)
+    return LDPS_BAD_HANDLE;
+
+  Pluginobj* obj = object->pluginobj();
   if (obj == NULL)
     return LDPS_BAD_HANDLE;
 
@@ -797,13 +854,19 @@ Plugin_manager::get_view(unsigned int handle, const void **viewp)
   off_t offset;
   size_t filesize;
   Input_file *input_file;
-  if (this->in_claim_file_handler_)
+  const Claim_file* claim = NULL;
+  {
+    Hold_optional_lock hl(this->lock_);
+    if (handle < this->claims_.size())
+      claim = this->claims_[handle];
+  }
+  if (claim != NULL)
     {
       // We are being called from the claim_file hook.
-      const struct ld_plugin_input_file &f = this->plugin_input_file_;
+      const struct ld_plugin_input_file &f = claim->plugin_input_file;
       offset = f.offset;
       filesize = f.filesize;
-      input_file = this->input_file_;
+      input_file = claim->input_file;
     }
   else
     {
@@ -1600,7 +1663,7 @@ get_input_section_count(const void* handle, unsigned int* count)
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(handle))
     return LDPS_ERR;
 
   Object* obj = parameters->options().plugins()->get_elf_object(handle);
@@ -1622,7 +1685,8 @@ get_input_section_type(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1645,7 +1709,8 @@ get_input_section_name(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1674,7 +1739,8 @@ get_input_section_contents(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1709,6 +1775,14 @@ update_section_order(const struct ld_plugin_section* section_list,
   if (section_list == NULL)
     return LDPS_ERR;
 
+  // The --call-graph-ordering option uses the same section order map.
+  if (parameters->options().call_graph_ordering() != NULL)
+    {
+      gold_error(_("--call-graph-ordering may not be used with a plugin "
+		   "which sets the section order"));
+      return LDPS_ERR;
+    }
+
   Layout* layout = parameters->options().plugins()->layout();
   gold_assert (layout != NULL);
 
@@ -1742,6 +1816,17 @@ allow_section_ordering()
   return LDPS_OK;
 }
 
+// Let the linker know that the plugin's claim_file handler may be
+// called for several files at once.
+
+static enum ld_plugin_status
+allow_concurrent_claim_file()
+{
+  gold_assert(parameters->options().has_plugins());
+  parameters->options().plugins()->allow_concurrent_claim_file();
+  return LDPS_OK;
+}
+
 // Let the linker know that a subset of sections could be mapped
 // to a unique segment.
 
@@ -60,7 +60,8 @@ class Plugin
       claim_file_handler_(NULL),
       all_symbols_read_handler_(NULL),
       cleanup_handler_(NULL),
-      cleanup_done_(false)
+      cleanup_done_(false),
+      concurrent_claim_file_(false)
   { }
 
   ~Plugin()
@@ -97,6 +98,16 @@ class Plugin
   set_cleanup_handler(ld_plugin_cleanup_handler handler)
   { this->cleanup_handler_ = handler; }
 
+  // Record that the claim-file handler may be called concurrently.
+  void
+  set_concurrent_claim_file()
+  { this->concurrent_claim_file_ = true; }
+
+  // Return whether the claim-file handler may be called concurrently.
+  bool
+  concurrent_claim_file() const
+  { return this->concurrent_claim_file_; }
+
   // Add an argument
   void
   add_option(const char* arg)
@@ -120,6 +131,9 @@ class Plugin
   ld_plugin_cleanup_handler cleanup_handler_;
   // TRUE if the cleanup handlers have been called.
   bool cleanup_done_;
+  // TRUE if the plugin allows its claim-file handler to be called
+  // for several files at once.
+  bool concurrent_claim_file_;
 };
 
 // A manager class for plugins.
@@ -128,13 +142,14 @@ class Plugin_manager
 {
  public:
   Plugin_manager(const General_options& options)
-    : plugins_(), objects_(), deferred_layout_objects_(), input_file_(NULL),
-      plugin_input_file_(), rescannable_(), undefined_symbols_(),
-      any_claimed_(false), in_replacement_phase_(false), any_added_(false),
-      in_claim_file_handler_(false),
-      options_(options), workqueue_(NULL), task_(NULL), input_objects_(NULL),
-      symtab_(NULL), layout_(NULL), dirpath_(NULL), mapfile_(NULL),
-      this_blocker_(NULL), extra_search_path_()
+    : plugins_(), objects_(), deferred_layout_objects_(), claims_(),
+      lock_(NULL), initialize_lock_(&this->lock_), claim_lock_(NULL),
+      initialize_claim_lock_(&this->claim_lock_), rescannable_(),
+      undefined_symbols_(), any_claimed_(false), in_replacement_phase_(false),
+      any_added_(false), concurrent_claim_file_(false), options_(options),
+      workqueue_(NULL), task_(NULL), input_objects_(NULL), symtab_(NULL),
+      layout_(NULL), dirpath_(NULL), mapfile_(NULL), this_blocker_(NULL),
+      extra_search_path_()
   { this->current_ = plugins_.end(); }
 
   ~Plugin_manager();
@@ -166,10 +181,10 @@ class Plugin_manager
   Object*
   get_elf_object(const void* handle);
 
-  // True if the claim_file handler of the plugins is being called.
+  // True if the claim_file handler of the plugins is being called
+  // for the file with HANDLE.
   bool
-  in_claim_file_handler()
-  { return in_claim_file_handler_; }
+  in_claim_file_handler(const void* handle);
 
   // Let the plugin manager save an archive for later rescanning.
   // This takes ownership of the Archive pointer.
@@ -225,6 +240,15 @@ class Plugin_manager
     (*this->current_)->set_cleanup_handler(handler);
   }
 
+  // Allow the claim-file handler of the current plugin to be called
+  // concurrently.
+  void
+  allow_concurrent_claim_file()
+  {
+    gold_assert(this->current_ != plugins_.end());
+    (*this->current_)->set_concurrent_claim_file();
+  }
+
   // Make a new Pluginobj object.  This is called when the plugin calls
   // the add_symbols API.
   Pluginobj*
@@ -234,6 +258,7 @@ class Plugin_manager
   Object*
   object(unsigned int handle) const
   {
+    Hold_optional_lock hl(this->lock_);
     if (handle >= this->objects_.size())
       return NULL;
     return this->objects_[handle];
@@ -338,9 +363,28 @@ class Plugin_manager
   // The list of regular objects whose layout has been deferred.
   Deferred_layout_list deferred_layout_objects_;
 
-  // The file currently up for claim by the plugins.
-  Input_file* input_file_;
-  struct ld_plugin_input_file plugin_input_file_;
+  // A file up for claim by the plugins.
+  struct Claim_file
+  {
+    Input_file* input_file;
+    struct ld_plugin_input_file plugin_input_file;
+  };
+
+  typedef std::vector<const Claim_file*> Claim_list;
+
+  // The files currently up for claim by the plugins, indexed by
+  // handle.  An entry is NULL once the claim-file handlers are done
+  // with that file.
+  Claim_list claims_;
+
+  // Lock for objects_ and claims_, which may be updated by several
+  // claim-file handlers at once.
+  Lock* lock_;
+  Initialize_lock initialize_lock_;
+  // Lock held across the claim-file handlers unless every plugin
+  // allows them to be called concurrently.
+  Lock* claim_lock_;
+  Initialize_lock initialize_claim_lock_;
 
   // A list of archives and input groups being saved for possible
   // later rescanning.
@@ -360,8 +404,9 @@ class Plugin_manager
   // Whether any input files or libraries were added by a plugin.
   bool any_added_;
 
-  // Set to true when the claim_file handler of a plugin is called.
-  bool in_claim_file_handler_;
+  // Set to true if every plugin allows its claim_file handler to be
+  // called concurrently.
+  bool concurrent_claim_file_;
 
   const General_options& options_;
   Workqueue* workqueue_;
@@ -1798,7 +1798,10 @@ Powerpc_relobj<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
 	      if (opd_size != 0)
 		{
 		  this->init_opd(opd_size);
-		  this->scan_opd_relocs(p->reloc_count, p->contents->data(),
+		  Reloc_window window;
+		  this->scan_opd_relocs(p->reloc_count,
+					this->section_relocs_contents(*p,
+								      &window),
 					rd->local_symbols->data());
 		}
 	      break;
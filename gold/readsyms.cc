@@ -23,6 +23,8 @@
 #include "gold.h"
 
 #include <cstring>
+#include <algorithm>
+#include <set>
 
 #include "elfcpp.h"
 #include "options.h"
@@ -287,6 +289,13 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
       return false;
     }
 
+  // For an incremental link, hash the file contents now, while the
+  // file is mapped and files are read in parallel.  The hash is
+  // recorded later by Incremental_inputs.  Members of a
+  // --start-lib/--end-lib group are not recorded separately.
+  if (parameters->incremental() && this->member_ == NULL)
+    input_file->file().get_content_hash();
+
   const unsigned char* ehdr;
   int read_size;
   bool is_elf = is_elf_object(input_file, 0, &ehdr, &read_size);
@@ -304,6 +313,13 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
 				      this->dirpath_, this);
 	  arch->setup();
 
+	  // An archive in a group may be searched again for symbols
+	  // which become undefined later in the group.  Hash its
+	  // symbol map now, while we are reading archives in
+	  // parallel.
+	  if (this->input_group_ != NULL)
+	    arch->hash_armap();
+
 	  // Unlock the archive so it can be used in the next task.
 	  arch->unlock(this);
 
@@ -400,6 +416,11 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
       Read_symbols_data* sd = new Read_symbols_data;
       elf_obj->read_symbols(sd);
 
+      // If the symbol table is sharded, sort the symbols by shard
+      // now, while we are running in parallel with other files.
+      if (this->member_ == NULL && this->symtab_->shard_count() > 1)
+	elf_obj->assign_symbol_shards(this->symtab_, sd);
+
       // Opening the file locked it, so now we need to unlock it.  We
       // need to unlock it before queuing the Add_symbols task,
       // because the workqueue doesn't know about our lock on the
@@ -462,7 +483,8 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
 // setting off Read_symbols Tasks as usual, but recording the archive
 // entries instead of deleting them.  We also start a Finish_group
 // Task which runs after we've read all the symbols.  In that task we
-// process the archives in a loop until we are done.
+// look up the new undefined symbols in the archives until there are
+// no more.
 
 void
 Read_symbols::do_group(Workqueue* workqueue)
@@ -556,6 +578,133 @@ Read_symbols::get_name() const
     }
 }
 
+// When the symbol table is sharded, Add_symbols queues an
+// Add_shard_symbols task for each shard which gets symbols from the
+// object.  The tasks for a shard are chained together by tokens, so
+// that each shard sees the input files in command line order, but
+// tasks for different shards can run at the same time.  Each task
+// also holds a blocker on the Release_shard_object task for the
+// object, and on the symbol table's shard blocker.
+
+class Add_shard_symbols : public Task
+{
+ public:
+  Add_shard_symbols(Symbol_table* symtab, Object* object,
+		    Read_symbols_data* sd, unsigned int shard,
+		    Task_token* this_blocker, Task_token* next_blocker,
+		    Task_token* object_blocker)
+    : symtab_(symtab), object_(object), sd_(sd), shard_(shard),
+      this_blocker_(this_blocker), next_blocker_(next_blocker),
+      object_blocker_(object_blocker), waited_(false)
+  { }
+
+  ~Add_shard_symbols()
+  {
+    if (this->this_blocker_ != NULL)
+      delete this->this_blocker_;
+    // next_blocker_ is deleted by the next task for the same shard,
+    // or by Symbol_table::finish_shards.
+  }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+      {
+	// We are called with the workqueue lock held, so we can
+	// update the statistics.
+	if (!this->waited_)
+	  {
+	    this->symtab_->note_shard_wait(this->shard_);
+	    this->waited_ = true;
+	  }
+	return this->this_blocker_;
+      }
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->next_blocker_);
+    tl->add(this, this->object_blocker_);
+    tl->add(this, this->symtab_->shard_blocker());
+  }
+
+  void
+  run(Workqueue*)
+  { this->object_->add_shard_symbols(this->symtab_, this->sd_, this->shard_); }
+
+  std::string
+  get_name() const
+  { return "Add_shard_symbols " + this->object_->name(); }
+
+ private:
+  Symbol_table* symtab_;
+  Object* object_;
+  Read_symbols_data* sd_;
+  unsigned int shard_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+  Task_token* object_blocker_;
+  // Whether we have had to wait for the previous task for the shard.
+  bool waited_;
+};
+
+// This task runs after all the Add_shard_symbols tasks for an object.
+// It frees the symbol data and releases the object, which Add_symbols
+// would otherwise have done.
+
+class Release_shard_object : public Task
+{
+ public:
+  Release_shard_object(Symbol_table* symtab, Object* object,
+		       Read_symbols_data* sd, Task_token* this_blocker)
+    : symtab_(symtab), object_(object), sd_(sd), this_blocker_(this_blocker)
+  { }
+
+  ~Release_shard_object()
+  { delete this->this_blocker_; }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    if (this->object_->is_locked())
+      return this->object_->token();
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    Task_token* token = this->object_->token();
+    if (token != NULL)
+      tl->add(this, token);
+    tl->add(this, this->symtab_->shard_blocker());
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->object_->discard_decompressed_sections();
+    delete this->sd_;
+    this->sd_ = NULL;
+    this->object_->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Release_shard_object " + this->object_->name(); }
+
+ private:
+  Symbol_table* symtab_;
+  Object* object_;
+  Read_symbols_data* sd_;
+  Task_token* this_blocker_;
+};
+
 // Class Add_symbols.
 
 Add_symbols::~Add_symbols()
@@ -567,13 +716,20 @@ Add_symbols::~Add_symbols()
 }
 
 // We are blocked by this_blocker_.  We block next_blocker_.  We also
-// lock the file.
+// lock the file.  If the symbol table is sharded and we can't add
+// our symbols to the shards separately, we must also wait for the
+// shard tasks queued for earlier files.
 
 Task_token*
 Add_symbols::is_runnable()
 {
   if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
     return this->this_blocker_;
+  Task_token* shard_blocker = this->symtab_->shard_blocker();
+  if (shard_blocker != NULL
+      && shard_blocker->is_blocked()
+      && (this->sd_ == NULL || this->sd_->symbol_shards == NULL))
+    return shard_blocker;
   if (this->object_->is_locked())
     return this->object_->token();
   return NULL;
@@ -591,7 +747,7 @@ Add_symbols::locks(Task_locker* tl)
 // Add the symbols in the object to the symbol table.
 
 void
-Add_symbols::run(Workqueue*)
+Add_symbols::run(Workqueue* workqueue)
 {
   Pluginobj* pluginobj = this->object_->pluginobj();
   if (pluginobj != NULL)
@@ -632,6 +788,13 @@ Add_symbols::run(Workqueue*)
 					    this->library_, script_info);
 	}
       this->object_->layout(this->symtab_, this->layout_, this->sd_);
+      // SD_ is NULL for an unchanged object in an incremental update.
+      if (this->sd_ != NULL && this->sd_->symbol_shards != NULL)
+	{
+	  this->queue_shard_tasks(workqueue);
+	  this->sd_ = NULL;
+	  return;
+	}
       this->object_->add_symbols(this->symtab_, this->sd_, this->layout_);
       this->object_->discard_decompressed_sections();
       delete this->sd_;
@@ -640,6 +803,47 @@ Add_symbols::run(Workqueue*)
     }
 }
 
+// Queue the tasks to add the symbols to the symbol table shards, and
+// the task to release the object when they are done.
+
+void
+Add_symbols::queue_shard_tasks(Workqueue* workqueue)
+{
+  const std::vector<std::vector<unsigned int> >& symbol_shards =
+    *this->sd_->symbol_shards;
+
+  int count = 0;
+  for (unsigned int i = 0; i < symbol_shards.size(); ++i)
+    if (!symbol_shards[i].empty())
+      ++count;
+
+  Task_token* object_blocker = new Task_token(true);
+  object_blocker->add_blockers(count);
+
+  // The shard blocker may be shared with tasks which are already
+  // running, so we must hold the workqueue lock to change it.
+  workqueue->add_blockers(this->symtab_->shard_blocker(), count + 1);
+
+  for (unsigned int i = 0; i < symbol_shards.size(); ++i)
+    {
+      if (symbol_shards[i].empty())
+	continue;
+      Task_token* this_blocker = this->symtab_->shard_token(i);
+      Task_token* next_blocker = new Task_token(true);
+      next_blocker->add_blocker();
+      this->symtab_->set_shard_token(i, next_blocker);
+      workqueue->queue_soon(new Add_shard_symbols(this->symtab_,
+						  this->object_,
+						  this->sd_, i,
+						  this_blocker,
+						  next_blocker,
+						  object_blocker));
+    }
+
+  workqueue->queue(new Release_shard_object(this->symtab_, this->object_,
+					    this->sd_, object_blocker));
+}
+
 // Class Read_member.
 
 Read_member::~Read_member()
@@ -776,6 +980,68 @@ Input_group::~Input_group()
     delete *p;
 }
 
+// Sort the symbol index by hash code.
+
+class Symbol_index_hash_less
+{
+ public:
+  bool
+  operator()(const Input_group::Symbol_index_entry& e1,
+	     const Input_group::Symbol_index_entry& e2) const
+  { return e1.hash < e2.hash; }
+};
+
+// Build the symbol index from the hash codes which each archive
+// computed when it was read.
+
+void
+Input_group::build_symbol_index()
+{
+  size_t count = 0;
+  for (Input_group::const_iterator p = this->begin();
+       p != this->end();
+       ++p)
+    count += (*p)->armap_size();
+
+  this->symbol_index_.clear();
+  this->symbol_index_.reserve(count);
+  for (unsigned int i = 0; i < this->archives_.size(); ++i)
+    {
+      const Archive* arch = this->archives_[i];
+      const size_t armap_size = arch->armap_size();
+      for (size_t j = 0; j < armap_size; ++j)
+	{
+	  Symbol_index_entry e;
+	  e.hash = arch->armap_hash(j);
+	  e.archive = i;
+	  e.armap_index = j;
+	  this->symbol_index_.push_back(e);
+	}
+    }
+
+  std::sort(this->symbol_index_.begin(), this->symbol_index_.end(),
+	    Symbol_index_hash_less());
+}
+
+// Add to *ENTRIES the entries in the symbol index for NAME.
+
+void
+Input_group::find_symbol(const char* name, Symbol_index* entries) const
+{
+  size_t len = strlen(name);
+  Symbol_index_entry key;
+  key.hash = gold::string_hash<char>(name, len);
+  key.archive = 0;
+  key.armap_index = 0;
+  std::pair<Symbol_index::const_iterator, Symbol_index::const_iterator> r =
+    std::equal_range(this->symbol_index_.begin(), this->symbol_index_.end(),
+		     key, Symbol_index_hash_less());
+  for (Symbol_index::const_iterator p = r.first; p != r.second; ++p)
+    if (this->archives_[p->archive]->armap_name_matches(p->armap_index,
+							name, len))
+      entries->push_back(*p);
+}
+
 // Class Start_group.
 
 Start_group::~Start_group()
@@ -786,13 +1052,17 @@ Start_group::~Start_group()
   // file in the group.
 }
 
-// We need to wait for THIS_BLOCKER_ and unblock NEXT_BLOCKER_.
+// We need to wait for THIS_BLOCKER_ and unblock NEXT_BLOCKER_.  We
+// also need to see all the symbols added so far.
 
 Task_token*
 Start_group::is_runnable()
 {
   if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
     return this->this_blocker_;
+  Task_token* shard_blocker = this->symtab_->shard_blocker();
+  if (shard_blocker != NULL && shard_blocker->is_blocked())
+    return shard_blocker;
   return NULL;
 }
 
@@ -802,12 +1072,13 @@ Start_group::locks(Task_locker* tl)
   tl->add(this, this->next_blocker_);
 }
 
-// Store the number of undefined symbols we see now.
+// Store the position in the list of undefined symbols now.
 
 void
 Start_group::run(Workqueue*)
 {
-  this->finish_group_->set_saw_undefined(this->symtab_->saw_undefined());
+  this->symtab_->get_undefined_position(
+      this->finish_group_->undefined_position());
 }
 
 // Class Finish_group.
@@ -820,13 +1091,17 @@ Finish_group::~Finish_group()
   // input file following the group.
 }
 
-// We need to wait for THIS_BLOCKER_ and unblock NEXT_BLOCKER_.
+// We need to wait for THIS_BLOCKER_ and unblock NEXT_BLOCKER_.  We
+// also need to see all the symbols added so far.
 
 Task_token*
 Finish_group::is_runnable()
 {
   if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
     return this->this_blocker_;
+  Task_token* shard_blocker = this->symtab_->shard_blocker();
+  if (shard_blocker != NULL && shard_blocker->is_blocked())
+    return shard_blocker;
   return NULL;
 }
 
@@ -836,25 +1111,113 @@ Finish_group::locks(Task_locker* tl)
   tl->add(this, this->next_blocker_);
 }
 
-// Loop over the archives until there are no new undefined symbols.
+// Look up each symbol in UNDEFS which is still a strong undefined
+// symbol in the symbol index of GROUP.  Add the archive map entries
+// found to PENDING, which holds the entries to check for each archive
+// in the group.  Return the number of entries added.
+
+static size_t
+add_pending_entries(const Input_group* group,
+		    const std::vector<Symbol*>& undefs,
+		    std::vector<std::set<size_t> >* pending)
+{
+  Input_group::Symbol_index entries;
+  for (std::vector<Symbol*>::const_iterator p = undefs.begin();
+       p != undefs.end();
+       ++p)
+    {
+      // The symbol may have been defined since it was recorded.
+      if ((*p)->is_undefined() && (*p)->binding() != elfcpp::STB_WEAK)
+	group->find_symbol((*p)->name(), &entries);
+    }
+
+  size_t count = 0;
+  for (Input_group::Symbol_index::const_iterator p = entries.begin();
+       p != entries.end();
+       ++p)
+    if ((*pending)[p->archive].insert(p->armap_index).second)
+      ++count;
+  return count;
+}
+
+// Each archive in the group has already been searched once, for the
+// symbols which were undefined when it was added.  Now look up each
+// symbol which has become undefined since the start of the group in
+// the symbol index of the group, and check only the archive map
+// entries for that symbol.  Including a member may make more symbols
+// undefined, which we look up in turn.  This avoids walking the
+// archive map of every archive in the group each time a new undefined
+// symbol is seen, which is slow for groups of many archives.
+
+// The entries are checked in the order in which the loop over the
+// archives which this replaces would have reached them, so that the
+// same members are included: the archives are visited in order,
+// wrapping around at the end of the group, and, as in
+// Archive::add_symbols, an archive is scanned again from the start of
+// its map when a member is included from it.  A symbol defined in more
+// than one archive is thus taken from the first archive at or after
+// the one whose member referred to it.
 
 void
 Finish_group::run(Workqueue*)
 {
-  size_t saw_undefined = this->saw_undefined_;
-  while (saw_undefined != this->symtab_->saw_undefined())
+  std::vector<Symbol*> undefs;
+  this->symtab_->get_new_undefined_symbols(&this->undefined_position_,
+					   &undefs);
+  if (!undefs.empty())
+    this->input_group_->build_symbol_index();
+
+  const unsigned int archive_count = this->input_group_->archive_count();
+  std::vector<std::set<size_t> > pending(archive_count);
+  size_t pending_count = add_pending_entries(this->input_group_, undefs,
+					     &pending);
+  unsigned int i = 0;
+  while (pending_count > 0)
     {
-      saw_undefined = this->symtab_->saw_undefined();
-
-      for (Input_group::const_iterator p = this->input_group_->begin();
-	   p != this->input_group_->end();
-	   ++p)
+      std::set<size_t>& archive_pending(pending[i]);
+      bool added = false;
+      if (!archive_pending.empty())
 	{
-	  Task_lock_obj<Archive> tl(this, *p);
-
-	  (*p)->add_symbols(this->symtab_, this->layout_,
-			    this->input_objects_, this->mapfile_);
+	  Archive* arch = this->input_group_->archive(i);
+	  Task_lock_obj<Archive> tl(this, arch);
+	  this->input_objects_->archive_start(arch);
+	  std::set<size_t>::iterator p = archive_pending.begin();
+	  while (p != archive_pending.end())
+	    {
+	      size_t armap_index = *p;
+	      archive_pending.erase(p);
+	      --pending_count;
+
+	      bool added_member = false;
+	      bool ok = arch->add_group_symbol(this->symtab_, this->layout_,
+					       this->input_objects_,
+					       this->mapfile_, armap_index,
+					       &added_member);
+	      if (added_member)
+		{
+		  added = true;
+		  undefs.clear();
+		  this->symtab_->get_new_undefined_symbols(
+		      &this->undefined_position_, &undefs);
+		  pending_count += add_pending_entries(this->input_group_,
+						       undefs, &pending);
+		}
+
+	      // As in Archive::add_symbols, an incompatible member
+	      // stops the scan of this archive.
+	      if (!ok)
+		{
+		  added = false;
+		  break;
+		}
+
+	      p = archive_pending.upper_bound(armap_index);
+	    }
+	  this->input_objects_->archive_stop(arch);
 	}
+
+      if (!added)
+	i = (i + 1) % archive_count;
     }
 
   // Now that we're done with the archives, record the incremental
@@ -876,6 +1239,39 @@ Finish_group::run(Workqueue*)
     delete this->input_group_;
 }
 
+// Class Finish_symbol_shards.
+
+Finish_symbol_shards::~Finish_symbol_shards()
+{
+  if (this->this_blocker_ != NULL)
+    delete this->this_blocker_;
+  // next_blocker_ is deleted by the task which follows us.
+}
+
+// We need to wait for THIS_BLOCKER_, and for all the shard tasks.
+
+Task_token*
+Finish_symbol_shards::is_runnable()
+{
+  if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+    return this->this_blocker_;
+  if (this->symtab_->shard_blocker()->is_blocked())
+    return this->symtab_->shard_blocker();
+  return NULL;
+}
+
+void
+Finish_symbol_shards::locks(Task_locker* tl)
+{
+  tl->add(this, this->next_blocker_);
+}
+
+void
+Finish_symbol_shards::run(Workqueue*)
+{
+  this->symtab_->finish_shards();
+}
+
 // Class Read_script
 
 Read_script::~Read_script()
@@ -166,6 +166,10 @@ class Add_symbols : public Task
   { return "Add_symbols " + this->object_->name(); }
 
 private:
+  // Queue tasks to add the symbols to a sharded symbol table.
+  void
+  queue_shard_tasks(Workqueue*);
+
   Input_objects* input_objects_;
   Symbol_table* symtab_;
   Layout* layout_;
@@ -320,8 +324,21 @@ class Input_group
   typedef std::vector<Archive*> Archives;
   typedef Archives::const_iterator const_iterator;
 
+  // An entry in the index of the archive map symbols of the group.
+  struct Symbol_index_entry
+  {
+    // The hash code of the symbol name, without any version.
+    size_t hash;
+    // The index of the archive in the group.
+    unsigned int archive;
+    // The index of the symbol in the archive map.
+    unsigned int armap_index;
+  };
+
+  typedef std::vector<Symbol_index_entry> Symbol_index;
+
   Input_group()
-    : archives_()
+    : archives_(), symbol_index_()
   { }
 
   ~Input_group();
@@ -331,6 +348,16 @@ class Input_group
   add_archive(Archive* arch)
   { this->archives_.push_back(arch); }
 
+  // Return the number of archives in the group.
+  unsigned int
+  archive_count() const
+  { return this->archives_.size(); }
+
+  // Return archive I in the group.
+  Archive*
+  archive(unsigned int i) const
+  { return this->archives_[i]; }
+
   // Loop over the archives in the group.
 
   const_iterator
@@ -341,13 +368,25 @@ class Input_group
   end() const
   { return this->archives_.end(); }
 
+  // Build the index of the symbols in the archive maps of the
+  // archives in the group.
+  void
+  build_symbol_index();
+
+  // Add to *ENTRIES the entries in the symbol index for the symbol
+  // NAME.  build_symbol_index must have been called.
+  void
+  find_symbol(const char* name, Symbol_index* entries) const;
+
  private:
   Archives archives_;
+  // The index of the archive map symbols, sorted by hash code.
+  Symbol_index symbol_index_;
 };
 
 // This class starts the handling of a group.  It exists only to pick
-// up the number of undefined symbols at that point, so that we only
-// run back through the group if we saw a new undefined symbol.
+// up the list of undefined symbols at that point, so that we only
+// look for the symbols which became undefined within the group.
 
 class Start_group : public Task
 {
@@ -393,16 +432,16 @@ class Finish_group : public Task
 	       Task_token* next_blocker)
     : input_objects_(input_objects), symtab_(symtab),
       layout_(layout), mapfile_(mapfile), input_group_(input_group),
-      saw_undefined_(0), this_blocker_(NULL), next_blocker_(next_blocker)
+      undefined_position_(), this_blocker_(NULL), next_blocker_(next_blocker)
   { }
 
   ~Finish_group();
 
-  // Set the number of undefined symbols when we start processing the
-  // group.  This is called by the Start_group task.
-  void
-  set_saw_undefined(size_t saw_undefined)
-  { this->saw_undefined_ = saw_undefined; }
+  // Return the position in the list of undefined symbols when we
+  // start processing the group.  This is set by the Start_group task.
+  std::vector<size_t>*
+  undefined_position()
+  { return &this->undefined_position_; }
 
   // Set the blocker to use for this task.
   void
@@ -433,7 +472,45 @@ class Finish_group : public Task
   Layout* layout_;
   Mapfile* mapfile_;
   Input_group* input_group_;
-  size_t saw_undefined_;
+  // A Symbol_table::Undefined_position.
+  std::vector<size_t> undefined_position_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
+// When the symbol table is sharded, this Task runs after all the
+// input files have been read.  It waits for all the tasks which add
+// symbols to the shards, and then finishes up the symbol table.  The
+// tasks which follow it may then see the complete symbol table.
+
+class Finish_symbol_shards : public Task
+{
+ public:
+  Finish_symbol_shards(Symbol_table* symtab, Task_token* this_blocker,
+		       Task_token* next_blocker)
+    : symtab_(symtab), this_blocker_(this_blocker),
+      next_blocker_(next_blocker)
+  { }
+
+  ~Finish_symbol_shards();
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Finish_symbol_shards"; }
+
+ private:
+  Symbol_table* symtab_;
   Task_token* this_blocker_;
   Task_token* next_blocker_;
 };
@@ -350,8 +350,12 @@ Sized_relobj_file<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
       Section_relocs& sr(rd->relocs.back());
       sr.reloc_shndx = i;
       sr.data_shndx = shndx;
-      sr.contents = this->get_lasting_view(shdr.get_sh_offset(), sh_size,
-					   true, true);
+      sr.reloc_offset = shdr.get_sh_offset();
+      // With --reloc-window-size we read the relocs when we scan
+      // them, so that we don't hold them all until then.
+      if (parameters->options().reloc_window_size() == 0)
+	sr.contents = this->get_lasting_view(shdr.get_sh_offset(), sh_size,
+					     true, true);
       sr.sh_type = sh_type;
       sr.reloc_count = reloc_count;
       sr.output_section = os;
@@ -396,6 +400,7 @@ Sized_relobj_file<size, big_endian>::do_gc_process_relocs(Symbol_table* symtab,
   else
     local_symbols = rd->local_symbols->data();
 
+  Reloc_window window;
   for (Read_relocs_data::Relocs_list::iterator p = rd->relocs.begin();
        p != rd->relocs.end();
        ++p)
@@ -408,7 +413,9 @@ Sized_relobj_file<size, big_endian>::do_gc_process_relocs(Symbol_table* symtab,
 	    if (p->is_data_section_allocated)
               target->gc_process_relocs(symtab, layout, this, 
                                         p->data_shndx, p->sh_type, 
-                                        p->contents->data(), p->reloc_count, 
+                                        this->section_relocs_contents(*p,
+								      &window),
+					p->reloc_count, 
                                         p->output_section,
                                         p->needs_special_offset_handling,
                                         this->local_symbol_count_, 
@@ -440,6 +447,10 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
   if (layout->incremental_inputs() != NULL)
     this->allocate_incremental_reloc_counts();
 
+  // The target scans the relocs for a section in one call, since it
+  // may track state from one reloc to the next, so with
+  // --reloc-window-size we read a whole section at a time.
+  Reloc_window window;
   for (Read_relocs_data::Relocs_list::iterator p = rd->relocs.begin();
        p != rd->relocs.end();
        ++p)
@@ -453,6 +464,8 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
           if (p->output_section == NULL)
             continue;
         }
+      const unsigned char* prelocs = this->section_relocs_contents(*p,
+								   &window);
       if (!parameters->options().relocatable())
 	{
 	  // As noted above, when not generating an object file, we
@@ -460,15 +473,15 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
 	  // section here if we are emitting relocs.
 	  if (p->is_data_section_allocated)
 	    target->scan_relocs(symtab, layout, this, p->data_shndx,
-				p->sh_type, p->contents->data(),
+				p->sh_type, prelocs,
 				p->reloc_count, p->output_section,
 				p->needs_special_offset_handling,
 				this->local_symbol_count_,
 				local_symbols);
 	  if (parameters->options().emit_relocs())
-	    this->emit_relocs_scan(symtab, layout, local_symbols, p);
+	    this->emit_relocs_scan(symtab, layout, local_symbols, p, prelocs);
 	  if (layout->incremental_inputs() != NULL)
-	    this->incremental_relocs_scan(p);
+	    this->incremental_relocs_scan(p, prelocs);
 	}
       else
 	{
@@ -477,7 +490,7 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
 	  rr->set_reloc_count(p->reloc_count);
 	  target->scan_relocatable_relocs(symtab, layout, this,
 					  p->data_shndx, p->sh_type,
-					  p->contents->data(),
+					  prelocs,
 					  p->reloc_count,
 					  p->output_section,
 					  p->needs_special_offset_handling,
@@ -544,7 +557,8 @@ Sized_relobj_file<size, big_endian>::emit_relocs_scan(
     Symbol_table* symtab,
     Layout* layout,
     const unsigned char* plocal_syms,
-    const Read_relocs_data::Relocs_list::iterator& p)
+    const Read_relocs_data::Relocs_list::iterator& p,
+    const unsigned char* prelocs)
 {
   Relocatable_relocs* rr = this->relocatable_relocs(p->reloc_shndx);
   gold_assert(rr != NULL);
@@ -552,12 +566,14 @@ Sized_relobj_file<size, big_endian>::emit_relocs_scan(
 
   if (p->sh_type == elfcpp::SHT_REL)
     this->emit_relocs_scan_reltype<elfcpp::SHT_REL>(symtab, layout,
-						    plocal_syms, p, rr);
+						    plocal_syms, p, prelocs,
+						    rr);
   else
     {
       gold_assert(p->sh_type == elfcpp::SHT_RELA);
       this->emit_relocs_scan_reltype<elfcpp::SHT_RELA>(symtab, layout,
-						       plocal_syms, p, rr);
+						       plocal_syms, p, prelocs,
+						       rr);
     }
 }
 
@@ -572,6 +588,7 @@ Sized_relobj_file<size, big_endian>::emit_relocs_scan_reltype(
     Layout* layout,
     const unsigned char* plocal_syms,
     const Read_relocs_data::Relocs_list::iterator& p,
+    const unsigned char* prelocs,
     Relocatable_relocs* rr)
 {
   scan_relocatable_relocs<size, big_endian, sh_type,
@@ -580,7 +597,7 @@ Sized_relobj_file<size, big_endian>::emit_relocs_scan_reltype(
     layout,
     this,
     p->data_shndx,
-    p->contents->data(),
+    prelocs,
     p->reloc_count,
     p->output_section,
     p->needs_special_offset_handling,
@@ -594,14 +611,15 @@ Sized_relobj_file<size, big_endian>::emit_relocs_scan_reltype(
 template<int size, bool big_endian>
 void
 Sized_relobj_file<size, big_endian>::incremental_relocs_scan(
-    const Read_relocs_data::Relocs_list::iterator& p)
+    const Read_relocs_data::Relocs_list::iterator& p,
+    const unsigned char* prelocs)
 {
   if (p->sh_type == elfcpp::SHT_REL)
-    this->incremental_relocs_scan_reltype<elfcpp::SHT_REL>(p);
+    this->incremental_relocs_scan_reltype<elfcpp::SHT_REL>(p, prelocs);
   else
     {
       gold_assert(p->sh_type == elfcpp::SHT_RELA);
-      this->incremental_relocs_scan_reltype<elfcpp::SHT_RELA>(p);
+      this->incremental_relocs_scan_reltype<elfcpp::SHT_RELA>(p, prelocs);
     }
 }
 
@@ -612,11 +630,11 @@ template<int size, bool big_endian>
 template<int sh_type>
 void
 Sized_relobj_file<size, big_endian>::incremental_relocs_scan_reltype(
-    const Read_relocs_data::Relocs_list::iterator& p)
+    const Read_relocs_data::Relocs_list::iterator& p,
+    const unsigned char* prelocs)
 {
   typedef typename Reloc_types<sh_type, size, big_endian>::Reloc Reltype;
   const int reloc_size = Reloc_types<sh_type, size, big_endian>::reloc_size;
-  const unsigned char* prelocs = p->contents->data();
   size_t reloc_count = p->reloc_count;
 
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
@@ -920,6 +938,11 @@ Sized_relobj_file<size, big_endian>::do_relocate_sections(
   relinfo.layout = layout;
   relinfo.object = this;
 
+  // With --reloc-window-size, we read the relocs into a buffer rather
+  // than keeping views of them until we are done with the object.
+  const uint64_t window_size = parameters->options().reloc_window_size();
+  Reloc_window window;
+
   const unsigned char* p = pshdrs + This::shdr_size;
   for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
     {
@@ -962,9 +985,6 @@ Sized_relobj_file<size, big_endian>::do_relocate_sections(
 	  continue;
 	}
 
-      const unsigned char* prelocs = this->get_view(shdr.get_sh_offset(),
-						    sh_size, true, false);
-
       unsigned int reloc_size;
       if (sh_type == elfcpp::SHT_REL)
 	reloc_size = elfcpp::Elf_sizes<size>::rel_size;
@@ -994,6 +1014,28 @@ Sized_relobj_file<size, big_endian>::do_relocate_sections(
       relinfo.reloc_shdr = p;
       relinfo.data_shndx = index;
       relinfo.data_shdr = pshdrs + index * This::shdr_size;
+
+      // Relocations for a section which is not allocated, such as a
+      // debugging section, are applied independently of each other,
+      // so we can apply them a window at a time.  For other sections
+      // the target may track state from one reloc to the next.
+      const unsigned char* prelocs;
+      size_t window_count = reloc_count;
+      if (window_size == 0)
+	prelocs = this->get_view(shdr.get_sh_offset(), sh_size, true, false);
+      else
+	{
+	  typename This::Shdr data_shdr(relinfo.data_shdr);
+	  if ((data_shdr.get_sh_flags() & elfcpp::SHF_ALLOC) == 0
+	      && !parameters->options().relocatable()
+	      && !parameters->options().emit_relocs()
+	      && !parameters->incremental()
+	      && window_size / reloc_size < reloc_count)
+	    window_count = std::max(window_size / reloc_size,
+				    static_cast<uint64_t>(1));
+	  prelocs = window.read(this, shdr.get_sh_offset(),
+				window_count * reloc_size);
+	}
       unsigned char* view = (*pviews)[index].view;
       Address address = (*pviews)[index].address;
       section_size_type view_size = (*pviews)[index].view_size;
@@ -1010,9 +1052,21 @@ Sized_relobj_file<size, big_endian>::do_relocate_sections(
 
       if (!parameters->options().relocatable())
 	{
-	  target->relocate_section(&relinfo, sh_type, prelocs, reloc_count, os,
-				   output_offset == invalid_address,
+	  target->relocate_section(&relinfo, sh_type, prelocs, window_count,
+				   os, output_offset == invalid_address,
 				   view, address, view_size, reloc_map);
+	  for (size_t done = window_count;
+	       done < reloc_count;
+	       done += window_count)
+	    {
+	      size_t count = std::min(window_count, reloc_count - done);
+	      prelocs = window.read(this,
+				    shdr.get_sh_offset() + done * reloc_size,
+				    count * reloc_size);
+	      target->relocate_section(&relinfo, sh_type, prelocs, count, os,
+				       output_offset == invalid_address,
+				       view, address, view_size, reloc_map);
+	    }
 	  if (parameters->options().emit_relocs())
 	    {
 	      Relocatable_relocs* rr = this->relocatable_relocs(i);
@@ -1490,6 +1544,29 @@ Merged_symbol_value<size>::value_from_output_section(
     return this->output_start_address_ + output_offset;
 }
 
+// Reloc_window methods.
+
+Reloc_window::~Reloc_window()
+{
+  delete[] this->data_;
+}
+
+// Read SIZE bytes at offset START in OBJECT into the buffer, growing
+// it if needed.
+
+const unsigned char*
+Reloc_window::read(Object* object, off_t start, section_size_type size)
+{
+  if (size > this->capacity_)
+    {
+      delete[] this->data_;
+      this->data_ = new unsigned char[size];
+      this->capacity_ = size;
+    }
+  object->read(start, size, this->data_);
+  return this->data_;
+}
+
 // Track_relocs methods.
 
 // Initialize the class to track the relocs.  This gets the object,
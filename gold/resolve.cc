@@ -23,6 +23,7 @@
 #include "gold.h"
 
 #include "elfcpp.h"
+#include "gold-threads.h"
 #include "target.h"
 #include "object.h"
 #include "symtab.h"
@@ -47,9 +48,9 @@ Symbol::override_version(const char* version)
       // NAME/NULL, and that symbol is overriding this one.  In this
       // case, since NAME/VERSION is the default, we make NAME/NULL
       // override NAME/VERSION as well.  They are already the same
-      // Symbol structure.  Setting the VERSION_ field to NULL ensures
-      // that it will be output with the correct, empty, version.
-      this->version_ = version;
+      // Symbol structure.  Setting the version to NULL ensures that
+      // it will be output with the correct, empty, version.
+      this->set_version(version);
     }
   else
     {
@@ -58,8 +59,8 @@ Symbol::override_version(const char* version)
       // overriding NAME.  If VERSION_ONE and VERSION_TWO are
       // different, then this can only happen when VERSION_ONE is NULL
       // and VERSION_TWO is not hidden.
-      gold_assert(this->version_ == version || this->version_ == NULL);
-      this->version_ = version;
+      gold_assert(this->version() == version || this->version() == NULL);
+      this->set_version(version);
     }
 }
 
@@ -341,6 +342,7 @@ Symbol_table::resolve(Sized_symbol<size>* to,
           = { object, orig_st_shndx, static_cast<off_t>(sym.get_st_value()) };
       Symbol_location toloc = { to->object(), to->shndx(&to_is_ordinary),
 				static_cast<off_t>(to->value()) };
+      Hold_optional_lock hl(this->shared_lock_);
       this->candidate_odr_violations_[to->name()].insert(fromloc);
       this->candidate_odr_violations_[to->name()].insert(toloc);
     }
@@ -943,7 +945,7 @@ Symbol::override_base_with_special(const Symbol* from)
       // one version (from a version script), but we want to define it
       // here with a different version (from a different version
       // script).
-      this->version_ = from->version_;
+      this->set_version(from->version());
     }
   this->type_ = from->type_;
   this->binding_ = from->binding_;
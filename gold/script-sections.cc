@@ -540,6 +540,133 @@ Orphan_section_placement::last_place() const
   return this->places_[PLACE_LAST].location;
 }
 
+// An index of the input section name patterns of a list of linker
+// script elements, used to avoid asking every element whether it
+// matches every input section.  Patterns without wildcards are kept
+// in a trie by their full string, and wildcard patterns are kept in
+// the same trie by the literal characters before the first wildcard.
+// Walking the trie once with a section name finds every element
+// which might match it, by position in the list.  The elements still
+// decide whether they really match, so asking them in order of
+// position gives the same result as asking every element.
+
+class Input_section_pattern_index
+{
+ public:
+  Input_section_pattern_index()
+    : root_(), any_()
+  { }
+
+  // Add a section name PATTERN for the element at position I.
+  // IS_WILDCARD is whether PATTERN has any wildcard characters.
+  void
+  add_pattern(unsigned int i, const std::string& pattern, bool is_wildcard);
+
+  // Record that the element at position I may match any section name.
+  void
+  add_any(unsigned int i)
+  { this->any_.push_back(i); }
+
+  // Set *POSITIONS to the positions of the elements which may match
+  // SECTION_NAME, in order.
+  void
+  find(const char* section_name, std::vector<unsigned int>* positions) const;
+
+ private:
+  Input_section_pattern_index(const Input_section_pattern_index&);
+  Input_section_pattern_index& operator=(const Input_section_pattern_index&);
+
+  // A node in the trie, reached by a string of literal characters.
+  struct Node
+  {
+    Node()
+      : children(), exact(), prefix()
+    { }
+
+    ~Node()
+    {
+      for (size_t i = 0; i < this->children.size(); ++i)
+	delete this->children[i].second;
+    }
+
+    // Return the child for character C, or NULL.
+    Node*
+    child(char c) const
+    {
+      for (size_t i = 0; i < this->children.size(); ++i)
+	if (this->children[i].first == c)
+	  return this->children[i].second;
+      return NULL;
+    }
+
+    // The children of this node.
+    std::vector<std::pair<char, Node*> > children;
+    // The positions of the elements with a pattern without wildcards
+    // which is the string for this node.
+    std::vector<unsigned int> exact;
+    // The positions of the elements with a wildcard pattern whose
+    // literal prefix is the string for this node.
+    std::vector<unsigned int> prefix;
+  };
+
+  // The root of the trie.
+  Node root_;
+  // The positions of the elements which may match any name.
+  std::vector<unsigned int> any_;
+};
+
+void
+Input_section_pattern_index::add_pattern(unsigned int i,
+					 const std::string& pattern,
+					 bool is_wildcard)
+{
+  // fnmatch treats a backslash as quoting the next character, so the
+  // literal prefix of a wildcard pattern stops there too.
+  size_t len = pattern.length();
+  if (is_wildcard)
+    len = pattern.find_first_of("?*[\\");
+
+  Node* n = &this->root_;
+  for (size_t j = 0; j < len; ++j)
+    {
+      Node* c = n->child(pattern[j]);
+      if (c == NULL)
+	{
+	  c = new Node();
+	  n->children.push_back(std::make_pair(pattern[j], c));
+	}
+      n = c;
+    }
+
+  std::vector<unsigned int>* v = is_wildcard ? &n->prefix : &n->exact;
+  if (v->empty() || v->back() != i)
+    v->push_back(i);
+}
+
+void
+Input_section_pattern_index::find(
+    const char* section_name,
+    std::vector<unsigned int>* positions) const
+{
+  positions->assign(this->any_.begin(), this->any_.end());
+  const Node* n = &this->root_;
+  for (const char* p = section_name; n != NULL; ++p)
+    {
+      positions->insert(positions->end(), n->prefix.begin(),
+			n->prefix.end());
+      if (*p == '\0')
+	{
+	  positions->insert(positions->end(), n->exact.begin(),
+			    n->exact.end());
+	  break;
+	}
+      n = n->child(*p);
+    }
+  std::sort(positions->begin(), positions->end());
+  positions->erase(std::unique(positions->begin(), positions->end()),
+		   positions->end());
+}
+
 // An element in a SECTIONS clause.
 
 class Sections_element
@@ -585,6 +712,13 @@ class Sections_element
 		      Script_sections::Section_type*, bool*)
   { return NULL; }
 
+  // Add the input section name patterns of this element to INDEX for
+  // position I.  The only real implementation is in
+  // Output_section_definition.
+  virtual void
+  add_input_section_patterns(Input_section_pattern_index*, unsigned int)
+  { }
+
   // Initialize OSP with an output section.
   virtual void
   orphan_section_init(Orphan_section_placement*,
@@ -803,6 +937,13 @@ class Output_section_element
   match_name(const char*, const char*, bool *) const
   { return false; }
 
+  // Add the section name patterns of this element to INDEX for
+  // position I.  The only real implementation is in
+  // Output_section_element_input.
+  virtual void
+  add_input_section_patterns(Input_section_pattern_index*, unsigned int)
+  { }
+
   // Set section addresses.  This includes applying assignments if the
   // expression is an absolute value.
   virtual void
@@ -1243,6 +1384,11 @@ class Output_section_element_input : public Output_section_element
   bool
   match_name(const char* file_name, const char* section_name, bool* keep) const;
 
+  // Add the section name patterns to INDEX for position I.
+  void
+  add_input_section_patterns(Input_section_pattern_index* index,
+			     unsigned int i);
+
   // Set the section address.
   void
   set_section_addresses(Symbol_table* symtab, Layout* layout, Output_section*,
@@ -1424,6 +1570,23 @@ Output_section_element_input::match_name(const char* file_name,
   return false;
 }
 
+// Add the section name patterns to INDEX.  If there are none, we
+// match any section name.
+
+void
+Output_section_element_input::add_input_section_patterns(
+    Input_section_pattern_index* index,
+    unsigned int i)
+{
+  if (this->input_section_patterns_.empty())
+    index->add_any(i);
+  for (Input_section_patterns::const_iterator p =
+	 this->input_section_patterns_.begin();
+       p != this->input_section_patterns_.end();
+       ++p)
+    index->add_pattern(i, p->pattern, p->pattern_is_wildcard);
+}
+
 // Information we use to sort the input sections.
 
 class Input_section_info
@@ -1868,6 +2031,11 @@ class Output_section_definition : public Sections_element
 		      Output_section***, Script_sections::Section_type*,
 		      bool*);
 
+  // Add the input section name patterns to INDEX for position I.
+  void
+  add_input_section_patterns(Input_section_pattern_index* index,
+			     unsigned int i);
+
   // Initialize OSP with an output section.
   void
   orphan_section_init(Orphan_section_placement* osp,
@@ -1973,6 +2141,9 @@ class Output_section_definition : public Sections_element
   bool is_relro_;
   // The output section type if specified.
   enum Script_section_type script_section_type_;
+  // An index of the input section patterns of elements_, built when
+  // first needed by set_section_addresses.
+  Input_section_pattern_index* pattern_index_;
 };
 
 // Constructor.
@@ -1995,7 +2166,8 @@ Output_section_definition::Output_section_definition(
     evaluated_load_address_(0),
     evaluated_addralign_(0),
     is_relro_(false),
-    script_section_type_(header->section_type)
+    script_section_type_(header->section_type),
+    pattern_index_(NULL)
 {
 }
 
@@ -2074,6 +2246,26 @@ Output_section_definition::add_input_section(const Input_section_spec* spec,
 {
   Output_section_element* p = new Output_section_element_input(spec, keep);
   this->elements_.push_back(p);
+
+  if (this->pattern_index_ != NULL)
+    {
+      delete this->pattern_index_;
+      this->pattern_index_ = NULL;
+    }
+}
+
+// Add the input section name patterns of all the elements to INDEX.
+// A section which matches any of them goes into this output section.
+
+void
+Output_section_definition::add_input_section_patterns(
+    Input_section_pattern_index* index,
+    unsigned int i)
+{
+  for (Output_section_elements::const_iterator p = this->elements_.begin();
+       p != this->elements_.end();
+       ++p)
+    (*p)->add_input_section_patterns(index, i);
 }
 
 // Create any required output sections.  We need an output section if
@@ -2480,13 +2672,64 @@ Output_section_definition::set_section_addresses(Symbol_table* symtab,
       *dot_value = address;
     }
 
+  // Each element takes the input sections that it matches and that
+  // no earlier element took.  Rather than having each element look at
+  // all the remaining input sections, find the element for each input
+  // section here, and give each element just its own sections.
+  std::vector<Input_section_list> element_sections(this->elements_.size());
+  if (!input_sections.empty())
+    {
+      if (this->pattern_index_ == NULL)
+	{
+	  this->pattern_index_ = new Input_section_pattern_index();
+	  for (size_t i = 0; i < this->elements_.size(); ++i)
+	    this->elements_[i]->add_input_section_patterns(this->pattern_index_,
+							   i);
+	}
+
+      std::vector<unsigned int> positions;
+      Input_section_list::iterator p = input_sections.begin();
+      while (p != input_sections.end())
+	{
+	  Relobj* relobj = p->relobj();
+	  std::string section_name;
+	  {
+	    const Task* task = reinterpret_cast<const Task*>(-1);
+	    Task_lock_obj<Object> tl(task, relobj);
+	    section_name = relobj->section_name(p->shndx());
+	  }
+
+	  this->pattern_index_->find(section_name.c_str(), &positions);
+	  std::vector<unsigned int>::const_iterator q;
+	  for (q = positions.begin(); q != positions.end(); ++q)
+	    {
+	      bool keep;
+	      if (this->elements_[*q]->match_name(relobj->name().c_str(),
+						  section_name.c_str(),
+						  &keep))
+		break;
+	    }
+
+	  if (q == positions.end())
+	    ++p;
+	  else
+	    {
+	      Input_section_list* l = &element_sections[*q];
+	      l->splice(l->end(), input_sections, p++);
+	    }
+	}
+    }
+
   Output_section* dot_section = this->output_section_;
-  for (Output_section_elements::iterator p = this->elements_.begin();
-       p != this->elements_.end();
-       ++p)
-    (*p)->set_section_addresses(symtab, layout, this->output_section_,
-				subalign, dot_value, dot_alignment,
-				&dot_section, &fill, &input_sections);
+  for (size_t i = 0; i < this->elements_.size(); ++i)
+    {
+      this->elements_[i]->set_section_addresses(symtab, layout,
+						this->output_section_,
+						subalign, dot_value,
+						dot_alignment, &dot_section,
+						&fill, &element_sections[i]);
+      gold_assert(element_sections[i].empty());
+    }
 
   gold_assert(input_sections.empty());
 
@@ -3174,10 +3417,25 @@ Script_sections::Script_sections()
     data_segment_align_start_(),
     saw_data_segment_align_(false),
     saw_relro_end_(false),
-    saw_segment_start_expression_(false)
+    saw_segment_start_expression_(false),
+    pattern_index_(NULL),
+    pattern_index_elements_()
 {
 }
 
+// Discard the index of the input section patterns, because the
+// patterns have changed.
+
+void
+Script_sections::clear_pattern_index()
+{
+  if (this->pattern_index_ != NULL)
+    {
+      delete this->pattern_index_;
+      this->pattern_index_ = NULL;
+    }
+}
+
 // Start a SECTIONS clause.
 
 void
@@ -3269,6 +3527,7 @@ Script_sections::start_output_section(
 								  namelen,
 								  header);
   this->sections_elements_->push_back(posd);
+  this->clear_pattern_index();
   gold_assert(this->output_section_ == NULL);
   this->output_section_ = posd;
 }
@@ -3309,6 +3568,7 @@ Script_sections::add_input_section(const Input_section_spec* spec, bool keep)
 {
   gold_assert(this->output_section_ != NULL);
   this->output_section_->add_input_section(spec, keep);
+  this->clear_pattern_index();
 }
 
 // This is called when we see DATA_SEGMENT_ALIGN.  It means that any
@@ -3398,13 +3658,34 @@ Script_sections::output_section_name(
     Script_sections::Section_type* psection_type,
     bool* keep)
 {
-  for (Sections_elements::const_iterator p = this->sections_elements_->begin();
-       p != this->sections_elements_->end();
+  // Only ask the elements which have a pattern which may match
+  // SECTION_NAME, in order.  Elements added to the list later are
+  // orphan section markers, which never match.
+  if (this->pattern_index_ == NULL)
+    {
+      this->pattern_index_ = new Input_section_pattern_index();
+      this->pattern_index_elements_.clear();
+      for (Sections_elements::const_iterator p =
+	     this->sections_elements_->begin();
+	   p != this->sections_elements_->end();
+	   ++p)
+	{
+	  unsigned int i = this->pattern_index_elements_.size();
+	  this->pattern_index_elements_.push_back(*p);
+	  (*p)->add_input_section_patterns(this->pattern_index_, i);
+	}
+    }
+
+  std::vector<unsigned int> positions;
+  this->pattern_index_->find(section_name, &positions);
+  for (std::vector<unsigned int>::const_iterator p = positions.begin();
+       p != positions.end();
        ++p)
     {
-      const char* ret = (*p)->output_section_name(file_name, section_name,
-						  output_section_slot,
-						  psection_type, keep);
+      Sections_element* pse = this->pattern_index_elements_[*p];
+      const char* ret = pse->output_section_name(file_name, section_name,
+						 output_section_slot,
+						 psection_type, keep);
 
       if (ret != NULL)
 	{
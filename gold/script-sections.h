@@ -44,6 +44,7 @@ class Output_section_definition;
 class Output_section;
 class Output_segment;
 class Orphan_section_placement;
+class Input_section_pattern_index;
 
 class Script_sections
 {
@@ -296,6 +297,10 @@ class Script_sections
   Output_segment*
   set_phdrs_clause_addresses(Layout*, uint64_t);
 
+  // Discard the index of input section patterns.
+  void
+  clear_pattern_index();
+
   // True if we ever saw a SECTIONS clause.
   bool saw_sections_clause_;
   // True if we are currently processing a SECTIONS clause.
@@ -319,6 +324,12 @@ class Script_sections
   bool saw_relro_end_;
   // Whether we have seen SEGMENT_START.
   bool saw_segment_start_expression_;
+  // An index of the input section patterns of the output section
+  // definitions, built when first needed by output_section_name.
+  Input_section_pattern_index* pattern_index_;
+  // The elements of the SECTIONS clause when the index was built, by
+  // their position in the index.
+  std::vector<Sections_element*> pattern_index_elements_;
 };
 
 // Attributes for memory regions.
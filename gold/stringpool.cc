@@ -28,6 +28,7 @@
 
 #include "output.h"
 #include "parameters.h"
+#include "dynobj.h"
 #include "stringpool.h"
 
 namespace gold
@@ -35,9 +36,10 @@ namespace gold
 
 template<typename Stringpool_char>
 Stringpool_template<Stringpool_char>::Stringpool_template(uint64_t addralign)
-  : string_set_(), key_to_offset_(), strings_(), strtab_size_(0),
-    zero_null_(true), optimize_(false), offset_(sizeof(Stringpool_char)),
-    addralign_(addralign)
+  : string_set_(), key_to_offset_(), strings_(), sort_groups_(),
+    strtab_size_(0),
+    zero_null_(true), optimize_(false), cache_dynamic_hashes_(false),
+    offset_(sizeof(Stringpool_char)), addralign_(addralign)
 {
   if (parameters->options_valid() && parameters->options().optimize() >= 2)
     this->optimize_ = true;
@@ -54,6 +56,7 @@ Stringpool_template<Stringpool_char>::clear()
   this->strings_.clear();
   this->key_to_offset_.clear();
   this->string_set_.clear();
+  this->sort_groups_.clear();
 }
 
 template<typename Stringpool_char>
@@ -162,46 +165,58 @@ Stringpool_template<Stringpool_char>::add_string(const Stringpool_char* s,
   // the null character.
   len = (len + 1) * sizeof(Stringpool_char);
 
-  size_t alc;
-  bool front = true;
-  if (len > buffer_size)
-    {
-      alc = sizeof(Stringdata) + len;
-      front = false;
-    }
-  else if (this->strings_.empty())
-    alc = sizeof(Stringdata) + buffer_size;
+  // The dynamic hash codes, if we store them, go before the string.
+  const size_t prefix = (this->cache_dynamic_hashes_
+			 ? dynamic_hashes_size
+			 : 0);
+  const size_t need = prefix + len;
+
+  Stringdata* psd;
+  if (need <= buffer_size
+      && !this->strings_.empty()
+      && need <= this->strings_.front()->alc - this->strings_.front()->len)
+    psd = this->strings_.front();
   else
     {
-      Stringdata* psd = this->strings_.front();
-      if (len > psd->alc - psd->len)
-	alc = sizeof(Stringdata) + buffer_size;
+      size_t alc = sizeof(Stringdata) + std::max(need, buffer_size);
+      psd = reinterpret_cast<Stringdata*>(new char[alc]);
+      psd->alc = alc - sizeof(Stringdata);
+      psd->len = 0;
+      if (need <= buffer_size)
+	this->strings_.push_front(psd);
       else
-	{
-	  char* ret = psd->data + psd->len;
-	  memcpy(ret, s, len - sizeof(Stringpool_char));
-	  memset(ret + len - sizeof(Stringpool_char), 0,
-		 sizeof(Stringpool_char));
+	this->strings_.push_back(psd);
+    }
 
-	  psd->len += len;
+  char* ret = psd->data + psd->len + prefix;
+  memcpy(ret, s, len - sizeof(Stringpool_char));
+  memset(ret + len - sizeof(Stringpool_char), 0, sizeof(Stringpool_char));
+  psd->len += need;
 
-	  return reinterpret_cast<const Stringpool_char*>(ret);
-	}
-    }
+  Stringpool_char* str = reinterpret_cast<Stringpool_char*>(ret);
+  if (prefix != 0)
+    set_dynamic_hashes(str);
+  return str;
+}
 
-  Stringdata* psd = reinterpret_cast<Stringdata*>(new char[alc]);
-  psd->alc = alc - sizeof(Stringdata);
-  memcpy(psd->data, s, len - sizeof(Stringpool_char));
-  memset(psd->data + len - sizeof(Stringpool_char), 0,
-	 sizeof(Stringpool_char));
-  psd->len = len;
+// Store the dynamic hash codes of S before it.  The ELF and GNU hash
+// functions are only defined for char strings.
 
-  if (front)
-    this->strings_.push_front(psd);
-  else
-    this->strings_.push_back(psd);
+template<typename Stringpool_char>
+void
+Stringpool_template<Stringpool_char>::set_dynamic_hashes(Stringpool_char*)
+{
+  gold_unreachable();
+}
 
-  return reinterpret_cast<const Stringpool_char*>(psd->data);
+template<>
+void
+Stringpool_template<char>::set_dynamic_hashes(char* s)
+{
+  uint32_t elf_hash = Dynobj::elf_hash(s);
+  uint32_t gnu_hash = Dynobj::gnu_hash(s);
+  memcpy(s - dynamic_hashes_size, &elf_hash, sizeof elf_hash);
+  memcpy(s - dynamic_hashes_size + 4, &gnu_hash, sizeof gnu_hash);
 }
 
 // Add a string to a string pool.
@@ -220,6 +235,11 @@ template<typename Stringpool_char>
 void
 Stringpool_template<Stringpool_char>::new_key_offset(size_t length)
 {
+  // A new string is not in the groups made by partition_for_sort, so
+  // discard them; set_string_offsets will sort all the strings.
+  if (!this->sort_groups_.empty())
+    Sort_groups().swap(this->sort_groups_);
+
   section_offset_type offset;
   if (this->zero_null_ && length == 0)
     offset = 0;
@@ -240,6 +260,19 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
 						      size_t length,
 						      bool copy,
 						      Key* pkey)
+{
+  return this->add_with_hash(s, length, string_hash(s, length), copy, pkey);
+}
+
+// Add a string whose hash code has already been computed.
+
+template<typename Stringpool_char>
+const Stringpool_char*
+Stringpool_template<Stringpool_char>::add_with_hash(const Stringpool_char* s,
+						    size_t length,
+						    size_t hash_code,
+						    bool copy,
+						    Key* pkey)
 {
   typedef std::pair<typename String_set_type::iterator, bool> Insert_type;
 
@@ -248,10 +281,14 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
 
   if (!copy)
     {
+      // We can only store the dynamic hash codes of a string which we
+      // copy.
+      gold_assert(!this->cache_dynamic_hashes_);
+
       // When we don't need to copy the string, we can call insert
       // directly.
 
-      std::pair<Hashkey, Hashval> element(Hashkey(s, length), k);
+      std::pair<Hashkey, Hashval> element(Hashkey(s, length, hash_code), k);
 
       Insert_type ins = this->string_set_.insert(element);
 
@@ -278,7 +315,7 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
   // canonicalize it by copying it into the canonical list. The hash
   // code will only be computed once.
 
-  Hashkey hk(s, length);
+  Hashkey hk(s, length, hash_code);
   typename String_set_type::const_iterator p = this->string_set_.find(hk);
   if (p != this->string_set_.end())
     {
@@ -303,6 +340,34 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
   return hk.string;
 }
 
+// Add a string which is known not to be in the pool, whose hash code
+// has already been computed.  This skips the lookup done by
+// add_with_length.
+
+template<typename Stringpool_char>
+const Stringpool_char*
+Stringpool_template<Stringpool_char>::add_new_with_hash(
+    const Stringpool_char* s,
+    size_t length,
+    size_t hash_code,
+    Key* pkey)
+{
+  // We add 1 so that 0 is always invalid.
+  const Key k = this->key_to_offset_.size() + 1;
+
+  this->new_key_offset(length);
+
+  Hashkey hk(this->add_string(s, length), length, hash_code);
+  std::pair<Hashkey, Hashval> element(hk, k);
+  std::pair<typename String_set_type::iterator, bool> ins =
+    this->string_set_.insert(element);
+  gold_assert(ins.second);
+
+  if (pkey != NULL)
+    *pkey = k;
+  return hk.string;
+}
+
 template<typename Stringpool_char>
 const Stringpool_char*
 Stringpool_template<Stringpool_char>::find(const Stringpool_char* s,
@@ -353,6 +418,25 @@ Stringpool_template<Stringpool_char>::Stringpool_sort_comparison::operator()(
   return len1 > len2;
 }
 
+// Return the rank of a string in the sort done by
+// Stringpool_sort_comparison.  The comparison looks at the last
+// character first, so strings whose last characters compare greater
+// come first, and the empty string comes last.  Characters are
+// compared using Stringpool_char, which may be signed, and large
+// characters share a rank.
+
+template<typename Stringpool_char>
+unsigned int
+Stringpool_template<Stringpool_char>::sort_rank(const Hashkey& hk)
+{
+  if (hk.length == 0)
+    return 384;
+  long c = hk.string[hk.length - 1];
+  if (c > 255)
+    c = 255;
+  return 255 - c;
+}
+
 // Return whether s1 is a suffix of s2.
 
 template<typename Stringpool_char>
@@ -402,12 +486,28 @@ Stringpool_template<Stringpool_char>::set_string_offsets()
       std::vector<Stringpool_sort_info> v;
       v.reserve(count);
 
-      for (typename String_set_type::iterator p = this->string_set_.begin();
-           p != this->string_set_.end();
-           ++p)
-        v.push_back(Stringpool_sort_info(p));
+      if (!this->sort_groups_.empty())
+	{
+	  // The groups were sorted by sort_group.  Since no two
+	  // strings compare equal, concatenating them gives the same
+	  // order as sorting all the strings at once.
+	  for (typename Sort_groups::iterator p = this->sort_groups_.begin();
+	       p != this->sort_groups_.end();
+	       ++p)
+	    v.insert(v.end(), p->begin(), p->end());
+	  gold_assert(v.size() == count);
+	  Sort_groups().swap(this->sort_groups_);
+	}
+      else
+	{
+	  for (typename String_set_type::iterator p =
+		 this->string_set_.begin();
+	       p != this->string_set_.end();
+	       ++p)
+	    v.push_back(Stringpool_sort_info(p));
 
-      std::sort(v.begin(), v.end(), Stringpool_sort_comparison());
+	  std::sort(v.begin(), v.end(), Stringpool_sort_comparison());
+	}
 
       section_offset_type last_offset = -1;
       for (typename std::vector<Stringpool_sort_info>::iterator last = v.end(),
@@ -439,6 +539,65 @@ Stringpool_template<Stringpool_char>::set_string_offsets()
   this->strtab_size_ = offset;
 }
 
+// Split the sort done by set_string_offsets into groups of strings
+// with adjacent ranks, each holding roughly the same number of
+// strings.
+
+template<typename Stringpool_char>
+unsigned int
+Stringpool_template<Stringpool_char>::partition_for_sort(unsigned int count)
+{
+  gold_assert(this->strtab_size_ == 0 && this->sort_groups_.empty());
+  if (!this->optimize_ || count <= 1 || this->string_set_.empty())
+    return 0;
+
+  const unsigned int rank_count = 385;
+  std::vector<size_t> rank_sizes(rank_count);
+  for (typename String_set_type::const_iterator p = this->string_set_.begin();
+       p != this->string_set_.end();
+       ++p)
+    ++rank_sizes[sort_rank(p->first)];
+
+  // Assign ranks to groups in order.
+  const size_t target = (this->string_set_.size() + count - 1) / count;
+  std::vector<unsigned int> rank_groups(rank_count);
+  unsigned int group = 0;
+  size_t group_size = 0;
+  for (unsigned int i = 0; i < rank_count; ++i)
+    {
+      if (group_size >= target && rank_sizes[i] != 0)
+	{
+	  ++group;
+	  group_size = 0;
+	}
+      rank_groups[i] = group;
+      group_size += rank_sizes[i];
+    }
+
+  std::vector<size_t> group_sizes(group + 1);
+  for (unsigned int i = 0; i < rank_count; ++i)
+    group_sizes[rank_groups[i]] += rank_sizes[i];
+  this->sort_groups_.resize(group + 1);
+  for (unsigned int i = 0; i <= group; ++i)
+    this->sort_groups_[i].reserve(group_sizes[i]);
+  for (typename String_set_type::iterator p = this->string_set_.begin();
+       p != this->string_set_.end();
+       ++p)
+    this->sort_groups_[rank_groups[sort_rank(p->first)]].push_back(
+	Stringpool_sort_info(p));
+
+  return this->sort_groups_.size();
+}
+
+template<typename Stringpool_char>
+void
+Stringpool_template<Stringpool_char>::sort_group(unsigned int i)
+{
+  gold_assert(i < this->sort_groups_.size());
+  std::sort(this->sort_groups_[i].begin(), this->sort_groups_[i].end(),
+	    Stringpool_sort_comparison());
+}
+
 // Get the offset of a string in the ELF strtab.  The string must
 // exist.
 
@@ -212,6 +212,29 @@ class Stringpool_template
   set_optimize()
   { this->optimize_ = true; }
 
+  // Indicate that this string pool should store the ELF and GNU hash
+  // codes of each string when it is added, for use in the dynamic
+  // hash tables.  This must be called before any strings are added,
+  // and all strings must then be copied into the pool.
+  void
+  set_cache_dynamic_hashes()
+  {
+    gold_assert(this->string_set_.empty());
+    this->cache_dynamic_hashes_ = true;
+  }
+
+  // Return the ELF hash code of S, which must be a string in a pool
+  // for which set_cache_dynamic_hashes was called.
+  static uint32_t
+  cached_elf_hash(const Stringpool_char* s)
+  { return get_cached_hash(s, dynamic_hashes_size); }
+
+  // Return the GNU hash code of S, which must be a string in a pool
+  // for which set_cache_dynamic_hashes was called.
+  static uint32_t
+  cached_gnu_hash(const Stringpool_char* s)
+  { return get_cached_hash(s, dynamic_hashes_size - 4); }
+
   // Add the string S to the pool.  This returns a canonical permanent
   // pointer to the string in the pool.  If COPY is true, the string
   // is copied into permanent storage.  If PKEY is not NULL, this sets
@@ -229,6 +252,29 @@ class Stringpool_template
   const Stringpool_char*
   add_with_length(const Stringpool_char* s, size_t len, bool copy, Key* pkey);
 
+  // Add string S of length LEN characters to the pool, given its
+  // HASH_CODE as returned by hash_string.  This is like
+  // add_with_length, but saves computing the hash code when the
+  // caller already has it.
+  const Stringpool_char*
+  add_with_hash(const Stringpool_char* s, size_t len, size_t hash_code,
+		bool copy, Key* pkey);
+
+  // Return the hash code which the pool uses for string S of length
+  // LEN characters.  This may be called from any thread.
+  static size_t
+  hash_string(const Stringpool_char* s, size_t len)
+  { return string_hash(s, len); }
+
+  // Add string S of length LEN characters to the pool, given its
+  // HASH_CODE as returned by hash_string.  The caller guarantees that
+  // the string is not already in the pool.  The string is always
+  // copied, so S need not be null terminated.  If PKEY is not NULL,
+  // this sets *PKEY to the key for the string.
+  const Stringpool_char*
+  add_new_with_hash(const Stringpool_char* s, size_t len, size_t hash_code,
+		    Key* pkey);
+
   // If the string S is present in the pool, return the canonical
   // string pointer.  Otherwise, return NULL.  If PKEY is not NULL,
   // set *PKEY to the key.
@@ -241,6 +287,20 @@ class Stringpool_template
   void
   set_string_offsets();
 
+  // When optimizing, set_string_offsets sorts the strings to find
+  // suffixes.  Split that sort into at most COUNT groups, based on the
+  // last character of each string, which may be sorted independently
+  // by sort_group.  This returns the number of groups, which is zero
+  // if there is nothing to sort.  If a new string is added after this,
+  // the groups are discarded.
+  unsigned int
+  partition_for_sort(unsigned int count);
+
+  // Sort group I as returned by partition_for_sort.  Different groups
+  // may be sorted in parallel.
+  void
+  sort_group(unsigned int i);
+
   // Get the offset of the string S in the string table.  This returns
   // the offset in bytes, not in units of Stringpool_char.  This may
   // only be called after set_string_offsets has been called.
@@ -321,6 +381,23 @@ class Stringpool_template
   const Stringpool_char*
   add_string(const Stringpool_char*, size_t);
 
+  // The number of bytes stored before each string for the dynamic
+  // hash codes: the ELF hash followed by the GNU hash.
+  static const size_t dynamic_hashes_size = 8;
+
+  // Store the dynamic hash codes of the copied string S.
+  static void
+  set_dynamic_hashes(Stringpool_char* s);
+
+  // Return a hash code stored OFFSET bytes before S.
+  static uint32_t
+  get_cached_hash(const Stringpool_char* s, size_t offset)
+  {
+    uint32_t h;
+    memcpy(&h, reinterpret_cast<const char*>(s) - offset, sizeof h);
+    return h;
+  }
+
   // Return whether s1 is a suffix of s2.
   static bool
   is_suffix(const Stringpool_char* s1, size_t len1,
@@ -353,6 +430,10 @@ class Stringpool_template
     Hashkey(const Stringpool_char* s, size_t len)
       : string(s), length(len), hash_code(string_hash(s, len))
     { }
+
+    Hashkey(const Stringpool_char* s, size_t len, size_t hash)
+      : string(s), length(len), hash_code(hash)
+    { }
   };
 
   // Hash function.  This is trivial, since we have already computed
@@ -388,6 +469,16 @@ class Stringpool_template
     operator()(const Stringpool_sort_info&, const Stringpool_sort_info&) const;
   };
 
+  // The strings sorted by Stringpool_sort_comparison, in groups which
+  // are created by partition_for_sort.
+  typedef std::vector<Stringpool_sort_info> Sort_group;
+  typedef std::vector<Sort_group> Sort_groups;
+
+  // Return the rank of a string in the sort; strings with a lower
+  // rank always sort first.
+  static unsigned int
+  sort_rank(const Hashkey&);
+
   // Keys map to offsets via a Chunked_vector.  We only use the
   // offsets if we turn this into an string table section.
   typedef Chunked_vector<section_offset_type> Key_to_offset;
@@ -401,12 +492,16 @@ class Stringpool_template
   Key_to_offset key_to_offset_;
   // List of buffers.
   Stringdata_list strings_;
+  // Strings grouped for sorting by partition_for_sort.
+  Sort_groups sort_groups_;
   // Size of string table.
   section_size_type strtab_size_;
   // Whether to reserve offset 0 to hold the null string.
   bool zero_null_;
   // Whether to optimize the string table.
   bool optimize_;
+  // Whether to store the dynamic hash codes before each string.
+  bool cache_dynamic_hashes_;
   // offset of the next string.
   section_offset_type offset_;
   // The alignment of strings in the stringpool.
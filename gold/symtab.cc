@@ -25,6 +25,7 @@
 #include <cstring>
 #include <stdint.h>
 #include <algorithm>
+#include <new>
 #include <set>
 #include <string>
 #include <utility>
@@ -56,11 +57,10 @@ Symbol::init_fields(const char* name, const char* version,
 		    elfcpp::STV visibility, unsigned char nonvis)
 {
   this->name_ = name;
-  this->version_ = version;
+  this->extra_ = NULL;
+  this->set_version(version);
   this->symtab_index_ = 0;
   this->dynsym_index_ = 0;
-  this->got_offsets_.init();
-  this->plt_offset_ = -1U;
   this->type_ = type;
   this->binding_ = binding;
   this->visibility_ = visibility;
@@ -299,12 +299,12 @@ Sized_symbol<size>::init_undefined(const char* name, const char* version,
 std::string
 Symbol::versioned_name() const
 {
-  gold_assert(this->version_ != NULL);
+  gold_assert(this->version() != NULL);
   std::string ret = this->name_;
   ret.push_back('@');
   if (this->is_def_)
     ret.push_back('@');
-  ret += this->version_;
+  ret += this->version();
   return ret;
 }
 
@@ -531,16 +531,49 @@ Symbol::set_output_section(Output_section* os)
 
 Symbol_table::Symbol_table(unsigned int count,
                            const Version_script_info& version_script)
-  : saw_undefined_(0), offset_(0), table_(count), namepool_(),
-    forwarders_(), commons_(), tls_commons_(), small_commons_(),
-    large_commons_(), forced_locals_(), warnings_(),
+  : offset_(0), shards_(), shard_blocker_(NULL), shared_lock_(NULL),
+    cached_name_hashes_(false), forwarders_(), commons_(), tls_commons_(),
+    small_commons_(), large_commons_(), warnings_(),
+    candidate_odr_violations_(), odr_objects_(), odr_objects_grouped_(false),
     version_script_(version_script), gc_(NULL), icf_(NULL)
 {
-  namepool_.reserve(count);
+  unsigned int shard_count = 1;
+  if (parameters->options_valid()
+      && parameters->options().symbol_table_shards() > 1)
+    shard_count = parameters->options().symbol_table_shards();
+
+  // When building a shared library or exporting all symbols, most of
+  // the names will go into the dynamic hash tables.  Compute their
+  // hash codes as the names are added, while the objects are read,
+  // rather than in one pass when the tables are built.
+  if (parameters->options_valid()
+      && (parameters->options().shared()
+	  || parameters->options().export_dynamic()))
+    this->cached_name_hashes_ = true;
+
+  this->shards_.reserve(shard_count);
+  for (unsigned int i = 0; i < shard_count; ++i)
+    {
+      this->shards_.push_back(new Shard(count / shard_count));
+      if (this->cached_name_hashes_)
+	this->shards_.back()->namepool.set_cache_dynamic_hashes();
+    }
+
+  if (shard_count > 1)
+    {
+      this->shard_blocker_ = new Task_token(true);
+      this->shared_lock_ = new Lock();
+    }
 }
 
 Symbol_table::~Symbol_table()
 {
+  for (Shards::iterator p = this->shards_.begin();
+       p != this->shards_.end();
+       ++p)
+    delete *p;
+  delete this->shard_blocker_;
+  delete this->shared_lock_;
 }
 
 // The symbol table key equality function.  This is called with
@@ -553,6 +586,33 @@ Symbol_table::Symbol_table_eq::operator()(const Symbol_table_key& k1,
   return k1.first == k2.first && k1.second == k2.second;
 }
 
+// Class Symbol_table::Symbol_arena.
+
+Symbol_table::Symbol_arena::~Symbol_arena()
+{
+  for (std::vector<char*>::iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    delete[] *p;
+}
+
+const size_t Symbol_table::Symbol_arena::chunk_size;
+
+// Start a new chunk if there are not BYTES bytes left in the current
+// one.  Any space left in the current chunk is wasted.
+
+void
+Symbol_table::Symbol_arena::reserve(size_t bytes)
+{
+  if (static_cast<size_t>(this->end_ - this->next_) >= bytes)
+    return;
+  size_t len = std::max(bytes, chunk_size);
+  char* chunk = new char[len];
+  this->chunks_.push_back(chunk);
+  this->next_ = chunk;
+  this->end_ = chunk + len;
+}
+
 bool
 Symbol_table::is_section_folded(Object* obj, unsigned int shndx) const
 {
@@ -627,6 +687,19 @@ Symbol_table::gc_mark_symbol(Symbol* sym)
   parameters->target().gc_mark_symbol(this, sym);
 }
 
+// Mark SYM, which is being added to the symbol table, for garbage
+// collection.  If the symbol table is sharded, tasks for other shards
+// may be running, so just record the symbol in its shard.
+
+void
+Symbol_table::gc_mark_added_symbol(Symbol* sym)
+{
+  if (this->shards_.size() == 1)
+    this->gc_mark_symbol(sym);
+  else
+    this->name_shard(sym->name())->gc_symbols.push_back(sym);
+}
+
 // When doing garbage collection, keep symbols that have been seen in
 // dynamic objects.
 inline void 
@@ -634,7 +707,34 @@ Symbol_table::gc_mark_dyn_syms(Symbol* sym)
 {
   if (sym->in_dyn() && sym->source() == Symbol::FROM_OBJECT
       && !sym->object()->is_dynamic())
-    this->gc_mark_symbol(sym);
+    this->gc_mark_added_symbol(sym);
+}
+
+// All the tasks adding symbols to the shards have completed.  Mark
+// the symbols recorded by gc_mark_added_symbol, and forget the shard
+// tokens, which are no longer referenced by any task.
+
+void
+Symbol_table::finish_shards()
+{
+  for (Shards::iterator p = this->shards_.begin();
+       p != this->shards_.end();
+       ++p)
+    {
+      Shard* shard = *p;
+      for (std::vector<Symbol*>::const_iterator ps =
+	     shard->gc_symbols.begin();
+	   ps != shard->gc_symbols.end();
+	   ++ps)
+	this->gc_mark_symbol(*ps);
+      shard->gc_symbols.clear();
+
+      if (shard->last_token != NULL)
+	{
+	  delete shard->last_token;
+	  shard->last_token = NULL;
+	}
+    }
 }
 
 // Make TO a symbol which forwards to FROM.
@@ -644,7 +744,10 @@ Symbol_table::make_forwarder(Symbol* from, Symbol* to)
 {
   gold_assert(from != to);
   gold_assert(!from->is_forwarder() && !to->is_forwarder());
-  this->forwarders_[from] = to;
+  {
+    Hold_optional_lock hl(this->shared_lock_);
+    this->forwarders_[from] = to;
+  }
   from->set_forwarder();
 }
 
@@ -665,26 +768,55 @@ Symbol_table::resolve_forwards(const Symbol* from) const
 Symbol*
 Symbol_table::lookup(const char* name, const char* version) const
 {
+  const Shard* shard = this->name_shard(name);
+
   Stringpool::Key name_key;
-  name = this->namepool_.find(name, &name_key);
+  name = shard->namepool.find(name, &name_key);
   if (name == NULL)
     return NULL;
 
   Stringpool::Key version_key = 0;
   if (version != NULL)
     {
-      version = this->namepool_.find(version, &version_key);
+      version = shard->namepool.find(version, &version_key);
       if (version == NULL)
 	return NULL;
     }
 
   Symbol_table_key key(name_key, version_key);
-  Symbol_table::Symbol_table_type::const_iterator p = this->table_.find(key);
-  if (p == this->table_.end())
+  Symbol_table::Symbol_table_type::const_iterator p = shard->table.find(key);
+  if (p == shard->table.end())
     return NULL;
   return p->second;
 }
 
+// Set *POS to the current end of the list of strong undefined
+// symbols.
+
+void
+Symbol_table::get_undefined_position(Undefined_position* pos) const
+{
+  pos->resize(this->shards_.size());
+  for (size_t i = 0; i < this->shards_.size(); ++i)
+    (*pos)[i] = this->shards_[i]->undefined_symbols.size();
+}
+
+// Append to *SYMS the symbols which have become strong undefined
+// symbols since *POS, and advance *POS.
+
+void
+Symbol_table::get_new_undefined_symbols(Undefined_position* pos,
+					std::vector<Symbol*>* syms) const
+{
+  gold_assert(pos->size() == this->shards_.size());
+  for (size_t i = 0; i < this->shards_.size(); ++i)
+    {
+      const std::vector<Symbol*>& undefs(this->shards_[i]->undefined_symbols);
+      syms->insert(syms->end(), undefs.begin() + (*pos)[i], undefs.end());
+      (*pos)[i] = undefs.size();
+    }
+}
+
 // Resolve a Symbol with another Symbol.  This is only used in the
 // unusual case where there are references to both an unversioned
 // symbol and a symbol with a version, and we then discover that that
@@ -728,7 +860,7 @@ Symbol_table::force_local(Symbol* sym)
       return;
     }
   sym->set_is_forced_local();
-  this->forced_locals_.push_back(sym);
+  this->name_shard(sym->name())->forced_locals.push_back(sym);
 }
 
 // Adjust NAME for wrapping, and update *NAME_KEY if necessary.  This
@@ -756,10 +888,11 @@ Symbol_table::wrap_symbol(const char* name, Stringpool::Key* name_key)
       s += "__wrap_";
       s += name;
 
-      // This will give us both the old and new name in NAMEPOOL_, but
-      // that is OK.  Only the versions we need will wind up in the
-      // real string table in the output file.
-      return this->namepool_.add(s.c_str(), true, name_key);
+      // This will give us both the old and new name in the name
+      // pool, but that is OK.  Only the versions we need will wind
+      // up in the real string table in the output file.
+      return this->name_shard(s.c_str())->namepool.add(s.c_str(), true,
+							name_key);
     }
 
   const char* const real_prefix = "__real_";
@@ -772,7 +905,8 @@ Symbol_table::wrap_symbol(const char* name, Stringpool::Key* name_key)
       if (prefix != '\0')
 	s += prefix;
       s += name + real_prefix_length;
-      return this->namepool_.add(s.c_str(), true, name_key);
+      return this->name_shard(s.c_str())->namepool.add(s.c_str(), true,
+							name_key);
     }
 
   return name;
@@ -855,10 +989,11 @@ Symbol_table::define_default_version(Sized_symbol<size>* sym,
 }
 
 // Add one symbol from OBJECT to the symbol table.  NAME is symbol
-// name and VERSION is the version; both are canonicalized.  DEF is
-// whether this is the default version.  ST_SHNDX is the symbol's
-// section index; IS_ORDINARY is whether this is a normal section
-// rather than a special code.
+// name and VERSION is the version; both are canonicalized in the name
+// pool of SHARD, which is the shard for NAME.  DEF is whether this is
+// the default version.  ST_SHNDX is the symbol's section index;
+// IS_ORDINARY is whether this is a normal section rather than a
+// special code.
 
 // If IS_DEFAULT_VERSION is true, then this is the definition of a
 // default version of a symbol.  That means that any lookup of
@@ -887,6 +1022,7 @@ Symbol_table::define_default_version(Sized_symbol<size>* sym,
 template<int size, bool big_endian>
 Sized_symbol<size>*
 Symbol_table::add_from_object(Object* object,
+			      Shard* shard,
 			      const char* name,
 			      Stringpool::Key name_key,
 			      const char* version,
@@ -922,22 +1058,25 @@ Symbol_table::add_from_object(Object* object,
 	  version = NULL;
 	  version_key = 0;
 	  name = wrap_name;
+	  shard = this->name_shard(name);
 	}
     }
 
+  Symbol_table_type& table(shard->table);
+
   Symbol* const snull = NULL;
   std::pair<typename Symbol_table_type::iterator, bool> ins =
-    this->table_.insert(std::make_pair(std::make_pair(name_key, version_key),
-				       snull));
+    table.insert(std::make_pair(std::make_pair(name_key, version_key),
+				snull));
 
   std::pair<typename Symbol_table_type::iterator, bool> insdefault =
-    std::make_pair(this->table_.end(), false);
+    std::make_pair(table.end(), false);
   if (is_default_version)
     {
       const Stringpool::Key vnull_key = 0;
-      insdefault = this->table_.insert(std::make_pair(std::make_pair(name_key,
-								     vnull_key),
-						      snull));
+      insdefault = table.insert(std::make_pair(std::make_pair(name_key,
+							      vnull_key),
+					       snull));
     }
 
   // ins.first: an iterator, which is a pointer to a pair.
@@ -947,6 +1086,7 @@ Symbol_table::add_from_object(Object* object,
 
   Sized_symbol<size>* ret;
   bool was_undefined;
+  bool was_weak_undefined;
   bool was_common;
   if (!ins.second)
     {
@@ -955,6 +1095,7 @@ Symbol_table::add_from_object(Object* object,
       gold_assert(ret != NULL);
 
       was_undefined = ret->is_undefined();
+      was_weak_undefined = ret->is_weak_undefined();
       was_common = ret->is_common();
 
       this->resolve(ret, sym, st_shndx, is_ordinary, orig_st_shndx, object,
@@ -978,6 +1119,7 @@ Symbol_table::add_from_object(Object* object,
 	  ret = this->get_sized_symbol<size>(insdefault.first->second);
 
 	  was_undefined = ret->is_undefined();
+	  was_weak_undefined = ret->is_weak_undefined();
 	  was_common = ret->is_common();
 
 	  this->resolve(ret, sym, st_shndx, is_ordinary, orig_st_shndx, object,
@@ -989,12 +1131,14 @@ Symbol_table::add_from_object(Object* object,
       else
 	{
 	  was_undefined = false;
+	  was_weak_undefined = false;
 	  was_common = false;
 
 	  Sized_target<size, big_endian>* target =
 	    parameters->sized_target<size, big_endian>();
 	  if (!target->has_make_symbol())
-	    ret = new Sized_symbol<size>();
+	    ret = new(shard->arena.allocate(sizeof(Sized_symbol<size>)))
+	      Sized_symbol<size>();
 	  else
 	    {
 	      ret = target->make_symbol();
@@ -1003,13 +1147,12 @@ Symbol_table::add_from_object(Object* object,
 		  // This means that we don't want a symbol table
 		  // entry after all.
 		  if (!is_default_version)
-		    this->table_.erase(ins.first);
+		    table.erase(ins.first);
 		  else
 		    {
-		      this->table_.erase(insdefault.first);
+		      table.erase(insdefault.first);
 		      // Inserting INSDEFAULT invalidated INS.
-		      this->table_.erase(std::make_pair(name_key,
-							version_key));
+		      table.erase(std::make_pair(name_key, version_key));
 		    }
 		  return NULL;
 		}
@@ -1035,15 +1178,24 @@ Symbol_table::add_from_object(Object* object,
   // archive groups.
   if (!was_undefined && ret->is_undefined())
     {
-      ++this->saw_undefined_;
+      ++shard->saw_undefined;
       if (parameters->options().has_plugins())
 	parameters->options().plugins()->new_undefined_symbol(ret);
     }
 
+  // Record every time a symbol becomes a strong undefined symbol,
+  // including a weak undefined symbol which is now strong, so that
+  // archive groups know which symbols to look for.
+  if ((!was_undefined || was_weak_undefined)
+      && ret->is_undefined()
+      && ret->binding() != elfcpp::STB_WEAK)
+    shard->undefined_symbols.push_back(ret);
+
   // Keep track of common symbols, to speed up common symbol
   // allocation.
   if (!was_common && ret->is_common())
     {
+      Hold_optional_lock hl(this->shared_lock_);
       if (ret->type() == elfcpp::STT_TLS)
 	this->tls_commons_.push_back(ret);
       else if (!is_ordinary
@@ -1081,7 +1233,9 @@ Symbol_table::add_from_relobj(
     const char* sym_names,
     size_t sym_name_size,
     typename Sized_relobj_file<size, big_endian>::Symbols* sympointers,
-    size_t* defined)
+    size_t* defined,
+    const std::vector<unsigned int>* indexes,
+    unsigned int shard_index)
 {
   *defined = 0;
 
@@ -1091,9 +1245,24 @@ Symbol_table::add_from_relobj(
 
   const bool just_symbols = relobj->just_symbols();
 
-  const unsigned char* p = syms;
-  for (size_t i = 0; i < count; ++i, p += sym_size)
+  if (indexes != NULL)
+    count = indexes->size();
+
+  // Allocate the new symbols for this object from one chunk.
+  if (!parameters->target().has_make_symbol())
+    {
+      if (indexes != NULL)
+	this->shards_[shard_index]->arena.reserve(count
+						  * sizeof(Sized_symbol<size>));
+      else if (this->shards_.size() == 1)
+	this->shards_[0]->arena.reserve(count * sizeof(Sized_symbol<size>));
+    }
+
+  for (size_t j = 0; j < count; ++j)
     {
+      const size_t i = indexes == NULL ? j : (*indexes)[j];
+      const unsigned char* p = syms + i * sym_size;
+
       (*sympointers)[i] = NULL;
 
       elfcpp::Sym<size, big_endian> sym(p);
@@ -1136,38 +1305,44 @@ Symbol_table::add_from_relobj(
       // this is the default version.
       const char* ver = strchr(name, '@');
       Stringpool::Key ver_key = 0;
-      int namelen = 0;
+      int namelen = ver != NULL ? ver - name : strlen(name);
       // IS_DEFAULT_VERSION: is the version default?
       // IS_FORCED_LOCAL: is the symbol forced local?
       bool is_default_version = false;
       bool is_forced_local = false;
 
+      // The name and version go in the name pool of the shard for
+      // the unversioned name.
+      Shard* shard;
+      if (indexes != NULL)
+	shard = this->shards_[shard_index];
+      else
+	shard = this->shards_[this->symbol_shard(name, namelen)];
+
       // FIXME: For incremental links, we don't store version information,
       // so we need to ignore version symbols for now.
       if (parameters->incremental_update() && ver != NULL)
 	{
-	  namelen = ver - name;
+	  namelen = strlen(name);
 	  ver = NULL;
 	}
 
       if (ver != NULL)
         {
           // The symbol name is of the form foo@VERSION or foo@@VERSION
-          namelen = ver - name;
           ++ver;
 	  if (*ver == '@')
 	    {
 	      is_default_version = true;
 	      ++ver;
 	    }
-	  ver = this->namepool_.add(ver, true, &ver_key);
+	  ver = shard->namepool.add(ver, true, &ver_key);
         }
       // We don't want to assign a version to an undefined symbol,
       // even if it is listed in the version script.  FIXME: What
       // about a common symbol?
       else
 	{
-	  namelen = strlen(name);
 	  if (!this->version_script_.empty()
 	      && st_shndx != elfcpp::SHN_UNDEF)
 	    {
@@ -1182,7 +1357,7 @@ Symbol_table::add_from_relobj(
 		    is_forced_local = true;
 		  else if (!version.empty())
 		    {
-		      ver = this->namepool_.add_with_length(version.c_str(),
+		      ver = shard->namepool.add_with_length(version.c_str(),
 							    version.length(),
 							    true,
 							    &ver_key);
@@ -1239,11 +1414,11 @@ Symbol_table::add_from_relobj(
         }
 
       Stringpool::Key name_key;
-      name = this->namepool_.add_with_length(name, namelen, true,
+      name = shard->namepool.add_with_length(name, namelen, true,
 					     &name_key);
 
       Sized_symbol<size>* res;
-      res = this->add_from_object(relobj, name, name_key, ver, ver_key,
+      res = this->add_from_object(relobj, shard, name, name_key, ver, ver_key,
 				  is_default_version, *psym, st_shndx,
 				  is_ordinary, orig_st_shndx);
       
@@ -1259,7 +1434,7 @@ Symbol_table::add_from_relobj(
 	  && !res->is_from_dynobj()
           && (parameters->options().shared()
 	      || parameters->options().export_dynamic()))
-        this->gc_mark_symbol(res);
+        this->gc_mark_added_symbol(res);
 
       if (is_defined_in_discarded_section)
 	res->set_is_defined_in_discarded_section();
@@ -1281,13 +1456,15 @@ Symbol_table::add_from_pluginobj(
   unsigned int st_shndx = sym->get_st_shndx();
   bool is_ordinary = st_shndx < elfcpp::SHN_LORESERVE;
 
+  Shard* shard = this->name_shard(name);
+
   Stringpool::Key ver_key = 0;
   bool is_default_version = false;
   bool is_forced_local = false;
 
   if (ver != NULL)
     {
-      ver = this->namepool_.add(ver, true, &ver_key);
+      ver = shard->namepool.add(ver, true, &ver_key);
     }
   // We don't want to assign a version to an undefined symbol,
   // even if it is listed in the version script.  FIXME: What
@@ -1308,7 +1485,7 @@ Symbol_table::add_from_pluginobj(
 		is_forced_local = true;
 	      else if (!version.empty())
                 {
-                  ver = this->namepool_.add_with_length(version.c_str(),
+                  ver = shard->namepool.add_with_length(version.c_str(),
                                                         version.length(),
                                                         true,
                                                         &ver_key);
@@ -1319,10 +1496,10 @@ Symbol_table::add_from_pluginobj(
     }
 
   Stringpool::Key name_key;
-  name = this->namepool_.add(name, true, &name_key);
+  name = shard->namepool.add(name, true, &name_key);
 
   Sized_symbol<size>* res;
-  res = this->add_from_object(obj, name, name_key, ver, ver_key,
+  res = this->add_from_object(obj, shard, name, name_key, ver, ver_key,
 		              is_default_version, *sym, st_shndx,
 			      is_ordinary, st_shndx);
 
@@ -1381,6 +1558,9 @@ Symbol_table::add_from_dynobj(
   // strong definition, if any, is to search the symbol table.
   std::vector<Sized_symbol<size>*> object_symbols;
 
+  if (this->shards_.size() == 1 && !parameters->target().has_make_symbol())
+    this->shards_[0]->arena.reserve(count * sizeof(Sized_symbol<size>));
+
   const unsigned char* p = syms;
   const unsigned char* vs = versym;
   for (size_t i = 0; i < count; ++i, p += sym_size, vs += 2)
@@ -1428,13 +1608,14 @@ Symbol_table::add_from_dynobj(
       if (st_shndx != elfcpp::SHN_UNDEF)
 	++*defined;
 
+      Shard* shard = this->name_shard(name);
       Sized_symbol<size>* res;
 
       if (versym == NULL)
 	{
 	  Stringpool::Key name_key;
-	  name = this->namepool_.add(name, true, &name_key);
-	  res = this->add_from_object(dynobj, name, name_key, NULL, 0,
+	  name = shard->namepool.add(name, true, &name_key);
+	  res = this->add_from_object(dynobj, shard, name, name_key, NULL, 0,
 				      false, *psym, st_shndx, is_ordinary,
 				      st_shndx);
 	}
@@ -1463,15 +1644,15 @@ Symbol_table::add_from_dynobj(
 
 	  // At this point we are definitely going to add this symbol.
 	  Stringpool::Key name_key;
-	  name = this->namepool_.add(name, true, &name_key);
+	  name = shard->namepool.add(name, true, &name_key);
 
 	  if (v == static_cast<unsigned int>(elfcpp::VER_NDX_LOCAL)
 	      || v == static_cast<unsigned int>(elfcpp::VER_NDX_GLOBAL))
 	    {
 	      // This symbol does not have a version.
-	      res = this->add_from_object(dynobj, name, name_key, NULL, 0,
-					  false, *psym, st_shndx, is_ordinary,
-					  st_shndx);
+	      res = this->add_from_object(dynobj, shard, name, name_key,
+					  NULL, 0, false, *psym, st_shndx,
+					  is_ordinary, st_shndx);
 	    }
 	  else
 	    {
@@ -1491,7 +1672,7 @@ Symbol_table::add_from_dynobj(
 		}
 
 	      Stringpool::Key version_key;
-	      version = this->namepool_.add(version, true, &version_key);
+	      version = shard->namepool.add(version, true, &version_key);
 
 	      // If this is an absolute symbol, and the version name
 	      // and symbol name are the same, then this is the
@@ -1501,15 +1682,16 @@ Symbol_table::add_from_dynobj(
 	      if (st_shndx == elfcpp::SHN_ABS
 		  && !is_ordinary
 		  && name_key == version_key)
-		res = this->add_from_object(dynobj, name, name_key, NULL, 0,
-					    false, *psym, st_shndx, is_ordinary,
-					    st_shndx);
+		res = this->add_from_object(dynobj, shard, name, name_key,
+					    NULL, 0, false, *psym, st_shndx,
+					    is_ordinary, st_shndx);
 	      else
 		{
 		  const bool is_default_version =
 		    !hidden && st_shndx != elfcpp::SHN_UNDEF;
-		  res = this->add_from_object(dynobj, name, name_key, version,
-					      version_key, is_default_version,
+		  res = this->add_from_object(dynobj, shard, name, name_key,
+					      version, version_key,
+					      is_default_version,
 					      *psym, st_shndx,
 					      is_ordinary, st_shndx);
 		}
@@ -1539,6 +1721,8 @@ Sized_symbol<size>*
 Symbol_table::add_from_incrobj(
     Object* obj,
     const char* name,
+    size_t name_len,
+    size_t name_hash,
     const char* ver,
     elfcpp::Sym<size, big_endian>* sym)
 {
@@ -1549,11 +1733,13 @@ Symbol_table::add_from_incrobj(
   bool is_default_version = false;
   bool is_forced_local = false;
 
+  Shard* shard = this->shards_[this->hash_shard(name_hash)];
   Stringpool::Key name_key;
-  name = this->namepool_.add(name, true, &name_key);
+  name = shard->namepool.add_with_hash(name, name_len, name_hash, true,
+				       &name_key);
 
   Sized_symbol<size>* res;
-  res = this->add_from_object(obj, name, name_key, ver, ver_key,
+  res = this->add_from_object(obj, shard, name, name_key, ver, ver_key,
 		              is_default_version, *sym, st_shndx,
 			      is_ordinary, st_shndx);
 
@@ -1687,10 +1873,13 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
   Symbol* oldsym;
   Sized_symbol<size>* sym;
 
+  Shard* shard = this->name_shard(*pname);
+  Symbol_table_type& table(shard->table);
+
   bool add_to_table = false;
-  typename Symbol_table_type::iterator add_loc = this->table_.end();
+  typename Symbol_table_type::iterator add_loc = table.end();
   bool add_def_to_table = false;
-  typename Symbol_table_type::iterator add_def_loc = this->table_.end();
+  typename Symbol_table_type::iterator add_def_loc = table.end();
 
   if (only_if_ref)
     {
@@ -1702,7 +1891,7 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
 
       *pname = oldsym->name();
       if (is_default_version)
-	*pversion = this->namepool_.add(*pversion, true, NULL);
+	*pversion = shard->namepool.add(*pversion, true, NULL);
       else
 	*pversion = oldsym->version();
     }
@@ -1710,27 +1899,25 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
     {
       // Canonicalize NAME and VERSION.
       Stringpool::Key name_key;
-      *pname = this->namepool_.add(*pname, true, &name_key);
+      *pname = shard->namepool.add(*pname, true, &name_key);
 
       Stringpool::Key version_key = 0;
       if (*pversion != NULL)
-	*pversion = this->namepool_.add(*pversion, true, &version_key);
+	*pversion = shard->namepool.add(*pversion, true, &version_key);
 
       Symbol* const snull = NULL;
       std::pair<typename Symbol_table_type::iterator, bool> ins =
-	this->table_.insert(std::make_pair(std::make_pair(name_key,
-							  version_key),
-					   snull));
+	table.insert(std::make_pair(std::make_pair(name_key, version_key),
+				    snull));
 
       std::pair<typename Symbol_table_type::iterator, bool> insdefault =
-	std::make_pair(this->table_.end(), false);
+	std::make_pair(table.end(), false);
       if (is_default_version)
 	{
 	  const Stringpool::Key vnull = 0;
-	  insdefault =
-	    this->table_.insert(std::make_pair(std::make_pair(name_key,
-							      vnull),
-					       snull));
+	  insdefault = table.insert(std::make_pair(std::make_pair(name_key,
+								  vnull),
+						   snull));
 	}
 
       if (!ins.second)
@@ -2354,7 +2541,9 @@ Symbol_table::add_undefined_symbol_from_command_line(const char* name)
 
   sym->init_undefined(name, version, elfcpp::STT_NOTYPE, elfcpp::STB_GLOBAL,
 		      elfcpp::STV_DEFAULT, 0);
-  ++this->saw_undefined_;
+  Shard* shard = this->name_shard(name);
+  ++shard->saw_undefined;
+  shard->undefined_symbols.push_back(sym);
 }
 
 // Set the dynamic symbol indexes.  INDEX is the index of the first
@@ -2370,45 +2559,51 @@ Symbol_table::set_dynsym_indexes(unsigned int index,
 {
   std::vector<Symbol*> as_needed_sym;
 
-  for (Symbol_table_type::iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  for (Shards::iterator ps = this->shards_.begin();
+       ps != this->shards_.end();
+       ++ps)
     {
-      Symbol* sym = p->second;
+      Symbol_table_type& table((*ps)->table);
+      for (Symbol_table_type::iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Symbol* sym = p->second;
 
-      // Note that SYM may already have a dynamic symbol index, since
-      // some symbols appear more than once in the symbol table, with
-      // and without a version.
+	  // Note that SYM may already have a dynamic symbol index, since
+	  // some symbols appear more than once in the symbol table, with
+	  // and without a version.
 
-      if (!sym->should_add_dynsym_entry(this))
-	sym->set_dynsym_index(-1U);
-      else if (!sym->has_dynsym_index())
-	{
-	  sym->set_dynsym_index(index);
-	  ++index;
-	  syms->push_back(sym);
-	  dynpool->add(sym->name(), false, NULL);
-
-	  // If the symbol is defined in a dynamic object and is
-	  // referenced strongly in a regular object, then mark the
-	  // dynamic object as needed.  This is used to implement
-	  // --as-needed.
-	  if (sym->is_from_dynobj()
-	      && sym->in_reg()
-	      && !sym->is_undef_binding_weak())
-	    sym->object()->set_is_needed();
-
-	  // Record any version information, except those from
-	  // as-needed libraries not seen to be needed.  Note that the
-	  // is_needed state for such libraries can change in this loop.
-	  if (sym->version() != NULL)
+	  if (!sym->should_add_dynsym_entry(this))
+	    sym->set_dynsym_index(-1U);
+	  else if (!sym->has_dynsym_index())
 	    {
-	      if (!sym->is_from_dynobj()
-		  || !sym->object()->as_needed()
-		  || sym->object()->is_needed())
-		versions->record_version(this, dynpool, sym);
-	      else
-		as_needed_sym.push_back(sym);
+	      sym->set_dynsym_index(index);
+	      ++index;
+	      syms->push_back(sym);
+	      dynpool->add(sym->name(), false, NULL);
+
+	      // If the symbol is defined in a dynamic object and is
+	      // referenced strongly in a regular object, then mark the
+	      // dynamic object as needed.  This is used to implement
+	      // --as-needed.
+	      if (sym->is_from_dynobj()
+		  && sym->in_reg()
+		  && !sym->is_undef_binding_weak())
+		sym->object()->set_is_needed();
+
+	      // Record any version information, except those from
+	      // as-needed libraries not seen to be needed.  Note that the
+	      // is_needed state for such libraries can change in this loop.
+	      if (sym->version() != NULL)
+		{
+		  if (!sym->is_from_dynobj()
+		      || !sym->object()->as_needed()
+		      || sym->object()->is_needed())
+		    versions->record_version(this, dynpool, sym);
+		  else
+		    as_needed_sym.push_back(sym);
+		}
 	    }
 	}
     }
@@ -2512,27 +2707,39 @@ Symbol_table::sized_finalize(off_t off, Stringpool* pool,
 
   // First do all the symbols which have been forced to be local, as
   // they must appear before all global symbols.
-  for (Forced_locals::iterator p = this->forced_locals_.begin();
-       p != this->forced_locals_.end();
-       ++p)
-    {
-      Symbol* sym = *p;
-      gold_assert(sym->is_forced_local());
-      if (this->sized_finalize_symbol<size>(sym))
+  for (Shards::iterator ps = this->shards_.begin();
+       ps != this->shards_.end();
+       ++ps)
+    {
+      Forced_locals& forced_locals((*ps)->forced_locals);
+      for (Forced_locals::iterator p = forced_locals.begin();
+	   p != forced_locals.end();
+	   ++p)
 	{
-	  this->add_to_final_symtab<size>(sym, pool, &index, &off);
-	  ++*plocal_symcount;
+	  Symbol* sym = *p;
+	  gold_assert(sym->is_forced_local());
+	  if (this->sized_finalize_symbol<size>(sym))
+	    {
+	      this->add_to_final_symtab<size>(sym, pool, &index, &off);
+	      ++*plocal_symcount;
+	    }
 	}
     }
 
   // Now do all the remaining symbols.
-  for (Symbol_table_type::iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
-    {
-      Symbol* sym = p->second;
-      if (this->sized_finalize_symbol<size>(sym))
-	this->add_to_final_symtab<size>(sym, pool, &index, &off);
+  for (Shards::iterator ps = this->shards_.begin();
+       ps != this->shards_.end();
+       ++ps)
+    {
+      Symbol_table_type& table((*ps)->table);
+      for (Symbol_table_type::iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Symbol* sym = p->second;
+	  if (this->sized_finalize_symbol<size>(sym))
+	    this->add_to_final_symtab<size>(sym, pool, &index, &off);
+	}
     }
 
   this->output_count_ = index - orig_index;
@@ -2834,164 +3041,173 @@ Symbol_table::sized_write_globals(const Stringpool* sympool,
   else
     dynamic_view = of->get_output_view(this->dynamic_offset_, dynamic_size);
 
-  for (Symbol_table_type::const_iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  for (Shards::const_iterator ps = this->shards_.begin();
+       ps != this->shards_.end();
+       ++ps)
     {
-      Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
-
-      // Possibly warn about unresolved symbols in shared libraries.
-      this->warn_about_undefined_dynobj_symbol(sym);
+      const Symbol_table_type& table((*ps)->table);
+      for (Symbol_table_type::const_iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Sized_symbol<size>* sym =
+	    static_cast<Sized_symbol<size>*>(p->second);
 
-      unsigned int sym_index = sym->symtab_index();
-      unsigned int dynsym_index;
-      if (dynamic_view == NULL)
-	dynsym_index = -1U;
-      else
-	dynsym_index = sym->dynsym_index();
+	  // Possibly warn about unresolved symbols in shared libraries.
+	  this->warn_about_undefined_dynobj_symbol(sym);
 
-      if (sym_index == -1U && dynsym_index == -1U)
-	{
-	  // This symbol is not included in the output file.
-	  continue;
-	}
+	  unsigned int sym_index = sym->symtab_index();
+	  unsigned int dynsym_index;
+	  if (dynamic_view == NULL)
+	    dynsym_index = -1U;
+	  else
+	    dynsym_index = sym->dynsym_index();
 
-      unsigned int shndx;
-      typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
-      typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
-      elfcpp::STB binding = sym->binding();
+	  if (sym_index == -1U && dynsym_index == -1U)
+	    {
+	      // This symbol is not included in the output file.
+	      continue;
+	    }
 
-      // If --no-gnu-unique is set, change STB_GNU_UNIQUE to STB_GLOBAL.
-      if (binding == elfcpp::STB_GNU_UNIQUE
-	  && !parameters->options().gnu_unique())
-	binding = elfcpp::STB_GLOBAL;
+	  unsigned int shndx;
+	  typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
+	  typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
+	  elfcpp::STB binding = sym->binding();
 
-      switch (sym->source())
-	{
-	case Symbol::FROM_OBJECT:
-	  {
-	    bool is_ordinary;
-	    unsigned int in_shndx = sym->shndx(&is_ordinary);
+	  // If --no-gnu-unique is set, change STB_GNU_UNIQUE to STB_GLOBAL.
+	  if (binding == elfcpp::STB_GNU_UNIQUE
+	      && !parameters->options().gnu_unique())
+	    binding = elfcpp::STB_GLOBAL;
 
-	    if (!is_ordinary
-		&& in_shndx != elfcpp::SHN_ABS
-		&& !Symbol::is_common_shndx(in_shndx))
-	      {
-		gold_error(_("%s: unsupported symbol section 0x%x"),
-			   sym->demangled_name().c_str(), in_shndx);
-		shndx = in_shndx;
-	      }
-	    else
+	  switch (sym->source())
+	    {
+	    case Symbol::FROM_OBJECT:
 	      {
-		Object* symobj = sym->object();
-		if (symobj->is_dynamic())
+		bool is_ordinary;
+		unsigned int in_shndx = sym->shndx(&is_ordinary);
+
+		if (!is_ordinary
+		    && in_shndx != elfcpp::SHN_ABS
+		    && !Symbol::is_common_shndx(in_shndx))
 		  {
-		    if (sym->needs_dynsym_value())
-		      dynsym_value = target.dynsym_value(sym);
-		    shndx = elfcpp::SHN_UNDEF;
-		    if (sym->is_undef_binding_weak())
-		      binding = elfcpp::STB_WEAK;
-		    else
-		      binding = elfcpp::STB_GLOBAL;
+		    gold_error(_("%s: unsupported symbol section 0x%x"),
+			       sym->demangled_name().c_str(), in_shndx);
+		    shndx = in_shndx;
 		  }
-		else if (symobj->pluginobj() != NULL)
-		  shndx = elfcpp::SHN_UNDEF;
-		else if (in_shndx == elfcpp::SHN_UNDEF
-			 || (!is_ordinary
-			     && (in_shndx == elfcpp::SHN_ABS
-				 || Symbol::is_common_shndx(in_shndx))))
-		  shndx = in_shndx;
 		else
 		  {
-		    Relobj* relobj = static_cast<Relobj*>(symobj);
-		    Output_section* os = relobj->output_section(in_shndx);
-                    if (this->is_section_folded(relobj, in_shndx))
-                      {
-                        // This global symbol must be written out even though
-                        // it is folded.
-                        // Get the os of the section it is folded onto.
-                        Section_id folded =
-                             this->icf_->get_folded_section(relobj, in_shndx);
-                        gold_assert(folded.first !=NULL);
-                        Relobj* folded_obj = 
-                          reinterpret_cast<Relobj*>(folded.first);
-                        os = folded_obj->output_section(folded.second);  
-                        gold_assert(os != NULL);
-                      }
-		    gold_assert(os != NULL);
-		    shndx = os->out_shndx();
-
-		    if (shndx >= elfcpp::SHN_LORESERVE)
+		    Object* symobj = sym->object();
+		    if (symobj->is_dynamic())
 		      {
-			if (sym_index != -1U)
-			  symtab_xindex->add(sym_index, shndx);
-			if (dynsym_index != -1U)
-			  dynsym_xindex->add(dynsym_index, shndx);
-			shndx = elfcpp::SHN_XINDEX;
+			if (sym->needs_dynsym_value())
+			  dynsym_value = target.dynsym_value(sym);
+			shndx = elfcpp::SHN_UNDEF;
+			if (sym->is_undef_binding_weak())
+			  binding = elfcpp::STB_WEAK;
+			else
+			  binding = elfcpp::STB_GLOBAL;
+		      }
+		    else if (symobj->pluginobj() != NULL)
+		      shndx = elfcpp::SHN_UNDEF;
+		    else if (in_shndx == elfcpp::SHN_UNDEF
+			     || (!is_ordinary
+				 && (in_shndx == elfcpp::SHN_ABS
+				     || Symbol::is_common_shndx(in_shndx))))
+		      shndx = in_shndx;
+		    else
+		      {
+			Relobj* relobj = static_cast<Relobj*>(symobj);
+			Output_section* os = relobj->output_section(in_shndx);
+			if (this->is_section_folded(relobj, in_shndx))
+			  {
+			    // This global symbol must be written out even
+			    // though it is folded.
+			    // Get the os of the section it is folded onto.
+			    Section_id folded =
+			      this->icf_->get_folded_section(relobj,
+							     in_shndx);
+			    gold_assert(folded.first !=NULL);
+			    Relobj* folded_obj = 
+			      reinterpret_cast<Relobj*>(folded.first);
+			    os = folded_obj->output_section(folded.second);  
+			    gold_assert(os != NULL);
+			  }
+			gold_assert(os != NULL);
+			shndx = os->out_shndx();
+
+			if (shndx >= elfcpp::SHN_LORESERVE)
+			  {
+			    if (sym_index != -1U)
+			      symtab_xindex->add(sym_index, shndx);
+			    if (dynsym_index != -1U)
+			      dynsym_xindex->add(dynsym_index, shndx);
+			    shndx = elfcpp::SHN_XINDEX;
+			  }
+
+			// In object files symbol values are section
+			// relative.
+			if (parameters->options().relocatable())
+			  sym_value -= os->address();
 		      }
-
-		    // In object files symbol values are section
-		    // relative.
-		    if (parameters->options().relocatable())
-		      sym_value -= os->address();
 		  }
 	      }
-	  }
-	  break;
+	      break;
 
-	case Symbol::IN_OUTPUT_DATA:
-	  {
-	    Output_data* od = sym->output_data();
-
-	    shndx = od->out_shndx();
-	    if (shndx >= elfcpp::SHN_LORESERVE)
+	    case Symbol::IN_OUTPUT_DATA:
 	      {
-		if (sym_index != -1U)
-		  symtab_xindex->add(sym_index, shndx);
-		if (dynsym_index != -1U)
-		  dynsym_xindex->add(dynsym_index, shndx);
-		shndx = elfcpp::SHN_XINDEX;
-	      }
+		Output_data* od = sym->output_data();
 
-	    // In object files symbol values are section
-	    // relative.
-	    if (parameters->options().relocatable())
-	      sym_value -= od->address();
-	  }
-	  break;
+		shndx = od->out_shndx();
+		if (shndx >= elfcpp::SHN_LORESERVE)
+		  {
+		    if (sym_index != -1U)
+		      symtab_xindex->add(sym_index, shndx);
+		    if (dynsym_index != -1U)
+		      dynsym_xindex->add(dynsym_index, shndx);
+		    shndx = elfcpp::SHN_XINDEX;
+		  }
 
-	case Symbol::IN_OUTPUT_SEGMENT:
-	  shndx = elfcpp::SHN_ABS;
-	  break;
+		// In object files symbol values are section
+		// relative.
+		if (parameters->options().relocatable())
+		  sym_value -= od->address();
+	      }
+	      break;
 
-	case Symbol::IS_CONSTANT:
-	  shndx = elfcpp::SHN_ABS;
-	  break;
+	    case Symbol::IN_OUTPUT_SEGMENT:
+	      shndx = elfcpp::SHN_ABS;
+	      break;
 
-	case Symbol::IS_UNDEFINED:
-	  shndx = elfcpp::SHN_UNDEF;
-	  break;
+	    case Symbol::IS_CONSTANT:
+	      shndx = elfcpp::SHN_ABS;
+	      break;
 
-	default:
-	  gold_unreachable();
-	}
+	    case Symbol::IS_UNDEFINED:
+	      shndx = elfcpp::SHN_UNDEF;
+	      break;
 
-      if (sym_index != -1U)
-	{
-	  sym_index -= first_global_index;
-	  gold_assert(sym_index < output_count);
-	  unsigned char* ps = psyms + (sym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
-						     binding, sympool, ps);
-	}
+	    default:
+	      gold_unreachable();
+	    }
 
-      if (dynsym_index != -1U)
-	{
-	  dynsym_index -= first_dynamic_global_index;
-	  gold_assert(dynsym_index < dynamic_count);
-	  unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, dynsym_value, shndx,
-						     binding, dynpool, pd);
+	  if (sym_index != -1U)
+	    {
+	      sym_index -= first_global_index;
+	      gold_assert(sym_index < output_count);
+	      unsigned char* ps = psyms + (sym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
+							 binding, sympool, ps);
+	    }
+
+	  if (dynsym_index != -1U)
+	    {
+	      dynsym_index -= first_dynamic_global_index;
+	      gold_assert(dynsym_index < dynamic_count);
+	      unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, dynsym_value,
+							 shndx, binding,
+							 dynpool, pd);
+	    }
 	}
     }
 
@@ -3150,14 +3366,56 @@ Symbol_table::sized_write_section_symbol(const Output_section* os,
 void
 Symbol_table::print_stats() const
 {
+  size_t arena_bytes = 0;
+  size_t arena_chunks = 0;
+  for (Shards::const_iterator p = this->shards_.begin();
+       p != this->shards_.end();
+       ++p)
+    {
+      arena_bytes += (*p)->arena.allocated();
+      arena_chunks += (*p)->arena.chunk_count();
+    }
+  fprintf(stderr, _("%s: symbol arena: %zu bytes in %zu chunks\n"),
+	  program_name, arena_bytes, arena_chunks);
+
+  if (this->shards_.size() == 1)
+    {
+      const Shard* shard = this->shards_[0];
 #if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
-  fprintf(stderr, _("%s: symbol table entries: %zu; buckets: %zu\n"),
-	  program_name, this->table_.size(), this->table_.bucket_count());
+      fprintf(stderr, _("%s: symbol table entries: %zu; buckets: %zu\n"),
+	      program_name, shard->table.size(), shard->table.bucket_count());
 #else
-  fprintf(stderr, _("%s: symbol table entries: %zu\n"),
-	  program_name, this->table_.size());
+      fprintf(stderr, _("%s: symbol table entries: %zu\n"),
+	      program_name, shard->table.size());
 #endif
-  this->namepool_.print_stats("symbol table stringpool");
+      shard->namepool.print_stats("symbol table stringpool");
+      return;
+    }
+
+  size_t entries = 0;
+  size_t min_entries = this->shards_[0]->table.size();
+  size_t max_entries = 0;
+  size_t tasks = 0;
+  size_t waits = 0;
+  for (Shards::const_iterator p = this->shards_.begin();
+       p != this->shards_.end();
+       ++p)
+    {
+      size_t n = (*p)->table.size();
+      entries += n;
+      min_entries = std::min(min_entries, n);
+      max_entries = std::max(max_entries, n);
+      tasks += (*p)->task_count;
+      waits += (*p)->wait_count;
+    }
+  fprintf(stderr, _("%s: symbol table entries: %zu\n"),
+	  program_name, entries);
+  fprintf(stderr, _("%s: symbol table shards: %zu; "
+		    "entries per shard: %zu min, %zu max\n"),
+	  program_name, this->shards_.size(), min_entries, max_entries);
+  fprintf(stderr, _("%s: symbol table shard tasks: %zu; "
+		    "waited for the same shard: %zu\n"),
+	  program_name, tasks, waits);
 }
 
 // We check for ODR violations by looking for symbols with the same
@@ -3171,7 +3429,7 @@ Symbol_table::print_stats() const
 // in those cases.
 
 // This struct is used to compare line information, as returned by
-// Dwarf_line_info::one_addr2line.  It implements a < comparison
+// Dwarf_line_info::addr2line.  It implements a < comparison
 // operator used with std::sort.
 
 struct Odr_violation_compare
@@ -3195,30 +3453,121 @@ struct Odr_violation_compare
   }
 };
 
-// Returns all of the lines attached to LOC, not just the one the
-// instruction actually came from.
-std::vector<std::string>
-Symbol_table::linenos_from_loc(const Task* task,
-                               const Symbol_location& loc)
-{
-  // We need to lock the object in order to read it.  This
-  // means that we have to run in a singleton Task.  If we
-  // want to run this in a general Task for better
-  // performance, we will need one Task for object, plus
-  // appropriate locking to ensure that we don't conflict with
-  // other uses of the object.  Also note, one_addr2line is not
-  // currently thread-safe.
-  Task_lock_obj<Object> tl(task, loc.object);
-
-  std::vector<std::string> result;
-  Symbol_location code_loc = loc;
-  parameters->target().function_location(&code_loc);
-  // 16 is the size of the object-cache that one_addr2line should use.
-  std::string canonical_result = Dwarf_line_info::one_addr2line(
-      code_loc.object, code_loc.shndx, code_loc.offset, 16, &result);
-  if (!canonical_result.empty())
-    result.push_back(canonical_result);
-  return result;
+// Group the definitions in candidate_odr_violations_ by object.
+
+void
+Symbol_table::group_odr_locations()
+{
+  gold_assert(!this->odr_objects_grouped_);
+  this->odr_objects_grouped_ = true;
+
+  Unordered_map<const Object*, unsigned int> indexes;
+  for (Odr_map::const_iterator it = this->candidate_odr_violations_.begin();
+       it != this->candidate_odr_violations_.end();
+       ++it)
+    {
+      for (Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
+	     p = it->second.begin();
+	   p != it->second.end();
+	   ++p)
+	{
+	  std::pair<Unordered_map<const Object*, unsigned int>::iterator,
+		    bool> ins =
+	    indexes.insert(std::make_pair(p->object,
+					  this->odr_objects_.size()));
+	  if (ins.second)
+	    this->odr_objects_.push_back(Odr_object(p->object));
+	  this->odr_objects_[ins.first->second].locs.push_back(*p);
+	}
+    }
+}
+
+// Find the source lines of the candidate ODR violations defined in
+// object INDEX.  We read the line information of the object once,
+// for all its sections, and then look up each definition.  This is
+// called by an Odr_task, or by detect_odr_violations, with the
+// object locked.
+
+void
+Symbol_table::find_odr_linenos(unsigned int index)
+{
+  Odr_object* odr = &this->odr_objects_[index];
+  Dwarf_line_info* lineinfo = Dwarf_line_info::make_line_info(odr->object,
+							      -1U);
+  odr->linenos.resize(odr->locs.size());
+  for (size_t i = 0; i < odr->locs.size(); ++i)
+    {
+      Symbol_location code_loc = odr->locs[i];
+      parameters->target().function_location(&code_loc);
+      std::vector<std::string>* linenos = &odr->linenos[i];
+      std::string canonical_result = lineinfo->addr2line(code_loc.shndx,
+							 code_loc.offset,
+							 linenos);
+      if (!canonical_result.empty())
+	linenos->push_back(canonical_result);
+      // Sort by Odr_violation_compare to make std::set_intersection work.
+      std::sort(linenos->begin(), linenos->end(), Odr_violation_compare());
+    }
+  delete lineinfo;
+}
+
+// This task finds the source lines of the candidate ODR violations
+// in one object.
+
+class Odr_task : public Task
+{
+ public:
+  Odr_task(Symbol_table* symtab, unsigned int index, Task_token* blocker)
+    : symtab_(symtab), index_(index), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    Object* object = this->symtab_->odr_object(this->index_);
+    return object->is_locked() ? object->token() : NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->blocker_);
+    Task_token* token = this->symtab_->odr_object(this->index_)->token();
+    if (token != NULL)
+      tl->add(this, token);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->symtab_->find_odr_linenos(this->index_);
+    this->symtab_->odr_object(this->index_)->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Odr_task " + this->symtab_->odr_object(this->index_)->name(); }
+
+ private:
+  Symbol_table* symtab_;
+  unsigned int index_;
+  Task_token* blocker_;
+};
+
+// Queue an Odr_task for each object with candidate ODR violations.
+
+void
+Symbol_table::queue_odr_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  if (this->candidate_odr_violations_.empty())
+    return;
+
+  this->group_odr_locations();
+  workqueue->add_blockers(blocker, this->odr_objects_.size());
+  for (unsigned int i = 0; i < this->odr_objects_.size(); ++i)
+    workqueue->queue(new Odr_task(this, i, blocker));
 }
 
 // OutputIterator that records if it was ever assigned to.  This
@@ -3256,8 +3605,32 @@ struct Check_intersection
 
 void
 Symbol_table::detect_odr_violations(const Task* task,
-				    const char* output_file_name) const
+				    const char* output_file_name)
 {
+  if (this->candidate_odr_violations_.empty())
+    return;
+
+  // Without threads, or if queue_odr_tasks was not called, find the
+  // source lines now.
+  if (!this->odr_objects_grouped_)
+    {
+      this->group_odr_locations();
+      for (unsigned int i = 0; i < this->odr_objects_.size(); ++i)
+	{
+	  Task_lock_obj<Object> tl(task, this->odr_objects_[i].object);
+	  this->find_odr_linenos(i);
+	}
+    }
+
+  typedef Unordered_map<Symbol_location, const std::vector<std::string>*,
+			Symbol_location_hash> Linenos_map;
+  Linenos_map linenos_map;
+  for (Odr_objects::const_iterator p = this->odr_objects_.begin();
+       p != this->odr_objects_.end();
+       ++p)
+    for (size_t i = 0; i < p->locs.size(); ++i)
+      linenos_map[p->locs[i]] = &p->linenos[i];
+
   for (Odr_map::const_iterator it = candidate_odr_violations_.begin();
        it != candidate_odr_violations_.end();
        ++it)
@@ -3265,13 +3638,13 @@ Symbol_table::detect_odr_violations(const Task* task,
       const char* const symbol_name = it->first;
 
       std::string first_object_name;
-      std::vector<std::string> first_object_linenos;
+      const std::vector<std::string>* first_object_linenos = NULL;
 
       Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
           locs = it->second.begin();
       const Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
           locs_end = it->second.end();
-      for (; locs != locs_end && first_object_linenos.empty(); ++locs)
+      for (; locs != locs_end; ++locs)
         {
           // Save the line numbers from the first definition to
           // compare to the other definitions.  Ideally, we'd compare
@@ -3280,28 +3653,26 @@ Symbol_table::detect_odr_violations(const Task* task,
           // false negatives that appear or disappear depending on the
           // link order, but it won't cause false positives.
           first_object_name = locs->object->name();
-          first_object_linenos = this->linenos_from_loc(task, *locs);
+          first_object_linenos = linenos_map[*locs];
+          if (!first_object_linenos->empty())
+            {
+              ++locs;
+              break;
+            }
         }
 
-      // Sort by Odr_violation_compare to make std::set_intersection work.
-      std::sort(first_object_linenos.begin(), first_object_linenos.end(),
-                Odr_violation_compare());
-
       for (; locs != locs_end; ++locs)
         {
-          std::vector<std::string> linenos =
-              this->linenos_from_loc(task, *locs);
+          const std::vector<std::string>* linenos = linenos_map[*locs];
           // linenos will be empty if we couldn't parse the debug info.
-          if (linenos.empty())
+          if (linenos->empty())
             continue;
-          // Sort by Odr_violation_compare to make std::set_intersection work.
-          std::sort(linenos.begin(), linenos.end(), Odr_violation_compare());
 
           Check_intersection intersection_result =
-              std::set_intersection(first_object_linenos.begin(),
-                                    first_object_linenos.end(),
-                                    linenos.begin(),
-                                    linenos.end(),
+              std::set_intersection(first_object_linenos->begin(),
+                                    first_object_linenos->end(),
+                                    linenos->begin(),
+                                    linenos->end(),
                                     Check_intersection(),
                                     Odr_violation_compare());
           if (!intersection_result.had_intersection())
@@ -3313,13 +3684,13 @@ Symbol_table::detect_odr_violations(const Task* task,
               // which may not be the location we expect to intersect
               // with another definition.  We could print the whole
               // set of locations, but that seems too verbose.
-              gold_assert(!first_object_linenos.empty());
-              gold_assert(!linenos.empty());
+              gold_assert(!first_object_linenos->empty());
+              gold_assert(!linenos->empty());
               fprintf(stderr, _("  %s from %s\n"),
-                      first_object_linenos[0].c_str(),
+                      (*first_object_linenos)[0].c_str(),
                       first_object_name.c_str());
               fprintf(stderr, _("  %s from %s\n"),
-                      linenos[0].c_str(),
+                      (*linenos)[0].c_str(),
                       locs->object->name().c_str());
               // Only print one broken pair, to avoid needing to
               // compare against a list of the disjoint definition
@@ -3331,8 +3702,6 @@ Symbol_table::detect_odr_violations(const Task* task,
             }
         }
     }
-  // We only call one_addr2line() in this function, so we can clear its cache.
-  Dwarf_line_info::clear_addr2line_cache();
 }
 
 // Warnings functions.
@@ -3340,10 +3709,10 @@ Symbol_table::detect_odr_violations(const Task* task,
 // Add a new warning.
 
 void
-Warnings::add_warning(Symbol_table* symtab, const char* name, Object* obj,
+Warnings::add_warning(const char* name, Object* obj,
 		      const std::string& warning)
 {
-  name = symtab->canonicalize_name(name);
+  name = this->namepool_.add(name, true, NULL);
   this->warnings_[name].set(obj, warning);
 }
 
@@ -3382,7 +3751,9 @@ Warnings::issue_warning(const Symbol* sym,
   if (sym->object() == relinfo->object)
     return;
 
-  Warning_table::const_iterator p = this->warnings_.find(sym->name());
+  const char* name = this->namepool_.find(sym->name(), NULL);
+  gold_assert(name != NULL);
+  Warning_table::const_iterator p = this->warnings_.find(name);
   gold_assert(p != this->warnings_.end());
   gold_warning_at_location(relinfo, relnum, reloffset,
 			   "%s", p->second.text.c_str());
@@ -3415,7 +3786,9 @@ Symbol_table::add_from_relobj<32, false>(
     const char* sym_names,
     size_t sym_name_size,
     Sized_relobj_file<32, false>::Symbols* sympointers,
-    size_t* defined);
+    size_t* defined,
+    const std::vector<unsigned int>* indexes,
+    unsigned int shard_index);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -3429,7 +3802,9 @@ Symbol_table::add_from_relobj<32, true>(
     const char* sym_names,
     size_t sym_name_size,
     Sized_relobj_file<32, true>::Symbols* sympointers,
-    size_t* defined);
+    size_t* defined,
+    const std::vector<unsigned int>* indexes,
+    unsigned int shard_index);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -3443,7 +3818,9 @@ Symbol_table::add_from_relobj<64, false>(
     const char* sym_names,
     size_t sym_name_size,
     Sized_relobj_file<64, false>::Symbols* sympointers,
-    size_t* defined);
+    size_t* defined,
+    const std::vector<unsigned int>* indexes,
+    unsigned int shard_index);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -3457,7 +3834,9 @@ Symbol_table::add_from_relobj<64, true>(
     const char* sym_names,
     size_t sym_name_size,
     Sized_relobj_file<64, true>::Symbols* sympointers,
-    size_t* defined);
+    size_t* defined,
+    const std::vector<unsigned int>* indexes,
+    unsigned int shard_index);
 #endif
 
 #ifdef HAVE_TARGET_32_LITTLE
@@ -3570,6 +3949,8 @@ Sized_symbol<32>*
 Symbol_table::add_from_incrobj(
     Object* obj,
     const char* name,
+    size_t name_len,
+    size_t name_hash,
     const char* ver,
     elfcpp::Sym<32, false>* sym);
 #endif
@@ -3580,6 +3961,8 @@ Sized_symbol<32>*
 Symbol_table::add_from_incrobj(
     Object* obj,
     const char* name,
+    size_t name_len,
+    size_t name_hash,
     const char* ver,
     elfcpp::Sym<32, true>* sym);
 #endif
@@ -3590,6 +3973,8 @@ Sized_symbol<64>*
 Symbol_table::add_from_incrobj(
     Object* obj,
     const char* name,
+    size_t name_len,
+    size_t name_hash,
     const char* ver,
     elfcpp::Sym<64, false>* sym);
 #endif
@@ -3600,6 +3985,8 @@ Sized_symbol<64>*
 Symbol_table::add_from_incrobj(
     Object* obj,
     const char* name,
+    size_t name_len,
+    size_t name_hash,
     const char* ver,
     elfcpp::Sym<64, true>* sym);
 #endif
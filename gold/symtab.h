@@ -60,6 +60,9 @@ class Output_file;
 class Output_symtab_xindex;
 class Garbage_collection;
 class Icf;
+class Task_token;
+class Workqueue;
+class Lock;
 
 // The base class of an entry in the symbol table.  The symbol table
 // can have a lot of entries, so we don't want this class too big.
@@ -119,11 +122,14 @@ class Symbol
   // unversioned symbol.
   const char*
   version() const
-  { return this->version_; }
+  { return this->extra_ == NULL ? NULL : this->extra_->version; }
 
   void
   clear_version()
-  { this->version_ = NULL; }
+  {
+    if (this->extra_ != NULL)
+      this->extra_->version = NULL;
+  }
 
   // Return whether this version is the default for this symbol name
   // (eg, "foo@@V2" is a default version; "foo@V1" is not).  Only
@@ -131,7 +137,7 @@ class Symbol
   bool
   is_default() const
   {
-    gold_assert(this->version_ != NULL);
+    gold_assert(this->version() != NULL);
     return this->is_def_;
   }
 
@@ -403,13 +409,17 @@ class Symbol
   // For a TLS symbol, this GOT entry will hold its tp-relative offset.
   bool
   has_got_offset(unsigned int got_type) const
-  { return this->got_offsets_.get_offset(got_type) != -1U; }
+  {
+    return (this->extra_ != NULL
+	    && this->extra_->got_offsets.get_offset(got_type) != -1U);
+  }
 
   // Return the offset into the GOT section of this symbol.
   unsigned int
   got_offset(unsigned int got_type) const
   {
-    unsigned int got_offset = this->got_offsets_.get_offset(got_type);
+    gold_assert(this->extra_ != NULL);
+    unsigned int got_offset = this->extra_->got_offsets.get_offset(got_type);
     gold_assert(got_offset != -1U);
     return got_offset;
   }
@@ -417,24 +427,28 @@ class Symbol
   // Set the GOT offset of this symbol.
   void
   set_got_offset(unsigned int got_type, unsigned int got_offset)
-  { this->got_offsets_.set_offset(got_type, got_offset); }
+  { this->extra()->got_offsets.set_offset(got_type, got_offset); }
 
   // Return the GOT offset list.
   const Got_offset_list*
   got_offset_list() const
-  { return this->got_offsets_.get_list(); }
+  {
+    if (this->extra_ == NULL)
+      return NULL;
+    return this->extra_->got_offsets.get_list();
+  }
 
   // Return whether this symbol has an entry in the PLT section.
   bool
   has_plt_offset() const
-  { return this->plt_offset_ != -1U; }
+  { return this->extra_ != NULL && this->extra_->plt_offset != -1U; }
 
   // Return the offset into the PLT section of this symbol.
   unsigned int
   plt_offset() const
   {
     gold_assert(this->has_plt_offset());
-    return this->plt_offset_;
+    return this->extra_->plt_offset;
   }
 
   // Set the PLT offset of this symbol.
@@ -442,7 +456,7 @@ class Symbol
   set_plt_offset(unsigned int plt_offset)
   {
     gold_assert(plt_offset != -1U);
-    this->plt_offset_ = plt_offset;
+    this->extra()->plt_offset = plt_offset;
   }
 
   // Return whether this dynamic symbol needs a special value in the
@@ -832,6 +846,12 @@ class Symbol
   Symbol()
   { memset(this, 0, sizeof *this); }
 
+  // Most symbols are allocated from the arena of the symbol table,
+  // and are never destroyed.  This is for the special symbols which
+  // are deleted after all.
+  ~Symbol()
+  { delete this->extra_; }
+
   // Initialize the general fields.
   void
   init_fields(const char* name, const char* version,
@@ -894,15 +914,55 @@ class Symbol
   void
   allocate_base_common(Output_data*);
 
+  // Set the symbol version.
+  void
+  set_version(const char* version)
+  {
+    if (version != NULL || this->extra_ != NULL)
+      this->extra()->version = version;
+  }
+
  private:
   Symbol(const Symbol&);
   Symbol& operator=(const Symbol&);
 
+  // The fields of a symbol which most symbols never set.  These are
+  // kept out of line, and allocated the first time one of them is
+  // set, so that a symbol fits in a cache line.
+  struct Extra
+  {
+    Extra()
+      : version(NULL), plt_offset(-1U), got_offsets()
+    { }
+
+    // Symbol version (expected to point into a Stringpool).  This may
+    // be NULL.
+    const char* version;
+    // If this symbol has an entry in the PLT section, then this is
+    // the offset from the start of the PLT section.  This is -1U if
+    // there is no PLT entry.
+    unsigned int plt_offset;
+    // The GOT section entries for this symbol.  A symbol may have
+    // more than one GOT offset (e.g., when mixing modules compiled
+    // with two different TLS models), but will usually have at most
+    // one.
+    Got_offset_list got_offsets;
+  };
+
+  // Return the out of line fields, allocating them if necessary.
+  Extra*
+  extra()
+  {
+    if (this->extra_ == NULL)
+      this->extra_ = new Extra();
+    return this->extra_;
+  }
+
   // Symbol name (expected to point into a Stringpool).
   const char* name_;
-  // Symbol version (expected to point into a Stringpool).  This may
-  // be NULL.
-  const char* version_;
+  // The version, GOT offsets and PLT offset of the symbol, or NULL
+  // if none of them have been set.
+  Extra* extra_;
 
   union
   {
@@ -951,16 +1011,6 @@ class Symbol
   // non-zero value during Layout::finalize.
   unsigned int dynsym_index_;
 
-  // The GOT section entries for this symbol.  A symbol may have more
-  // than one GOT offset (e.g., when mixing modules compiled with two
-  // different TLS models), but will usually have at most one.
-  Got_offset_list got_offsets_;
-
-  // If this symbol has an entry in the PLT section, then this is the
-  // offset from the start of the PLT section.  This is -1U if there
-  // is no PLT entry.
-  unsigned int plt_offset_;
-
   // Symbol type (bits 0 to 3).
   elfcpp::STT type_ : 4;
   // Symbol binding (bits 4 to 7).
@@ -1230,14 +1280,13 @@ class Warnings
 {
  public:
   Warnings()
-    : warnings_()
+    : namepool_(), warnings_()
   { }
 
   // Add a warning for symbol NAME in object OBJ.  WARNING is the text
   // of the warning.
   void
-  add_warning(Symbol_table* symtab, const char* name, Object* obj,
-	      const std::string& warning);
+  add_warning(const char* name, Object* obj, const std::string& warning);
 
   // For each symbol for which we should give a warning, make a note
   // on the symbol.
@@ -1274,10 +1323,15 @@ class Warnings
     }
   };
 
-  // A mapping from warning symbol names (canonicalized in
-  // Symbol_table's namepool_ field) to warning information.
+  // A mapping from warning symbol names (canonicalized in namepool_)
+  // to warning information.
   typedef Unordered_map<const char*, Warning_location> Warning_table;
 
+  // The names of the symbols with warnings.  We keep our own pool,
+  // rather than using the symbol table's, because warning sections
+  // are seen during layout, which may run at the same time as tasks
+  // adding symbols to a sharded symbol table.
+  Stringpool namepool_;
   Warning_table warnings_;
 };
 
@@ -1359,7 +1413,10 @@ class Symbol_table
   // offset in the symbol table of the first symbol, SYM_NAMES is
   // their names, SYM_NAME_SIZE is the size of SYM_NAMES.  This sets
   // SYMPOINTERS to point to the symbols in the symbol table.  It sets
-  // *DEFINED to the number of defined symbols.
+  // *DEFINED to the number of defined symbols.  If INDEXES is not
+  // NULL, only the symbols at those indexes into SYMS are added, and
+  // they must all belong to symbol table shard SHARD; this is used by
+  // the tasks which add symbols to a sharded symbol table.
   template<int size, bool big_endian>
   void
   add_from_relobj(Sized_relobj_file<size, big_endian>* relobj,
@@ -1367,7 +1424,9 @@ class Symbol_table
 		  size_t symndx_offset, const char* sym_names,
 		  size_t sym_name_size,
 		  typename Sized_relobj_file<size, big_endian>::Symbols*,
-		  size_t* defined);
+		  size_t* defined,
+		  const std::vector<unsigned int>* indexes = NULL,
+		  unsigned int shard = 0);
 
   // Add one external symbol from the plugin object OBJ to the symbol table.
   // Returns a pointer to the resolved symbol in the symbol table.
@@ -1392,11 +1451,14 @@ class Symbol_table
 		  size_t* defined);
 
   // Add one external symbol from the incremental object OBJ to the symbol
-  // table.  Returns a pointer to the resolved symbol in the symbol table.
+  // table.  NAME_LEN and NAME_HASH are the length of NAME and its hash
+  // code as returned by Stringpool::hash_string.  Returns a pointer to
+  // the resolved symbol in the symbol table.
   template<int size, bool big_endian>
   Sized_symbol<size>*
-  add_from_incrobj(Object* obj, const char* name,
-		   const char* ver, elfcpp::Sym<size, big_endian>* sym);
+  add_from_incrobj(Object* obj, const char* name, size_t name_len,
+		   size_t name_hash, const char* ver,
+		   elfcpp::Sym<size, big_endian>* sym);
 
   // Define a special symbol based on an Output_data.  It is a
   // multiple definition error if this symbol is already defined.
@@ -1465,7 +1527,105 @@ class Symbol_table
   // Return the count of undefined symbols seen.
   size_t
   saw_undefined() const
-  { return this->saw_undefined_; }
+  {
+    size_t ret = 0;
+    for (Shards::const_iterator p = this->shards_.begin();
+	 p != this->shards_.end();
+	 ++p)
+      ret += (*p)->saw_undefined;
+    return ret;
+  }
+
+  // A position in the list of symbols which have become strong
+  // undefined symbols, used by archive groups.  There is one entry
+  // for each shard.
+  typedef std::vector<size_t> Undefined_position;
+
+  // Set *POS to the current end of the list of strong undefined
+  // symbols.
+  void
+  get_undefined_position(Undefined_position* pos) const;
+
+  // Append to *SYMS the symbols which have become strong undefined
+  // symbols since *POS, and advance *POS past them.  A symbol may
+  // appear more than once, and may have been defined since.
+  void
+  get_new_undefined_symbols(Undefined_position* pos,
+			    std::vector<Symbol*>* syms) const;
+
+  // Return the number of shards in the symbol table.  Each shard
+  // holds the symbols whose names hash to it, with its own hash table
+  // and name pool.  When there is more than one shard, the symbols of
+  // a relocatable object are added by a separate task for each shard,
+  // so that different objects may be added to different shards at the
+  // same time.  The symbols in each shard are still added in command
+  // line order.
+  unsigned int
+  shard_count() const
+  { return this->shards_.size(); }
+
+  // Return whether the symbol names have their ELF and GNU hash codes
+  // stored by the name pools, as returned by
+  // Stringpool::cached_elf_hash and Stringpool::cached_gnu_hash.
+  bool
+  has_cached_name_hashes() const
+  { return this->cached_name_hashes_; }
+
+  // Return the shard for the symbol named NAME, where LEN is the
+  // length of the name not counting any version suffix.
+  unsigned int
+  symbol_shard(const char* name, size_t len) const
+  {
+    if (this->shards_.size() == 1)
+      return 0;
+    return this->hash_shard(gold::string_hash<char>(name, len));
+  }
+
+  // Return the shard for a symbol name whose hash code is H.
+  unsigned int
+  hash_shard(size_t h) const
+  {
+    if (this->shards_.size() == 1)
+      return 0;
+    return (h ^ (h >> 16)) % this->shards_.size();
+  }
+
+  // Return a blocker token which is blocked while there are tasks
+  // adding symbols to the shards.  A task which needs to see all the
+  // symbols added so far must wait for it.  This returns NULL if the
+  // symbol table is not sharded.
+  Task_token*
+  shard_blocker() const
+  { return this->shard_blocker_; }
+
+  // Return the token which will be unblocked when the last task
+  // queued to add symbols to SHARD completes, or NULL if there is
+  // none.
+  Task_token*
+  shard_token(unsigned int shard) const
+  { return this->shards_[shard]->last_token; }
+
+  // Record that a new task will add symbols to SHARD, and will
+  // unblock TOKEN when it completes.
+  void
+  set_shard_token(unsigned int shard, Task_token* token)
+  {
+    this->shards_[shard]->last_token = token;
+    ++this->shards_[shard]->task_count;
+  }
+
+  // Record that a task adding symbols to SHARD had to wait for the
+  // previous task for the same shard.  This is called with the
+  // workqueue lock held.
+  void
+  note_shard_wait(unsigned int shard)
+  { ++this->shards_[shard]->wait_count; }
+
+  // This is called after all the tasks adding symbols to the shards
+  // have completed.  It marks the symbols which were recorded for
+  // garbage collection while the tasks were running.
+  void
+  finish_shards();
 
   // Allocate the common symbols
   void
@@ -1475,12 +1635,12 @@ class Symbol_table
   // of the warning.
   void
   add_warning(const char* name, Object* obj, const std::string& warning)
-  { this->warnings_.add_warning(this, name, obj, warning); }
+  { this->warnings_.add_warning(name, obj, warning); }
 
   // Canonicalize a symbol name for use in the hash table.
   const char*
   canonicalize_name(const char* name)
-  { return this->namepool_.add(name, true, NULL); }
+  { return this->name_shard(name)->namepool.add(name, true, NULL); }
 
   // Possibly issue a warning for a reference to SYM at LOCATION which
   // is in OBJ.
@@ -1494,7 +1654,25 @@ class Symbol_table
   // Check candidate_odr_violations_ to find symbols with the same name
   // but apparently different definitions (different source-file/line-no).
   void
-  detect_odr_violations(const Task*, const char* output_file_name) const;
+  detect_odr_violations(const Task*, const char* output_file_name);
+
+  // Queue a task for each object with candidate ODR violations to
+  // find the source lines of the definitions.  BLOCKER is held until
+  // all the tasks are done.  This is only used with threads; without
+  // them detect_odr_violations finds the lines itself.
+  void
+  queue_odr_tasks(Workqueue*, Task_token* blocker);
+
+  // Find the source lines of the candidate ODR violations defined in
+  // object INDEX in odr_objects_.  The object must be locked.
+  void
+  find_odr_linenos(unsigned int index);
+
+  // Return the object whose candidate ODR violations are INDEX in
+  // odr_objects_.
+  Object*
+  odr_object(unsigned int index) const
+  { return this->odr_objects_[index].object; }
 
   // Add any undefined symbols named on the command line to the symbol
   // table.
@@ -1579,12 +1757,19 @@ class Symbol_table
   void
   for_all_symbols(F f) const
   {
-    for (Symbol_table_type::const_iterator p = this->table_.begin();
-         p != this->table_.end();
-         ++p)
+    for (Shards::const_iterator ps = this->shards_.begin();
+	 ps != this->shards_.end();
+	 ++ps)
       {
-	Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
-	f(sym);
+	const Symbol_table_type& table((*ps)->table);
+	for (Symbol_table_type::const_iterator p = table.begin();
+	     p != table.end();
+	     ++p)
+	  {
+	    Sized_symbol<size>* sym =
+	      static_cast<Sized_symbol<size>*>(p->second);
+	    f(sym);
+	  }
       }
   }
 
@@ -1641,14 +1826,151 @@ class Symbol_table
                         Unordered_set<Symbol_location, Symbol_location_hash> >
   Odr_map;
 
+  // The definitions in an Odr_map from one object, and all the lines
+  // attached to each of them, not just the one the instruction
+  // actually came from; this helps the ODR checker avoid false
+  // positives.  The lines are sorted so that they can be compared.
+  struct Odr_object
+  {
+    Odr_object(Object* o)
+      : object(o), locs(), linenos()
+    { }
+
+    Object* object;
+    std::vector<Symbol_location> locs;
+    std::vector<std::vector<std::string> > linenos;
+  };
+
+  typedef std::vector<Odr_object> Odr_objects;
+
+  // The type of the list of symbols which have been forced local.
+  typedef std::vector<Symbol*> Forced_locals;
+
+  // An arena from which the symbols read from input files are
+  // allocated.  Those symbols are never freed, so allocation is a
+  // pointer increment, and the symbols of one object are next to
+  // each other in memory.
+  class Symbol_arena
+  {
+   public:
+    Symbol_arena()
+      : chunks_(), next_(NULL), end_(NULL), allocated_(0)
+    { }
+
+    ~Symbol_arena();
+
+    // Make sure that the next BYTES bytes of allocations come from a
+    // single chunk.
+    void
+    reserve(size_t bytes);
+
+    // Allocate BYTES bytes.
+    void*
+    allocate(size_t bytes)
+    {
+      bytes = (bytes + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+      if (static_cast<size_t>(this->end_ - this->next_) < bytes)
+	this->reserve(bytes);
+      void* ret = this->next_;
+      this->next_ += bytes;
+      this->allocated_ += bytes;
+      return ret;
+    }
+
+    // Return the number of bytes allocated.
+    size_t
+    allocated() const
+    { return this->allocated_; }
+
+    // Return the number of chunks.
+    size_t
+    chunk_count() const
+    { return this->chunks_.size(); }
+
+   private:
+    Symbol_arena(const Symbol_arena&);
+    Symbol_arena& operator=(const Symbol_arena&);
+
+    // The default size of a chunk.
+    static const size_t chunk_size = 256 * 1024;
+
+    // The chunks of memory.
+    std::vector<char*> chunks_;
+    // The free space in the last chunk.
+    char* next_;
+    char* end_;
+    // The number of bytes allocated.
+    size_t allocated_;
+  };
+
+  // A shard of the symbol table.
+  struct Shard
+  {
+    Shard(unsigned int count)
+      : table(count), namepool(), arena(), forced_locals(),
+	saw_undefined(0), undefined_symbols(), gc_symbols(),
+	last_token(NULL), task_count(0), wait_count(0)
+    { this->namepool.reserve(count); }
+
+    // The symbol hash table.
+    Symbol_table_type table;
+    // A pool of symbol names.  The names and versions of all the
+    // symbols in the shard are here, and entries in TABLE point into
+    // this pool.
+    Stringpool namepool;
+    // The symbols created by add_from_object for this shard.
+    Symbol_arena arena;
+    // The symbols in this shard which have been forced to be local.
+    // We don't expect there to be very many of them, so we keep a
+    // list of them rather than walking the whole table to find them.
+    Forced_locals forced_locals;
+    // We increment this every time we see a new undefined symbol in
+    // this shard, for use in archive groups.
+    size_t saw_undefined;
+    // The symbols in this shard which have become strong undefined
+    // symbols, in the order in which that happened.  This lets an
+    // archive group look up only the symbols which may pull in new
+    // members, rather than rescanning every archive map.
+    std::vector<Symbol*> undefined_symbols;
+    // Symbols to mark for garbage collection when all the tasks
+    // adding symbols are complete.  See gc_mark_added_symbol.
+    std::vector<Symbol*> gc_symbols;
+    // The token unblocked by the last task queued for this shard.
+    Task_token* last_token;
+    // The number of tasks queued for this shard, and the number
+    // which had to wait for an earlier task; used for --stats.
+    size_t task_count;
+    size_t wait_count;
+  };
+
+  typedef std::vector<Shard*> Shards;
+
+  // Return the shard for the symbol named NAME, which may not have a
+  // version suffix.
+  Shard*
+  name_shard(const char* name) const
+  {
+    if (this->shards_.size() == 1)
+      return this->shards_[0];
+    return this->shards_[this->symbol_shard(name, strlen(name))];
+  }
+
   // Make FROM a forwarder symbol to TO.
   void
   make_forwarder(Symbol* from, Symbol* to);
 
+  // Mark SYM for garbage collection as it is added to the symbol
+  // table.  If the table is sharded, SYM is only recorded in its
+  // shard, since other tasks may be adding symbols; finish_shards
+  // will mark it.
+  void
+  gc_mark_added_symbol(Symbol* sym);
+
   // Add a symbol.
   template<int size, bool big_endian>
   Sized_symbol<size>*
-  add_from_object(Object*, const char* name, Stringpool::Key name_key,
+  add_from_object(Object*, Shard*, const char* name,
+		  Stringpool::Key name_key,
 		  const char* version, Stringpool::Key version_key,
 		  bool def, const elfcpp::Sym<size, big_endian>& sym,
 		  unsigned int st_shndx, bool is_ordinary,
@@ -1789,11 +2111,11 @@ class Symbol_table
   do_allocate_commons_list(Layout*, Commons_section_type, Commons_type*,
 			   Mapfile*, Sort_commons_order);
 
-  // Returns all of the lines attached to LOC, not just the one the
-  // instruction actually came from.  This helps the ODR checker avoid
-  // false positives.
-  static std::vector<std::string>
-  linenos_from_loc(const Task* task, const Symbol_location& loc);
+  // Group the definitions in candidate_odr_violations_ by object in
+  // odr_objects_, so that the line information of each object is
+  // only read once.
+  void
+  group_odr_locations();
 
   // Implement detect_odr_violations.
   template<int size, bool big_endian>
@@ -1841,16 +2163,10 @@ class Symbol_table
   sized_write_section_symbol(const Output_section*, Output_symtab_xindex*,
 			     Output_file*, off_t) const;
 
-  // The type of the list of symbols which have been forced local.
-  typedef std::vector<Symbol*> Forced_locals;
-
   // A map from symbols with COPY relocs to the dynamic objects where
   // they are defined.
   typedef Unordered_map<const Symbol*, Dynobj*> Copied_symbol_dynobjs;
 
-  // We increment this every time we see a new undefined symbol, for
-  // use in archive groups.
-  size_t saw_undefined_;
   // The index of the first global symbol in the output file.
   unsigned int first_global_index_;
   // The file offset within the output symtab section where we should
@@ -1864,11 +2180,16 @@ class Symbol_table
   unsigned int first_dynamic_global_index_;
   // The number of global dynamic symbols, or 0 if none.
   unsigned int dynamic_count_;
-  // The symbol hash table.
-  Symbol_table_type table_;
-  // A pool of symbol names.  This is used for all global symbols.
-  // Entries in the hash table point into this pool.
-  Stringpool namepool_;
+  // The shards of the symbol table.  There is always at least one.
+  Shards shards_;
+  // Blocked while tasks are adding symbols to the shards; NULL if
+  // there is only one shard.
+  Task_token* shard_blocker_;
+  // Controls access to the data below which is shared by all the
+  // shards; NULL if there is only one shard.
+  Lock* shared_lock_;
+  // Whether the name pools store the dynamic hash codes of the names.
+  bool cached_name_hashes_;
   // Forwarding symbols.
   Unordered_map<const Symbol*, Symbol*> forwarders_;
   // Weak aliases.  A symbol in this list points to the next alias.
@@ -1887,14 +2208,14 @@ class Symbol_table
   Commons_type small_commons_;
   // This is for large common symbols.
   Commons_type large_commons_;
-  // A list of symbols which have been forced to be local.  We don't
-  // expect there to be very many of them, so we keep a list of them
-  // rather than walking the whole table to find them.
-  Forced_locals forced_locals_;
   // Manage symbol warnings.
   Warnings warnings_;
   // Manage potential One Definition Rule (ODR) violations.
   Odr_map candidate_odr_violations_;
+  // The candidate ODR violations grouped by object.
+  Odr_objects odr_objects_;
+  // Whether odr_objects_ has been set up.
+  bool odr_objects_grouped_;
 
   // When we emit a COPY reloc for a symbol, we define it in an
   // Output_data.  When it's time to emit version information for it,
@@ -0,0 +1,60 @@
+/* call_graph_test.c -- test --call-graph-ordering.
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   The profile in call_graph_test.txt says that main calls cg_caller,
+   which calls cg_callee, so the three functions should be placed
+   together in that order, although cg_callee comes first here and
+   cold_2 lies between them.  */
+
+int cold_1 (int);
+int cg_callee (int);
+int cold_2 (int);
+int cg_caller (int);
+
+int
+cold_1 (int i)
+{
+  return i + 1;
+}
+
+int
+cg_callee (int i)
+{
+  return i * 3;
+}
+
+int
+cold_2 (int i)
+{
+  return i - 1;
+}
+
+int
+cg_caller (int i)
+{
+  return cg_callee (i) + 1;
+}
+
+int
+main (void)
+{
+  return cg_caller (1) - 4;
+}
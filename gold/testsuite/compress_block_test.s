@@ -0,0 +1,10 @@
+/* A debug section of 2.4 megabytes, which --compress-debug-sections
+   splits into several blocks.  The contents are pseudo-random so
+   that the blocks do not compress to almost nothing.  */
+
+	.section .debug_test, ""
+	.set v, 1
+	.rept 600000
+	.long v
+	.set v, (v * 1103515245 + 12345) & 0x7fffffff
+	.endr
@@ -0,0 +1,34 @@
+#!/bin/sh
+
+# dwp_test_3.sh -- test dwp --threads.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that dwp gives the same
+# output with --threads as without.  dwp_test_3.dwp is made from the
+# same input files as dwp_test_1.dwp, using threads.
+
+if ! cmp -s dwp_test_1.dwp dwp_test_3.dwp
+then
+    echo "dwp_test_1.dwp and dwp_test_3.dwp differ"
+    exit 1
+fi
+
+exit 0
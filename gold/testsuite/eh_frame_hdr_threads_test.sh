@@ -0,0 +1,44 @@
+#!/bin/sh
+
+# eh_frame_hdr_threads_test.sh -- test --eh-frame-hdr with --threads.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that sorting the .eh_frame_hdr
+# table in chunks with threads gives the same table as sorting it
+# without threads.  eh_frame_hdr_threads_test_1.hdr is the
+# .eh_frame_hdr section of the link without threads, and
+# eh_frame_hdr_threads_test_2.hdr that of the link with threads.  The
+# input has 140000 FDEs, which is more than two chunks, and their
+# addresses are not in the order of the FDEs.
+
+# The header is 12 bytes, followed by 8 bytes for each FDE.
+size=`wc -c < eh_frame_hdr_threads_test_1.hdr`
+if test "$size" -ne 1120012; then
+    echo "Unexpected size of .eh_frame_hdr: $size"
+    exit 1
+fi
+
+if ! cmp -s eh_frame_hdr_threads_test_1.hdr eh_frame_hdr_threads_test_2.hdr; then
+    echo "Sorting with threads gave a different .eh_frame_hdr"
+    exit 1
+fi
+
+exit 0
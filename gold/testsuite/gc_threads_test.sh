@@ -0,0 +1,77 @@
+#!/bin/sh
+
+# gc_threads_test.sh -- test --gc-sections with --threads.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that marking the sections for
+# --gc-sections with threads keeps the same sections as marking them
+# without threads.  gc_threads_test_1.stdout and gc_threads_test_1.err
+# are the nm output and the --print-gc-sections output of the link
+# without threads, and gc_threads_test_2.* those of the link with
+# threads.
+
+check()
+{
+    if ! grep -q "$2" $1; then
+	echo "Did not find expected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" $1; then
+	echo "Found unexpected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for f in gc_threads_test_1.stdout gc_threads_test_2.stdout; do
+    check $f " T main$"
+    check $f " T kept_1$"
+    check $f " T kept_2$"
+    check $f " T kept_3$"
+    check $f " D kept_data$"
+    check_missing $f "cycle_"
+    check_missing $f "unused_"
+done
+
+for s in cycle_1 cycle_2 unused_1 unused_2 unused_data_1 unused_data_2; do
+    check gc_threads_test_1.err "\.[a-z]*\.$s'"
+done
+
+for f in stdout err; do
+    if ! cmp -s gc_threads_test_1.$f gc_threads_test_2.$f; then
+	echo "Marking with threads kept different sections:"
+	diff gc_threads_test_1.$f gc_threads_test_2.$f
+	exit 1
+    fi
+done
+
+exit 0
@@ -0,0 +1,61 @@
+/* gc_threads_test_1.c -- a test case for gold
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   Functions which are reached from main through references in both
+   files, a cycle which is not reached from main, and functions and
+   data which are not referenced at all.  */
+
+extern int kept_data[];
+extern int kept_2 (int);
+extern int cycle_2 (int);
+extern int unused_2 (int);
+
+int unused_data_1[16] = { 1 };
+
+int
+kept_1 (int i)
+{
+  return i > 0 ? kept_2 (i - 1) + kept_data[0] : 0;
+}
+
+int
+kept_3 (int i)
+{
+  return i > 0 ? kept_1 (i - 1) : 1;
+}
+
+int
+cycle_1 (int i)
+{
+  return i > 0 ? cycle_2 (i - 1) : 0;
+}
+
+int
+unused_1 (int i)
+{
+  return unused_2 (i) + unused_data_1[i];
+}
+
+int
+main (void)
+{
+  return kept_1 (3);
+}
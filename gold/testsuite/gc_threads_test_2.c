@@ -0,0 +1,46 @@
+/* gc_threads_test_2.c -- a test case for gold
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   The other half of the references for gc_threads_test.  */
+
+extern int kept_3 (int);
+extern int cycle_1 (int);
+
+int kept_data[4] = { 1, 2, 3, 4 };
+int unused_data_2[16] = { 2 };
+
+int
+kept_2 (int i)
+{
+  return i > 0 ? kept_3 (i - 1) : kept_data[1];
+}
+
+int
+cycle_2 (int i)
+{
+  return i > 0 ? cycle_1 (i - 1) : 0;
+}
+
+int
+unused_2 (int i)
+{
+  return unused_data_2[i];
+}
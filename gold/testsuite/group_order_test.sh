@@ -0,0 +1,61 @@
+#!/bin/sh
+
+# group_order_test.sh -- test the order in which the archives in a
+# --start-group/--end-group group are searched.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# libgroup_order_test_1.a and libgroup_order_test_3.a both define d.
+# The reference to d comes from c in libgroup_order_test_2.a, which is
+# only included when the group is searched again for the reference to
+# c from a in libgroup_order_test_3.a.  The archives are searched in
+# order starting after libgroup_order_test_2.a, so d must come from
+# libgroup_order_test_3.a.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check group_order_test.stdout "group_order_test_4_marker"
+check_missing group_order_test.stdout "group_order_test_1_marker"
+
+exit 0
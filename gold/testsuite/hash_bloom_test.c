@@ -0,0 +1,39 @@
+/* hash_bloom_test.c -- test --hash-bloom-false-positive-rate.
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+
+   This defines enough global functions that the size of the .gnu.hash
+   bloom filter depends on the requested false positive rate.  */
+
+#define F(n) int hb_##n (void); int hb_##n (void) { return n; }
+#define F10(n) F (n##0) F (n##1) F (n##2) F (n##3) F (n##4) \
+  F (n##5) F (n##6) F (n##7) F (n##8) F (n##9)
+
+F10 (1)
+F10 (2)
+F10 (3)
+F10 (4)
+F10 (5)
+F10 (6)
+F10 (7)
+F10 (8)
+F10 (9)
+F10 (10)
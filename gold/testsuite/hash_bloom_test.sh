@@ -0,0 +1,50 @@
+#!/bin/sh
+
+# hash_bloom_test.sh -- test --hash-bloom-false-positive-rate.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that a lower false positive
+# rate gives a larger .gnu.hash bloom filter.  File hash_bloom_test.c
+# is in this test.  hash_bloom_test_1.so is linked with a rate of 0.5
+# and hash_bloom_test_2.so with a rate of 0.001.
+
+set -e
+
+hash_size()
+{
+    awk '{ for (i = 1; i < NF; i++)
+	     if ($i == ".gnu.hash") { print $(i + 4); exit; } }' $1
+}
+
+size_1=`hash_size hash_bloom_test_1.stdout`
+size_2=`hash_size hash_bloom_test_2.stdout`
+
+if test -z "$size_1" || test -z "$size_2"; then
+    echo "did not find .gnu.hash"
+    exit 1
+fi
+
+# readelf prints the sizes in hex without a leading 0x.
+if test `printf "%d" 0x$size_1` -ge `printf "%d" 0x$size_2`; then
+    echo ".gnu.hash size $size_1 for rate 0.5 is not less than"
+    echo ".gnu.hash size $size_2 for rate 0.001"
+    exit 1
+fi
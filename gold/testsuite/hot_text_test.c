@@ -0,0 +1,66 @@
+/* hot_text_test.c -- test --hot-text.
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+
+   ht_hot is in a .text.hot section, and hot_text_test.txt names the
+   section of ht_listed, so with --hot-text both should be placed
+   before the other functions, although they come last here.  The
+   linker defines __hot_text_start and __hot_text_end around them.  */
+
+extern char __hot_text_start[];
+extern char __hot_text_end[];
+
+int ht_cold_1 (int);
+int ht_cold_2 (int);
+int ht_listed (int);
+int ht_hot (int) __attribute__ ((section (".text.hot.ht_hot")));
+
+int
+ht_cold_1 (int i)
+{
+  return i + 1;
+}
+
+int
+ht_cold_2 (int i)
+{
+  return i - 1;
+}
+
+int
+ht_listed (int i)
+{
+  return ht_cold_1 (i) * 2;
+}
+
+int
+ht_hot (int i)
+{
+  return ht_cold_2 (i) * 3;
+}
+
+int
+main (void)
+{
+  if (__hot_text_end - __hot_text_start <= 0)
+    return 1;
+  return ht_hot (1) + ht_listed (1) - 2;
+}
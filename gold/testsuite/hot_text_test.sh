@@ -0,0 +1,72 @@
+#!/bin/sh
+
+# hot_text_test.sh -- test --hot-text.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --hot-text places the hot
+# functions at the start of .text, before __hot_text_end, and that the
+# end of the hot text is aligned to --hot-text-align.  File
+# hot_text_test.c is in this test.
+
+set -e
+
+check()
+{
+    awk "
+BEGIN { saw1 = 0; saw2 = 0; err = 0; }
+/.*$2\$/ { saw1 = 1; }
+/.*$3\$/ {
+     saw2 = 1;
+     if (!saw1)
+       {
+	  printf \"layout of $2 and $3 is not right\\n\";
+	  err = 1;
+	  exit 1;
+       }
+    }
+END {
+      if (!saw1 && !err)
+        {
+	  printf \"did not see $2\\n\";
+	  exit 1;
+	}
+      if (!saw2 && !err)
+	{
+	  printf \"did not see $3\\n\";
+	  exit 1;
+	}
+    }" $1
+}
+
+check hot_text_test.stdout "__hot_text_start" "ht_hot"
+check hot_text_test.stdout "__hot_text_start" "ht_listed"
+check hot_text_test.stdout "ht_hot" "__hot_text_end"
+check hot_text_test.stdout "ht_listed" "__hot_text_end"
+check hot_text_test.stdout "__hot_text_end" "ht_cold_1"
+check hot_text_test.stdout "__hot_text_end" "ht_cold_2"
+
+# The hot text is padded to the 0x1000 alignment given in Makefile.am.
+if ! grep -q '^[0-9a-f]*000 [a-zA-Z] __hot_text_end$' hot_text_test.stdout
+then
+    echo "__hot_text_end is not aligned"
+    cat hot_text_test.stdout
+    exit 1
+fi
@@ -0,0 +1,46 @@
+// icf_rodata_test.cc -- a test case for gold
+
+// Copyright 2014 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that --icf-rodata folds
+// identical read-only data.  table_a and table_b have the same
+// contents, so with --icf=all they must be folded.  Their addresses
+// are taken, so with --icf=safe they must not be.
+
+extern const int table_a[8];
+extern const int table_b[8];
+
+const int table_a[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+const int table_b[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+int
+sum(const int* p)
+{
+  int s = 0;
+  for (int i = 0; i < 8; ++i)
+    s += p[i];
+  return s;
+}
+
+int
+main()
+{
+  return sum(table_a) - sum(table_b);
+}
@@ -0,0 +1,51 @@
+#!/bin/sh
+
+# icf_rodata_test.sh -- test --icf-rodata
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --icf-rodata folds
+# identical read-only data with --icf=all, but not data whose address
+# is taken with --icf=safe.  File icf_rodata_test.cc is in this test.
+
+check_fold()
+{
+    sym_addr_1=`grep " $2\$" $1 | awk '{print $1}'`
+    sym_addr_2=`grep " $3\$" $1 | awk '{print $1}'`
+    if [ -z "$sym_addr_1" ] || [ "$sym_addr_1" != "$sym_addr_2" ]
+    then
+        echo "Identical Code Folding did not fold" $2 "and" $3
+	exit 1
+    fi
+}
+
+check_nofold()
+{
+    sym_addr_1=`grep " $2\$" $1 | awk '{print $1}'`
+    sym_addr_2=`grep " $3\$" $1 | awk '{print $1}'`
+    if [ -z "$sym_addr_1" ] || [ "$sym_addr_1" = "$sym_addr_2" ]
+    then
+        echo "Safe Identical Code Folding folded" $2 "and" $3
+	exit 1
+    fi
+}
+
+check_fold icf_rodata_test.stdout "table_a" "table_b"
+check_nofold icf_rodata_safe_test.stdout "table_a" "table_b"
@@ -65,6 +65,9 @@ check_cmp actual recorded
 
 rm -f actual recorded
 
+# Verify that the header records the size of the symbol name hash codes.
+check incremental_test.stdout "Symbol name hash size: [48]$"
+
 # Filter the incremental-dump output into a format that can be grepped
 # more easily.
 
@@ -74,6 +77,8 @@ awk '
     /^ / { print section, subsection, $0; }
 ' < incremental_test.stdout > incremental_test.dump
 
+check incremental_test.dump "Input files: .* incremental_test_1.o  *Content hash: 0x0*[1-9a-f]"
+check incremental_test.dump "Input files: .* incremental_test_2.o  *Content hash: 0x0*[1-9a-f]"
 check incremental_test.dump "Input sections: .* incremental_test_1.o  *1 "
 check incremental_test.dump "Input sections: .* incremental_test_2.o  *1 "
 check incremental_test.dump "Global symbol table: .* main  .* relocation type "
@@ -0,0 +1,61 @@
+#!/bin/sh
+
+# incremental_touch_test.sh -- test that an incremental link does not
+# treat an input file as changed when only its timestamp has changed.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The first update link follows a touch of incremental_touch_test_tmp.o,
+# so the linker must hash the file and find it unchanged.  The second
+# update link follows the first with no touch in between, so the first
+# link must have recorded the new timestamp and no hash is needed.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check incremental_touch_test_1.stdout \
+  "incremental_touch_test_tmp.o: timestamp changed but contents unchanged"
+check_missing incremental_touch_test_2.stdout \
+  "incremental_touch_test_tmp.o: timestamp changed"
+
+exit 0
@@ -0,0 +1,73 @@
+#!/bin/sh
+
+# link_server_test.sh -- test --link-server and --use-link-server.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that a link run by a link
+# server gives the same output as running it directly, and that the
+# link uses the umask of the client.  two_file_relocatable.o is the
+# output of the direct link.
+
+set -e
+
+sock=link_server_test.sock
+inputs="two_file_test_1.o two_file_test_1b.o two_file_test_2.o"
+
+rm -f $sock link_server_test_1.o link_server_test_2.o link_server_test.err
+
+(umask 022; exec gcctestdir/ld --link-server $sock two_file_test_1.o) &
+server=$!
+trap 'kill $server 2>/dev/null; rm -f $sock' 0
+
+# Wait for the server to create its socket.
+tries=0
+while test ! -S $sock; do
+    tries=`expr $tries + 1`
+    if test $tries -gt 30; then
+	echo "link server did not start"
+	exit 1
+    fi
+    sleep 1
+done
+
+# Link twice, so that the second link reads the files cached by the
+# first one.
+for n in 1 2; do
+    (umask 077; gcctestdir/ld --use-link-server $sock -r \
+	-o link_server_test_$n.o $inputs) 2> link_server_test.err
+    if test -s link_server_test.err; then
+	echo "link $n through the link server failed:"
+	cat link_server_test.err
+	exit 1
+    fi
+    if ! cmp -s link_server_test_$n.o two_file_relocatable.o; then
+	echo "link $n through the link server differs from direct link"
+	exit 1
+    fi
+    perms=`ls -l link_server_test_$n.o | cut -c1-10`
+    if test "$perms" != "-rw-------"; then
+	echo "link $n through the link server did not use the client umask:"
+	echo "$perms"
+	exit 1
+    fi
+done
+
+exit 0
@@ -27,6 +27,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
 #include "plugin-api.h"
 
 struct claimed_file
@@ -51,6 +54,12 @@ struct sym_info
 static struct claimed_file* first_claimed_file = NULL;
 static struct claimed_file* last_claimed_file = NULL;
 
+#ifdef ENABLE_THREADS
+/* Protects the list of claimed files, since the claim file hook may
+   be called from several threads at once.  */
+static pthread_mutex_t claimed_file_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 static ld_plugin_register_claim_file register_claim_file_hook = NULL;
 static ld_plugin_register_all_symbols_read register_all_symbols_read_hook = NULL;
 static ld_plugin_register_cleanup register_cleanup_hook = NULL;
@@ -67,6 +76,7 @@ static ld_plugin_get_input_section_name get_input_section_name = NULL;
 static ld_plugin_get_input_section_contents get_input_section_contents = NULL;
 static ld_plugin_update_section_order update_section_order = NULL;
 static ld_plugin_allow_section_ordering allow_section_ordering = NULL;
+static ld_plugin_allow_concurrent_claim_file allow_concurrent_claim_file = NULL;
 
 #define MAXOPTS 10
 
@@ -154,6 +164,10 @@ onload(struct ld_plugin_tv *tv)
 	case LDPT_ALLOW_SECTION_ORDERING:
 	  allow_section_ordering = *entry->tv_u.tv_allow_section_ordering;
 	  break;
+	case LDPT_ALLOW_CONCURRENT_CLAIM_FILE:
+	  allow_concurrent_claim_file
+	    = *entry->tv_u.tv_allow_concurrent_claim_file;
+	  break;
         default:
           break;
         }
@@ -189,6 +203,26 @@ onload(struct ld_plugin_tv *tv)
   for (i = 0; i < nopts; ++i)
     (*message)(LDPL_INFO, "option: %s", opts[i]);
 
+  /* The "concurrent" option asks the linker to call the claim file
+     hook from several threads at once.  */
+  for (i = 0; i < nopts; ++i)
+    {
+      if (strcmp(opts[i], "concurrent") != 0)
+        continue;
+      if (allow_concurrent_claim_file == NULL)
+        {
+          fprintf(stderr,
+                  "tv_allow_concurrent_claim_file interface missing\n");
+          return LDPS_ERR;
+        }
+      if ((*allow_concurrent_claim_file)() != LDPS_OK)
+        {
+          (*message)(LDPL_ERROR, "error allowing concurrent claim file hook");
+          return LDPS_ERR;
+        }
+      (*message)(LDPL_INFO, "claim file hook may be called concurrently");
+    }
+
   if ((*register_claim_file_hook)(claim_file_hook) != LDPS_OK)
     {
       (*message)(LDPL_ERROR, "error registering claim file hook");
@@ -365,11 +399,17 @@ claim_file_hook (const struct ld_plugin_input_file* file, int* claimed)
   claimed_file->nsyms = nsyms;
   claimed_file->syms = syms;
   claimed_file->next = NULL;
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock(&claimed_file_lock);
+#endif
   if (last_claimed_file == NULL)
     first_claimed_file = claimed_file;
   else
     last_claimed_file->next = claimed_file;
   last_claimed_file = claimed_file;
+#ifdef ENABLE_THREADS
+  pthread_mutex_unlock(&claimed_file_lock);
+#endif
 
   (*message)(LDPL_INFO, "%s: claiming file, adding %d symbols",
              file->name, nsyms);
@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# reloc_window_test.sh -- test --reloc-window-size.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that reading the relocations
+# in small windows does not change the output.  reloc_window_test is
+# basic_test.o linked with a 64 byte --reloc-window-size, so it should
+# be the same as basic_test.
+
+if ! cmp -s basic_test reloc_window_test
+then
+    echo "basic_test and reloc_window_test differ"
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,120 @@
+// stringpool_unittest.cc -- test Stringpool
+
+// Copyright 2014 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include "stringpool.h"
+
+#include "test.h"
+
+namespace gold_testsuite
+{
+
+using namespace gold;
+
+// Strings added before the sort is partitioned.  Some are suffixes of
+// others.
+static const char* const first_strings[] =
+{
+  "", "abc", "bc", "c", "hello", "lo", "xyz", "yz", "world", "ld",
+  "zzz", "a", "main", "domain", "_start", "start", "printf", "f"
+};
+
+// Strings added after the sort is partitioned, as when the merge tasks
+// did not handle an input section.  Some are new suffixes, and one is
+// already in the pool.
+static const char* const later_strings[] =
+{
+  "llo", "orld", "z", "ain", "newstring", "bc", "intf"
+};
+
+// Add the strings to POOL.
+
+static void
+add_strings(Stringpool* pool, const char* const* strings, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    pool->add(strings[i], true, NULL);
+}
+
+// Test that sorting the strings of an optimized Stringpool in
+// groups, as the parallel merge tasks do, gives the same string table
+// as sorting them all at once, even if strings are added after the
+// groups were made.
+
+bool
+Stringpool_sort_groups_test(Test_report*)
+{
+  const size_t first_count = sizeof first_strings / sizeof first_strings[0];
+  const size_t later_count = sizeof later_strings / sizeof later_strings[0];
+
+  Stringpool expected;
+  expected.set_optimize();
+  add_strings(&expected, first_strings, first_count);
+  add_strings(&expected, later_strings, later_count);
+  expected.set_string_offsets();
+
+  // Sort in groups, without adding any strings later.
+  Stringpool grouped;
+  grouped.set_optimize();
+  add_strings(&grouped, first_strings, first_count);
+  add_strings(&grouped, later_strings, later_count);
+  unsigned int groups = grouped.partition_for_sort(4);
+  CHECK(groups > 1);
+  for (unsigned int i = 0; i < groups; ++i)
+    grouped.sort_group(i);
+  grouped.set_string_offsets();
+
+  // Sort in groups, and then add more strings.
+  Stringpool deferred;
+  deferred.set_optimize();
+  add_strings(&deferred, first_strings, first_count);
+  groups = deferred.partition_for_sort(4);
+  CHECK(groups > 1);
+  for (unsigned int i = 0; i < groups; ++i)
+    deferred.sort_group(i);
+  add_strings(&deferred, later_strings, later_count);
+  deferred.set_string_offsets();
+
+  CHECK(grouped.get_strtab_size() == expected.get_strtab_size());
+  CHECK(deferred.get_strtab_size() == expected.get_strtab_size());
+  for (size_t i = 0; i < first_count; ++i)
+    {
+      CHECK(grouped.get_offset(first_strings[i])
+	    == expected.get_offset(first_strings[i]));
+      CHECK(deferred.get_offset(first_strings[i])
+	    == expected.get_offset(first_strings[i]));
+    }
+  for (size_t i = 0; i < later_count; ++i)
+    {
+      CHECK(grouped.get_offset(later_strings[i])
+	    == expected.get_offset(later_strings[i]));
+      CHECK(deferred.get_offset(later_strings[i])
+	    == expected.get_offset(later_strings[i]));
+    }
+
+  return true;
+}
+
+Register_test stringpool_register("Stringpool_sort_groups",
+				  Stringpool_sort_groups_test);
+
+} // End namespace gold_testsuite.
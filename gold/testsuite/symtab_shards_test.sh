@@ -0,0 +1,72 @@
+#!/bin/sh
+
+# symtab_shards_test.sh -- test --symbol-table-shards.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that a link which adds the
+# symbols to a sharded symbol table resolves the same symbols as one
+# which does not, including weak and common symbols and symbols
+# defined in an archive.  symtab_shards_test_1.stdout is the nm
+# output of the unsharded link, and symtab_shards_test_2.stdout that
+# of the sharded one.
+
+check()
+{
+    if ! grep -q "$2" $1; then
+	echo "Did not find expected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" $1; then
+	echo "Found unexpected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for f in symtab_shards_test_1.stdout symtab_shards_test_2.stdout; do
+    check $f " T weak_1$"
+    check $f " W weak_2$"
+    check $f " w weak_undef$"
+    check $f " D common_1$"
+    check $f "0*20 B common_2$"
+    check $f " B common_ar$"
+    check $f " T ar_2$"
+    check_missing $f "ar_unused"
+done
+
+if ! cmp -s symtab_shards_test_1.stdout symtab_shards_test_2.stdout; then
+    echo "Sharded symbol table resolved different symbols:"
+    diff symtab_shards_test_1.stdout symtab_shards_test_2.stdout
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,64 @@
+/* symtab_shards_test_1.c -- a test case for gold
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   The main program.  It references symbols defined in the other
+   object and in libsymtab_shards_test.a, and defines weak and common
+   symbols which the other object overrides.  */
+
+extern int f2_1 (void);
+extern int f2_2 (void);
+extern int f2_3 (void);
+extern int f2_4 (void);
+extern int ar_1 (void);
+extern int weak_undef (void) __attribute__ ((weak));
+
+int common_1;
+int common_2[2];
+
+int weak_1 (void) __attribute__ ((weak));
+int weak_2 (void) __attribute__ ((weak));
+
+int
+weak_1 (void)
+{
+  return 1;
+}
+
+int
+weak_2 (void)
+{
+  return 2;
+}
+
+int f1_1 (void) { return 11; }
+int f1_2 (void) { return 12; }
+int f1_3 (void) { return 13; }
+int f1_4 (void) { return 14; }
+
+int
+main (void)
+{
+  int r = f2_1 () + f2_2 () + f2_3 () + f2_4 () + ar_1 ();
+  r += weak_1 () + weak_2 () + common_1 + common_2[0];
+  if (weak_undef)
+    r += weak_undef ();
+  return r;
+}
@@ -0,0 +1,39 @@
+/* symtab_shards_test_2.c -- a test case for gold
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   Overrides the weak definition of weak_1 and the common symbol
+   common_1, and has a larger common common_2.  */
+
+extern int f1_1 (void);
+
+int common_1 = 5;
+int common_2[8];
+
+int
+weak_1 (void)
+{
+  return 10;
+}
+
+int f2_1 (void) { return f1_1 () + 21; }
+int f2_2 (void) { return 22; }
+int f2_3 (void) { return 23; }
+int f2_4 (void) { return 24; }
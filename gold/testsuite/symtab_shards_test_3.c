@@ -0,0 +1,42 @@
+/* symtab_shards_test_3.c -- a test case for gold
+
+   Copyright 2014 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   A member of libsymtab_shards_test.a which the main program pulls in.
+   It pulls in the next member, and has a weak definition of weak_2,
+   which must not override the one in the main program.  */
+
+extern int ar_2 (void);
+
+int common_ar;
+
+int weak_2 (void) __attribute__ ((weak));
+
+int
+weak_2 (void)
+{
+  return 20;
+}
+
+int
+ar_1 (void)
+{
+  return ar_2 () + common_ar;
+}
@@ -0,0 +1,89 @@
+// symtab_unittest.cc -- test Symbol_table
+
+// Copyright 2014 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include "parameters.h"
+#include "options.h"
+#include "script.h"
+#include "symtab.h"
+
+#include "test.h"
+#include "testfile.h"
+
+namespace gold_testsuite
+{
+
+using namespace gold;
+
+// Test that defining a versioned special symbol a second time returns
+// the symbol defined the first time.  The second time
+// define_special_symbol makes a new symbol, which overrides the weak
+// first definition and is then deleted, along with the version stored
+// out of line.
+
+bool
+Symbol_table_special_test(Test_report*)
+{
+  General_options options;
+  set_parameters_options(&options);
+
+#if defined(HAVE_TARGET_64_LITTLE)
+  set_parameters_target(target_test_pointer_64_little);
+#elif defined(HAVE_TARGET_32_LITTLE)
+  set_parameters_target(target_test_pointer_32_little);
+#elif defined(HAVE_TARGET_64_BIG)
+  set_parameters_target(target_test_pointer_64_big);
+#else
+  set_parameters_target(target_test_pointer_32_big);
+#endif
+
+  Version_script_info version_script;
+  version_script.finalize();
+  Symbol_table symtab(0, version_script);
+
+  Symbol* sym1 = symtab.define_as_constant("special", "VERS_1",
+					   Symbol_table::PREDEFINED, 1, 0,
+					   elfcpp::STT_NOTYPE,
+					   elfcpp::STB_WEAK,
+					   elfcpp::STV_DEFAULT, 0, false,
+					   false);
+  CHECK(sym1 != NULL);
+  CHECK(strcmp(sym1->version(), "VERS_1") == 0);
+
+  Symbol* sym2 = symtab.define_as_constant("special", "VERS_1",
+					   Symbol_table::PREDEFINED, 2, 0,
+					   elfcpp::STT_NOTYPE,
+					   elfcpp::STB_GLOBAL,
+					   elfcpp::STV_DEFAULT, 0, false,
+					   false);
+  CHECK(sym2 == sym1);
+  CHECK(sym1->binding() == elfcpp::STB_GLOBAL);
+  CHECK(symtab.lookup("special", "VERS_1") == sym1);
+  CHECK(strcmp(sym1->version(), "VERS_1") == 0);
+
+  return true;
+}
+
+Register_test symtab_register("Symbol_table_special",
+			      Symbol_table_special_test);
+
+} // End namespace gold_testsuite.
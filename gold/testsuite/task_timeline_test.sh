@@ -0,0 +1,53 @@
+#!/bin/sh
+
+# task_timeline_test.sh -- test --task-timeline.
+
+# Copyright 2014 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --task-timeline writes a
+# JSON trace with an event for each kind of task that a simple link
+# runs, and flow events for the tokens that blocked them.
+
+check()
+{
+    if ! grep -q -e "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check task_timeline_test.json '^{"displayTimeUnit":"ms","traceEvents":\[$'
+check task_timeline_test.json '"name":"process_name","ph":"M"'
+check task_timeline_test.json '"name":"Read_symbols [^"]*basic_test.o","cat":"Read_symbols","ph":"X"'
+check task_timeline_test.json '"cat":"Add_symbols","ph":"X"'
+check task_timeline_test.json '"cat":"Relocate_task","ph":"X"'
+check task_timeline_test.json '"cat":"Write_symbols_task","ph":"X"'
+check task_timeline_test.json '"args":{"id":[0-9]*,"queued_us":[0-9]*,"waited_us":[0-9]*'
+check task_timeline_test.json '"token_type":"blocker","unblocked_by":[0-9]*}}'
+check task_timeline_test.json '"name":"unblock","cat":"token","ph":"s"'
+check task_timeline_test.json '"name":"unblock","cat":"token","ph":"f"'
+check task_timeline_test.json '^\]}$'
+
+exit 0
@@ -22,6 +22,12 @@
 
 #include "gold.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/time.h>
+
 #include "debug.h"
 #include "options.h"
 #include "timer.h"
@@ -114,17 +120,64 @@ class Workqueue_threader_single : public Workqueue_threader
   { return false; }
 };
 
+// Hold the Workqueue lock, and release it when this goes out of
+// scope.
+
+class Hold_workqueue_lock
+{
+ public:
+  Hold_workqueue_lock(Workqueue* workqueue)
+    : workqueue_(workqueue)
+  { this->workqueue_->acquire_lock(); }
+
+  ~Hold_workqueue_lock()
+  { this->workqueue_->lock_.release(); }
+
+ private:
+  // This class can not be copied.
+  Hold_workqueue_lock(const Hold_workqueue_lock&);
+  Hold_workqueue_lock& operator=(const Hold_workqueue_lock&);
+
+  Workqueue* workqueue_;
+};
+
+// Return the current time in microseconds, for --task-timeline.
+
+static long long
+timeline_now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+// The number of sets of ready lists to create for threads when the
+// thread count is not specified.  Threads beyond this share lists.
+
+static const unsigned int default_thread_ready_count = 16;
+
 // Workqueue methods.
 
 Workqueue::Workqueue(const General_options& options)
   : lock_(),
-    first_tasks_(),
-    tasks_(),
-    running_(0),
+    ready_(0),
     waiting_(0),
     condvar_(this->lock_),
+    shared_ready_(),
+    thread_ready_(),
+    lock_acquisitions_(0),
+    lock_waits_(0),
+    thread_sleeps_(0),
+    tasks_run_(0),
+    timeline_(options.task_timeline() != NULL),
+    timeline_last_id_(0),
+    timeline_base_(0),
+    timeline_events_(),
     threader_(NULL)
 {
+  if (this->timeline_)
+    this->timeline_base_ = timeline_now();
+
   bool threads = options.threads();
 #ifndef ENABLE_THREADS
   threads = false;
@@ -138,24 +191,65 @@ Workqueue::Workqueue(const General_options& options)
 #else
       gold_unreachable();
 #endif
+
+      unsigned int count = std::max(options.thread_count_initial(),
+				    std::max(options.thread_count_middle(),
+					     options.thread_count_final()));
+      if (count == 0)
+	count = default_thread_ready_count;
+      for (unsigned int i = 0; i < count; ++i)
+	this->thread_ready_.push_back(new Ready_tasks());
     }
 }
 
 Workqueue::~Workqueue()
 {
+  for (Thread_ready_tasks::iterator p = this->thread_ready_.begin();
+       p != this->thread_ready_.end();
+       ++p)
+    delete *p;
 }
 
-// Add a task to the end of a specific queue, or put it on the list
-// waiting for a Token.
+// Acquire the Workqueue lock.  Try first without blocking, so that we
+// can count how often threads contend for the lock.
 
 void
-Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
+Workqueue::acquire_lock()
 {
-  Hold_lock hl(this->lock_);
+  if (!this->lock_.try_acquire())
+    {
+      this->lock_.acquire();
+      ++this->lock_waits_;
+    }
+  ++this->lock_acquisitions_;
+}
+
+// Add a task to the shared ready lists, or put it on the list waiting
+// for a Token.
+
+void
+Workqueue::add_to_queue(Task* t, bool front)
+{
+  // Allocate the timeline information before taking the lock.
+  Task::Timeline_info* info = NULL;
+  if (this->timeline_)
+    {
+      info = new Task::Timeline_info();
+      t->set_timeline_info(info);
+    }
+
+  Hold_workqueue_lock hl(this);
+
+  if (info != NULL)
+    {
+      info->id = ++this->timeline_last_id_;
+      info->queued = timeline_now();
+    }
 
   Task_token* token = t->is_runnable();
   if (token != NULL)
     {
+      this->timeline_wait(t, token);
       if (front)
 	token->add_waiting_front(t);
       else
@@ -163,14 +257,7 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
       ++this->waiting_;
     }
   else
-    {
-      if (front)
-	queue->push_front(t);
-      else
-	queue->push_back(t);
-      // Tell any waiting thread that there is work to do.
-      this->condvar_.signal();
-    }
+    this->make_ready(t, -1, front);
 }
 
 // Add a task to the queue.
@@ -178,7 +265,7 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
 void
 Workqueue::queue(Task* t)
 {
-  this->add_to_queue(&this->tasks_, t, false);
+  this->add_to_queue(t, false);
 }
 
 // Queue a task which should run soon.
@@ -187,7 +274,7 @@ void
 Workqueue::queue_soon(Task* t)
 {
   t->set_should_run_soon();
-  this->add_to_queue(&this->first_tasks_, t, false);
+  this->add_to_queue(t, false);
 }
 
 // Queue a task which should run next.
@@ -196,7 +283,7 @@ void
 Workqueue::queue_next(Task* t)
 {
   t->set_should_run_soon();
-  this->add_to_queue(&this->first_tasks_, t, true);
+  this->add_to_queue(t, true);
 }
 
 // Return whether to cancel the current thread.
@@ -207,55 +294,137 @@ Workqueue::should_cancel_thread(int thread_number)
   return this->threader_->should_cancel_thread(thread_number);
 }
 
-// Find a runnable task in TASKS.  Return NULL if none could be found.
-// If we find a Task waiting for a Token, add it to the list for that
-// Token.  The workqueue lock must be held when this is called.
+// Return the ready lists owned by THREAD_NUMBER.  When not using
+// threads, the single thread uses the shared lists.
 
-Task*
-Workqueue::find_runnable_in_list(Task_list* tasks)
+inline Workqueue::Ready_tasks*
+Workqueue::thread_ready_tasks(int thread_number)
 {
-  Task* t;
-  while ((t = tasks->pop_front()) != NULL)
-    {
-      Task_token* token = t->is_runnable();
+  if (this->thread_ready_.empty())
+    return &this->shared_ready_;
+  return this->thread_ready_[thread_number % this->thread_ready_.size()];
+}
 
-      if (token == NULL)
-	return t;
+// T is ready to run.  Take its locks, and add it to the ready lists
+// of THREAD_NUMBER, or to the shared lists if THREAD_NUMBER is -1.
+// Once T holds its locks it stays runnable, so any thread may run it.
+// The workqueue lock must be held when this is called.
 
-      token->add_waiting(t);
-      ++this->waiting_;
-    }
+void
+Workqueue::make_ready(Task* t, int thread_number, bool front)
+{
+  // Get the locks for the task.  This must be called while we are
+  // still holding the Workqueue lock.
+  t->locks(t->locker());
+  ++this->ready_;
+
+  Ready_tasks* ready = (thread_number < 0
+			? &this->shared_ready_
+			: this->thread_ready_tasks(thread_number));
+  {
+    Hold_lock hl(ready->lock);
+    Task_list* list = (t->should_run_soon()
+		       ? &ready->first_tasks
+		       : &ready->tasks);
+    if (front)
+      list->push_front(t);
+    else
+      list->push_back(t);
+  }
 
-  // We couldn't find any runnable task.
-  return NULL;
+  // Tell any waiting thread that there is work to do.
+  this->condvar_.signal();
 }
 
-// Find a runnable task.  Return NULL if none could be found.  The
-// workqueue lock must be held when this is called.
+// Return whether there are tasks on the ready lists of THREAD_NUMBER
+// or on the shared lists.  Tasks which other threads have queued do
+// not delay T, since those threads will run them.
+
+bool
+Workqueue::has_ready(int thread_number)
+{
+  Ready_tasks* own = this->thread_ready_tasks(thread_number);
+  {
+    Hold_lock hl(own->lock);
+    if (!own->first_tasks.empty() || !own->tasks.empty())
+      return true;
+  }
+  Hold_lock hl(this->shared_ready_.lock);
+  return (!this->shared_ready_.first_tasks.empty()
+	  || !this->shared_ready_.tasks.empty());
+}
+
+// Remove a task from READY, from the tasks to execute soon if SOON is
+// true.  STEAL is true if READY belongs to another thread.  Return
+// NULL if there is no such task.  This only takes the lock for READY.
 
 Task*
-Workqueue::find_runnable()
+Workqueue::take_ready(Ready_tasks* ready, bool soon, bool steal)
 {
-  Task* t = this->find_runnable_in_list(&this->first_tasks_);
-  if (t == NULL)
-    t = this->find_runnable_in_list(&this->tasks_);
+  Hold_lock hl(ready->lock);
+  Task* t = (soon ? ready->first_tasks : ready->tasks).pop_front();
+  if (t != NULL)
+    {
+      if (steal)
+	++ready->stolen;
+      else
+	++ready->dequeued;
+    }
   return t;
 }
 
-// Find a runnable a task, and wait until we find one.  Return NULL if
-// we should exit.  The workqueue lock must be held when this is
-// called.
+// Find a task which is ready to run.  Look at the thread's own lists,
+// then at the shared lists, and then steal from the other threads,
+// first for tasks which should run soon and then for the others.
+// Return NULL if there are no ready tasks.  This does not require the
+// workqueue lock.
+
+Task*
+Workqueue::find_ready(int thread_number)
+{
+  Ready_tasks* own = this->thread_ready_tasks(thread_number);
+  size_t count = this->thread_ready_.size();
+  for (int i = 0; i < 2; ++i)
+    {
+      bool soon = i == 0;
+      Task* t = this->take_ready(own, soon, false);
+      if (t != NULL)
+	return t;
+      if (own != &this->shared_ready_)
+	{
+	  t = this->take_ready(&this->shared_ready_, soon, false);
+	  if (t != NULL)
+	    return t;
+	}
+      for (size_t j = 1; j < count; ++j)
+	{
+	  Ready_tasks* victim =
+	    this->thread_ready_[(thread_number + j) % count];
+	  if (victim != own)
+	    {
+	      t = this->take_ready(victim, soon, true);
+	      if (t != NULL)
+		return t;
+	    }
+	}
+    }
+  return NULL;
+}
+
+// Find a task which is ready to run, and wait until we find one.
+// Return NULL if we should exit.  The workqueue lock must be held
+// when this is called.  Ready tasks are only added with the workqueue
+// lock held, so if we find none here we can wait on the condition
+// variable.
 
 Task*
-Workqueue::find_runnable_or_wait(int thread_number)
+Workqueue::find_ready_or_wait(int thread_number)
 {
-  Task* t = this->find_runnable();
+  Task* t = this->find_ready(thread_number);
 
   while (t == NULL)
     {
-      if (this->running_ == 0
-	  && this->first_tasks_.empty()
-	  && this->tasks_.empty())
+      if (this->ready_ == 0)
 	{
 	  // Kick all the threads to make them exit.
 	  this->condvar_.broadcast();
@@ -269,11 +438,12 @@ Workqueue::find_runnable_or_wait(int thread_number)
 
       gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
 
+      ++this->thread_sleeps_;
       this->condvar_.wait();
 
       gold_debug(DEBUG_TASK, "%3d awake", thread_number);
 
-      t = this->find_runnable();
+      t = this->find_ready(thread_number);
     }
 
   return t;
@@ -288,24 +458,17 @@ Workqueue::find_runnable_or_wait(int thread_number)
 bool
 Workqueue::find_and_run_task(int thread_number)
 {
-  Task* t;
-  Task_locker tl;
+  Task* t = this->find_ready(thread_number);
 
-  {
-    Hold_lock hl(this->lock_);
-
-    // Find a runnable task.
-    t = this->find_runnable_or_wait(thread_number);
-
-    if (t == NULL)
-      return false;
+  if (t == NULL)
+    {
+      Hold_workqueue_lock hl(this);
 
-    // Get the locks for the task.  This must be called while we are
-    // still holding the Workqueue lock.
-    t->locks(&tl);
+      t = this->find_ready_or_wait(thread_number);
 
-    ++this->running_;
-  }
+      if (t == NULL)
+	return false;
+    }
 
   while (t != NULL)
     {
@@ -316,8 +479,19 @@ Workqueue::find_and_run_task(int thread_number)
       if (is_debugging_enabled(DEBUG_TASK))
         timer.start();
 
+      long long start = 0;
+      if (this->timeline_)
+	{
+	  t->name();
+	  start = timeline_now();
+	}
+
       t->run(this);
 
+      long long end = 0;
+      if (this->timeline_)
+	end = timeline_now();
+
       if (is_debugging_enabled(DEBUG_TASK))
         {
           Timer::TimeStats elapsed = timer.get_elapsed_time();
@@ -333,31 +507,34 @@ Workqueue::find_and_run_task(int thread_number)
 
       Task* next;
       {
-	Hold_lock hl(this->lock_);
-
-	--this->running_;
+	Hold_workqueue_lock hl(this);
 
-	// Release the locks for the task.  This must be done with the
-	// workqueue lock held.  Get the next Task to run if any.
-	next = this->release_locks(t, &tl);
+	--this->ready_;
+	++this->tasks_run_;
 
-	if (next == NULL)
-	  next = this->find_runnable();
-
-	// If we have another Task to run, get the Locks.  This must
-	// be called while we are still holding the Workqueue lock.
-	if (next != NULL)
+	if (this->timeline_)
 	  {
-	    tl.clear();
-	    next->locks(&tl);
-
-	    ++this->running_;
+	    this->timeline_events_.push_back(Timeline_event());
+	    Timeline_event& ev(this->timeline_events_.back());
+	    ev.name = t->name();
+	    ev.thread_number = thread_number;
+	    ev.start = start;
+	    ev.end = end;
+	    ev.info = *t->timeline_info();
 	  }
+
+	// Release the locks for the task.  This must be done with the
+	// workqueue lock held.  Get the next Task to run if any; it
+	// already holds its locks.
+	next = this->release_locks(t, thread_number);
       }
 
       // We are done with this task.
       delete t;
 
+      if (next == NULL)
+	next = this->find_ready(thread_number);
+
       t = next;
     }
 
@@ -369,12 +546,14 @@ Workqueue::find_and_run_task(int thread_number)
 
 // 1) If T is not runnable, queue it on the appropriate token.
 
-// 2) Otherwise, T is runnable.  If *PRET is not NULL, then we have
-// already decided which Task to run next.  Add T to the list of
-// runnable tasks, and signal another thread.
+// Otherwise T is runnable, and takes its locks now.
+
+// 2) If *PRET is not NULL, then we have already decided which Task to
+// run next.  Add T to this thread's list of ready tasks, and signal
+// another thread, which may steal it.
 
 // 3) Otherwise, *PRET is NULL.  If IS_BLOCKER is false, then T was
-// waiting on a write lock.  We can grab that lock now, so we run T
+// waiting on a write lock.  We have grabbed that lock, so we run T
 // now.
 
 // 4) Otherwise, IS_BLOCKER is true.  If we should run T soon, then
@@ -391,18 +570,18 @@ Workqueue::find_and_run_task(int thread_number)
 
 // This function must be called with the Workqueue lock held.
 
-// Return true if we set *PRET to T, false otherwise.
-
-bool
-Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
+void
+Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret,
+			   int thread_number)
 {
   Task_token* token = t->is_runnable();
 
   if (token != NULL)
     {
+      this->timeline_wait(t, token);
       token->add_waiting(t);
       ++this->waiting_;
-      return false;
+      return;
     }
 
   bool should_queue = false;
@@ -414,7 +593,7 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     should_return = true;
   else if (t->should_run_soon())
     should_return = true;
-  else if (!this->first_tasks_.empty() || !this->tasks_.empty())
+  else if (this->has_ready(thread_number))
     should_queue = true;
   else
     should_return = true;
@@ -422,30 +601,26 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
   if (should_return)
     {
       gold_assert(*pret == NULL);
+      t->locks(t->locker());
+      ++this->ready_;
       *pret = t;
-      return true;
     }
   else if (should_queue)
-    {
-      if (t->should_run_soon())
-	this->first_tasks_.push_back(t);
-      else
-	this->tasks_.push_back(t);
-      this->condvar_.signal();
-      return false;
-    }
-
-  gold_unreachable();
+    this->make_ready(t, thread_number, false);
+  else
+    gold_unreachable();
 }
 
 // Release the locks associated with a Task.  Return the first
 // runnable Task that we find.  If we find more runnable tasks, add
-// them to the run queue and signal any other threads.  This must be
-// called with the Workqueue lock held.
+// them to this thread's ready lists and signal any other threads.
+// This must be called with the Workqueue lock held.
 
 Task*
-Workqueue::release_locks(Task* t, Task_locker* tl)
+Workqueue::release_locks(Task* t, int thread_number)
 {
+  Task* const done = t;
+  Task_locker* tl = t->locker();
   Task* ret = NULL;
   for (Task_locker::iterator p = tl->begin(); p != tl->end(); ++p)
     {
@@ -460,28 +635,29 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	      while ((t = token->remove_first_waiting()) != NULL)
 		{
 		  --this->waiting_;
-		  this->return_or_queue(t, true, &ret);
+		  this->timeline_ready(t, done, thread_number);
+		  this->return_or_queue(t, true, &ret, thread_number);
 		}
 	    }
 	}
       else
 	{
-	  token->remove_writer(t);
+	  token->remove_writer(done);
 
-	  // One more waiting Task may now be runnable.  If we are
-	  // going to run it next, we can stop.  Otherwise we need to
-	  // move all the Tasks to the runnable queue, to avoid a
-	  // potential deadlock if the locking status changes before
-	  // we run the next thread.
+	  // One more waiting Task may now be runnable.  A runnable
+	  // Task takes the lock right away, so once the token is
+	  // locked again the remaining Tasks must keep waiting.
 	  Task* t;
-	  while ((t = token->remove_first_waiting()) != NULL)
+	  while (token->is_writable()
+		 && (t = token->remove_first_waiting()) != NULL)
 	    {
 	      --this->waiting_;
-	      if (this->return_or_queue(t, false, &ret))
-		break;
+	      this->timeline_ready(t, done, thread_number);
+	      this->return_or_queue(t, false, &ret, thread_number);
 	    }
 	}
     }
+  tl->clear();
   return ret;
 }
 
@@ -502,7 +678,7 @@ Workqueue::process(int thread_number)
 void
 Workqueue::set_thread_count(int threads)
 {
-  Hold_lock hl(this->lock_);
+  Hold_workqueue_lock hl(this);
 
   this->threader_->set_thread_count(threads);
   // Wake up all the threads, since something has changed.
@@ -514,8 +690,180 @@ Workqueue::set_thread_count(int threads)
 void
 Workqueue::add_blocker(Task_token* token)
 {
-  Hold_lock hl(this->lock_);
+  Hold_workqueue_lock hl(this);
   token->add_blocker();
 }
 
+// Add several new blockers to an existing Task_token.
+
+void
+Workqueue::add_blockers(Task_token* token, int count)
+{
+  Hold_workqueue_lock hl(this);
+  token->add_blockers(count);
+}
+
+// Note that T must wait for TOKEN.  The workqueue lock must be held.
+
+void
+Workqueue::timeline_wait(Task* t, const Task_token* token)
+{
+  if (!this->timeline_)
+    return;
+  Task::Timeline_info* info = t->timeline_info();
+  info->wait_start = timeline_now();
+  info->waited = true;
+  info->waited_for_blocker = token->is_blocker();
+}
+
+// Note that T is no longer waiting because DONE_BY released a token.
+// The workqueue lock must be held.
+
+void
+Workqueue::timeline_ready(Task* t, Task* done_by, int thread_number)
+{
+  if (!this->timeline_)
+    return;
+  long long now = timeline_now();
+  Task::Timeline_info* info = t->timeline_info();
+  info->wait_total += now - info->wait_start;
+  info->unblocked_by = done_by->timeline_info()->id;
+  info->unblocked_thread = thread_number;
+  info->unblocked_time = now;
+}
+
+// Write S to F as a JSON string.
+
+static void
+write_json_string(FILE* f, const std::string& s)
+{
+  putc('"', f);
+  for (std::string::const_iterator p = s.begin(); p != s.end(); ++p)
+    {
+      unsigned char c = *p;
+      if (c == '"' || c == '\\')
+	fprintf(f, "\\%c", c);
+      else if (c < 0x20)
+	fprintf(f, "\\u%04x", c);
+      else
+	putc(c, f);
+    }
+  putc('"', f);
+}
+
+// Write the tasks which ran to FILENAME in the JSON trace event
+// format read by the Chrome and Perfetto trace viewers.  Each task is
+// a complete event on the thread which ran it, named by the task
+// name, which includes the object or section it worked on.  Its
+// arguments say how long it was queued and how long it waited for
+// tokens.  A task which waited for a token has a flow arrow from the
+// end of the task which released the token.
+
+void
+Workqueue::write_timeline(const char* filename) const
+{
+  FILE* f = fopen(filename, "w");
+  if (f == NULL)
+    {
+      gold_error(_("%s: cannot open task timeline: %s"), filename,
+		 strerror(errno));
+      return;
+    }
+
+  const long long base = this->timeline_base_;
+  fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+	  "\"args\":{\"name\":");
+  write_json_string(f, program_name);
+  fprintf(f, "}}");
+
+  std::vector<bool> seen_threads;
+  for (Timeline_events::const_iterator p = this->timeline_events_.begin();
+       p != this->timeline_events_.end();
+       ++p)
+    {
+      size_t thread = p->thread_number;
+      if (thread >= seen_threads.size())
+	seen_threads.resize(thread + 1);
+      if (!seen_threads[thread])
+	{
+	  seen_threads[thread] = true;
+	  fprintf(f, (",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+		      "\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}"),
+		  p->thread_number, p->thread_number);
+	}
+
+      // The category is the name of the Task class, which is the
+      // first word of the task name.
+      std::string cat(p->name, 0, p->name.find(' '));
+
+      fprintf(f, ",\n{\"name\":");
+      write_json_string(f, p->name);
+      fprintf(f, ",\"cat\":");
+      write_json_string(f, cat);
+      fprintf(f, (",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%lld,"
+		  "\"dur\":%lld,\"args\":{\"id\":%u,\"queued_us\":%lld,"
+		  "\"waited_us\":%lld"),
+	      p->thread_number, p->start - base, p->end - p->start,
+	      p->info.id, p->start - p->info.queued, p->info.wait_total);
+      if (p->info.waited)
+	fprintf(f, ",\"token_type\":\"%s\"",
+		p->info.waited_for_blocker ? "blocker" : "lock");
+      if (p->info.unblocked_by != 0)
+	fprintf(f, ",\"unblocked_by\":%u", p->info.unblocked_by);
+      fprintf(f, "}}");
+
+      if (p->info.unblocked_by != 0)
+	{
+	  fprintf(f, (",\n{\"name\":\"unblock\",\"cat\":\"token\","
+		      "\"ph\":\"s\",\"id\":%u,\"pid\":1,\"tid\":%d,"
+		      "\"ts\":%lld}"),
+		  p->info.id, p->info.unblocked_thread,
+		  p->info.unblocked_time - base);
+	  fprintf(f, (",\n{\"name\":\"unblock\",\"cat\":\"token\","
+		      "\"ph\":\"f\",\"bp\":\"e\",\"id\":%u,\"pid\":1,"
+		      "\"tid\":%d,\"ts\":%lld}"),
+		  p->info.id, p->thread_number, p->start - base);
+	}
+    }
+
+  fprintf(f, "\n]}\n");
+  if (fclose(f) != 0)
+    gold_error(_("%s: error writing task timeline: %s"), filename,
+	       strerror(errno));
+}
+
+// Print statistics to stderr.
+
+void
+Workqueue::print_stats() const
+{
+  fprintf(stderr, _("%s: workqueue tasks run: %u\n"),
+	  program_name, this->tasks_run_);
+  fprintf(stderr, _("%s: workqueue lock acquisitions: %u\n"),
+	  program_name, this->lock_acquisitions_);
+  fprintf(stderr, _("%s: workqueue lock waits: %u\n"),
+	  program_name, this->lock_waits_);
+  fprintf(stderr, _("%s: workqueue thread sleeps: %u\n"),
+	  program_name, this->thread_sleeps_);
+
+  if (this->thread_ready_.empty())
+    return;
+  unsigned int dequeued = 0;
+  unsigned int stolen = 0;
+  for (Thread_ready_tasks::const_iterator p = this->thread_ready_.begin();
+       p != this->thread_ready_.end();
+       ++p)
+    {
+      dequeued += (*p)->dequeued;
+      stolen += (*p)->stolen;
+    }
+  fprintf(stderr, _("%s: workqueue tasks run from shared lists: %u\n"),
+	  program_name, this->shared_ready_.dequeued);
+  fprintf(stderr, _("%s: workqueue tasks run from own thread lists: %u\n"),
+	  program_name, dequeued);
+  fprintf(stderr, _("%s: workqueue tasks stolen from other threads: %u\n"),
+	  program_name, stolen);
+}
+
 } // End namespace gold.
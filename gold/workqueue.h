@@ -28,6 +28,7 @@
 #define GOLD_WORKQUEUE_H
 
 #include <string>
+#include <vector>
 
 #include "gold-threads.h"
 #include "token.h"
@@ -45,10 +46,11 @@ class Task
 {
  public:
   Task()
-    : list_next_(NULL), name_(), should_run_soon_(false)
+    : list_next_(NULL), name_(), should_run_soon_(false),
+      locker_(), timeline_info_(NULL)
   { }
   virtual ~Task()
-  { }
+  { delete this->timeline_info_; }
 
   // Check whether the Task can be run now.  This method is only
   // called with the workqueue lock held.  If the Task can run, this
@@ -96,6 +98,13 @@ class Task
   clear_list_next()
   { this->list_next_ = NULL; }
 
+  // Return the locks held by the Task.  The Workqueue takes them
+  // when the Task becomes ready to run, and releases them after the
+  // Task has run.
+  Task_locker*
+  locker()
+  { return &this->locker_; }
+
   // Return the name of the Task.  This is only used for debugging
   // purposes.
   const std::string&
@@ -106,6 +115,47 @@ class Task
     return this->name_;
   }
 
+  // Information recorded for --task-timeline.  This is only used by
+  // the Workqueue, and is only allocated when the timeline is
+  // enabled.  Times are in microseconds.  Nothing here points to a
+  // Task_token, since the tokens may be deleted before the timeline
+  // is written.
+  struct Timeline_info
+  {
+    // A serial number for the task, starting at 1.
+    unsigned int id;
+    // When the task was queued.
+    long long queued;
+    // When the task started waiting for a token, if it is waiting.
+    long long wait_start;
+    // The total time the task spent waiting for tokens.
+    long long wait_total;
+    // Whether the task waited for a token.
+    bool waited;
+    // Whether the last token the task waited for was a blocker,
+    // rather than a lock.
+    bool waited_for_blocker;
+    // The serial number of the task which released that token, or 0.
+    unsigned int unblocked_by;
+    // The thread which released the token, and when.
+    int unblocked_thread;
+    long long unblocked_time;
+  };
+
+  // Return the timeline information, or NULL if the timeline is not
+  // enabled.
+  Timeline_info*
+  timeline_info()
+  { return this->timeline_info_; }
+
+  // Set the timeline information.  Called by the Workqueue.
+  void
+  set_timeline_info(Timeline_info* info)
+  {
+    gold_assert(this->timeline_info_ == NULL);
+    this->timeline_info_ = info;
+  }
+
  protected:
   // Get the name of the task.  This must be implemented by the child
   // class.
@@ -127,6 +177,10 @@ class Task
   // Whether this Task should be executed soon.  This is used for
   // Tasks which can be run after some data is read.
   bool should_run_soon_;
+  // The locks held by this Task while it is ready to run or running.
+  Task_locker locker_;
+  // Information for --task-timeline, or NULL.
+  Timeline_info* timeline_info_;
 };
 
 // An interface for Task_function.  This is a convenience class to run
@@ -233,26 +287,103 @@ class Workqueue
   void
   add_blocker(Task_token*);
 
+  // Add COUNT new blockers to an existing Task_token, with the
+  // workqueue lock held.
+  void
+  add_blockers(Task_token*, int count);
+
+  // Print statistics to stderr.
+  void
+  print_stats() const;
+
+  // Write the --task-timeline file.
+  void
+  write_timeline(const char* filename) const;
+
  private:
   // This class can not be copied.
   Workqueue(const Workqueue&);
   Workqueue& operator=(const Workqueue&);
 
-  // Add a task to a queue.
+  // A task which ran, for --task-timeline.
+  struct Timeline_event
+  {
+    // The name of the task.
+    std::string name;
+    // The thread which ran it.
+    int thread_number;
+    // When it started and finished running.
+    long long start;
+    long long end;
+    // When it was queued and how it waited.
+    Task::Timeline_info info;
+  };
+
+  typedef std::vector<Timeline_event> Timeline_events;
+
+  // Lists of tasks which are ready to run.  A task on one of these
+  // lists already holds its locks, so any thread may run it.  Each
+  // set of lists has its own lock, so that threads can take tasks
+  // from their own lists, or steal them from other threads, without
+  // taking lock_.  Tasks are only added with lock_ held as well, so a
+  // thread which holds lock_ and finds every list empty may sleep on
+  // condvar_ without missing any work.
+  struct Ready_tasks
+  {
+    Ready_tasks()
+      : lock(), first_tasks(), tasks(), dequeued(0), stolen(0)
+    { }
+
+    // Lock for the remaining members.
+    Lock lock;
+    // Tasks to execute soon.
+    Task_list first_tasks;
+    // Tasks to execute after the ones in first_tasks.
+    Task_list tasks;
+    // The number of tasks taken by the thread which owns the lists,
+    // or by any thread for the shared lists.
+    unsigned int dequeued;
+    // The number of tasks stolen by other threads.
+    unsigned int stolen;
+  };
+
+  typedef std::vector<Ready_tasks*> Thread_ready_tasks;
+
+  friend class Hold_workqueue_lock;
+
+  // Acquire lock_, counting how often we have to wait for it.
+  void
+  acquire_lock();
+
+  // Add a task to the queue.
+  void
+  add_to_queue(Task* t, bool front);
+
+  // Return the ready lists owned by a thread.
+  Ready_tasks*
+  thread_ready_tasks(int thread_number);
+
+  // Take the locks for a task which is ready to run, and add it to
+  // the ready lists of a thread, or to the shared lists if
+  // THREAD_NUMBER is -1.
   void
-  add_to_queue(Task_list* queue, Task* t, bool front);
+  make_ready(Task* t, int thread_number, bool front);
+
+  // Return whether a thread has tasks which are ready to run.
+  bool
+  has_ready(int thread_number);
 
-  // Find a runnable task, or wait for one.
+  // Remove a task from a set of ready lists.
   Task*
-  find_runnable_or_wait(int thread_number);
+  take_ready(Ready_tasks*, bool soon, bool steal);
 
-  // Find a runnable task.
+  // Find a task which is ready to run.
   Task*
-  find_runnable();
+  find_ready(int thread_number);
 
-  // Find a runnable task in a list.
+  // Find a task which is ready to run, or wait for one.
   Task*
-  find_runnable_in_list(Task_list*);
+  find_ready_or_wait(int thread_number);
 
   // Find an run a task.
   bool
@@ -260,31 +391,63 @@ class Workqueue
 
   // Release the locks for a Task.  Return the next Task to run.
   Task*
-  release_locks(Task*, Task_locker*);
+  release_locks(Task*, int thread_number);
 
   // Store T into *PRET, or queue it as appropriate.
-  bool
-  return_or_queue(Task* t, bool is_blocker, Task** pret);
+  void
+  return_or_queue(Task* t, bool is_blocker, Task** pret, int thread_number);
 
   // Return whether to cancel this thread.
   bool
   should_cancel_thread(int thread_number);
 
+  // Note for the timeline that T is waiting for TOKEN.
+  void
+  timeline_wait(Task* t, const Task_token* token);
+
+  // Note for the timeline that T is no longer waiting, because
+  // DONE_BY, running on THREAD_NUMBER, released a token.
+  void
+  timeline_ready(Task* t, Task* done_by, int thread_number);
+
   // Master Workqueue lock.  This controls access to the following
-  // member variables.
+  // member variables, and to all Task_tokens.
   Lock lock_;
-  // List of tasks to execute soon.
-  Task_list first_tasks_;
-  // List of tasks to execute after the ones in first_tasks_.
-  Task_list tasks_;
-  // Number of tasks currently running.
-  int running_;
+  // Number of tasks which are ready to run or running.
+  int ready_;
   // Number of tasks waiting for a lock to release.
   int waiting_;
   // Condition variable associated with lock_.  This is signalled when
   // there may be a new Task to execute.
   Condvar condvar_;
 
+  // The ready lists for tasks queued by queue(), or by a thread when
+  // not using threads.
+  Ready_tasks shared_ready_;
+  // The ready lists for tasks which a thread found when releasing
+  // locks, indexed by thread number modulo the size.  This is only
+  // used when using threads, and is not changed after construction.
+  Thread_ready_tasks thread_ready_;
+
+  // Statistics, protected by lock_.
+  // The number of times lock_ was acquired.
+  unsigned int lock_acquisitions_;
+  // The number of times a thread had to wait to acquire lock_.
+  unsigned int lock_waits_;
+  // The number of times a thread waited for a task to run.
+  unsigned int thread_sleeps_;
+  // The number of tasks run.
+  unsigned int tasks_run_;
+
+  // Whether to record the task timeline, for --task-timeline.
+  bool timeline_;
+  // The serial number of the last task queued.  Protected by lock_.
+  unsigned int timeline_last_id_;
+  // When the workqueue was created.
+  long long timeline_base_;
+  // The tasks which have run, protected by lock_.
+  Timeline_events timeline_events_;
+
   // The threading implementation.  This is set at construction time
   // and not changed thereafter.
   Workqueue_threader* threader_;
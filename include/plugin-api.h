@@ -345,6 +345,17 @@ enum ld_plugin_status
     const struct ld_plugin_section * section_list,
     unsigned int num_sections);
 
+/* The linker's interface for declaring that the plugin's claim_file
+   handler may be called concurrently, from several threads, for
+   different input files.  While it runs, the handler may call
+   add_symbols, get_view, message and the get_input_section_*
+   interfaces, each with the handle of the file it was given.  This
+   should be invoked when the plugin is first loaded.  */
+
+typedef
+enum ld_plugin_status
+(*ld_plugin_allow_concurrent_claim_file) (void);
+
 enum ld_plugin_level
 {
   LDPL_INFO,
@@ -384,7 +395,8 @@ enum ld_plugin_tag
   LDPT_ALLOW_SECTION_ORDERING = 24,
   LDPT_GET_SYMBOLS_V2 = 25,
   LDPT_ALLOW_UNIQUE_SEGMENT_FOR_SECTIONS = 26,
-  LDPT_UNIQUE_SEGMENT_FOR_SECTIONS = 27
+  LDPT_UNIQUE_SEGMENT_FOR_SECTIONS = 27,
+  LDPT_ALLOW_CONCURRENT_CLAIM_FILE = 28
 };
 
 /* The plugin transfer vector.  */
@@ -416,6 +428,7 @@ struct ld_plugin_tv
     ld_plugin_allow_section_ordering tv_allow_section_ordering;
     ld_plugin_allow_unique_segment_for_sections tv_allow_unique_segment_for_sections; 
     ld_plugin_unique_segment_for_sections tv_unique_segment_for_sections;
+    ld_plugin_allow_concurrent_claim_file tv_allow_concurrent_claim_file;
   } tv_u;
 };
 